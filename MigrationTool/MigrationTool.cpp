@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include "MigrationTool.h"
 #include "filelist.h"
 #include "file.h"
@@ -15,6 +16,8 @@
 #include "str.h"
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <thread>
 #include "nlohmann/json.hpp"
 
 using json = nlohmann::json;
@@ -24,6 +27,13 @@ MigrationTool::MigrationTool()
 {
 	_parser = CreateParserObject();
 	_total_files = 0;
+	_a = false;
+	_a_only = false;
+	_inventory = false;
+
+	_readers = PIPELINE_READERS;
+	_threads = 0;
+	_prefetch = PIPELINE_PREFETCH;
     
 	_exe = NULL;
 }
@@ -62,43 +72,87 @@ int MigrationTool::ProcessFiles()
 
 	_log.Log("\n\nSource file%s: %d (%s)\n", SUFFIX(_total_files), _total_files, total_size_fmt);
 
-	int num = 1;
 	int total_lines = 0;
 
 	int all_start = Os::GetTickCount();
 
-	// Handle each file
-//	for(std::list<std::string>::iterator i = fileList.Get().begin(); i != fileList.Get().end(); i++, num++)
-//	{
-		int start = Os::GetTickCount();
+	// Assessment and inventory collect statistics in the parser, so they use a single converter
+	int converters = _threads;
+
+	if(converters <= 0)
+		converters = std::thread::hardware_concurrency();
+
+	if(_a || _inventory || converters > _total_files)
+		converters = (_a || _inventory) ? 1 : _total_files;
+
+	if(converters < 1)
+		converters = 1;
+
+	int readers = (_readers < _total_files) ? _readers : _total_files;
+
+	if(readers < 1)
+		readers = 1;
+
+	CreateParsers(converters);
+
+	// Assessment-only and inventory runs produce no output to cache
+	if(!_cache_dir.empty() && !_a_only && !_inventory && !_cache.IsOpen())
+	{
+		if(!_cache.Open(_cache_dir.c_str(), GetSettingsHash()))
+			_log.Log("\n\nError:\n Opening cache directory %s", _cache_dir.c_str());
+	}
 
-        std::string current = _srcfile;
-		std::string relative_name = File::GetRelativeName(_in.c_str(), current.c_str()); 
+	Pipeline pipeline(_prefetch, readers, converters);
 
-		_log.Log("\n%5d. %s", num, relative_name.c_str()); 
+	// Names of files are relative to the source directory when multiple files are converted
+	std::string base = _srcfile;
 
-        std::string out_name = _dstfile/*GetOutFileName(*i, relative_name)*/;
+	if(File::IsDirectory(base.c_str()) && !base.empty() && base[base.size() - 1] != DIR_SEPARATOR_CHAR)
+		base += DIR_SEPARATOR_CHAR;
 
-		int in_size = 0;
-		int in_lines = 0;
+	// Multiple files are written to the destination directory
+	if(_total_files > 1 && _out.empty())
+		_out = _dstfile;
 
-        SetParserOption(_parser, MIGRATION_CURRENT_FILE, relative_name.c_str());
+	int num = 1;
+
+	for(std::list<std::string>::iterator i = fileList.Get().begin(); i != fileList.Get().end(); i++, num++)
+	{
+		PipelineItem *item = new PipelineItem();
+
+		item->num = num;
+		item->file = *i;
+
+		if(_total_files == 1)
+		{
+			item->relative_name = File::GetRelativeName(_in.c_str(), item->file.c_str());
+			item->out_file = _dstfile;
+		}
+		else
+		{
+			item->relative_name = File::GetRelativeName(base.c_str(), item->file.c_str());
 
-		// Convert the current file
-	    rc = ProcessFile(current, out_name, &in_size, &in_lines);
+			// Target directories are created only when the output is written
+			if(!_a_only && !_inventory)
+				item->out_file = GetOutFileName(item->file, item->relative_name);
+		}
+
+		pipeline.items.push_back(item);
+	}
 
-		total_lines += in_lines;
+	std::vector<std::thread> threads;
 
-		int end = Os::GetTickCount() - start;
+	for(int i = 0; i < readers; i++)
+		threads.push_back(std::thread(&MigrationTool::ReadFiles, this, &pipeline));
 
-		char time_fmt[21];
-		char size_fmt[21];
+	for(int i = 0; i < converters; i++)
+		threads.push_back(std::thread(&MigrationTool::ConvertFiles, this, &pipeline, _parsers[i]));
 
-		Str::FormatTime(end, time_fmt);
-		Str::FormatByteSize(in_size, size_fmt);
+	// The current thread writes the converted files
+	rc = WriteFiles(&pipeline, &total_lines);
 
-		_log.Log("...Ok (%s, %d line%s, %s)", size_fmt, in_lines, SUFFIX(in_lines), time_fmt); 
-//	}
+	for(std::vector<std::thread>::iterator i = threads.begin(); i != threads.end(); i++)
+		(*i).join();
 
 	char total_time_fmt[21];
 	Str::FormatTime(Os::GetTickCount() - all_start, total_time_fmt);
@@ -111,11 +165,71 @@ int MigrationTool::ProcessFiles()
 
 		_log.Log("%s", summary);
 
+		size_t spl_peak = 0;
+
+		for(std::vector<void*>::iterator i = _parsers.begin(); i != _parsers.end(); i++)
+		{
+			size_t peak = GetSplPeakMemory(*i);
+
+			if(peak > spl_peak)
+				spl_peak = peak;
+		}
+
+		char spl_peak_fmt[21];
+		Str::FormatByteSize(spl_peak, spl_peak_fmt);
+
+		_log.LogFile("\nPeak procedure scope memory: %s", spl_peak_fmt);
+
+		char read_fmt[21];
+		char convert_fmt[21];
+		char write_fmt[21];
+
+		Str::FormatTime(pipeline.read_busy, read_fmt);
+		Str::FormatTime(pipeline.convert_busy, convert_fmt);
+		Str::FormatTime(pipeline.write_busy, write_fmt);
+
+		_log.LogFile("\nPipeline: %d reader%s, %d converter%s, busy read %s, convert %s, write %s", readers, SUFFIX(readers),
+			converters, SUFFIX(converters), read_fmt, convert_fmt, write_fmt);
+		_log.LogFile("\nPipeline read queue: max depth %d, avg depth %.1f, reader wait %d ms, converter wait %d ms",
+			(int)pipeline.read_queue.GetMaxDepth(), pipeline.read_queue.GetAvgDepth(), pipeline.read_queue.GetPushWait(), pipeline.read_queue.GetPopWait());
+		_log.LogFile("\nPipeline write queue: max depth %d, avg depth %.1f, converter wait %d ms, writer wait %d ms",
+			(int)pipeline.write_queue.GetMaxDepth(), pipeline.write_queue.GetAvgDepth(), pipeline.write_queue.GetPushWait(), pipeline.write_queue.GetPopWait());
+
+		if(_cache.IsOpen())
+			_log.Log("\nCache: %d file%s reused, %d stored", _cache.GetHits(), SUFFIX(_cache.GetHits()), _cache.GetStored());
+
+		int memo_statements = 0;
+		int memo_hits = 0;
+
+		for(std::vector<void*>::iterator i = _parsers.begin(); i != _parsers.end(); i++)
+		{
+			int statements = 0;
+			int hits = 0;
+
+			GetMemoStats(*i, &statements, &hits);
+
+			memo_statements += statements;
+			memo_hits += hits;
+		}
+
+		if(memo_statements > 0)
+			_log.LogFile("\nStatement memo: %d of %d statement%s reused (%.1f%%)", memo_hits, memo_statements, SUFFIX(memo_statements),
+				100.0 * memo_hits / memo_statements);
+
+		CheckSequenceUsage();
+
         if(_a)
         {
             _log.Log("\n\nCreating assessment report");
             CreateAssessmentReport(_parser, summary);
         }
+
+        if(_inventory)
+        {
+            _log.Log("\n\nObjects:%s", GetInventorySummary(_parser));
+            _log.Log("\n\nCreating inventory");
+            CreateInventoryReport(_parser);
+        }
     }
 
 	PrintCurrentTimestamp();
@@ -123,6 +237,222 @@ int MigrationTool::ProcessFiles()
 	return rc;
 }
 
+// Read files and pass them to converters, the OS reads the next file of the thread in background
+void MigrationTool::ReadFiles(Pipeline *pipeline)
+{
+	size_t count = pipeline->items.size();
+
+	for(size_t i = pipeline->next++; i < count; i = pipeline->next++)
+	{
+		PipelineItem *item = pipeline->items[i];
+
+		int start = Os::GetTickCount();
+
+		// Other readers take the files in between
+		if(i + pipeline->readers < count)
+			File::Prefetch(pipeline->items[i + pipeline->readers]->file.c_str());
+
+		int size = File::GetFileSize(item->file.c_str());
+
+		if(size > 0)
+		{
+			// Allocate a buffer for the file content
+			item->input = new char[size];
+
+			// Get content of the file (without terminating 'x0')
+			if(File::GetContent(item->file.c_str(), item->input, size) != -1)
+				item->size = size;
+			else
+			{
+				delete [] item->input;
+				item->input = NULL;
+			}
+		}
+
+		if(size < 0 || (size > 0 && item->input == NULL))
+			item->error = "reading " + item->file;
+
+		int time = Os::GetTickCount() - start;
+
+		item->time += time;
+		pipeline->read_busy += time;
+
+		pipeline->read_queue.Push(item);
+	}
+
+	pipeline->read_queue.Done();
+}
+
+// Convert files with the parser of the thread
+void MigrationTool::ConvertFiles(Pipeline *pipeline, void *parser)
+{
+	PipelineItem *item = NULL;
+
+	while((item = pipeline->read_queue.Pop()) != NULL)
+	{
+		int start = Os::GetTickCount();
+
+		if(item->input == NULL)
+			item->rc = -1;
+		else
+		{
+			SetParserOption(parser, MIGRATION_CURRENT_FILE, item->relative_name.c_str());
+			SetParserOption(parser, MIGRATION_CURRENT_PATH, item->file.c_str());
+
+			char *cached = NULL;
+
+			if(_cache.IsOpen())
+				item->key = _cache.GetKey(item->input, item->size);
+
+			// Assessment collects statistics of each file, so files are always converted
+			if(_cache.IsOpen() && !_a && _cache.Get(item->key, &cached, &item->out_size, &item->lines))
+			{
+				item->output = cached;
+				item->cached = true;
+			}
+			else
+			// Only scan object headers and block extents, no output is produced
+			if(_inventory)
+				item->rc = ScanInventory(parser, item->input, item->size, &item->lines);
+			else
+				item->rc = ConvertSql(parser, item->input, item->size, &item->output, &item->out_size, &item->lines);
+
+			// Source is not needed anymore, the file is converted
+			delete [] item->input;
+			item->input = NULL;
+		}
+
+		int time = Os::GetTickCount() - start;
+
+		item->time += time;
+		pipeline->convert_busy += time;
+
+		pipeline->write_queue.Push(item);
+	}
+
+	pipeline->write_queue.Done();
+}
+
+// Write converted files, they are logged in the order of the file list
+int MigrationTool::WriteFiles(Pipeline *pipeline, int *total_lines)
+{
+	int rc = -1;
+
+	std::map<int, PipelineItem*> converted;
+	int next = 1;
+
+	PipelineItem *item = NULL;
+
+	while((item = pipeline->write_queue.Pop()) != NULL)
+	{
+		int start = Os::GetTickCount();
+
+		// Write the target content to the file (there is no output in assessment-only mode)
+		if(item->size > 0 && !_inventory)
+		{
+			if(!_a_only)
+				item->rc = File::Write(item->out_file.c_str(), item->output, item->out_size);
+
+			if(item->rc == -1)
+				item->error = "writing " + item->out_file;
+
+			// The file is added to the cache journal once its output is written
+			if(_cache.IsOpen() && !item->cached && item->rc != -1)
+				_cache.Put(item->key, item->output, item->out_size, item->lines, item->relative_name.c_str());
+
+			if(item->cached)
+				delete [] item->output;
+			else
+				FreeOutput(item->output);
+
+			item->output = NULL;
+		}
+
+		int time = Os::GetTickCount() - start;
+
+		item->time += time;
+		pipeline->write_busy += time;
+
+		converted[item->num] = item;
+
+		// Log all files converted so far without a gap
+		for(std::map<int, PipelineItem*>::iterator i = converted.begin(); i != converted.end() && i->first == next; next++)
+		{
+			PipelineItem *cur = i->second;
+
+			char time_fmt[21];
+			char size_fmt[21];
+
+			Str::FormatTime(cur->time, time_fmt);
+			Str::FormatByteSize(cur->size, size_fmt);
+
+			if(cur->error.empty())
+				_log.Log("\n%5d. %s...Ok (%s, %d line%s, %s)", cur->num, cur->relative_name.c_str(), size_fmt, cur->lines, SUFFIX(cur->lines), time_fmt); 
+			else
+				_log.Log("\n%5d. %s...Failed (error %s)", cur->num, cur->relative_name.c_str(), cur->error.c_str()); 
+
+			*total_lines += cur->lines;
+
+			// A failure of any file is returned, not only of the last one
+			if(cur->num == 1 || rc != -1)
+				rc = cur->rc;
+
+			converted.erase(i++);
+		}
+	}
+
+	return rc;
+}
+
+// Create parsers for converter threads
+void MigrationTool::CreateParsers(int count)
+{
+	if(_parsers.empty())
+		_parsers.push_back(_parser);
+
+	while((int)_parsers.size() < count)
+	{
+		void *parser = CreateParserObject();
+
+		SetTypes(parser);
+		SetOptions(parser);
+
+		_parsers.push_back(parser);
+	}
+}
+
+// Log sequences converted to AUTO_INCREMENT in one file and referenced in another, each file is converted
+// without seeing the others, so the sequence is removed while the other file still needs it
+void MigrationTool::CheckSequenceUsage()
+{
+	std::map<std::string, std::string> converted;
+	std::multimap<std::string, std::string> references;
+
+	for(std::vector<void*>::iterator i = _parsers.begin(); i != _parsers.end(); i++)
+	{
+		const char *name = NULL;
+		const char *file = NULL;
+		int auto_increment = 0;
+
+		for(int num = 0; GetSequenceUsage(*i, num, &name, &file, &auto_increment) == 1; num++)
+		{
+			if(auto_increment)
+				converted[name] = file;
+			else
+				references.insert(std::pair<std::string, std::string>(name, file));
+		}
+	}
+
+	for(std::multimap<std::string, std::string>::iterator i = references.begin(); i != references.end(); i++)
+	{
+		std::map<std::string, std::string>::iterator seq = converted.find(i->first);
+
+		if(seq != converted.end() && seq->second != i->second)
+			_log.Log("\n\nWarning:\n Sequence %s converted to AUTO_INCREMENT in %s is referenced in %s", i->first.c_str(), 
+				seq->second.c_str(), i->second.c_str());
+	}
+}
+
 // Get output name of the file
 std::string MigrationTool::GetOutFileName(std::string &input, std::string &relative_name)
 {
@@ -187,52 +517,6 @@ std::string MigrationTool::GetOutFileName(std::string &input, std::string &relat
 	return output;
 }
 
-// Process a file
-int MigrationTool::ProcessFile(std::string &file, std::string &out_file, int *in_size, int *in_lines)
-{
-	if(_parser == NULL)
-		return -1;
-
-	int size = File::GetFileSize(file.c_str());
-
-	if(size <= 0)
-		return -1;
-
-	// Allocate a buffer for the file content
-	char *input = new char[size];
-
-	// Get content of the file (without terminating 'x0')
-	int rc = File::GetContent(file.c_str(), input, size);
-
-	if(rc == -1)
-	{
-		delete input;
-		return -1;
-	}
-
-	const char *output = NULL;
-	int out_size = 0;
-	int lines;
-
-	// Convert the file
-    rc = ConvertSql(_parser, input, size, &output, &out_size, &lines);
-
-    // Write the target content to the file
-    rc = File::Write(out_file.c_str(), output, out_size);
-
-    FreeOutput(output);
-
-	if(in_size != NULL)
-		*in_size = size;
-
-	if(in_lines != NULL)
-		*in_lines = lines;
-
-	delete input;
-
-	return rc;
-}
-
 // Read and validate parameters
 int MigrationTool::SetParameters(int argc, char **argv)
 {
@@ -286,34 +570,112 @@ int MigrationTool::SetParameters(int argc, char **argv)
 	if(value != NULL)
 		_a = true;
 
+    // Get -a_only option
+	if(_parameters.Get(A_ONLY_OPTION) != NULL)
+	{
+		_a = true;
+		_a_only = true;
+	}
+
+    // Get -inventory option
+	if(_parameters.Get(INVENTORY_OPTION) != NULL)
+		_inventory = true;
+
+    // Get pipeline options
+	value = _parameters.Get(READERS_OPTION);
+
+	if(value != NULL)
+		_readers = atoi(value);
+
+	value = _parameters.Get(THREADS_OPTION);
+
+	if(value != NULL)
+		_threads = atoi(value);
+
+	value = _parameters.Get(PREFETCH_OPTION);
+
+	if(value != NULL)
+		_prefetch = atoi(value);
+
+    // Get -cache option
+	value = _parameters.Get(CACHE_OPTION);
+
+	if(value != NULL)
+		_cache_dir = value;
+
 	if(_parameters.Get(HELP_PARAMETER))
 	{
 		PrintHowToUse();
 		return -1;
 	}
 
-	SetTypes();
-	SetOptions();
+	SetTypes(_parser);
+	SetOptions(_parser);
 
 	return rc;
 }
 
+// Get hash of options, mapping files and the tool that affect the conversion
+unsigned long long MigrationTool::GetSettingsHash()
+{
+	// Options that do not change the output of a file
+	static const char *skip[] = { PARAM_OPTION, OUT_OPTION, LOG_OPTION, READERS_OPTION, THREADS_OPTION, PREFETCH_OPTION,
+		CACHE_OPTION, "-s", "-d", NULL };
+
+	// Options that name mapping and meta files, their content is hashed
+	static const char *files[] = { "-omapf", "-fspmapf", "-meta", NULL };
+
+	unsigned long long hash = ConversionCache::Hash(MIGRATION_VERSION, strlen(MIGRATION_VERSION));
+
+	// Rebuilt tool can convert differently
+#ifdef WIN32
+	if(_exe != NULL)
+		hash = ConversionCache::HashFile(_exe, hash);
+#else
+	hash = ConversionCache::HashFile("/proc/self/exe", hash);
+#endif
+
+	ParametersMap &map = _parameters.GetMap();
+
+	for(ParametersMap::iterator i = map.begin(); i != map.end(); ++i)
+	{
+		bool skipped = false;
+
+		for(int k = 0; skip[k] != NULL && !skipped; k++)
+			skipped = (_stricmp(i->first.c_str(), skip[k]) == 0);
+
+		if(skipped)
+			continue;
+
+		hash = ConversionCache::Hash(i->first.c_str(), i->first.length() + 1, hash);
+		hash = ConversionCache::Hash(i->second.c_str(), i->second.length() + 1, hash);
+
+		for(int k = 0; files[k] != NULL; k++)
+		{
+			if(_stricmp(i->first.c_str(), files[k]) == 0)
+				hash = ConversionCache::HashFile(i->second.c_str(), hash);
+		}
+	}
+
+	return hash;
+}
+
 // Set source and target types
-void MigrationTool::SetTypes()
+void MigrationTool::SetTypes(void *parser)
 {
     int source = SQL_ORACLE;
     int target = SQL_MYSQL;
 
-	SetParserTypes(_parser, source, target);
+	SetParserTypes(parser, source, target);
 }
 
 // Set conversion options
-void MigrationTool::SetOptions()
+void MigrationTool::SetOptions(void *parser)
 {
 	ParametersMap &map = _parameters.GetMap();
 
 	for(ParametersMap::iterator i = map.begin(); i != map.end(); ++i)
-		SetParserOption(_parser, i->first.c_str(), i->second.c_str());
+		SetParserOption(parser, i->first.c_str(), i->second.c_str());
 }
 
 // Define SQL dialect type by name
@@ -342,7 +704,22 @@ void MigrationTool::PrintHowToUse()
 	printf("\n\nOptions:\n");
     printf("\n   -p        - Parameter file");
 	printf("\n   -out      - Output directory (the current directory by default)");
-	printf("\n   -log      - Log file (sqlines.log by default)");
+	printf("\n   -log      - Log file (sqlines.log by default, .jsonl for JSON lines)");
+	printf("\n   -a        - Create the assessment report");
+	printf("\n   -a_only   - Create the assessment report only, without target files and script-level rewrites");
+	printf("\n   -snippets - Maximum number of code snippets per report item (100 by default)");
+	printf("\n   -snippets_page - Number of report items per snippets page, the snippets file becomes an index");
+	printf("\n   -report_export - Export assessment statistics to JSON or CSV file");
+	printf("\n   -inventory - Only create the object inventory (sqlines_inventory.csv by default, .json for JSON)");
+	printf("\n   -readers  - Number of threads reading files (2 by default)");
+	printf("\n   -threads  - Number of threads converting files (number of CPUs by default, 1 for -a and -inventory)");
+	printf("\n   -prefetch - Number of files read ahead of the converters and waiting for the writer (4 by default)");
+	printf("\n   -cache    - Directory of converted files reused while the files and options are not changed");
+	printf("\n   -nomemo   - Convert each statement fully, without reusing conversions of repeated statements and INSERT heads");
+	printf("\n   -insert_batch - Merge consecutive single-row INSERT statements into multi-row INSERT with up to N rows");
+	printf("\n   -max_allowed_packet - Maximum size of multi-row INSERT in bytes (4194304 by default)");
+	printf("\n   -session_temp_tables - Create global temporary tables as TEMPORARY tables in procedures using them");
+	printf("\n   -mysql_version - Target MySQL version (the latest by default), 5.7 creates generated columns for function-based indexes");
 	printf("\n   -?        - Print how to use");
 
 	printf("\n\nExample:");
@@ -2,15 +2,28 @@
 #define migrationtool_migrationtool_h
 
 #include <string>
+#include <vector>
 #include "applog.h"
 #include "parameters.h"
+#include "pipeline.h"
+#include "cache.h"
 
 #define PARAM_OPTION                "-p"        // Parameter file
 #define OUT_OPTION                  "-out"      // Output directory
 #define A_OPTION                    "-a"        // Assessment
+#define A_ONLY_OPTION               "-a_only"   // Assessment only, target files are not written
 #define LOG_OPTION                  "-log"      // Log file
+#define INVENTORY_OPTION            "-inventory" // Object inventory only, no conversion
+#define READERS_OPTION              "-readers"  // Number of reader threads
+#define THREADS_OPTION              "-threads"  // Number of converter threads
+#define PREFETCH_OPTION             "-prefetch" // Number of files read ahead of the converters
+#define CACHE_OPTION                "-cache"    // Directory of converted files reused between runs
 
 #define MIGRATION_CURRENT_FILE        "__cur_file__"   // Relative path for the current file
+#define MIGRATION_CURRENT_PATH        "__cur_path__"   // Path to read the current file again (assessment snippets)
+
+// Version included into cache keys, change when cached outputs must not be reused
+#define MIGRATION_VERSION             "1.0"
 
 // Default log file name
 #define MIGRATION_LOGFILE             "migration.log"
@@ -27,12 +40,25 @@ class MigrationTool
     std::string _dstfile;
 
     bool _a;
+    bool _a_only;
+    bool _inventory;
+
+    // Pipeline threads
+    int _readers;
+    int _threads;
+    int _prefetch;
+
+    // Conversion cache
+    std::string _cache_dir;
+    ConversionCache _cache;
 
     // Current executable file
     const char *_exe;
 
     // SQL parser handle 
     void *_parser;
+    // Parser of each converter thread, the first one is _parser
+    std::vector<void*> _parsers;
 
     // Total number of files
     int _total_files;
@@ -53,17 +79,30 @@ private:
     int SetParameters(int argc, char **argv);
 
     int ProcessFiles();
-    int ProcessFile(std::string &file, std::string &out_file, int *in_size, int *in_lines);
+
+    // Pipeline stages
+    void ReadFiles(Pipeline *pipeline);
+    void ConvertFiles(Pipeline *pipeline, void *parser);
+    int WriteFiles(Pipeline *pipeline, int *total_lines);
+
+    // Create parsers for converter threads
+    void CreateParsers(int count);
+
+    // Log sequences converted to AUTO_INCREMENT in one file and referenced in another
+    void CheckSequenceUsage();
+
+    // Get hash of options, mapping files and the tool that affect the conversion
+    unsigned long long GetSettingsHash();
 
     // Get output name of the file
     std::string GetOutFileName(std::string &input, std::string &relative_name);
 
     // Set source and target types
-    void SetTypes();
+    void SetTypes(void *parser);
     short DefineType(const char *name);
 
     // Set conversion options
-    void SetOptions();
+    void SetOptions(void *parser);
 
     // Output how to use the tool if /? or incorrect parameters are specified
     void PrintHowToUse();
@@ -1,11 +1,12 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
         MigrationTool.cpp \
         applog.cpp \
+        cache.cpp \
         file.cpp \
         filelist.cpp \
         main.cpp \
@@ -15,10 +16,12 @@ SOURCES += \
 HEADERS += \
     MigrationTool.h \
     applog.h \
+    cache.h \
     file.h \
     filelist.h \
     os.h \
     parameters.h \
+    pipeline.h \
     sqlparserexp.h
 
 win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../Parser/release/ -lParser
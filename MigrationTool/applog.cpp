@@ -3,13 +3,72 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include "applog.h"
 
+AppLog* AppLog::_active = NULL;
+
+// Order queued messages as they were logged
+static bool AppLogSeqLess(const AppLogMessage &a, const AppLogMessage &b)
+{
+	return a.seq < b.seq;
+}
+
 // Constructor
 AppLog::AppLog()
 {
 	_filename = APPLOG_DEFAULT_FILE;
 	_trace = false;
+	_json = false;
+
+	_file = NULL;
+	_file_opened = false;
+
+	_seq = 0;
+	_threads = 0;
+	_stop = false;
+
+	// Queued messages are written on exit and crash
+	if(_active == NULL)
+	{
+		_active = this;
+
+		atexit(FlushOnExit);
+
+		signal(SIGSEGV, FlushOnSignal);
+		signal(SIGABRT, FlushOnSignal);
+		signal(SIGFPE, FlushOnSignal);
+		signal(SIGILL, FlushOnSignal);
+		signal(SIGINT, FlushOnSignal);
+		signal(SIGTERM, FlushOnSignal);
+	}
+
+	_flush_thread = std::thread(&AppLog::FlushThread, this);
+}
+
+// Destructor
+AppLog::~AppLog()
+{
+	{
+		std::lock_guard<std::mutex> lock(_flush_lock);
+		_stop = true;
+	}
+
+	_flush_cond.notify_one();
+	_flush_thread.join();
+
+	Flush();
+
+	if(_active == this)
+		_active = NULL;
+
+	if(_file != NULL)
+		fclose(_file);
 }
 
 // Log message to console and log file
@@ -18,17 +77,14 @@ void AppLog::Log(const char *format, ...)
 	va_list args;
 	va_start(args, format);
 
-	// log message to console
+	// log message to console, stdout is flushed by the background thread
 	vprintf(format, args);
 
-	// QT tools seem to get delayed output
-	fflush(stdout);
-
         va_end(args);
         va_start(args, format);
 
 	// log message to file
-	LogFileVaList(format, args);
+	LogFileVaList(APPLOG_LEVEL_LOG, format, args);
 
 	va_end(args);
 }
@@ -43,7 +99,7 @@ void AppLog::Trace(const char *format, ...)
 	va_start(args, format);
 
 	// log message into the file
-	LogFileVaList(format, args);
+	LogFileVaList(APPLOG_LEVEL_TRACE, format, args);
 
 	va_end(args);
 }
@@ -57,8 +113,6 @@ void AppLog::LogConsole(const char *format, ...)
 	// log message to console
 	vprintf(format, args);
 
-	fflush(stdout);
-
 	va_end(args);
 }
 
@@ -69,35 +123,255 @@ void AppLog::LogFile(const char *format, ...)
 	va_start(args, format);
 
 	// log message into the file
-	LogFileVaList(format, args);
+	LogFileVaList(APPLOG_LEVEL_FILE, format, args);
 
 	va_end(args);
 }
 
-// Write to log file
-void AppLog::LogFileVaList(const char *format, va_list args)
+// Set log file name, .json and .jsonl files are written as JSON lines
+void AppLog::SetLogfile(const char *name)
+{
+	if(name == NULL)
+		return;
+
+	// Messages queued so far belong to the previous file
+	Flush();
+
+	std::lock_guard<std::mutex> lock(_write_lock);
+
+	if(_file != NULL)
+	{
+		fclose(_file);
+		_file = NULL;
+	}
+
+	_filename = name;
+
+	const char *ext = strrchr(name, '.');
+	_json = (ext != NULL && (strcmp(ext, ".json") == 0 || strcmp(ext, ".jsonl") == 0));
+}
+
+// Queue message for the log file
+void AppLog::LogFileVaList(short level, const char *format, va_list args)
+{
+	AppLogMessage message;
+
+	char buf[1024];
+
+	va_list args_copy;
+	va_copy(args_copy, args);
+
+	// Format in the logging thread, so the writer only copies the text
+	int len = vsnprintf(buf, sizeof(buf), format, args);
+
+	if(len >= (int)sizeof(buf))
+	{
+		message.text.resize((size_t)len + 1);
+		vsnprintf(&message.text[0], (size_t)len + 1, format, args_copy);
+		message.text.resize((size_t)len);
+	}
+	else
+	if(len > 0)
+		message.text.assign(buf, (size_t)len);
+
+	va_end(args_copy);
+
+	message.level = level;
+	message.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	AppLogQueue &queue = GetQueue(&message.thread);
+	bool full = false;
+
+	{
+		std::lock_guard<std::mutex> lock(queue.lock);
+
+		// Sequence is taken under the queue lock, so each queue stays ordered
+		message.seq = _seq++;
+		queue.messages.push_back(std::move(message));
+
+		full = (queue.messages.size() >= APPLOG_QUEUE_SIZE);
+	}
+
+	// The queue is bounded, the logging thread writes the log itself when it is full
+	if(full)
+		Flush();
+}
+
+// Get the queue of the current thread
+AppLogQueue& AppLog::GetQueue(int *thread)
+{
+	static thread_local int num = -1;
+
+	if(num == -1)
+		num = _threads++;
+
+	if(thread != NULL)
+		*thread = num;
+
+	return _queues[num % APPLOG_QUEUES];
+}
+
+// Write all queued messages to the log file, the locks are not waited for on crash
+void AppLog::Flush(bool crash)
+{
+	std::unique_lock<std::mutex> write_lock(_write_lock, std::defer_lock);
+
+	if(crash)
+	{
+		if(!write_lock.try_lock())
+			return;
+	}
+	else
+		write_lock.lock();
+
+	std::vector<AppLogMessage> messages;
+
+	for(int i = 0; i < APPLOG_QUEUES; i++)
+	{
+		std::unique_lock<std::mutex> lock(_queues[i].lock, std::defer_lock);
+
+		if(crash)
+		{
+			if(!lock.try_lock())
+				continue;
+		}
+		else
+			lock.lock();
+
+		if(messages.empty())
+			messages.swap(_queues[i].messages);
+		else
+		{
+			std::move(_queues[i].messages.begin(), _queues[i].messages.end(), std::back_inserter(messages));
+			_queues[i].messages.clear();
+		}
+	}
+
+	// Queues are ordered, merge them into the logging order
+	std::sort(messages.begin(), messages.end(), AppLogSeqLess);
+
+	Write(messages);
+
+	fflush(stdout);
+}
+
+// Write messages to the log file, as is or as JSON lines
+void AppLog::Write(std::vector<AppLogMessage> &messages)
+{
+	if(messages.empty())
+		return;
+
+	if(_file == NULL)
+	{
+		// During the first open destroy the log file content that may exists from the previous runs
+		_file = fopen(_filename.c_str(), _file_opened ? "a" : "w");
+
+		if(_file == NULL)
+		{
+			// Show error message during the first open only
+			if(!_file_opened)
+				printf("\n\nError:\n Opening log file %s - %s", _filename.c_str(), strerror(errno));
+
+			_file_opened = true;
+			return;
+		}
+
+		_file_opened = true;
+	}
+
+	for(std::vector<AppLogMessage>::iterator i = messages.begin(); i != messages.end(); i++)
+	{
+		if(_json)
+			WriteJson(*i);
+		else
+			fwrite((*i).text.c_str(), 1, (*i).text.length(), _file);
+	}
+
+	fflush(_file);
+}
+
+// Write a message as JSON line
+void AppLog::WriteJson(AppLogMessage &message)
 {
-	static bool firstCall = true;
-	const char *openMode = "a";
+	static const char *levels[] = { "log", "trace", "file" };
+
+	time_t t = (time_t)(message.time / 1000);
+	struct tm *lt = localtime(&t);
+
+	char prefix[160];
+
+	if(lt != NULL)
+		snprintf(prefix, sizeof(prefix), "{\"time\":\"%d-%02d-%02d %02d:%02d:%02d.%03d\",\"thread\":%d,\"level\":\"%s\",\"message\":\"",
+			lt->tm_year + 1900, lt->tm_mon + 1, lt->tm_mday, lt->tm_hour, lt->tm_min, lt->tm_sec, (int)(message.time % 1000),
+			message.thread, levels[message.level]);
+	else
+		snprintf(prefix, sizeof(prefix), "{\"thread\":%d,\"level\":\"%s\",\"message\":\"", message.thread, levels[message.level]);
+
+	std::string line = prefix;
+
+	// Messages are formatted for the console, the leading and trailing new lines are not included
+	size_t start = message.text.find_first_not_of("\r\n");
+	size_t end = message.text.find_last_not_of("\r\n");
+
+	for(size_t i = start; start != std::string::npos && i <= end; i++)
+	{
+		char c = message.text[i];
 
-	// During the first call destroy the log file content that may exists from the previous runs
-	if(firstCall)
-		openMode = "w";
+		if(c == '"' || c == '\\')
+		{
+			line += '\\';
+			line += c;
+		}
+		else
+		if(c == '\n')
+			line += "\\n";
+		else
+		if(c == '\r')
+			line += "\\r";
+		else
+		if(c == '\t')
+			line += "\\t";
+		else
+		if((unsigned char)c >= 0x20)
+			line += c;
+	}
+
+	line += "\"}\n";
 
-	FILE *file = fopen(_filename.c_str(), openMode);
+	fwrite(line.c_str(), 1, line.length(), _file);
+}
 
-	// Log message to file
-	if(file != NULL)
+// Background flush thread
+void AppLog::FlushThread()
+{
+	std::unique_lock<std::mutex> lock(_flush_lock);
+
+	while(!_stop)
 	{
-		vfprintf(file, format, args);
-		fclose(file);
+		_flush_cond.wait_for(lock, std::chrono::milliseconds(APPLOG_FLUSH_INTERVAL));
+
+		if(_stop)
+			break;
+
+		lock.unlock();
+		Flush();
+		lock.lock();
 	}
-	else 
-	{  
-		// Show error message during the first call only  
-		if(firstCall)
-			printf("\n\nError:\n Opening log file %s - %s", _filename.c_str(), strerror(errno));
-	} 
-
-	firstCall = false;
+}
+
+// Flush the active log on exit
+void AppLog::FlushOnExit()
+{
+	if(_active != NULL)
+		_active->Flush(true);
+}
+
+// Flush the active log on crash and continue with the default handler
+void AppLog::FlushOnSignal(int sig)
+{
+	if(_active != NULL)
+		_active->Flush(true);
+
+	signal(sig, SIG_DFL);
+	raise(sig);
 }
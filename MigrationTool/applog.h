@@ -2,19 +2,82 @@
 #define migrationtool_applog_h
 
 #include <stdarg.h>
+#include <stdio.h>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 
 // Default log file name
 #define APPLOG_DEFAULT_FILE			"applog.log"
 
+// Number of message queues, threads are spread over them so they do not contend on a single lock
+#define APPLOG_QUEUES				8
+// Maximum number of messages in a queue, the logging thread writes the log itself when it is full
+#define APPLOG_QUEUE_SIZE			1024
+// Interval of the background flush in milliseconds
+#define APPLOG_FLUSH_INTERVAL		200
+
+// Message levels
+#define APPLOG_LEVEL_LOG			0
+#define APPLOG_LEVEL_TRACE			1
+#define APPLOG_LEVEL_FILE			2
+
+// Message waiting to be written to the log file
+struct AppLogMessage
+{
+	// Order of messages from all threads
+	unsigned long long seq;
+	// Logging thread number and message level
+	int thread;
+	short level;
+	// Time in milliseconds since the epoch
+	long long time;
+
+	std::string text;
+};
+
+struct AppLogQueue
+{
+	std::mutex lock;
+	std::vector<AppLogMessage> messages;
+};
+
 class AppLog
 {
 	// Log file name
 	std::string _filename;
-	// Trace mode 
+	// Trace mode
 	bool _trace;
+	// Write messages as JSON lines (.json or .jsonl log file)
+	bool _json;
+
+	// Log file is kept open, it is truncated when opened for the first time
+	FILE *_file;
+	bool _file_opened;
+
+	// Messages are queued by the logging threads and written by the flush thread
+	AppLogQueue _queues[APPLOG_QUEUES];
+	std::atomic<unsigned long long> _seq;
+	std::atomic<int> _threads;
+
+	// Serializes writing to the log file
+	std::mutex _write_lock;
+
+	// Background flush
+	std::mutex _flush_lock;
+	std::condition_variable _flush_cond;
+	bool _stop;
+	std::thread _flush_thread;
+
+	// Log flushed on exit and crash
+	static AppLog *_active;
+
 public:
 	AppLog();
+	~AppLog();
 
 	// Log message to console and log file
     void Log(const char *format, ...);
@@ -25,11 +88,27 @@ public:
     // Write to log file only
     void LogFile(const char *format, ...);
 
+	// Write all queued messages to the log file, the locks are not waited for on crash
+	void Flush(bool crash = false);
+
 	// Set log file name
-	void SetLogfile(const char *name) { _filename = name; }
+	void SetLogfile(const char *name);
 private:
-    // Write to log file
-    void LogFileVaList(const char *format, va_list args);	
+    // Queue message for the log file
+    void LogFileVaList(short level, const char *format, va_list args);
+	// Get the queue of the current thread
+	AppLogQueue& GetQueue(int *thread);
+
+	// Write messages to the log file, as is or as JSON lines
+	void Write(std::vector<AppLogMessage> &messages);
+	void WriteJson(AppLogMessage &message);
+
+	// Background flush thread
+	void FlushThread();
+
+	// Flush the active log on exit and crash
+	static void FlushOnExit();
+	static void FlushOnSignal(int sig);
 };
 
 #endif // migrationtool_applog_h
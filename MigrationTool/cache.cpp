@@ -0,0 +1,225 @@
+// ConversionCache - Converted files reused between runs by the hash of their content and settings
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cache.h"
+#include "file.h"
+
+// Constructor
+ConversionCache::ConversionCache()
+{
+	_settings = 0;
+	_journal = NULL;
+
+	_hits = 0;
+	_stored = 0;
+}
+
+// Destructor
+ConversionCache::~ConversionCache()
+{
+	if(_journal != NULL)
+		fclose(_journal);
+}
+
+// Open the cache directory and read the journal
+bool ConversionCache::Open(const char *dir, unsigned long long settings)
+{
+	if(dir == NULL || *dir == '\x0')
+		return false;
+
+	_dir = dir;
+	_settings = settings;
+
+	File::CreateDirectories(_dir.c_str());
+
+	std::string journal;
+	File::GetPathFromDirectoryAndFile(journal, _dir.c_str(), CONVERSION_CACHE_JOURNAL);
+
+	FILE *file = fopen(journal.c_str(), "r");
+
+	if(file != NULL)
+	{
+		char line[1024];
+
+		// Each line is "key size lines name", a line cut by an interrupted run is skipped
+		while(fgets(line, sizeof(line), file) != NULL)
+		{
+			unsigned long long key = 0;
+			ConversionCacheEntry entry;
+
+			if(strchr(line, '\n') != NULL && sscanf(line, "%llx %d %d", &key, &entry.size, &entry.lines) == 3)
+				_entries[key] = entry;
+		}
+
+		fclose(file);
+	}
+
+	_journal = fopen(journal.c_str(), "a");
+
+	return _journal != NULL;
+}
+
+// Get the key of the file content
+unsigned long long ConversionCache::GetKey(const char *input, size_t size)
+{
+	return Hash(input, size, _settings);
+}
+
+// Get the cached output, the buffer is allocated with new []
+bool ConversionCache::Get(unsigned long long key, char **output, int *size, int *lines)
+{
+	if(output == NULL)
+		return false;
+
+	ConversionCacheEntry entry;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		std::map<unsigned long long, ConversionCacheEntry>::iterator i = _entries.find(key);
+
+		if(i == _entries.end())
+			return false;
+
+		entry = i->second;
+	}
+
+	std::string path = GetPath(key);
+
+	// Output file was removed or changed after it was journaled
+	if(File::GetFileSize(path.c_str()) != entry.size)
+		return false;
+
+	char *data = new char[entry.size + 1];
+
+	if(entry.size > 0 && File::GetContent(path.c_str(), data, entry.size) == -1)
+	{
+		delete [] data;
+		return false;
+	}
+
+	data[entry.size] = '\x0';
+
+	*output = data;
+
+	if(size != NULL)
+		*size = entry.size;
+
+	if(lines != NULL)
+		*lines = entry.lines;
+
+	std::lock_guard<std::mutex> lock(_lock);
+	_hits++;
+
+	return true;
+}
+
+// Store the output and add it to the journal
+void ConversionCache::Put(unsigned long long key, const char *output, int size, int lines, const char *name)
+{
+	if(_journal == NULL || output == NULL || size < 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		// Same content was already stored
+		std::map<unsigned long long, ConversionCacheEntry>::iterator i = _entries.find(key);
+
+		if(i != _entries.end() && i->second.size == size)
+			return;
+	}
+
+	std::string path = GetPath(key);
+	std::string tmp = path + ".tmp";
+
+	// Output is written under a temporary name, so the cache never has a partial file under the key
+	FILE *file = fopen(tmp.c_str(), "wb");
+
+	if(file == NULL)
+		return;
+
+	bool written = (fwrite(output, 1, size, file) == (size_t)size);
+
+	if(fclose(file) != 0 || !written || rename(tmp.c_str(), path.c_str()) != 0)
+	{
+		remove(tmp.c_str());
+		return;
+	}
+
+	ConversionCacheEntry entry;
+	entry.size = size;
+	entry.lines = lines;
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_entries[key] = entry;
+	_stored++;
+
+	// Journal is flushed after each file, an interrupted run resumes from the last journaled file
+	fprintf(_journal, "%016llx %d %d %s\n", key, size, lines, (name != NULL) ? name : "");
+	fflush(_journal);
+}
+
+// Get the path of the cached output
+std::string ConversionCache::GetPath(unsigned long long key)
+{
+	char name[32];
+	sprintf(name, "%016llx%s", key, CONVERSION_CACHE_EXT);
+
+	std::string path;
+	File::GetPathFromDirectoryAndFile(path, _dir.c_str(), name);
+
+	return path;
+}
+
+// 64-bit hash of data, the previous hash value is passed to hash multiple blocks
+unsigned long long ConversionCache::Hash(const void *data, size_t size, unsigned long long hash)
+{
+	const unsigned char *cur = (const unsigned char*)data;
+
+	if(cur == NULL)
+		return hash;
+
+	const unsigned long long prime = 1099511628211ULL;
+
+	// FNV-1a over 8-byte words, the tail is hashed by bytes
+	for(; size >= 8; size -= 8, cur += 8)
+	{
+		unsigned long long word;
+		memcpy(&word, cur, 8);
+
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 29;
+	}
+
+	for(; size > 0; size--, cur++)
+		hash = (hash ^ *cur) * prime;
+
+	// Final mix, so close inputs do not get close keys
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// Hash of the file content, the hash is not changed if the file cannot be read
+unsigned long long ConversionCache::HashFile(const char *file, unsigned long long hash)
+{
+	int size = File::GetFileSize(file);
+
+	if(size <= 0)
+		return hash;
+
+	char *input = new char[size];
+
+	if(File::GetContent(file, input, size) != -1)
+		hash = Hash(input, size, hash);
+
+	delete [] input;
+
+	return hash;
+}
@@ -0,0 +1,72 @@
+// ConversionCache - Converted files reused between runs by the hash of their content and settings
+
+#ifndef migrationtool_cache_h
+#define migrationtool_cache_h
+
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <mutex>
+
+// Journal file in the cache directory
+#define CONVERSION_CACHE_JOURNAL		"journal.txt"
+// Extension of cached output files
+#define CONVERSION_CACHE_EXT			".out"
+
+// Cached conversion of a file
+struct ConversionCacheEntry
+{
+	int size;
+	int lines;
+
+	ConversionCacheEntry() { size = 0; lines = 0; }
+};
+
+// Cache directory holds an output file per key, and the journal of stored keys. An entry is added to the journal
+// after its output is written, so the journal is a checkpoint of files that do not need to be converted again
+class ConversionCache
+{
+	std::string _dir;
+
+	// Hash of conversion settings, combined with the content hash into the key
+	unsigned long long _settings;
+
+	std::map<unsigned long long, ConversionCacheEntry> _entries;
+	FILE *_journal;
+
+	// Number of files reused and stored in this run
+	int _hits;
+	int _stored;
+
+	std::mutex _lock;
+
+public:
+	ConversionCache();
+	~ConversionCache();
+
+	// Open the cache directory and read the journal
+	bool Open(const char *dir, unsigned long long settings);
+	bool IsOpen() { return _journal != NULL; }
+
+	// Get the key of the file content
+	unsigned long long GetKey(const char *input, size_t size);
+
+	// Get the cached output, the buffer is allocated with new []
+	bool Get(unsigned long long key, char **output, int *size, int *lines);
+	// Store the output and add it to the journal
+	void Put(unsigned long long key, const char *output, int size, int lines, const char *name);
+
+	int GetHits() { return _hits; }
+	int GetStored() { return _stored; }
+
+	// 64-bit hash of data, the previous hash value is passed to hash multiple blocks
+	static unsigned long long Hash(const void *data, size_t size, unsigned long long hash = 14695981039346656037ULL);
+	// Hash of the file content, 0 if the file cannot be read
+	static unsigned long long HashFile(const char *file, unsigned long long hash = 14695981039346656037ULL);
+
+private:
+	// Get the path of the cached output
+	std::string GetPath(unsigned long long key);
+};
+
+#endif // migrationtool_cache_h
@@ -292,13 +292,34 @@ int File::GetContent(const char *file, void *input, size_t len)
 		return -1;
 	}
 
-	// Read the file content to the buffer
-	int bytesRead = _read(fileHandle, input, len);
-	if(bytesRead == -1)
+#ifndef WIN32
+	// The file is read once from start to end
+	posix_fadvise(fileHandle, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	size_t total = 0;
+
+	// Read the file content to the buffer, read can return less than requested
+	while(total < len)
 	{
-		_close(fileHandle);
+		int bytesRead = _read(fileHandle, (char*)input + total, len - total);
 
-		return -1;
+		if(bytesRead == -1)
+		{
+			_close(fileHandle);
+
+			return -1;
+		}
+
+		// The file is shorter than expected
+		if(bytesRead == 0)
+		{
+			_close(fileHandle);
+
+			return -1;
+		}
+
+		total += bytesRead;
 	}
 
 	_close(fileHandle);
@@ -306,6 +327,24 @@ int File::GetContent(const char *file, void *input, size_t len)
 	return 0;
 }
 
+// Ask the OS to start reading the file into the page cache
+void File::Prefetch(const char *file)
+{
+#ifndef WIN32
+	if(file == NULL)
+		return;
+
+	int fileHandle = open(file, O_RDONLY);
+
+	if(fileHandle == -1)
+		return;
+
+	posix_fadvise(fileHandle, 0, 0, POSIX_FADV_WILLNEED);
+
+	_close(fileHandle);
+#endif
+}
+
 // Get relative name
 std::string File::GetRelativeName(const char* base, const char *file)
 {
@@ -348,7 +387,7 @@ int File::Write(const char *file, const char* content, size_t size)
   int fileh = _open(file, _O_CREAT | _O_RDWR | _O_BINARY | _O_TRUNC, _S_IREAD | _S_IWRITE);
 #else
   // open the file
-  int fileh = open(file, O_CREAT | O_RDWR, 0666);
+  int fileh = open(file, O_CREAT | O_RDWR | O_TRUNC, 0666);
 #endif
 
    if(fileh == -1)
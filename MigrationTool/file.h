@@ -48,6 +48,8 @@ public:
 
 	// Get content of the file (without terminating with 'x0')
 	static int GetContent(const char* file, void *input, size_t len);
+	// Ask the OS to start reading the file into the page cache
+	static void Prefetch(const char *file);
 
 	// Get relative name
 	static std::string GetRelativeName(const char* base, const char *file);
@@ -12,6 +12,7 @@
 #include <sys/stat.h>
 #include <sys/io.h>
 #include <unistd.h>
+#include <dirent.h>
 
 #define _read read
 #define _write write
@@ -23,6 +24,8 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <string>
+#include <algorithm>
+#include <thread>
 #include "filelist.h"
 #include "file.h"
 #include "str.h"
@@ -82,11 +85,26 @@ int FileList::Load(const char *inputPath)
 			FindFiles(*i, file, dirs, _files); 
 		}
 
+		AddFoundFiles(_files);
 	}
 
 	return 0;
 }
 
+// Join directory and name
+static std::string JoinPath(const std::string &dir, const char *name)
+{
+	if(dir.empty())
+		return name;
+
+	char last = dir[dir.length() - 1];
+
+	if(last == '/' || last == '\\')
+		return dir + name;
+
+	return dir + DIR_SEPARATOR_STR + name;
+}
+
 // Get the directory list matching the specified wildcard (A*\B*\C\D* i.e.)
 int FileList::GetDirectoriesByWildcard(const char *wildcard, std::list<std::string> &dirs)
 {
@@ -94,7 +112,7 @@ int FileList::GetDirectoriesByWildcard(const char *wildcard, std::list<std::stri
 		return -1;
 
 	// If wildcard is not specified add to the list and return
-	if(strchr(wildcard, '*') == NULL)
+	if(strchr(wildcard, '*') == NULL && strchr(wildcard, '?') == NULL)
 	{
 		std::string dir = wildcard;
 		dirs.push_back(dir);
@@ -102,6 +120,198 @@ int FileList::GetDirectoriesByWildcard(const char *wildcard, std::list<std::stri
 		return 0;
 	}
 
+	std::vector<std::string> current;
+	std::vector<std::string> next;
+
+	// Absolute path starts from the root
+	current.push_back((*wildcard == '/' || *wildcard == '\\') ? DIR_SEPARATOR_STR : "");
+
+	const char *cur = wildcard;
+
+	// Expand the path component by component
+	while(*cur != '\x0')
+	{
+		if(*cur == '/' || *cur == '\\')
+		{
+			cur++;
+			continue;
+		}
+
+		const char *end = cur;
+
+		while(*end != '\x0' && *end != '/' && *end != '\\')
+			end++;
+
+		std::string component(cur, end - cur);
+		bool wild = (component.find_first_of("*?") != std::string::npos);
+
+		next.clear();
+
+		for(std::vector<std::string>::iterator i = current.begin(); i != current.end(); i++)
+		{
+			if(wild)
+			{
+				std::vector<std::string> subdirs;
+
+				ReadDirectory(*i, component.c_str(), NULL, subdirs);
+				next.insert(next.end(), subdirs.begin(), subdirs.end());
+			}
+			else
+				next.push_back(JoinPath(*i, component.c_str()));
+		}
+
+		current.swap(next);
+		cur = end;
+	}
+
+	for(std::vector<std::string>::iterator i = current.begin(); i != current.end(); i++)
+		dirs.push_back(*i);
+
+	return 0;
+}
+
+// Check if the name matches the wildcard (* and ? are supported)
+bool FileList::MatchWildcard(const char *name, const char *wildcard)
+{
+	if(name == NULL || wildcard == NULL)
+		return false;
+
+	const char *star = NULL;
+	const char *star_name = NULL;
+
+	while(*name != '\x0')
+	{
+		if(*wildcard == '*')
+		{
+			// Remember the position to backtrack to
+			star = ++wildcard;
+			star_name = name;
+		}
+		else
+		if(*wildcard == '?' || *wildcard == *name)
+		{
+			wildcard++;
+			name++;
+		}
+		else
+		if(star != NULL)
+		{
+			wildcard = star;
+			name = ++star_name;
+		}
+		else
+			return false;
+	}
+
+	while(*wildcard == '*')
+		wildcard++;
+
+	return *wildcard == '\x0';
+}
+
+// Read directory entries matching the wildcard, only sub-directories if files is NULL
+int FileList::ReadDirectory(const std::string &dir, const char *wildcard, std::vector<std::string> *files, std::vector<std::string> &subdirs)
+{
+	std::vector<std::string> found_files;
+	std::vector<std::string> found_dirs;
+
+#ifdef WIN32
+
+	struct _finddata_t fileInfo;
+
+	int searchHandle = _findfirst(JoinPath(dir, "*").c_str(), &fileInfo); 
+	if(searchHandle == -1)
+		return -1;
+
+	do
+	{
+		if(!MatchWildcard(fileInfo.name, wildcard))
+			continue;
+
+		if(File::IsFile(&fileInfo))
+			found_files.push_back(fileInfo.name);
+		else
+		if(File::IsDirectory(&fileInfo))
+			found_dirs.push_back(fileInfo.name);
+
+	} while(_findnext(searchHandle, &fileInfo) == 0); 
+
+	_findclose(searchHandle);
+
+#else
+
+	DIR *handle = opendir(dir.empty() ? "." : dir.c_str());
+
+	if(handle == NULL)
+		return -1;
+
+	struct dirent *entry = NULL;
+
+	while((entry = readdir(handle)) != NULL)
+	{
+		const char *name = entry->d_name;
+
+		// Hidden entries match only explicitly as in the shell
+		if(name[0] == '.' && (name[1] == '\x0' || (name[1] == '.' && name[2] == '\x0') || *wildcard != '.'))
+			continue;
+
+		if(!MatchWildcard(name, wildcard))
+			continue;
+
+		bool is_file = false;
+		bool is_dir = false;
+
+#ifdef DT_DIR
+		// The entry type is usually known without stat()
+		if(entry->d_type == DT_REG)
+			is_file = true;
+		else
+		if(entry->d_type == DT_DIR)
+			is_dir = true;
+		else
+#endif
+		{
+			// Symbolic links and file systems not reporting the type
+			struct stat info;
+			std::string path = JoinPath(dir, name);
+
+			// Linked files are converted, but linked directories are not followed as in ls -R (they can form a cycle)
+			if(lstat(path.c_str(), &info) == 0)
+			{
+				if(S_ISLNK(info.st_mode))
+					is_file = (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode));
+				else
+				{
+					is_file = S_ISREG(info.st_mode);
+					is_dir = S_ISDIR(info.st_mode);
+				}
+			}
+		}
+
+		if(is_file && files != NULL)
+			found_files.push_back(name);
+		else
+		if(is_dir)
+			found_dirs.push_back(name);
+	}
+
+	closedir(handle);
+
+#endif
+
+	// Entries are returned in name order as ls did
+	std::sort(found_files.begin(), found_files.end());
+	std::sort(found_dirs.begin(), found_dirs.end());
+
+	if(files != NULL)
+	{
+		for(std::vector<std::string>::iterator i = found_files.begin(); i != found_files.end(); i++)
+			files->push_back(JoinPath(dir, (*i).c_str()));
+	}
+
+	for(std::vector<std::string>::iterator i = found_dirs.begin(); i != found_dirs.end(); i++)
+		subdirs.push_back(JoinPath(dir, (*i).c_str()));
+
 	return 0;
 }
 
@@ -120,6 +330,9 @@ int	FileList::FindFiles(std::string dir, std::string file, std::list<std::string
 
 		if(File::IsFile(path.c_str(), &size) == true)
 		{
+			// Keep the order with files found before
+			AddFoundFiles(files);
+
 			files.push_back(path);
 			_size += size;
 
@@ -164,49 +377,71 @@ int	FileList::FindFiles(std::string dir, std::string file, std::list<std::string
 
 #else
 
-	// Get the name of temporary file to store directory listing
-	char temp[256]; *temp = '\x0';
-	sprintf(temp, "sl_ls_%d.txt", getpid());
+	std::vector<std::string> subdirs;
+
+	// *.* means all files as on Windows
+	const char *wildcard = (file == "*.*") ? "*" : file.c_str();
+
+	// Sizes of found files are taken later for all directories at once
+	ReadDirectory(dir, wildcard, &_found, subdirs);
+
+	// Sub-directories matching the wildcard are searched as well (the same as _findfirst on Windows)
+	for(std::vector<std::string>::iterator i = subdirs.begin(); i != subdirs.end(); i++)
+		dirs.push_back(*i);
+
+#endif
+
+	return 0;
+}
+
+// Get sizes of found files (in parallel for large lists) and add them to the list
+void FileList::AddFoundFiles(std::list<std::string> &files)
+{
+	if(_found.empty())
+		return;
+
+	std::vector<long long> sizes(_found.size(), -1);
 
-	std::string command = "ls -1 -d ";
-	command += path;
-	command += " 2>/dev/null > ";
-	command += temp;
+	size_t threads = std::thread::hardware_concurrency();
 
-	// Read matched files
-	if(system(command.c_str()) != -1)
+	if(threads > FILELIST_STAT_THREADS)
+		threads = FILELIST_STAT_THREADS;
+
+	if(_found.size() < FILELIST_PARALLEL_STAT || threads < 2)
+		StatFiles(&_found, &sizes, 0, _found.size());
+	else
 	{
-		FILE *file = fopen(temp, "r");
-		char fileName[1024]; *fileName = '\x0';
-  
-		if(file)
-		{
-			// Read file content line by line
-			while(fgets(fileName, 1024, file))
-			{
-				// Remove new line from path, otherwise stat() will fail
-				int len = strlen(fileName);
-				if(len && fileName[len-1] == '\n')
-					fileName[len-1] = '\x0'; 
+		std::vector<std::thread> workers;
+		size_t chunk = (_found.size() + threads - 1) / threads;
 
-				size_t size = 0;
-				bool file = File::IsFile(fileName, &size);
+		for(size_t start = 0; start < _found.size(); start += chunk)
+			workers.push_back(std::thread(StatFiles, &_found, &sizes, start, std::min(start + chunk, _found.size())));
 
-				if(file == true)
-				{
-					files.push_back(fileName);
-					_size += size;
-				}
-			 }
-		}
-	 
-		fclose(file);
-   }
+		for(std::vector<std::thread>::iterator i = workers.begin(); i != workers.end(); i++)
+			(*i).join();
+	}
 
-   // delete the temporary file
-   unlink(temp);
+	for(size_t i = 0; i < _found.size(); i++)
+	{
+		// File was removed or replaced after the directory was read
+		if(sizes[i] < 0)
+			continue;
 
-#endif
+		files.push_back(_found[i]);
+		_size += (int)sizes[i];
+	}
 
-	return 0;
+	_found.clear();
+}
+
+// Get sizes of files in the range, -1 if the path is not a file
+void FileList::StatFiles(std::vector<std::string> *paths, std::vector<long long> *sizes, size_t start, size_t end)
+{
+	for(size_t i = start; i < end; i++)
+	{
+		size_t size = 0;
+
+		if(File::IsFile((*paths)[i].c_str(), &size))
+			(*sizes)[i] = (long long)size;
+	}
 }
@@ -5,6 +5,12 @@
 
 #include <string>
 #include <list>
+#include <vector>
+
+// Minimum number of found files to get their sizes in parallel
+#define FILELIST_PARALLEL_STAT		1024
+// Maximum number of threads getting file sizes
+#define FILELIST_STAT_THREADS		8
 
 class FileList
 {
@@ -12,6 +18,9 @@ class FileList
 	std::list<std::string> _files;
 	// Total size of all files in the list in bytes
 	int _size;  
+
+	// Files found by directory walk, their sizes are not known yet
+	std::vector<std::string> _found;
 public:
 	FileList();
 
@@ -26,9 +35,18 @@ public:
 	// Get total size of all files in the list in bytes
 	int GetSize() { return _size; }
 
+	// Check if the name matches the wildcard (* and ? are supported)
+	static bool MatchWildcard(const char *name, const char *wildcard);
+
 private:
 	// Find files in the specified directory matching the file wildcard
 	int	FindFiles(std::string dir, std::string file, std::list<std::string> &dirs, std::list<std::string> &files); 
+
+	// Read directory entries matching the wildcard, only sub-directories if files is NULL
+	int ReadDirectory(const std::string &dir, const char *wildcard, std::vector<std::string> *files, std::vector<std::string> &subdirs);
+	// Get sizes of found files (in parallel for large lists) and add them to the list
+	void AddFoundFiles(std::list<std::string> &files);
+	static void StatFiles(std::vector<std::string> *paths, std::vector<long long> *sizes, size_t start, size_t end);
 };
 
 #endif // migrationtool_filelist_h
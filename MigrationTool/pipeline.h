@@ -0,0 +1,185 @@
+// Pipeline - Files passed between read, convert and write stages through bounded queues
+
+#ifndef migrationtool_pipeline_h
+#define migrationtool_pipeline_h
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "os.h"
+
+// Default number of reader threads and files read ahead of the converters
+#define PIPELINE_READERS			2
+#define PIPELINE_PREFETCH			4
+
+// File passing through the pipeline
+struct PipelineItem
+{
+	// Position in the file list (1-based), the log follows this order
+	int num;
+
+	std::string file;
+	std::string relative_name;
+	std::string out_file;
+
+	// File content, NULL if the file cannot be read
+	char *input;
+	int size;
+
+	// Converted content, allocated by the parser or read from the cache
+	const char *output;
+	int out_size;
+	int lines;
+
+	// Cache key of the content, and whether the output was taken from the cache
+	unsigned long long key;
+	bool cached;
+
+	int rc;
+	// Description of the read or write failure, empty if the file is processed
+	std::string error;
+
+	// Time spent on the file by all stages in milliseconds
+	int time;
+
+	PipelineItem() { num = 0; input = NULL; size = 0; output = NULL; out_size = 0; lines = 0; key = 0; cached = false; rc = 0; time = 0; }
+	~PipelineItem() { delete [] input; }
+};
+
+// Bounded blocking queue between pipeline stages
+class PipelineQueue
+{
+	std::deque<PipelineItem*> _items;
+	size_t _capacity;
+
+	// Number of producers that are still running, the queue is closed when all are done
+	int _producers;
+
+	std::mutex _lock;
+	std::condition_variable _not_empty;
+	std::condition_variable _not_full;
+
+	// Depth statistics, sampled on each push
+	size_t _max_depth;
+	long long _depth_sum;
+	int _pushes;
+
+	// Time producers waited for space and consumers waited for items (ms)
+	std::atomic<int> _push_wait;
+	std::atomic<int> _pop_wait;
+
+public:
+	PipelineQueue(size_t capacity, int producers)
+	{
+		_capacity = (capacity > 0) ? capacity : 1;
+		_producers = producers;
+
+		_max_depth = 0;
+		_depth_sum = 0;
+		_pushes = 0;
+
+		_push_wait = 0;
+		_pop_wait = 0;
+	}
+
+	// Add the item, wait while the queue is full
+	void Push(PipelineItem *item)
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+
+		if(_items.size() >= _capacity)
+		{
+			int start = Os::GetTickCount();
+
+			_not_full.wait(lock, [this] { return _items.size() < _capacity; });
+			_push_wait += Os::GetTickCount() - start;
+		}
+
+		_items.push_back(item);
+
+		if(_items.size() > _max_depth)
+			_max_depth = _items.size();
+
+		_depth_sum += _items.size();
+		_pushes++;
+
+		_not_empty.notify_one();
+	}
+
+	// Get the next item, wait while the queue is empty, NULL when all producers are done
+	PipelineItem* Pop()
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+
+		if(_items.empty() && _producers > 0)
+		{
+			int start = Os::GetTickCount();
+
+			_not_empty.wait(lock, [this] { return !_items.empty() || _producers == 0; });
+			_pop_wait += Os::GetTickCount() - start;
+		}
+
+		if(_items.empty())
+			return NULL;
+
+		PipelineItem *item = _items.front();
+		_items.pop_front();
+
+		_not_full.notify_one();
+
+		return item;
+	}
+
+	// Producer finished
+	void Done()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		if(--_producers <= 0)
+			_not_empty.notify_all();
+	}
+
+	size_t GetMaxDepth() { return _max_depth; }
+	double GetAvgDepth() { return (_pushes > 0) ? (double)_depth_sum / _pushes : 0; }
+	int GetPushWait() { return _push_wait; }
+	int GetPopWait() { return _pop_wait; }
+};
+
+// Files read by the reader threads, converted by the converter threads and written by the writer
+struct Pipeline
+{
+	std::vector<PipelineItem*> items;
+
+	// Next file to read
+	std::atomic<size_t> next;
+	int readers;
+
+	// Read files waiting for a converter, and converted files waiting for the writer
+	PipelineQueue read_queue;
+	PipelineQueue write_queue;
+
+	// Busy time of each stage summed over its threads (ms)
+	std::atomic<int> read_busy;
+	std::atomic<int> convert_busy;
+	int write_busy;
+
+	Pipeline(size_t prefetch, int readers, int converters) : read_queue(prefetch, readers), write_queue(prefetch, converters)
+	{
+		next = 0;
+		this->readers = readers;
+		read_busy = 0;
+		convert_busy = 0;
+		write_busy = 0;
+	}
+
+	~Pipeline()
+	{
+		for(std::vector<PipelineItem*>::iterator i = items.begin(); i != items.end(); i++)
+			delete *i;
+	}
+};
+
+#endif // migrationtool_pipeline_h
@@ -3,6 +3,8 @@
 #ifndef migrationtool_sqlparserexp_h
 #define migrationtool_sqlparserexp_h
 
+#include <stddef.h>
+
 // SQL dialect types
 #define SQL_ORACLE				2
 #define SQL_MYSQL				4
@@ -13,5 +15,11 @@ extern int SetParserOption(void *parser, const char *option, const char *value);
 extern int ConvertSql(void *parser, const char *input, int size, const char **output, int *out_size, int *lines);
 extern void FreeOutput(const char *output);
 extern int CreateAssessmentReport(void *parser, const char *summary);
+extern size_t GetSplPeakMemory(void *parser);
+extern void GetMemoStats(void *parser, int *statements, int *hits);
+extern int GetSequenceUsage(void *parser, int num, const char **name, const char **file, int *auto_increment);
+extern int ScanInventory(void *parser, const char *input, int size, int *lines);
+extern int CreateInventoryReport(void *parser);
+extern const char* GetInventorySummary(void *parser);
 
 #endif // migrationtool_sqlparserexp_h
@@ -13,7 +13,10 @@ SOURCES += \
     functions.cpp \
     guess.cpp \
     helpers.cpp \
+    hints.cpp \
+    inventory.cpp \
     language.cpp \
+    memo.cpp \
     oracle.cpp \
     patterns.cpp \
     post.cpp \
@@ -27,13 +30,23 @@ SOURCES += \
     token.cpp
 
 HEADERS += \
+    arena.h \
     doc.h \
     file.h \
+    inventory.h \
+    listpool.h \
     listt.h \
     listw.h \
     listwm.h \
+    memo.h \
+    partitions.h \
     report.h \
+    reportwriter.h \
+    sequences.h \
+    splstate.h \
     sqlparser.h \
     stats.h \
+    statsmap.h \
     str.h \
+    temptables.h \
     token.h
@@ -0,0 +1,135 @@
+// Arena class - Chunked bump allocator released all at once by Rewind
+
+#ifndef sqlines_arena_h
+#define sqlines_arena_h
+
+#include <stddef.h>
+
+// Default chunk size in bytes
+#define ARENA_CHUNK_SIZE		65536
+// Alignment of allocated blocks
+#define ARENA_ALIGN				16
+
+class Arena
+{
+	// Memory chunk, data follows the header
+	struct Chunk
+	{
+		size_t size;
+		Chunk *next;
+	};
+
+	// All chunks in allocation order, chunks are kept on Rewind and reused
+	Chunk *first;
+	// The chunk allocations are taken from
+	Chunk *current;
+	// Offset of free space in the current chunk
+	size_t offset;
+
+	// Bytes allocated since the last rewind, and the peak value
+	size_t used;
+	size_t peak;
+
+	// Size of chunks allocated by the arena
+	size_t chunk_size;
+
+public:
+	// Constructor
+	Arena(size_t size = ARENA_CHUNK_SIZE)
+	{
+		first = NULL;
+		current = NULL;
+		offset = 0;
+		used = 0;
+		peak = 0;
+		chunk_size = size;
+	}
+
+	// Destructor
+	~Arena()
+	{
+		Chunk *cur = first;
+		Chunk *next = NULL;
+
+		while(cur)
+		{
+			next = cur->next;
+			delete[] (char*)cur;
+			cur = next;
+		}
+	}
+
+	// Allocate a block; it is released by Rewind only
+	void* Alloc(size_t size)
+	{
+		size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+		// Find a chunk with enough space, reusing chunks kept after rewind
+		while(current == NULL || offset + size > current->size)
+		{
+			Chunk *next = (current != NULL) ? current->next : first;
+
+			if(next == NULL)
+				next = AddChunk(size);
+
+			current = next;
+			offset = 0;
+		}
+
+		char *block = (char*)current + GetHeaderSize() + offset;
+
+		offset += size;
+		used += size;
+
+		if(used > peak)
+			peak = used;
+
+		return block;
+	}
+
+	// Release all blocks at once
+	void Rewind()
+	{
+		current = NULL;
+		offset = 0;
+		used = 0;
+	}
+
+	// Get the number of bytes allocated since the last rewind
+	size_t GetSize() { return used; }
+	// Get the maximum number of bytes allocated between rewinds
+	size_t GetPeakSize() { return peak; }
+
+private:
+	// Chunk header size rounded up to keep data aligned
+	static size_t GetHeaderSize()
+	{
+		return (sizeof(Chunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	}
+
+	// Allocate a new chunk and link it to the end of the chunk list
+	Chunk* AddChunk(size_t size)
+	{
+		size_t data_size = (size > chunk_size) ? size : chunk_size;
+
+		Chunk *chunk = (Chunk*)new char[GetHeaderSize() + data_size];
+		chunk->size = data_size;
+		chunk->next = NULL;
+
+		if(first == NULL)
+			first = chunk;
+		else
+		{
+			Chunk *last = first;
+
+			while(last->next != NULL)
+				last = last->next;
+
+			last->next = chunk;
+		}
+
+		return chunk;
+	}
+};
+
+#endif // sqlines_arena_h
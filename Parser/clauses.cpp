@@ -5,7 +5,7 @@
 #include "sqlparser.h"
 
 // ALTER/CREATE SEQUENCE options
-bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_by_out, StatsSummaryItem &ssi)
+bool SqlParser::ParseSequenceOptions(OracleSequence *sequence, StatsSummaryItem &ssi)
 {
 	bool exists = false;
 
@@ -26,8 +26,8 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 
 			Token::Remove(option, start_with);
 
-            if(start_with_out != nullptr)
-				*start_with_out = start_with;
+            if(sequence != nullptr)
+				sequence->start_with = start_with;
 
 			STATS_DTL_DESC(SEQUENCE_START_WITH_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
@@ -46,8 +46,8 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 
 			Token::Remove(option, increment_by);
 
-            if(increment_by_out != nullptr)
-				*increment_by_out = increment_by;
+            if(sequence != nullptr)
+				sequence->increment_by = increment_by;
 
 			STATS_DTL_DESC(SEQUENCE_INCREMENT_BY_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
@@ -65,6 +65,9 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 
 			Token::Remove(option, value);
 
+            if(sequence != nullptr)
+				sequence->min_value = value;
+
 			STATS_DTL_DESC(SEQUENCE_MINVALUE_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
 
@@ -94,6 +97,9 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 
 			Token::Remove(option, value);
 
+            if(sequence != nullptr)
+				sequence->max_value = value;
+
 			STATS_DTL_DESC(SEQUENCE_MAXVALUE_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
 
@@ -122,6 +128,9 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 
 			Token::Remove(option, value);
 
+            if(sequence != nullptr)
+				sequence->cache = value;
+
 			STATS_DTL_DESC(SEQUENCE_CACHE_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
 
@@ -136,6 +145,9 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 		{
 			Token::Remove(option);
 
+            if(sequence != nullptr)
+				sequence->nocache = true;
+
 			STATS_DTL_DESC(SEQUENCE_NOCACHE_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
 
@@ -162,6 +174,9 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 		{
 			Token::Remove(option);
 
+            if(sequence != nullptr)
+				sequence->cycle = true;
+
 			STATS_DTL_DESC(SEQUENCE_CYCLE_DESC)
 			STATS_DTL_CONV_NO_NEED(Target(SQL_ORACLE, SQL_MARIADB_ORA))
 
@@ -171,6 +186,35 @@ bool SqlParser::ParseSequenceOptions(Token **start_with_out, Token **increment_b
 		}
 		else
 		// ORDER
+		if(TOKEN_CMP(option, "ORDER"))
+		{
+			Comment(option, option);
+
+			STATS_DTL_DESC(SEQUENCE_ORDER_DESC)
+			STATS_DTL_CONV_OK(true, STATS_CONV_LOW, SEQUENCE_ORDER_CONV, SEQUENCE_ORDER_URL)
+
+            SEQ_DTL_STATS_V("ORDER", option)
+
+			exists = true;
+		}
+		else
+		// NOORDER
+		if(TOKEN_CMP(option, "NOORDER"))
+		{
+			Token::Remove(option);
+
+			STATS_DTL_DESC(SEQUENCE_NOORDER_DESC)
+			STATS_DTL_CONV_OK(true, STATS_CONV_LOW, SEQUENCE_NOORDER_CONV, "")
+
+            SEQ_DTL_STATS_V("NOORDER", option)
+
+			exists = true;
+		}
+		else
+		{
+			PushBack(option);
+			break;
+		}
 		
 		STATS_UPDATE_STATUS
 	}
@@ -171,7 +171,7 @@ bool SqlParser::ParseTypedVariable(Token *var, Token *ref_type)
     if(rowtype != nullptr)
     {
         // Save variable
-        _spl_rowtype_vars.Add(var);
+        _spl->rowtype_vars.Add(var);
 
         Token::Remove(var, rowtype);
 
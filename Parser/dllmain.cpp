@@ -58,6 +58,81 @@ int CreateAssessmentReport(void *parser, const char *summary)
 	return sql_parser->CreateReport(summary);
 }
 
+// Get the peak memory used by procedural scope state
+size_t GetSplPeakMemory(void *parser)
+{
+	if(parser == NULL)
+		return 0;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->GetSplPeakMemory();
+}
+
+// Get the number of statements looked up in the statement memo and reused
+void GetMemoStats(void *parser, int *statements, int *hits)
+{
+	if(parser == NULL || statements == NULL || hits == NULL)
+		return;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	sql_parser->GetMemoStats(statements, hits);
+}
+
+// Get a sequence converted to AUTO_INCREMENT or referenced in the converted files, 0 if there are no more sequences
+int GetSequenceUsage(void *parser, int num, const char **name, const char **file, int *auto_increment)
+{
+	if(parser == NULL || name == NULL || file == NULL || auto_increment == NULL)
+		return 0;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	SequenceUsage *usage = sql_parser->GetSequenceUsage((size_t)num);
+
+	if(usage == NULL)
+		return 0;
+
+	*name = usage->name.c_str();
+	*file = usage->file.c_str();
+	*auto_increment = usage->auto_increment ? 1 : 0;
+
+	return 1;
+}
+
+// Scan the input for objects without conversion
+int ScanInventory(void *parser, const char *input, int size, int *lines)
+{
+	if(parser == NULL)
+		return -1;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->ScanInventory(input, size, lines);
+}
+
+// Create inventory file
+int CreateInventoryReport(void *parser)
+{
+	if(parser == NULL)
+		return -1;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->CreateInventory();
+}
+
+// Get the number of found objects by type
+const char* GetInventorySummary(void *parser)
+{
+	if(parser == NULL)
+		return "";
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->GetInventorySummary();
+}
+
 // Free allocated result
 void FreeOutput(const char *output)
 {
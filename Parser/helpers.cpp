@@ -35,6 +35,13 @@ Book* SqlParser::Bookmark(int type, Token *name, Token *book)
 
 	_bookmarks.Add(bookmark);
 
+	// CREATE TABLE definitions are looked up by name
+    if(type == BOOK_CT_START)
+		_table_definitions[GetNameKey(name)]++;
+	else
+    if(type == BOOK_CTC_ALL_END)
+		_table_end_books[name] = bookmark;
+
 	return bookmark;
 }
 
@@ -48,6 +55,13 @@ Book* SqlParser::Bookmark(int type, Token *name, Token *name2, Token *book)
 
 	_bookmarks.Add(bookmark);
 
+	// Column definitions are looked up by table and column
+    if(type == BOOK_CTC_END)
+	{
+		_column_books[GetNameKey(name, name2)] = bookmark;
+		_table_column_books[name].push_back(bookmark);
+	}
+
 	return bookmark;
 }
 
@@ -98,6 +112,141 @@ Book* SqlParser::GetBookmark2(int type, Token *nm)
 	return book;
 }
 
+// Get the column definition in the last CREATE TABLE for the table
+Book* SqlParser::GetColumnBookmark(Token *table, Token *column)
+{
+    if(table == nullptr || column == nullptr)
+		return nullptr;
+
+	std::unordered_map<std::string, Book*>::iterator i = _column_books.find(GetNameKey(table, column));
+
+	return (i != _column_books.end()) ? i->second : nullptr;
+}
+
+// Get the case-insensitive lookup key of the name
+std::string SqlParser::GetNameKey(const char *str, size_t len)
+{
+	std::string key;
+
+    if(str != nullptr)
+		key.assign(str, len);
+
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+	return key;
+}
+
+// Get the lookup key of the name, or name.name2
+std::string SqlParser::GetNameKey(Token *name, Token *name2)
+{
+	std::string key = (name != nullptr) ? GetNameKey(name->str, name->len) : std::string();
+
+    if(name2 != nullptr)
+		key += "." + GetNameKey(name2->str, name2->len);
+
+	return key;
+}
+
+// Get the lookup key of the sequence in seq.NEXTVAL or seq.CURRVAL reference
+std::string SqlParser::GetSequenceKey(Token *ref)
+{
+    if(IsSequenceReference(ref, nullptr) == false)
+		return std::string();
+
+	return GetNameKey(ref->str, ref->len - 8);
+}
+
+// Get primary and unique keys of the table defined in CREATE TABLE
+bool SqlParser::GetTableKeys(Token *table_name, std::vector<std::vector<Token*> > &keys)
+{
+    if(table_name == nullptr)
+		return false;
+
+	// End of the column definitions of the current table
+	std::unordered_map<Token*, Book*>::iterator i = _table_end_books.find(table_name);
+	Book *col_end = (i != _table_end_books.end()) ? i->second : nullptr;
+
+	// CREATE TABLE AS SELECT does not define keys
+    if(col_end == nullptr)
+		return false;
+
+	int level = 0;
+
+	// First token of the current column or constraint definition
+	Token *item = nullptr;
+	bool item_start = false;
+
+	for(Token *token = table_name->next; token != nullptr && token != col_end->book; token = token->next)
+	{
+        if(token->IsBlank() == true || token->type == TOKEN_COMMENT)
+			continue;
+
+        if(token->Compare('(', L'(') == true)
+		{
+			level++;
+
+            if(level == 1)
+				item_start = true;
+
+			continue;
+		}
+
+        if(token->Compare(')', L')') == true)
+		{
+			level--;
+			continue;
+		}
+
+        if(level != 1)
+			continue;
+
+        if(token->Compare(',', L',') == true)
+		{
+			item_start = true;
+			continue;
+		}
+
+        if(item_start == true)
+		{
+			item = token;
+			item_start = false;
+		}
+
+		bool primary = TOKEN_CMP(token, "PRIMARY");
+
+        if(primary == false && TOKEN_CMP(token, "UNIQUE") == false)
+			continue;
+
+		std::vector<Token*> key;
+
+		Token *next = Token::SkipSpaces(token->next);
+
+        if(primary == true && TOKEN_CMP(next, "KEY"))
+			next = Token::SkipSpaces(next->next);
+
+		// Constraint with the column list
+        if(TOKEN_CMPC(next, '('))
+		{
+			for(token = next->next; token != nullptr && TOKEN_CMPC(token, ')') == false; token = token->next)
+			{
+                if(token->IsBlank() == false && token->type != TOKEN_COMMENT && TOKEN_CMPC(token, ',') == false)
+					key.push_back(token);
+			}
+
+            if(token == nullptr)
+				break;
+		}
+		else
+		// Column constraint
+        if(item != nullptr && !TOKEN_CMP(item, "CONSTRAINT") && !TOKEN_CMP(item, "PRIMARY") && !TOKEN_CMP(item, "UNIQUE"))
+			key.push_back(item);
+
+		keys.push_back(key);
+	}
+
+	return true;
+}
+
 // Return first not NULL
 Token* SqlParser::Nvl(Token *first, Token *second, Token *third, Token *fourth)
 {
@@ -917,7 +1066,7 @@ void SqlParser::PrefixPackageName(TokenStr &ident)
 // Replace PL/SQL records with variable list
 void SqlParser::DiscloseRecordVariables(Token *format)
 {
-	ListwItem *item = _spl_rowtype_vars.GetFirst();
+	ListwItem *item = _spl->rowtype_vars.GetFirst();
 
 	// Convert record declaration to variable list declaration
     while(item != nullptr)
@@ -925,7 +1074,7 @@ void SqlParser::DiscloseRecordVariables(Token *format)
 		Token *decl_rec = (Token*)item->value;
 		bool found = false;
 
-		ListwmItem *fields = _spl_rowtype_fields.GetFirst();
+		ListwmItem *fields = _spl->rowtype_fields.GetFirst();
 
         while(fields != nullptr)
 		{
@@ -951,7 +1100,7 @@ void SqlParser::DiscloseRecordVariables(Token *format)
 		item = item->next;
 	}
 
-	item = _spl_rowtype_fetches.GetFirst();
+	item = _spl->rowtype_fetches.GetFirst();
 
 	// Convert FETCH INTO rec to FETCH INTO rec_field1, rec_field2 etc.
     while(item != nullptr)
@@ -959,7 +1108,7 @@ void SqlParser::DiscloseRecordVariables(Token *format)
 		Token *fetch_rec = (Token*)item->value;
 		bool found = false;
 
-		ListwmItem *fields = _spl_rowtype_fields.GetFirst();
+		ListwmItem *fields = _spl->rowtype_fields.GetFirst();
 
         while(fields != nullptr)
 		{
@@ -990,7 +1139,7 @@ void SqlParser::DiscloseRecordVariables(Token *format)
 // Add declarations for implicit record fields (for cursor loops)
 void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 {
-	ListwmItem *item = _spl_implicit_rowtype_fields.GetFirst();
+	ListwmItem *item = _spl->implicit_rowtype_fields.GetFirst();
 
 	Token *append = GetDeclarationAppend();
 	Token *fmt = Nvl(_declare_format, format);
@@ -1014,7 +1163,7 @@ void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 		APPEND_FMT(append, "\nDECLARE ", fmt);
 		AppendCopy(append, var);
 
-		ListwmItem *sel_item = _spl_declared_cursors_select_exp.GetFirst();
+		ListwmItem *sel_item = _spl->declared_cursors_select_exp.GetFirst();
         const char *datatype_meta = nullptr;
 
 		// Try to define the data type from SELECT list expressions
@@ -1063,7 +1212,7 @@ void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 		item = item->next;
 	}
 
-	item = _spl_implicit_rowtype_fetches.GetFirst();
+	item = _spl->implicit_rowtype_fetches.GetFirst();
 
 	// Add column list to all generated fetch statements
     while(item != nullptr)
@@ -1072,7 +1221,7 @@ void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 		Token *fetch_stmt = (Token*)item->value2;
 		Token *format = (Token*)item->value3;
 
-		ListwmItem *col_item = _spl_implicit_rowtype_fields.GetFirst();
+		ListwmItem *col_item = _spl->implicit_rowtype_fields.GetFirst();
 
 		TokenStr into_cols;
 		int cnt = 0;
@@ -1102,7 +1251,7 @@ void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 		item = item->next;
 	}
 		
-	item = _spl_declared_cursors_select_first_exp.GetFirst();
+	item = _spl->declared_cursors_select_first_exp.GetFirst();
 
 	// Add column list to cursor declaration that use SELECT * FROM instead of explicit column list
     while(item != nullptr)
@@ -1116,7 +1265,7 @@ void SqlParser::DiscloseImplicitRecordVariables(Token *format)
 			continue;
 		}
 		
-		ListwmItem *col_item = _spl_implicit_rowtype_fields.GetFirst();
+		ListwmItem *col_item = _spl->implicit_rowtype_fields.GetFirst();
 
 		TokenStr cursor_cols;
 		int cnt = 0;
@@ -1301,7 +1450,7 @@ ListwmItem* SqlParser::Find(ListWM &list, Token *what, Token *what2)
 // Get position to append new generated declarations
 Token* SqlParser::GetDeclarationAppend()
 {
-	Token *append = _spl_last_declare;
+	Token *append = _spl->last_declare;
 
 	if(!TOKEN_CMPC(append, ';'))
 	{
@@ -1323,7 +1472,7 @@ Token* SqlParser::GetDeclarationAppend()
 	}
 
     if(append == nullptr)
-		append = _spl_last_declare;
+		append = _spl->last_declare;
 
 	return append;
 }
@@ -1332,7 +1481,7 @@ Token* SqlParser::GetDeclarationAppend()
 void SqlParser::AddGeneratedVariables()
 {
 	// Add not hound handler that must go after all variables and cursors; and initialize not_found variable before second and subsequent OPEN cursors
-//    if(_spl_need_not_found_handler)
+//    if(_spl->need_not_found_handler)
 //	{
 //		MySQLAddNotFoundHandler();
 //		MySQLInitNotFoundBeforeOpen();
@@ -1341,109 +1490,29 @@ void SqlParser::AddGeneratedVariables()
 	Token *format_indent = _declare_format;
 
 	// Oracle uses DECLARE block with the keyword at the beginning so use the variable name to define the indention
-		format_indent = _spl_last_outer_declare_varname;
+		format_indent = _spl->last_outer_declare_varname;
 
-	Token *format = Nvl(_declare_format, _spl_outer_begin, _spl_outer_as);
+	Token *format = Nvl(_declare_format, _spl->outer_begin, _spl->outer_as);
 
 }
 
 // Clear all procedural lists, statuses
 void SqlParser::ClearSplScope()
 {
-	_spl_scope = 0;
-    _spl_name = nullptr;
-    _spl_start = nullptr;
+	// Release the state of the previous procedure; list items are released by the arena rewind below
+    if(_spl != nullptr)
+		_spl->~SplState();
+
+	_spl_arena.Rewind();
+
+	// Allocate the initial state from the rewound arena
+	_spl = new (_spl_arena.Alloc(sizeof(SplState))) SplState(&_spl_arena);
 
     _declare_format = nullptr;
-	
-	// Delete variable and parameters
-	_spl_variables.DeleteAll();
-	_spl_parameters.DeleteAll();
 
 	// Clear statements clause scope
 	_scope.DeleteAll();
 
-    _spl_outer_begin = nullptr;
-    _spl_outer_as = nullptr;
-    _spl_begin_blocks.DeleteAll();
-    _spl_last_declare = nullptr;
-    _spl_first_non_declare = nullptr;
-    _spl_last_outer_declare_var = nullptr;
-    _spl_last_outer_declare_varname = nullptr;
-    _spl_last_stmt = nullptr;
-
-    _spl_new_correlation_name = nullptr;
-    _spl_old_correlation_name = nullptr;
-
-	_spl_result_sets = 0;
-	_spl_result_set_cursors.DeleteAll();
-	_spl_result_set_generated_cursors.DeleteAll();
-	
-	_spl_delimiter_set = false;
-	_spl_user_exceptions.DeleteAll();
-    _spl_outer_label = nullptr;
-	_spl_cursor_params.DeleteAll();
-	_spl_cursor_vars.DeleteAll();
-	_spl_declared_cursors.DeleteAll();
-	_spl_declared_cursors_using_vars.DeleteAll();
-	_spl_declared_cursors_stmts.DeleteAll();
-	_spl_updatable_current_of_cursors.DeleteAll();
-	_spl_declared_cursors_select.DeleteAll();
-	_spl_declared_cursors_select_first_exp.DeleteAll();
-	_spl_declared_cursors_select_exp.DeleteAll();
-
-    _spl_current_declaring_cursor = nullptr;
-	_spl_current_declaring_cursor_uses_vars = false;
-
-	_spl_rowtype_vars.DeleteAll();
-	_spl_rowtype_fields.DeleteAll();
-	_spl_rowtype_fetches.DeleteAll();
-
-	_spl_implicit_rowtype_vars.DeleteAll();
-	_spl_implicit_rowtype_fields.DeleteAll();
-	_spl_implicit_rowtype_fetches.DeleteAll();
-
-	_spl_declared_local_tables.DeleteAll();
-	_spl_created_session_tables.DeleteAll();
-
-	_spl_tr_new_columns.DeleteAll();
-	_spl_tr_old_columns.DeleteAll();
-    _spl_param_close = nullptr;
-
-    _spl_returns = nullptr;
-	_spl_returning_out_names.DeleteAll();
-	_spl_return_with_resume = 0;
-	_spl_return_int = false;
-
-	_spl_foreach_num = 0;
-	_spl_moved_if_select = 0;
-	_spl_return_num = 0;
-
-    _spl_last_insert_table_name = nullptr;
-    _spl_last_open_cursor_name = nullptr;
-    _spl_last_fetch_cursor_name = nullptr;
-	_spl_open_cursors.DeleteAll();
-
-	_spl_prepared_stmts.DeleteAll();
-	_spl_prepared_stmts_cursors.DeleteAll();
-	_spl_prepared_stmts_cursors_with_return.DeleteAll();
-
-	_spl_implicit_record_fields.DeleteAll();
-
-	_spl_rs_locator_procedures.DeleteAll();
-
-    _spl_loops.DeleteAll();
-    _spl_loop_labels = 0;
-
-	_spl_sp_calls.DeleteAll();
-
-	_spl_proc_to_func = false;
-	_spl_func_to_proc = false;
-    _spl_not_found_handler = false;
-	_spl_need_not_found_handler = false;
-
-	_spl_monday_1 = false;   // means unknown from context
-
 	_exp_select = 0;
 }
 
@@ -1518,15 +1587,15 @@ void SqlParser::GenerateResultSetCursorName(TokenStr *name)
 	name->Append("cur", L"cur", 3);
 
 	// Not incremented yet - cur, cur2, cur3, ...
-	if(_spl_result_sets > 0)
-		name->Append(_spl_result_sets + 1);
+	if(_spl->result_sets > 0)
+		name->Append(_spl->result_sets + 1);
 }
 
 // Add FOR SELECT for WITH RETURN cursors
 bool SqlParser::OpenWithReturnCursor(Token *name)
 {
 	// No WITH RETURN cursors
-    if(_spl_result_sets == 0 || name == nullptr)
+    if(_spl->result_sets == 0 || name == nullptr)
 		return false;
 
 	bool exists = false;
@@ -0,0 +1,399 @@
+// SQLParser for optimizer hints
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "sqlparser.h"
+#include "str.h"
+
+// Keywords that end the table reference, and cannot be its alias
+static const char *g_hint_table_ref_end[] = { "CONNECT", "CROSS", "FETCH", "FOR", "FULL", "GROUP", "HAVING", "INNER",
+	"INTERSECT", "JOIN", "LEFT", "LOG", "MINUS", "MODEL", "NATURAL", "OFFSET", "ON", "ORDER", "OUTER", "PARTITION",
+	"RETURN", "RETURNING", "RIGHT", "SAMPLE", "SET", "START", "UNION", "USING", "WHERE", "WITH", nullptr };
+
+// Convert Oracle optimizer hints in /*+ */ comment following SELECT, UPDATE or DELETE keyword
+void SqlParser::OptimizerHints(Token *stmt, Token *comment)
+{
+    if(stmt == nullptr || comment == nullptr || comment->len < 5)
+		return;
+
+	// Table name and alias tokens of the query block, and index hints added to them
+	std::vector<std::pair<Token*, Token*> > tables;
+	GetHintTableReferences(stmt, tables);
+
+	std::vector<std::string> index_hints(tables.size());
+
+	// MySQL optimizer hints, and Oracle hints without equivalent kept in a regular comment
+	std::string hints;
+	std::string unsupported;
+
+	const char *cur = comment->str + 3;
+	const char *end = comment->str + comment->len - 2;
+
+	while(cur < end)
+	{
+        if(Str::IsSpace(*cur) || *cur == ',')
+		{
+			cur++;
+			continue;
+		}
+
+		const char *start = cur;
+
+		while(cur < end && (isalnum((unsigned char)*cur) || *cur == '_' || *cur == '$' || *cur == '#'))
+			cur++;
+
+		// Not a hint, the rest of the comment is kept as is
+        if(cur == start)
+		{
+			std::string rest(start, (size_t)(end - start));
+			Str::TrimTrailingSpaces(rest);
+
+            if(!unsupported.empty())
+				unsupported += " ";
+
+			unsupported += rest;
+			break;
+		}
+
+		std::string name(start, (size_t)(cur - start));
+		std::vector<std::string> args;
+
+		// Query block references and column lists are not converted
+		bool complex = false;
+
+		const char *open = cur;
+
+		while(open < end && Str::IsSpace(*open))
+			open++;
+
+		// Arguments are separated by spaces or commas
+        if(open < end && *open == '(')
+		{
+			int level = 0;
+
+			for(cur = open + 1; cur < end; cur++)
+			{
+                if(*cur == '(')
+				{
+					level++;
+					complex = true;
+				}
+				else
+                if(*cur == ')' && level-- == 0)
+				{
+					cur++;
+					break;
+				}
+				else
+                if(*cur == '@')
+					complex = true;
+				else
+                if(level == 0 && !Str::IsSpace(*cur) && *cur != ',')
+				{
+					const char *arg = cur;
+
+					while(cur + 1 < end && !Str::IsSpace(cur[1]) && cur[1] != ',' && cur[1] != '(' && cur[1] != ')' && cur[1] != '@')
+						cur++;
+
+					args.push_back(std::string(arg, (size_t)(cur - arg + 1)));
+				}
+			}
+		}
+
+		std::string value = name;
+		std::string target;
+
+		const char *kind = complex ? nullptr : OptimizerHint(stmt, name, args, tables, index_hints, target);
+
+        if(kind != nullptr)
+		{
+            if(!target.empty())
+			{
+                if(!hints.empty())
+					hints += " ";
+
+				hints += target;
+			}
+
+			value += " hint converted to ";
+			value += kind;
+		}
+		else
+		{
+			std::string text(start, (size_t)(cur - start));
+
+            if(!unsupported.empty())
+				unsupported += " ";
+
+			unsupported += text;
+			value += " hint not converted";
+		}
+
+        if(_stats != nullptr)
+		{
+			StatsSummaryItem ssi(kind != nullptr ? STATS_CONV_OK : STATS_CONV_WARN);
+			_stats->Statements(value.c_str(), &ssi, stmt, comment);
+		}
+	}
+
+	// Index hints follow the table reference, and precede tokens already appended to it
+	for(size_t i = 0; i < tables.size(); i++)
+	{
+        if(!index_hints[i].empty())
+			AppendFirstNoFormat(Nvl(tables[i].second, tables[i].first), index_hints[i].c_str(), nullptr, index_hints[i].length());
+	}
+
+	std::string text;
+
+    if(!hints.empty())
+		text = "/*+ " + hints + " */";
+
+    if(!unsupported.empty())
+	{
+        if(!text.empty())
+			text += " ";
+
+		text += "/* " + unsupported + " */";
+	}
+
+    if(text.empty())
+		Token::Remove(comment);
+	else
+		Token::ChangeNoFormat(comment, text.c_str(), nullptr, text.length());
+}
+
+// Convert a single Oracle hint, return the kind of MySQL hint or NULL if there is no equivalent
+const char* SqlParser::OptimizerHint(Token *stmt, std::string &name, std::vector<std::string> &args,
+	std::vector<std::pair<Token*, Token*> > &tables, std::vector<std::string> &index_hints, std::string &target)
+{
+	const char *hint = name.c_str();
+
+	// Hints without arguments
+    if(args.empty())
+	{
+        if(_stricmp(hint, "ORDERED") == 0)
+		{
+			target = "JOIN_FIXED_ORDER()";
+			return "JOIN_FIXED_ORDER";
+		}
+
+		return nullptr;
+	}
+
+	std::string list = args[0];
+
+	for(size_t i = 1; i < args.size(); i++)
+		list += ", " + args[i];
+
+	// Index of the table reference referred by the hint, only UPDATE and SELECT allow index hints after the table
+	int table = -1;
+
+    if(!TOKEN_CMP(stmt, "DELETE"))
+	{
+		for(size_t i = 0; i < tables.size() && table == -1; i++)
+		{
+			Token *ref = Nvl(tables[i].second, tables[i].first);
+			const char *dot = nullptr;
+
+			// Table referenced by name is compared without schema
+            if(tables[i].second == nullptr)
+			{
+				for(size_t j = 0; j < ref->len; j++)
+				{
+                    if(ref->str[j] == '.')
+						dot = ref->str + j;
+				}
+			}
+
+			const char *ref_str = (dot != nullptr) ? dot + 1 : ref->str;
+			size_t ref_len = ref->len - (size_t)(ref_str - ref->str);
+
+            if(args[0].length() == ref_len && _strnicmp(args[0].c_str(), ref_str, ref_len) == 0)
+				table = (int)i;
+		}
+	}
+
+	bool index_list = (args.size() > 1);
+
+	std::string indexes;
+
+	for(size_t i = 1; i < args.size(); i++)
+	{
+        if(i > 1)
+			indexes += ", ";
+
+		indexes += args[i];
+	}
+
+	// INDEX(t idx ...) and NO_INDEX(t idx ...)
+    if(_stricmp(hint, "INDEX") == 0 || _stricmp(hint, "INDEX_ASC") == 0 || _stricmp(hint, "INDEX_DESC") == 0 ||
+		_stricmp(hint, "INDEX_RS") == 0 || _stricmp(hint, "INDEX_RS_ASC") == 0 || _stricmp(hint, "INDEX_RS_DESC") == 0)
+	{
+        if(table != -1 && index_list)
+		{
+			index_hints[table] += " FORCE INDEX (" + indexes + ")";
+			return "FORCE INDEX";
+		}
+
+		target = "INDEX(" + args[0] + (index_list ? " " + indexes : "") + ")";
+		return "INDEX";
+	}
+	else
+    if(_stricmp(hint, "NO_INDEX") == 0)
+	{
+        if(table != -1 && index_list)
+		{
+			index_hints[table] += " IGNORE INDEX (" + indexes + ")";
+			return "IGNORE INDEX";
+		}
+
+		target = "NO_INDEX(" + args[0] + (index_list ? " " + indexes : "") + ")";
+		return "NO_INDEX";
+	}
+	else
+	// Full table scan when no index is used
+    if(_stricmp(hint, "FULL") == 0 && args.size() == 1)
+	{
+		target = "NO_INDEX(" + args[0] + ")";
+		return "NO_INDEX";
+	}
+	else
+    if(_stricmp(hint, "INDEX_SS") == 0 || _stricmp(hint, "INDEX_SS_ASC") == 0 || _stricmp(hint, "INDEX_SS_DESC") == 0)
+	{
+		target = "SKIP_SCAN(" + args[0] + (index_list ? " " + indexes : "") + ")";
+		return "SKIP_SCAN";
+	}
+	else
+    if(_stricmp(hint, "NO_INDEX_SS") == 0)
+	{
+		target = "NO_SKIP_SCAN(" + args[0] + (index_list ? " " + indexes : "") + ")";
+		return "NO_SKIP_SCAN";
+	}
+	else
+    if(_stricmp(hint, "INDEX_COMBINE") == 0)
+	{
+		target = "INDEX_MERGE(" + args[0] + (index_list ? " " + indexes : "") + ")";
+		return "INDEX_MERGE";
+	}
+	else
+	// LEADING specifies the first tables of the join order
+    if(_stricmp(hint, "LEADING") == 0)
+	{
+		target = "JOIN_PREFIX(" + list + ")";
+		return "JOIN_PREFIX";
+	}
+	else
+	// Block nested loop hints select hash joins in MySQL 8.0.20 and later
+    if(_stricmp(hint, "USE_HASH") == 0 || _stricmp(hint, "NO_USE_NL") == 0)
+	{
+		target = "BNL(" + list + ")";
+		return "BNL";
+	}
+	else
+    if(_stricmp(hint, "USE_NL") == 0 || _stricmp(hint, "NO_USE_HASH") == 0)
+	{
+		target = "NO_BNL(" + list + ")";
+		return "NO_BNL";
+	}
+	else
+    if(_stricmp(hint, "MERGE") == 0 || _stricmp(hint, "NO_MERGE") == 0)
+	{
+		target = name + "(" + list + ")";
+		return (_stricmp(hint, "MERGE") == 0) ? "MERGE" : "NO_MERGE";
+	}
+
+	return nullptr;
+}
+
+// Get table references of the query block, table name and alias tokens
+void SqlParser::GetHintTableReferences(Token *stmt, std::vector<std::pair<Token*, Token*> > &tables)
+{
+	bool select = TOKEN_CMP(stmt, "SELECT");
+
+	// UPDATE and DELETE [FROM] are followed by the table reference, SELECT list is followed by FROM
+	bool from = !select;
+	bool expected = !select;
+
+	int level = 0;
+
+	for(Token *token = GetNextHintToken(stmt); token != nullptr; token = GetNextHintToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+		{
+			level++;
+			expected = false;
+			continue;
+		}
+		else
+        if(TOKEN_CMPC(token, ')'))
+		{
+            if(--level < 0)
+				break;
+
+			continue;
+		}
+
+        if(level > 0)
+			continue;
+
+        if(TOKEN_CMPC(token, ';') || TOKEN_CMP(token, "WHERE") || TOKEN_CMP(token, "UNION") || TOKEN_CMP(token, "INTERSECT") ||
+			TOKEN_CMP(token, "MINUS"))
+			break;
+
+        if(from == false)
+		{
+            if(TOKEN_CMP(token, "FROM"))
+				from = expected = true;
+
+			continue;
+		}
+
+        if(TOKEN_CMPC(token, ',') || TOKEN_CMP(token, "JOIN"))
+		{
+            if(select == false)
+				break;
+
+			expected = true;
+			continue;
+		}
+
+        if(expected == false || (token->type != TOKEN_WORD && token->type != TOKEN_IDENT && token->type != TOKEN_KEYWORD))
+			continue;
+
+		// DELETE FROM table
+        if(select == false && tables.empty() && TOKEN_CMP(stmt, "DELETE") && TOKEN_CMP(token, "FROM"))
+			continue;
+
+		Token *alias = GetNextHintToken(token);
+
+        if(alias != nullptr && (alias->type == TOKEN_WORD || alias->type == TOKEN_IDENT))
+		{
+			for(int i = 0; g_hint_table_ref_end[i] != nullptr && alias != nullptr; i++)
+			{
+                if(Token::Compare(alias, g_hint_table_ref_end[i], nullptr, strlen(g_hint_table_ref_end[i])))
+					alias = nullptr;
+			}
+		}
+		else
+			alias = nullptr;
+
+		tables.push_back(std::pair<Token*, Token*>(token, alias));
+
+        if(alias != nullptr)
+			token = alias;
+
+		expected = false;
+	}
+}
+
+// Get the next token skipping blanks, comments, generated and removed tokens
+Token* SqlParser::GetNextHintToken(Token *token)
+{
+	Token *next = GetNextPatternToken(token);
+
+	while(next != nullptr && next->IsRemoved())
+		next = GetNextPatternToken(next);
+
+	return next;
+}
@@ -0,0 +1,597 @@
+// Inventory class - Lexer-only scan of object headers and block extents without conversion
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "inventory.h"
+#include "str.h"
+
+// Object type names by INVENTORY_* value
+static const char *g_inventory_types[] = { "TABLE", "VIEW", "MATERIALIZED VIEW", "SEQUENCE", "INDEX", "SYNONYM", "PROCEDURE",
+	"FUNCTION", "TRIGGER", "PACKAGE", "PACKAGE BODY", "TYPE", "TYPE BODY" };
+
+// Words that can follow CREATE, modifiers go first
+static const char *g_inventory_create[] = { "OR", "REPLACE", "EDITIONABLE", "NONEDITIONABLE", "EDITIONING", "GLOBAL", "PRIVATE",
+	"TEMPORARY", "SHARED", "FORCE", "NOFORCE", "NO", "UNIQUE", "BITMAP", "MULTIVALUE", "PUBLIC",
+	"TABLE", "VIEW", "MATERIALIZED", "SEQUENCE", "INDEX", "SYNONYM", "PROCEDURE", "FUNCTION", "TRIGGER", "PACKAGE", "TYPE", NULL };
+
+#define INVENTORY_CREATE_MODIFIERS	16
+
+// Object type by the word in g_inventory_create following the modifiers
+static const int g_inventory_create_types[] = { INVENTORY_TABLE, INVENTORY_VIEW, INVENTORY_MVIEW, INVENTORY_SEQUENCE, INVENTORY_INDEX,
+	INVENTORY_SYNONYM, INVENTORY_PROCEDURE, INVENTORY_FUNCTION, INVENTORY_TRIGGER, INVENTORY_PACKAGE, INVENTORY_TYPE };
+
+// Words starting a statement that are handled by the scan
+static const char *g_inventory_start[] = { "CREATE", "DECLARE", "BEGIN",
+	// SQL*Plus commands that are terminated by the end of line
+	"PROMPT", "SET", "SPOOL", "REM", "REMARK", "EXIT", "QUIT", "WHENEVER", "CONNECT", "DEFINE", "UNDEFINE", "SHOW", "EXEC",
+	"EXECUTE", "COLUMN", "PAUSE", "ACCEPT", NULL };
+
+#define INVENTORY_START_BLOCKS		3
+
+// Check if the character can be a part of an unquoted identifier
+#define INVENTORY_IDENT_CHAR(c)		(isalnum((unsigned char)(c)) || (c) == '_' || (c) == '$' || (c) == '#')
+
+// Constructor
+Inventory::Inventory(const char *path)
+{
+	if(path != NULL && *path != '\x0')
+		_path = path;
+	else
+		_path = SQLINES_INVENTORY_FILE;
+
+	_bytes = 0;
+	_lines = 0;
+
+	memset(_counts, 0, sizeof(_counts));
+	memset(_special, 0, sizeof(_special));
+
+	_special[(unsigned char)'\n'] = true;
+	_special[(unsigned char)'\''] = true;
+	_special[(unsigned char)'"'] = true;
+	_special[(unsigned char)'-'] = true;
+	_special[(unsigned char)'/'] = true;
+	_special[(unsigned char)';'] = true;
+}
+
+// Scan the input and add found objects
+int Inventory::Scan(const char *input, int size, int *lines)
+{
+	if(input == NULL)
+		return -1;
+
+	// Objects can be scanned without the source file set
+	if(_files.empty())
+		_files.push_back("");
+
+	const char *cur = input;
+	const char *end = input + size;
+
+	int line = 1;
+	int count = 0;
+
+	while(cur < end)
+	{
+		cur = SkipSpaces(cur, end, &line);
+
+		if(cur >= end)
+			break;
+
+		// Script command
+		if(*cur == '@')
+		{
+			cur = SkipLine(cur, end);
+			continue;
+		}
+
+		int start_line = line;
+		int type = -1;
+		bool plsql = false;
+
+		const char *next = cur;
+		int word = GetWord(cur, end, g_inventory_start, &next);
+
+		if(word == 0)
+			type = GetObjectType(next, end, &next, &line, &plsql);
+		else
+		// Anonymous block
+		if(word > 0 && word < INVENTORY_START_BLOCKS)
+			plsql = true;
+		else
+		if(word >= INVENTORY_START_BLOCKS)
+		{
+			cur = SkipLine(next, end);
+			continue;
+		}
+
+		InventoryItem *item = NULL;
+
+		if(type != -1)
+		{
+			_items.push_back(InventoryItem());
+
+			item = &_items.back();
+			item->type = (short)type;
+			item->file = (int)_files.size() - 1;
+			item->start_line = start_line;
+
+			next = SkipSpaces(next, end, &line);
+			next = GetIdent(next, end, item->name);
+		}
+
+		int last_line = line;
+
+		cur = SkipStatement(next, end, plsql, &line, &last_line);
+
+		if(item != NULL)
+		{
+			item->end_line = last_line;
+
+			_counts[type]++;
+			count++;
+		}
+	}
+
+	// Do not count the empty line after the terminating new line
+	if(size > 0 && input[size - 1] == '\n')
+		line--;
+
+	_bytes += size;
+	_lines += line;
+
+	if(lines != NULL)
+		*lines = line;
+
+	return count;
+}
+
+// Recognize the object type after CREATE and its modifiers, -1 if it is not an object
+int Inventory::GetObjectType(const char *cur, const char *end, const char **next, int *line, bool *plsql)
+{
+	int word = -1;
+
+	// Skip OR REPLACE, GLOBAL TEMPORARY and other modifiers
+	do
+	{
+		cur = SkipSpaces(cur, end, line);
+		word = GetWord(cur, end, g_inventory_create, &cur);
+
+	} while(word != -1 && word < INVENTORY_CREATE_MODIFIERS);
+
+	*next = cur;
+
+	if(word == -1)
+		return -1;
+
+	int type = g_inventory_create_types[word - INVENTORY_CREATE_MODIFIERS];
+
+	if(type == INVENTORY_MVIEW)
+	{
+		const char *view = SkipSpaces(cur, end, line);
+
+		if(!IsWord(view, end, "VIEW"))
+			return -1;
+
+		*next = view + 4;
+	}
+	else
+	// PACKAGE [BODY] and TYPE [BODY] are PL/SQL blocks
+	if(type == INVENTORY_PACKAGE || type == INVENTORY_TYPE)
+	{
+		const char *body = SkipSpaces(cur, end, line);
+
+		if(IsWord(body, end, "BODY"))
+		{
+			type = (type == INVENTORY_PACKAGE) ? INVENTORY_PACKAGE_BODY : INVENTORY_TYPE_BODY;
+			*next = body + 4;
+		}
+	}
+
+	if(type >= INVENTORY_PROCEDURE)
+		*plsql = true;
+
+	return type;
+}
+
+// Skip spaces and comments, count new lines
+const char* Inventory::SkipSpaces(const char *cur, const char *end, int *line)
+{
+	while(cur < end)
+	{
+		if(*cur == '\n')
+			(*line)++;
+		else
+		// Single line comment
+		if(*cur == '-' && cur + 1 < end && cur[1] == '-')
+		{
+			cur = SkipLine(cur, end);
+			continue;
+		}
+		else
+		// Multi-line comment
+		if(*cur == '/' && cur + 1 < end && cur[1] == '*')
+		{
+			cur += 2;
+
+			while(cur < end && !(*cur == '*' && cur + 1 < end && cur[1] == '/'))
+			{
+				if(*cur == '\n')
+					(*line)++;
+
+				cur++;
+			}
+
+			cur = (cur < end) ? cur + 2 : end;
+			continue;
+		}
+		else
+		// SQL*Plus / executing the previous statement, or a new line
+		if(*cur != ' ' && *cur != '\t' && *cur != '\r' && *cur != '/')
+			break;
+
+		cur++;
+	}
+
+	return cur;
+}
+
+// Skip to the end of statement, PL/SQL blocks end with / line
+const char* Inventory::SkipStatement(const char *cur, const char *end, bool plsql, int *line, int *last_line)
+{
+	const char *start = cur;
+
+	// Line and position after the last ; in PL/SQL block
+	int semicolon_line = *line;
+	const char *semicolon_end = NULL;
+
+	while(cur < end)
+	{
+		// Skip characters that cannot change the state
+		while(cur < end && !_special[(unsigned char)*cur])
+			cur++;
+
+		if(cur >= end)
+			break;
+
+		char c = *cur;
+
+		if(c == '\n')
+		{
+			(*line)++;
+			cur++;
+
+			const char *first = cur;
+
+			while(first < end && (*first == ' ' || *first == '\t' || *first == '\r'))
+				first++;
+
+			// Line containing / only terminates the statement
+			if(first < end && *first == '/')
+			{
+				const char *tail = first + 1;
+
+				while(tail < end && (*tail == ' ' || *tail == '\t' || *tail == '\r'))
+					tail++;
+
+				if(tail >= end || *tail == '\n')
+				{
+					*last_line = *line;
+					return tail;
+				}
+			}
+
+			// A block without / terminator is followed by CREATE at the beginning of line after ;
+			if(plsql && semicolon_end != NULL && first < end && (*first == 'C' || *first == 'c') && IsWord(first, end, "CREATE"))
+			{
+				const char *prev = semicolon_end;
+
+				while(prev < cur && (*prev == ' ' || *prev == '\t' || *prev == '\r' || *prev == '\n'))
+					prev++;
+
+				if(prev == cur)
+				{
+					*last_line = semicolon_line;
+					return cur;
+				}
+			}
+		}
+		else
+		// String literal, '' inside is handled as two adjacent literals
+		if(c == '\'')
+		{
+			char close = '\'';
+
+			// Oracle q'<delimiter>...<delimiter>' quoting
+			if(cur > start && (cur[-1] == 'q' || cur[-1] == 'Q'))
+			{
+				if(cur + 1 < end)
+				{
+					close = cur[1];
+
+					if(close == '[') close = ']';
+					else if(close == '(') close = ')';
+					else if(close == '{') close = '}';
+					else if(close == '<') close = '>';
+
+					cur++;
+				}
+			}
+
+			cur++;
+
+			while(cur < end && !(*cur == close && (close == '\'' || (cur + 1 < end && cur[1] == '\''))))
+			{
+				if(*cur == '\n')
+					(*line)++;
+
+				cur++;
+			}
+
+			if(close != '\'' && cur < end)
+				cur++;
+
+			cur = (cur < end) ? cur + 1 : end;
+		}
+		else
+		// Quoted identifier
+		if(c == '"')
+		{
+			cur++;
+
+			while(cur < end && *cur != '"')
+			{
+				if(*cur == '\n')
+					(*line)++;
+
+				cur++;
+			}
+
+			cur = (cur < end) ? cur + 1 : end;
+		}
+		else
+		if(c == '-' && cur + 1 < end && cur[1] == '-')
+			cur = SkipLine(cur, end);
+		else
+		if(c == '/' && cur + 1 < end && cur[1] == '*')
+		{
+			cur += 2;
+
+			while(cur < end && !(*cur == '*' && cur + 1 < end && cur[1] == '/'))
+			{
+				if(*cur == '\n')
+					(*line)++;
+
+				cur++;
+			}
+
+			cur = (cur < end) ? cur + 2 : end;
+		}
+		else
+		if(c == ';')
+		{
+			cur++;
+
+			if(!plsql)
+			{
+				*last_line = *line;
+				return cur;
+			}
+
+			semicolon_line = *line;
+			semicolon_end = cur;
+		}
+		else
+			cur++;
+	}
+
+	// The statement ends at the last non-empty line of the input
+	const char *last = end;
+
+	*last_line = *line;
+
+	while(last > start && (last[-1] == '\n' || last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+	{
+		if(last[-1] == '\n')
+			(*last_line)--;
+
+		last--;
+	}
+
+	return end;
+}
+
+// Get the next (quoted, qualified) identifier
+const char* Inventory::GetIdent(const char *cur, const char *end, std::string &ident)
+{
+	const char *start = cur;
+
+	while(cur < end)
+	{
+		const char *part = cur;
+
+		if(*cur == '"')
+		{
+			const char *close = (const char*)memchr(cur + 1, '"', end - cur - 1);
+
+			cur = (close != NULL) ? close + 1 : end;
+		}
+		else
+		{
+			while(cur < end && INVENTORY_IDENT_CHAR(*cur))
+				cur++;
+		}
+
+		if(cur == part || cur >= end || *cur != '.')
+			break;
+
+		cur++;
+	}
+
+	ident.assign(start, cur - start);
+
+	return cur;
+}
+
+// Get the position of the word in the list, the input is not copied
+int Inventory::GetWord(const char *cur, const char *end, const char **list, const char **next)
+{
+	const char *start = cur;
+
+	while(cur < end && INVENTORY_IDENT_CHAR(*cur))
+		cur++;
+
+	size_t len = cur - start;
+
+	if(len == 0)
+		return -1;
+
+	for(int i = 0; list[i] != NULL; i++)
+	{
+		if(_strnicmp(start, list[i], len) == 0 && list[i][len] == '\x0')
+		{
+			*next = cur;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// Check if the input starts with the keyword followed by a delimiter
+bool Inventory::IsWord(const char *cur, const char *end, const char *word)
+{
+	size_t len = strlen(word);
+
+	if(cur + len > end || _strnicmp(cur, word, len) != 0)
+		return false;
+
+	if(cur + len < end && INVENTORY_IDENT_CHAR(cur[len]))
+		return false;
+
+	return true;
+}
+
+// Skip to the end of line (the new line is not skipped to be counted by the caller)
+const char* Inventory::SkipLine(const char *cur, const char *end)
+{
+	const char *nl = (const char*)memchr(cur, '\n', end - cur);
+
+	return (nl != NULL) ? nl : end;
+}
+
+// Write the inventory file
+int Inventory::Write()
+{
+	FILE *file = fopen(_path.c_str(), "w+");
+
+	if(file == NULL)
+		return -1;
+
+	// Output format is defined by the file extension
+	size_t len = _path.length();
+
+	if(len > 5 && _stricmp(_path.c_str() + len - 5, ".json") == 0)
+		WriteJson(file);
+	else
+		WriteCsv(file);
+
+	fclose(file);
+
+	return (int)_items.size();
+}
+
+// Write in CSV format
+void Inventory::WriteCsv(FILE *file)
+{
+	fprintf(file, "file,type,name,start_line,end_line,lines\n");
+
+	for(std::vector<InventoryItem>::iterator i = _items.begin(); i != _items.end(); i++)
+	{
+		fprintf(file, "%s,%s,%s,%d,%d,%d\n", EscapeCsv(_files[i->file]).c_str(), g_inventory_types[i->type], EscapeCsv(i->name).c_str(),
+			i->start_line, i->end_line, i->end_line - i->start_line + 1);
+	}
+}
+
+// Write in JSON format
+void Inventory::WriteJson(FILE *file)
+{
+	fprintf(file, "{\n  \"bytes\": %.0lf,\n  \"lines\": %d,\n  \"summary\": {", _bytes, _lines);
+
+	bool first = true;
+
+	for(int i = 0; i < INVENTORY_TYPES; i++)
+	{
+		if(_counts[i] == 0)
+			continue;
+
+		fprintf(file, "%s\n    \"%s\": %d", first ? "" : ",", g_inventory_types[i], _counts[i]);
+		first = false;
+	}
+
+	fprintf(file, "\n  },\n  \"objects\": [");
+
+	for(std::vector<InventoryItem>::iterator i = _items.begin(); i != _items.end(); i++)
+	{
+		fprintf(file, "%s\n    {\"file\": \"%s\", \"type\": \"%s\", \"name\": \"%s\", \"start_line\": %d, \"end_line\": %d, \"lines\": %d}",
+			(i == _items.begin()) ? "" : ",", EscapeJson(_files[i->file]).c_str(), g_inventory_types[i->type], EscapeJson(i->name).c_str(),
+			i->start_line, i->end_line, i->end_line - i->start_line + 1);
+	}
+
+	fprintf(file, "\n  ]\n}\n");
+}
+
+// Get the number of objects by type as text
+const char* Inventory::GetSummary()
+{
+	char value[256];
+
+	_summary.clear();
+
+	for(int i = 0; i < INVENTORY_TYPES; i++)
+	{
+		if(_counts[i] == 0)
+			continue;
+
+		sprintf(value, "\n  %-20s %d", g_inventory_types[i], _counts[i]);
+		_summary += value;
+	}
+
+	return _summary.c_str();
+}
+
+// Escape a value for CSV, quotes are used only when required
+std::string Inventory::EscapeCsv(const std::string &value)
+{
+	if(value.find_first_of(",\"\n") == std::string::npos)
+		return value;
+
+	std::string out = "\"";
+
+	for(size_t i = 0; i < value.length(); i++)
+	{
+		if(value[i] == '"')
+			out += '"';
+
+		out += value[i];
+	}
+
+	out += '"';
+
+	return out;
+}
+
+// Escape a value for JSON string
+std::string Inventory::EscapeJson(const std::string &value)
+{
+	std::string out;
+
+	for(size_t i = 0; i < value.length(); i++)
+	{
+		if(value[i] == '"' || value[i] == '\\')
+			out += '\\';
+
+		out += value[i];
+	}
+
+	return out;
+}
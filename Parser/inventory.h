@@ -0,0 +1,109 @@
+// Inventory class - Lexer-only scan of object headers and block extents without conversion
+
+#ifndef sqlines_inventory_h
+#define sqlines_inventory_h
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define SQLINES_INVENTORY_FILE      "sqlines_inventory.csv"
+
+// Object types
+#define INVENTORY_TABLE             0
+#define INVENTORY_VIEW              1
+#define INVENTORY_MVIEW             2
+#define INVENTORY_SEQUENCE          3
+#define INVENTORY_INDEX             4
+#define INVENTORY_SYNONYM           5
+#define INVENTORY_PROCEDURE         6
+#define INVENTORY_FUNCTION          7
+#define INVENTORY_TRIGGER           8
+#define INVENTORY_PACKAGE           9
+#define INVENTORY_PACKAGE_BODY      10
+#define INVENTORY_TYPE              11
+#define INVENTORY_TYPE_BODY         12
+
+#define INVENTORY_TYPES             13
+
+// Object found by the scan
+struct InventoryItem
+{
+	// Object type and name as specified in the source
+	short type;
+	std::string name;
+
+	// Index of the source file
+	int file;
+
+	// Lines of the CREATE statement
+	int start_line;
+	int end_line;
+
+	InventoryItem() { type = 0; file = 0; start_line = 0; end_line = 0; }
+};
+
+class Inventory
+{
+	// Output file, CSV or JSON by extension
+	std::string _path;
+
+	// Source files, the last one is the current
+	std::vector<std::string> _files;
+
+	// Objects in scan order, and the number of objects by type
+	std::vector<InventoryItem> _items;
+	int _counts[INVENTORY_TYPES];
+
+	// Total number of scanned bytes and lines
+	double _bytes;
+	int _lines;
+
+	// Characters that can change the scanner state, all others are skipped without checks
+	bool _special[256];
+
+	// Summary text
+	std::string _summary;
+
+public:
+	Inventory(const char *path);
+
+	// Set the current source file
+	void SetSourceFile(const char *file) { if(file != NULL) _files.push_back(file); }
+
+	// Scan the input and add found objects
+	int Scan(const char *input, int size, int *lines);
+
+	// Write the inventory file
+	int Write();
+
+	// Get the number of objects by type as text
+	const char* GetSummary();
+
+private:
+	// Recognize the object type after CREATE and its modifiers, -1 if it is not an object
+	int GetObjectType(const char *cur, const char *end, const char **next, int *line, bool *plsql);
+
+	// Skip spaces and comments, count new lines
+	const char* SkipSpaces(const char *cur, const char *end, int *line);
+	// Skip to the end of statement, PL/SQL blocks end with / line
+	const char* SkipStatement(const char *cur, const char *end, bool plsql, int *line, int *last_line);
+	// Skip to the end of line
+	const char* SkipLine(const char *cur, const char *end);
+
+	// Get the next (quoted, qualified) identifier
+	const char* GetIdent(const char *cur, const char *end, std::string &ident);
+	// Get the position of the word in the list, the input is not copied
+	int GetWord(const char *cur, const char *end, const char **list, const char **next);
+	// Check if the input starts with the keyword followed by a delimiter
+	bool IsWord(const char *cur, const char *end, const char *word);
+
+	// Write in CSV and JSON formats
+	void WriteCsv(FILE *file);
+	void WriteJson(FILE *file);
+	// Escape a value for CSV and JSON
+	static std::string EscapeCsv(const std::string &value);
+	static std::string EscapeJson(const std::string &value);
+};
+
+#endif // sqlines_inventory_h
@@ -39,7 +39,7 @@ void SqlParser::ConvertIdentifier(Token *token, int type, int scope)
 	}
 
 	// Check for a cursor parameter reference NOW PROCESSED AS LOCAL BLOCK VAR
-	//if(_spl_current_declaring_cursor != NULL && ConvertCursorParameter(token) == true)
+	//if(_spl->current_declaring_cursor != NULL && ConvertCursorParameter(token) == true)
 	//	return;
 
 	// Check for record variable reference
@@ -61,6 +61,10 @@ void SqlParser::ConvertIdentifier(Token *token, int type, int scope)
 	// Convert column name
 	if(type == SQL_IDENT_COLUMN || type == SQL_IDENT_COLUMN_SINGLE)
 	{
+		// seq.NEXTVAL and seq.CURRVAL are emulated by functions
+		if(ConvertOraclePseudoColumn(token) == true)
+			return;
+
 		ConvertColumnIdentifier(token, scope);
 		return;
 	}
@@ -214,19 +218,19 @@ void SqlParser::ConvertColumnIdentifierSingle(Token *token, int /*scope*/)
 // Oracle PL/SQL cursor parameter reference NOW PROCESSED AS LOCAL BLOCK VAR
 bool SqlParser::ConvertCursorParameter(Token *token)
 {
-    if(token == nullptr || _spl_current_declaring_cursor == nullptr)
+    if(token == nullptr || _spl->current_declaring_cursor == nullptr)
 		return false;
 
 	bool exists = false;
 
 	// Use variables instead of cursor parameters 
-	if(_spl_cursor_params.GetCount() > 0)
+	if(_spl->cursor_params.GetCount() > 0)
 	{
-        for(ListwmItem *i = _spl_cursor_params.GetFirst(); i != nullptr; i = i->next)
+        for(ListwmItem *i = _spl->cursor_params.GetFirst(); i != nullptr; i = i->next)
 		{
 			Token *cursor_name = (Token*)i->value2;
 
-			if(Token::Compare(cursor_name, _spl_current_declaring_cursor) == true)
+			if(Token::Compare(cursor_name, _spl->current_declaring_cursor) == true)
 			{
 				Token *param = (Token*)i->value3;
 
@@ -253,7 +257,7 @@ bool SqlParser::ConvertRecordVariable(Token *token)
 
 	bool exists = false;
 
-	ListwItem *item = _spl_rowtype_vars.GetFirst();
+	ListwItem *item = _spl->rowtype_vars.GetFirst();
 
 	// Compare identifier prefix with existing record name
     while(item != nullptr)
@@ -276,8 +280,8 @@ bool SqlParser::ConvertRecordVariable(Token *token)
 
 
 			// Save referenced record fields (once only)
-            if(Find(_spl_rowtype_fields, rec, token) == nullptr)
-				_spl_rowtype_fields.Add(rec, token);
+            if(Find(_spl->rowtype_fields, rec, token) == nullptr)
+				_spl->rowtype_fields.Add(rec, token);
 
 			exists = true;
 			break;
@@ -297,7 +301,7 @@ bool SqlParser::ConvertImplicitRecordVariable(Token *token)
 
 	bool exists = false;
 
-	ListwmItem *item = _spl_implicit_rowtype_vars.GetFirst();
+	ListwmItem *item = _spl->implicit_rowtype_vars.GetFirst();
 
 	// Compare identifier prefix with existing record name
     while(item != nullptr)
@@ -329,8 +333,8 @@ bool SqlParser::ConvertImplicitRecordVariable(Token *token, Token *rec)
 		Token::ChangeNoFormat(token, ident);
 
 		// Save referenced record fields (once only)
-        if(Find(_spl_implicit_rowtype_fields, rec, token) == nullptr)
-			_spl_implicit_rowtype_fields.Add(rec, token);
+        if(Find(_spl->implicit_rowtype_fields, rec, token) == nullptr)
+			_spl->implicit_rowtype_fields.Add(rec, token);
 
 		return true;
 	}
@@ -344,7 +348,7 @@ bool SqlParser::ConvertImplicitForRecordVariable(Token *token)
 
 	bool exists = false;
 
-    ListwmItem *i = Find(_spl_implicit_record_fields, nullptr, token);
+    ListwmItem *i = Find(_spl->implicit_record_fields, nullptr, token);
 
 	// Field found
     if(i != nullptr && i->value != nullptr && i->value2 != nullptr)
@@ -376,18 +380,18 @@ bool SqlParser::ConvertImplicitForRecordVariable(Token *token)
 // Check for NEW or OLD column reference in trigger
 bool SqlParser::ConvertTriggerNewOldColumn(Token *token)
 {
-    if(token == nullptr || _spl_scope != SQL_SCOPE_TRIGGER)
+    if(token == nullptr || _spl->scope != SQL_SCOPE_TRIGGER)
 		return false;
 
 	bool exists = false;
 
-    if(_spl_old_correlation_name == nullptr && Token::Compare(token, "OLD", L"OLD", 1, 3) == true &&
+    if(_spl->old_correlation_name == nullptr && Token::Compare(token, "OLD", L"OLD", 1, 3) == true &&
 			token->Compare(".", L".", 4, 1) == true)
 	{
 
 		// Save referenced old columns (once only)
-        if(Find(_spl_tr_old_columns, token) == nullptr)
-			_spl_tr_old_columns.Add(token);
+        if(Find(_spl->tr_old_columns, token) == nullptr)
+			_spl->tr_old_columns.Add(token);
 
 		exists = true;
 	}		
@@ -403,7 +407,7 @@ bool SqlParser::ConvertTableVariable(Token *token)
 
 	bool exists = false;
 
-	ListwItem *item = _spl_declared_local_tables.GetFirst();
+	ListwItem *item = _spl->declared_local_tables.GetFirst();
 
 	// Compare identifier with existing declared local table (table variable)
     while(item != nullptr)
@@ -445,7 +449,7 @@ bool SqlParser::ConvertLocalTableColumn(Token *token)
 
 	bool exists = false;
 
-	ListwItem *item = _spl_declared_local_tables.GetFirst();
+	ListwItem *item = _spl->declared_local_tables.GetFirst();
 
 	// Compare identifier prefix with existing local temporary name
     while(item != nullptr)
@@ -1373,8 +1377,19 @@ bool SqlParser::ParseExpression(Token *first, int prev_operator)
             ConvertParameterIdentifier(first, param);
 
         if(var == nullptr && param == nullptr)
+        {
             ConvertIdentifier(first, SQL_IDENT_COLUMN);
 
+            // Column of the indexed table gets the data type of its definition
+            Token *type = GetCreateTableColumnType(_create_index_table, first);
+
+            if(type != nullptr)
+            {
+                first->data_type = type->data_type;
+                first->data_subtype = type->data_subtype;
+            }
+        }
+
 		exists = true;
 	}
 	else
@@ -1385,6 +1400,18 @@ bool SqlParser::ParseExpression(Token *first, int prev_operator)
 	if(exists == false)
 		return false;
 
+	// Field of a collection element or an object returned by function - c(i).field
+	if(first->type == TOKEN_FUNCTION)
+	{
+		Token *field = GetNextToken();
+
+		if(field != nullptr && field->str != nullptr && field->len > 1 && field->str[0] == '.' && 
+			field->prev != nullptr && field->prev->Compare(')', L')') == true)
+			exists = true;
+		else
+			PushBack(field);
+	}
+
 	// Parse operators (they will be processed recursively by calling ParseExpression on the second operand)
 	bool op_exists = false;
 
@@ -1617,6 +1644,10 @@ bool SqlParser::ParseBooleanExpression(int scope, Token *stmt_start, int *condit
 		{
 			unary = true;
 			count++;
+
+			// Oracle rownum BETWEEN 1 AND n
+            if(ParseOracleRownumCondition(first, op, exp2, rowlimit) == true)
+				count--;
 		}
 	}
 	else
@@ -1763,6 +1794,13 @@ bool SqlParser::ParseInPredicate(Token *in)
             if(exp == nullptr)
 				break;
 
+			// IN (SELECT ...) subquery
+            if(TOKEN_CMP(exp, "SELECT"))
+			{
+				ParseSelectStatement(exp, 0, SQL_SEL_EXP, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+				break;
+			}
+
 			ParseExpression(exp);
 
 			Token *comma = GetNextCharToken(',', ',');
@@ -1808,11 +1846,11 @@ bool SqlParser::ParseBlock(int type, bool frontier, int scope, int *result_sets)
 
 			if(block == true)
 			{
-                _spl_begin_blocks.Add(token);
+                _spl->begin_blocks.Add(token);
 
 				ParseBlock(SQL_BLOCK_BEGIN, true, scope, result_sets);
 
-                _spl_begin_blocks.DeleteLast();
+                _spl->begin_blocks.DeleteLast();
 
 				Token *end = GetNext("END", L"END", 3);
 
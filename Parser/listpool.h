@@ -0,0 +1,142 @@
+// ListPoolT<T, N> class - Node pool for wrapped lists (first N nodes inline, then chunks reused via free list)
+
+#ifndef sqlines_listpool_h
+#define sqlines_listpool_h
+
+#include <stddef.h>
+#include <new>
+#include "arena.h"
+
+// Number of nodes allocated at once when inline nodes are exhausted
+#define LISTPOOL_CHUNK_ITEMS	32
+
+template <class T, int N> class ListPoolT
+{
+	// Chunk of nodes allocated when inline nodes are exhausted
+	struct Chunk
+	{
+		T items[LISTPOOL_CHUNK_ITEMS];
+		Chunk *next;
+	};
+
+	// Inline nodes, so short lists do not allocate at all
+	T inline_items[N];
+	// Number of inline nodes taken from the pool at least once
+	int inline_used;
+
+	// Released nodes ready for reuse (linked through next)
+	T *free_items;
+
+	// Allocated chunks, released in destructor only
+	Chunk *chunks;
+	// Arena to take chunks from (released by arena rewind, not by the pool)
+	Arena *arena;
+	// Number of heap allocations performed by the pool
+	int allocations;
+
+public:
+	// Constructor
+	ListPoolT()
+	{
+		inline_used = 0;
+		free_items = NULL;
+		chunks = NULL;
+		arena = NULL;
+		allocations = 0;
+	}
+
+	// Destructor
+	~ListPoolT()
+	{
+		Chunk *current = chunks;
+		Chunk *next = NULL;
+
+		while(current)
+		{
+			next = current->next;
+			delete current;
+			current = next;
+		}
+	}
+
+	// Get a node, nodes are reinitialized before returning
+	T* Alloc()
+	{
+		T *item = NULL;
+
+		// Released nodes are reused first
+		if(free_items != NULL)
+		{
+			item = free_items;
+			free_items = item->next;
+		}
+		else
+		if(inline_used < N)
+		{
+			item = &inline_items[inline_used];
+			inline_used++;
+		}
+		else
+		{
+			Chunk *chunk = NULL;
+
+			if(arena != NULL)
+				chunk = new (arena->Alloc(sizeof(Chunk))) Chunk();
+			else
+			{
+				chunk = new Chunk();
+
+				chunk->next = chunks;
+				chunks = chunk;
+				allocations++;
+			}
+
+			// Take the first node, all others go to the free list
+			for(int i = LISTPOOL_CHUNK_ITEMS - 1; i > 0; i--)
+			{
+				chunk->items[i].next = free_items;
+				free_items = &chunk->items[i];
+			}
+
+			item = &chunk->items[0];
+		}
+
+		*item = T();
+
+		return item;
+	}
+
+	// Return a single node to the pool
+	void Free(T *item)
+	{
+		if(item == NULL)
+			return;
+
+		item->next = free_items;
+		free_items = item;
+	}
+
+	// Return the linked chain of nodes from first to last inclusively (they must be linked through next)
+	void FreeChain(T *first, T *last)
+	{
+		if(first == NULL || last == NULL)
+			return;
+
+		last->next = free_items;
+		free_items = first;
+	}
+
+	// Take chunks from the arena instead of the heap (must be set before the first chunk is allocated)
+	void SetArena(Arena *value)
+	{
+		arena = value;
+	}
+
+	// Get the number of heap allocations performed by the pool
+	int GetAllocations()
+	{
+		return allocations;
+	}
+};
+
+#endif // sqlines_listpool_h
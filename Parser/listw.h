@@ -3,6 +3,11 @@
 #ifndef sqlines_listw_h
 #define sqlines_listw_h
 
+#include "listpool.h"
+
+// Number of list items stored inline before the pool allocates chunks
+#define LISTW_INLINE_ITEMS		4
+
 class ListwItem
 {
 public:
@@ -29,6 +34,9 @@ class ListW
 	// Total number of items in the list
 	int count;
 
+	// Items are taken from and returned to the pool, not allocated one by one
+	ListPoolT<ListwItem, LISTW_INLINE_ITEMS> pool;
+
 public:
 	// Constructor
 	ListW()
@@ -47,16 +55,8 @@ public:
 	// Delete all elements from the list
 	void DeleteAll()
 	{
-		ListwItem *current = first;
-		ListwItem *next = NULL;
-
-		// remove list elements
-		while(current)
-		{
-			next = current->next;
-			delete current;
-			current = next;
-		}
+		// return all list elements to the pool at once
+		pool.FreeChain(first, last);
 
 		first = NULL;
 		last = NULL;
@@ -76,7 +76,7 @@ public:
 			return;
 
 		ListwItem *current = since;
-		ListwItem *next = NULL;
+		ListwItem *prev_last = last;
 
 		if(since == first)
 			first = NULL;
@@ -86,21 +86,21 @@ public:
 		if(last != NULL)
 			last->next = NULL;
 
-		// remove list elements
+		// count removed elements
 		while(current)
 		{
-			next = current->next;
-			delete current;
-			current = next;
-
+			current = current->next;
 			count--;
 		}
+
+		// return removed elements to the pool
+		pool.FreeChain(since, prev_last);
 	}
 
 	// Add a new item to the list
 	void Add(void* value)
 	{
-		ListwItem *item = new ListwItem();
+		ListwItem *item = pool.Alloc();
 
 		item->value = value;
 
@@ -136,6 +136,12 @@ public:
 		return last;
 	}
 
+	// Allocate items from the arena, they are released by the arena rewind
+	void SetArena(Arena *arena)
+	{
+		pool.SetArena(arena);
+	}
+
 	// Get the total number of items in the list
 	int GetCount() 
 	{ 
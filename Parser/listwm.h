@@ -3,6 +3,11 @@
 #ifndef sqlines_listwm_h
 #define sqlines_listwm_h
 
+#include "listpool.h"
+
+// Number of list items stored inline before the pool allocates chunks
+#define LISTWM_INLINE_ITEMS		4
+
 class ListwmItem
 {
 public:
@@ -44,6 +49,9 @@ class ListWM
 	// Total number of items in the list
 	int count;
 
+	// Items are taken from and returned to the pool, not allocated one by one
+	ListPoolT<ListwmItem, LISTWM_INLINE_ITEMS> pool;
+
 public:
 	// Constructor
 	ListWM()
@@ -62,16 +70,8 @@ public:
 	// Delete all elements from the list
 	void DeleteAll()
 	{
-		ListwmItem *current = first;
-		ListwmItem *next = NULL;
-
-		// remove list elements
-		while(current)
-		{
-			next = current->next;
-			delete current;
-			current = next;
-		}
+		// return all list elements to the pool at once
+		pool.FreeChain(first, last);
 
 		first = NULL;
 		last = NULL;
@@ -91,7 +91,7 @@ public:
 
 	void Add(void* value, void* value2, void* value3, void* value4, void* value5, void* value6, int ivalue)
 	{
-		ListwmItem *item = new ListwmItem();
+		ListwmItem *item = pool.Alloc();
 
 		item->value = value;
 		item->value2 = value2;
@@ -140,7 +140,7 @@ public:
 		if(item->next != NULL)
 			item->next->prev = item->prev;
 
-		delete item;
+		pool.Free(item);
 
 		count--;
 	}
@@ -190,7 +190,7 @@ public:
 				if(next != NULL)
 					next->prev = current->prev;
 
-				delete current;
+				pool.Free(current);
 
 				count--;
 			}
@@ -227,6 +227,12 @@ public:
 		return NULL;
 	}
 
+	// Allocate items from the arena, they are released by the arena rewind
+	void SetArena(Arena *arena)
+	{
+		pool.SetArena(arena);
+	}
+
 	// Get the total number of items in the list
 	int GetCount() 
 	{ 
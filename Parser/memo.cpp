@@ -0,0 +1,705 @@
+// SQLParser for repeated top-level statements, their conversion is recorded and reused
+
+#include <stdio.h>
+#include <string.h>
+#include "sqlparser.h"
+#include "str.h"
+
+// Kind of top-level statement for the memo
+#define MEMO_STMT_OTHER			0	// Does not change the state and is not recorded
+#define MEMO_STMT_DEFINE		1	// Can change the conversion of later statements, recorded statements are dropped
+#define MEMO_STMT_RECORD		2	// Converted the same way every time, recorded when repeated
+
+// Parse a top-level statement, a repeated statement reuses its recorded conversion
+void SqlParser::ParseWithMemo(Token *token, int *result_sets)
+{
+	// Assessment and inventory collect statistics for each statement, so it is always parsed
+	if(!_option_memo || _stats != nullptr || _inventory != nullptr || _source_app != 0)
+	{
+		Parse(token, SQL_SCOPE_FREE, result_sets);
+		return;
+	}
+
+	int kind = GetMemoStatementKind(token);
+
+	// Literal-only INSERT statements of data scripts
+	if(kind == MEMO_STMT_RECORD && ParseInsertLiterals(token, result_sets))
+		return;
+
+	// Replayed statements are not bookmarked, so INSERT statements are parsed to be merged into batches
+	if(kind == MEMO_STMT_RECORD && _option_insert_batch > 1 && TOKEN_CMP(token, "INSERT"))
+		kind = MEMO_STMT_OTHER;
+
+	StatementScan scan;
+
+	if(kind != MEMO_STMT_RECORD || !ScanMemoStatement(token, scan))
+	{
+		Parse(token, SQL_SCOPE_FREE, result_sets);
+
+		// Later statements can be converted differently
+		if(kind == MEMO_STMT_DEFINE)
+			_memo.Clear();
+
+		return;
+	}
+
+	_memo.statements++;
+
+	StatementMemoEntry *entry = _memo.Find(scan);
+
+	if(entry != nullptr)
+	{
+		ReplayMemoStatement(token, scan, entry);
+		_memo.hits++;
+
+		return;
+	}
+
+	// Statements are recorded when seen for the second time, most statements are unique
+	bool record = _memo.Seen(scan);
+
+	Token *before = token->prev;
+
+	std::vector<int> before_flags;
+
+	if(record)
+		GetMemoBeforeFlags(before, before_flags);
+
+	int line = _line;
+
+	Parse(token, SQL_SCOPE_FREE, result_sets);
+
+	// Statement must be parsed until its end, and must not change the tokens before it
+	if(!record || _next_start != scan.start + scan.len || _push_back_token != nullptr || IsMemoBeforeChanged(before, before_flags))
+		return;
+
+	// Lines are counted when the statement is replayed, so the scan must count them as the lexer does
+	if(_line - line != scan.total_lines)
+		return;
+
+	RecordMemoStatement(before, scan);
+}
+
+// Literal-only INSERT INTO ... VALUES statement reuses the conversion of the same head, the values are copied as is
+bool SqlParser::ParseInsertLiterals(Token *insert, int *result_sets)
+{
+	if(!TOKEN_CMP(insert, "INSERT") || insert->str == nullptr || insert->source_allocated || insert->str + insert->len != _next_start)
+		return false;
+
+	const char *head_end = nullptr;
+	const char *open = nullptr;
+	const char *semi = nullptr;
+	int open_lines = 0;
+	int lines = 0;
+
+	if(!ScanInsertLiterals(&head_end, &open, &semi, &open_lines, &lines))
+		return false;
+
+	const char *end = semi + 1;
+
+	_memo.statements++;
+
+	size_t head_len = head_end - insert->str;
+	const std::string *head = _memo.FindHead(insert->str, head_len);
+
+	// The statement becomes the head, values and ; tokens, the target is set only if the head was changed
+	if(head != nullptr)
+	{
+		insert->type = TOKEN_STATEMENT;
+		insert->len = open - insert->str;
+
+		if(head->length() != head_len || memcmp(head->c_str(), insert->str, head_len) != 0)
+		{
+			size_t spaces = open - head_end;
+			char *target = new char[head->length() + spaces + 1];
+
+			memcpy(target, head->c_str(), head->length());
+			memcpy(target + head->length(), head_end, spaces);
+			target[head->length() + spaces] = '\x0';
+
+			insert->t_str = target;
+			insert->t_len = head->length() + spaces;
+		}
+
+		insert->next_start = open;
+		insert->remain_size = _remain_size - (int)(open - _next_start);
+
+		Token *values = new Token();
+		values->type = TOKEN_LITERALS;
+		values->str = open;
+		values->len = semi - open;
+		values->line = _line + open_lines;
+		values->next_start = semi;
+		values->remain_size = _remain_size - (int)(semi - _next_start);
+
+		_tokens.Add(values);
+
+		SkipMemoInput(end);
+		_line += lines;
+
+		Token *close = new Token();
+		close->type = TOKEN_SYMBOL;
+		close->chr = ';';
+		close->line = _line;
+		close->next_start = _next_start;
+		close->remain_size = _remain_size;
+
+		_tokens.Add(close);
+
+		if(_option_insert_batch > 1)
+			Bookmark(BOOK_INSERT_ROW, insert, values, close);
+
+		_memo.hits++;
+
+		return true;
+	}
+
+	Token *before = insert->prev;
+
+	std::vector<int> before_flags;
+	GetMemoBeforeFlags(before, before_flags);
+
+	int line = _line;
+
+	Parse(insert, SQL_SCOPE_FREE, result_sets);
+
+	if(_next_start != end || _push_back_token != nullptr || _line - line != lines || IsMemoBeforeChanged(before, before_flags))
+		return true;
+
+	Token *first = (before != nullptr) ? before->next : _tokens.GetFirstNoCurrent();
+	size_t len = 0;
+
+	// Lines with removed tokens can be removed from the output, so the head is recorded only without them
+	for(Token *cur = first; cur != nullptr; cur = cur->next)
+	{
+		if(cur->IsRemoved())
+			return true;
+
+		len += cur->GetTargetLength();
+	}
+
+	char *target = new char[len + 1];
+	int target_len = 0;
+
+	for(Token *cur = first; cur != nullptr; cur = cur->next)
+		cur->AppendTarget(target, &target_len);
+
+	size_t rest = end - head_end;
+
+	// Values must be kept unchanged, so only the head is reused
+	if((size_t)target_len >= rest && memcmp(target + target_len - rest, head_end, rest) == 0)
+		_memo.AddHead(insert->str, head_len, std::string(target, target_len - rest));
+
+	delete [] target;
+
+	return true;
+}
+
+// Get the end of INSERT INTO ... VALUES head, ( of values and ; of the statement if it contains literals only
+bool SqlParser::ScanInsertLiterals(const char **head_end, const char **open, const char **semi, int *open_lines, int *lines)
+{
+	const char *cur = _next_start;
+	const char *input_end = _next_start + _remain_size;
+
+	int count = SkipLiteralSpaces(&cur, input_end);
+
+	if(cur == _next_start || input_end - cur < 4 || _strnicmp(cur, "INTO", 4) != 0)
+		return false;
+
+	cur += 4;
+
+	const char *space = cur;
+	count += SkipLiteralSpaces(&cur, input_end);
+
+	// Table name
+	if(cur == space || !ScanMemoIdentifier(&cur, input_end))
+		return false;
+
+	count += SkipLiteralSpaces(&cur, input_end);
+
+	// Optional column list
+	if(cur < input_end && *cur == '(')
+	{
+		cur++;
+
+		while(true)
+		{
+			count += SkipLiteralSpaces(&cur, input_end);
+
+			if(!ScanMemoIdentifier(&cur, input_end))
+				return false;
+
+			count += SkipLiteralSpaces(&cur, input_end);
+
+			if(cur < input_end && *cur == ',')
+			{
+				cur++;
+				continue;
+			}
+
+			if(cur < input_end && *cur == ')')
+			{
+				cur++;
+				break;
+			}
+
+			return false;
+		}
+
+		count += SkipLiteralSpaces(&cur, input_end);
+	}
+
+	if(input_end - cur < 6 || _strnicmp(cur, "VALUES", 6) != 0)
+		return false;
+
+	cur += 6;
+	*head_end = cur;
+
+	count += SkipLiteralSpaces(&cur, input_end);
+
+	// Single row of literals, multiple rows are converted to SELECT
+	if(cur >= input_end || *cur != '(')
+		return false;
+
+	*open = cur;
+	*open_lines = count;
+
+	cur++;
+
+	int literal_lines = 0;
+	const char *last = ScanLiterals(cur, input_end, &literal_lines);
+
+	if(last == nullptr)
+		return false;
+
+	cur = last;
+	count += literal_lines;
+	count += SkipLiteralSpaces(&cur, input_end);
+
+	if(cur >= input_end || *cur != ')')
+		return false;
+
+	cur++;
+	count += SkipLiteralSpaces(&cur, input_end);
+
+	if(cur >= input_end || *cur != ';')
+		return false;
+
+	*semi = cur;
+	*lines = count;
+
+	return true;
+}
+
+// Skip an unquoted or "quoted" identifier that can be qualified
+bool SqlParser::ScanMemoIdentifier(const char **cur, const char *end)
+{
+	const char *start = *cur;
+	const char *c = start;
+
+	while(c < end)
+	{
+		if((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '_' || *c == '$' || *c == '#' || *c == '.')
+			c++;
+		else
+		if(*c == '"')
+		{
+			const char *close = c + 1;
+
+			while(close < end && *close != '"' && *close != '\r' && *close != '\n')
+				close++;
+
+			if(close >= end || *close != '"')
+				return false;
+
+			c = close + 1;
+		}
+		else
+			break;
+	}
+
+	*cur = c;
+
+	return c != start;
+}
+
+// Get flags of whitespace and comments before the statement, they can be removed with its first token
+void SqlParser::GetMemoBeforeFlags(Token *before, std::vector<int> &flags)
+{
+	for(Token *cur = before; cur != nullptr && (cur->IsBlank() || cur->type == TOKEN_COMMENT); cur = cur->prev)
+		flags.push_back(cur->flags);
+}
+
+// Check whether the statement changed whitespace and comments before it
+bool SqlParser::IsMemoBeforeChanged(Token *before, std::vector<int> &flags)
+{
+	size_t i = 0;
+
+	for(Token *cur = before; i < flags.size(); cur = cur->prev, i++)
+	{
+		if(cur == nullptr || cur->flags != flags[i] || cur->t_str != nullptr)
+			return true;
+	}
+
+	return false;
+}
+
+// Get the kind of top-level statement for the memo
+int SqlParser::GetMemoStatementKind(Token *token)
+{
+	if(token == nullptr)
+		return MEMO_STMT_OTHER;
+
+	if(TOKEN_CMP(token, "INSERT") || TOKEN_CMP(token, "UPDATE"))
+		return MEMO_STMT_RECORD;
+
+	// Objects, bookmarks and types used by later statements are defined by DDL and blocks
+	if(TOKEN_CMP(token, "CREATE") || TOKEN_CMP(token, "ALTER") || TOKEN_CMP(token, "DROP") || 
+		TOKEN_CMP(token, "DECLARE") || TOKEN_CMP(token, "BEGIN"))
+		return MEMO_STMT_DEFINE;
+
+	// COMMENT ON COLUMN changes CREATE TABLE, so it is not recorded
+	return MEMO_STMT_OTHER;
+}
+
+// Split the statement text into significant parts and gaps the way the lexer does
+bool SqlParser::ScanMemoStatement(Token *first, StatementScan &scan)
+{
+	// Statement starts with the first token that was just read from the input
+	if(first == nullptr || first->str == nullptr || first->source_allocated || first->str + first->len != _next_start)
+		return false;
+
+	const char *start = first->str;
+	const char *end = _next_start + _remain_size;
+	const char *cur = _next_start;
+
+	scan.start = start;
+	scan.normalized.assign(first->str, first->len);
+
+	int depth = 0;
+	int lines = 0;
+
+	bool found = false;
+
+	while(cur < end && !found)
+	{
+		if((size_t)(cur - start) > STATEMENT_MEMO_MAX_SIZE)
+			return false;
+
+		char c = *cur;
+
+		bool comment = (c == '/' && cur + 1 < end && cur[1] == '*') || (c == '-' && cur + 1 < end && cur[1] == '-');
+
+		// Gap of whitespace and comments, -- starts a comment only at the beginning of a token
+		if(c == ' ' || c == '\t' || c == '\r' || c == '\n' || comment)
+		{
+			if(c == '-' && strchr(" \t\r\n(),;=", cur[-1]) == nullptr)
+				return false;
+
+			StatementGap gap;
+			gap.start = cur - start;
+			gap.lines = lines;
+
+			bool spaces = true;
+
+			while(cur < end)
+			{
+				if(*cur == ' ' || *cur == '\t' || *cur == '\r' || *cur == '\n')
+				{
+					// The lexer counts \n and single \r (not followed by \n)
+					if(*cur == '\n' || (*cur == '\r' && cur + 1 < end && cur[1] != '\n'))
+						scan.total_lines++;
+
+					if(*cur != ' ')
+						spaces = false;
+
+					cur++;
+				}
+				else
+				if(*cur == '-' && cur + 1 < end && cur[1] == '-')
+				{
+					while(cur < end && *cur != '\r' && *cur != '\n')
+						cur++;
+
+					spaces = false;
+				}
+				else
+				if(*cur == '/' && cur + 1 < end && cur[1] == '*')
+				{
+					const char *close = cur + 2;
+
+					while(close + 1 < end && !(*close == '*' && close[1] == '/'))
+					{
+						if(*close == '\n')
+							scan.total_lines++;
+
+						close++;
+					}
+
+					if(close + 1 >= end)
+						return false;
+
+					cur = close + 2;
+					spaces = false;
+				}
+				else
+					break;
+			}
+
+			gap.end = cur - start;
+			scan.gaps.push_back(gap);
+
+			lines = 0;
+
+			// Gaps of spaces only and other gaps are lexed differently (- 1 is a single token i.e.)
+			scan.normalized += spaces ? ' ' : '\n';
+			continue;
+		}
+
+		const char *part = cur;
+
+		// String literal, '' is an escaped quote
+		if(c == '\'')
+		{
+			cur++;
+
+			while(cur < end)
+			{
+				if(*cur == '\'')
+				{
+					if(cur + 1 < end && cur[1] == '\'')
+					{
+						cur += 2;
+						continue;
+					}
+
+					break;
+				}
+
+				if(*cur == '\n')
+					lines++;
+
+				cur++;
+			}
+
+			if(cur >= end)
+				return false;
+
+			cur++;
+		}
+		else
+		// Quoted identifier
+		if(c == '"')
+		{
+			const char *close = (const char*)memchr(cur + 1, '"', end - cur - 1);
+
+			if(close == nullptr)
+				return false;
+
+			cur = close + 1;
+		}
+		else
+		// Characters that the lexer treats depending on the context
+		if(c == '`' || c == '[' || c == '#')
+			return false;
+		else
+		{
+			if(c == '(')
+				depth++;
+			else
+			if(c == ')')
+				depth--;
+			else
+			if(c == ';' && depth == 0)
+				found = true;
+
+			cur++;
+		}
+
+		scan.normalized.append(part, cur - part);
+	}
+
+	if(!found)
+		return false;
+
+	scan.len = cur - start;
+	scan.tail_lines = lines;
+
+	for(std::vector<StatementGap>::iterator i = scan.gaps.begin(); i != scan.gaps.end(); i++)
+		scan.total_lines += (*i).lines;
+
+	scan.total_lines += lines;
+	scan.hash = StatementMemo::Hash(scan.normalized);
+
+	return true;
+}
+
+// Record the conversion of the statement that follows the specified token
+void SqlParser::RecordMemoStatement(Token *before, StatementScan &scan)
+{
+	Token *first = (before != nullptr) ? before->next : _tokens.GetFirstNoCurrent();
+
+	bool layout = false;
+	int last_gap = -1;
+	int cur_gap = -1;
+
+	// Gaps can be lexed again from other text only if each gap is kept unchanged, in order and in one piece
+	for(Token *cur = first; cur != nullptr && !layout; cur = cur->next)
+	{
+		int gap = GetMemoGap(cur, scan, cur_gap, &layout);
+
+		if(gap == -1)
+			cur_gap = -1;
+		else
+		if(gap != cur_gap)
+		{
+			if(gap != last_gap + 1)
+				layout = true;
+
+			last_gap = gap;
+			cur_gap = gap;
+		}
+	}
+
+	if(last_gap != (int)scan.gaps.size() - 1)
+		layout = true;
+
+	StatementMemoEntry *entry = new StatementMemoEntry();
+
+	entry->normalized = scan.normalized;
+	entry->layout = layout;
+
+	if(layout)
+		entry->raw.assign(scan.start, scan.len);
+
+	cur_gap = -1;
+
+	for(Token *cur = first; cur != nullptr; cur = cur->next)
+	{
+		bool changed = false;
+		int gap = layout ? -1 : GetMemoGap(cur, scan, cur_gap, &changed);
+
+		StatementMemoPiece piece;
+		piece.token = nullptr;
+		piece.gap = gap;
+
+		if(gap == -1)
+			piece.token = CopyMemoToken(cur);
+		else
+		// Gap is lexed again as a whole
+		if(gap == cur_gap)
+			continue;
+
+		cur_gap = gap;
+		entry->pieces.push_back(piece);
+	}
+
+	_memo.Add(scan, entry);
+}
+
+// Get the gap of the lexed whitespace or comment token, -1 for other tokens
+int SqlParser::GetMemoGap(Token *token, StatementScan &scan, int prev_gap, bool *changed)
+{
+	if(token == nullptr || (token->flags & TOKEN_INSERTED) || (!token->IsBlank() && token->type != TOKEN_COMMENT))
+		return -1;
+
+	if(token->IsRemoved() || token->t_str != nullptr)
+	{
+		*changed = true;
+		return -1;
+	}
+
+	const char *pos = nullptr;
+
+	if(token->str != nullptr)
+		pos = token->str;
+	else
+	if(token->next_start != nullptr)
+		pos = token->next_start - 1;
+
+	// Space added by the lexer after -- belongs to the gap of the comment
+	if(pos == nullptr)
+		return prev_gap;
+
+	if(pos < scan.start || pos >= scan.start + scan.len)
+	{
+		*changed = true;
+		return -1;
+	}
+
+	size_t offset = pos - scan.start;
+
+	for(size_t i = 0; i < scan.gaps.size(); i++)
+	{
+		if(offset >= scan.gaps[i].start && offset < scan.gaps[i].end)
+			return (int)i;
+	}
+
+	*changed = true;
+	return -1;
+}
+
+// Replace the statement with the recorded conversion, gaps are lexed from the statement text
+void SqlParser::ReplayMemoStatement(Token *first, StatementScan &scan, StatementMemoEntry *entry)
+{
+	// The first token is replaced by its recorded copy
+	_tokens.Delete(first);
+
+	for(std::vector<StatementMemoPiece>::iterator i = entry->pieces.begin(); i != entry->pieces.end(); i++)
+	{
+		if((*i).token != nullptr)
+		{
+			_tokens.Add(CopyMemoToken((*i).token));
+			continue;
+		}
+
+		StatementGap &gap = scan.gaps[(*i).gap];
+
+		// Skip the significant part before the gap, its tokens are recorded
+		SkipMemoInput(scan.start + gap.start);
+		_line += gap.lines;
+
+		ParseComment();
+	}
+
+	SkipMemoInput(scan.start + scan.len);
+
+	_line += entry->layout ? scan.total_lines : scan.tail_lines;
+}
+
+// Move the input position forward without creating tokens
+void SqlParser::SkipMemoInput(const char *to)
+{
+	if(to <= _next_start)
+		return;
+
+	_remain_size -= (int)(to - _next_start);
+	_next_start = to;
+}
+
+// Copy the token with its own source and target values
+Token* SqlParser::CopyMemoToken(Token *source)
+{
+	Token *token = new Token();
+	*token = *source;
+
+	token->prev = nullptr;
+	token->next = nullptr;
+
+	// References to other tokens are used only while the statement is parsed
+	token->open = nullptr;
+	token->close = nullptr;
+	token->table = nullptr;
+
+	token->next_start = nullptr;
+	token->remain_size = 0;
+
+	token->str = (source->str != nullptr) ? Str::GetCopy(source->str, source->len) : nullptr;
+	token->wstr = nullptr;
+	token->source_allocated = true;
+
+	token->t_str = (source->t_str != nullptr) ? Str::GetCopy(source->t_str, source->t_len) : nullptr;
+	token->t_wstr = nullptr;
+
+	return token;
+}
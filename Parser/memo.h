@@ -0,0 +1,192 @@
+// StatementMemo class - Conversions of repeated top-level statements recorded and reused within a file
+
+#ifndef sqlines_memo_h
+#define sqlines_memo_h
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "token.h"
+
+// Maximum number of recorded statements per file, and the maximum statement size in bytes
+#define STATEMENT_MEMO_ENTRIES		4096
+#define STATEMENT_MEMO_MAX_SIZE		65536
+
+// Whitespace and comments between significant parts of the statement (offsets from the statement start)
+struct StatementGap
+{
+	size_t start;
+	size_t end;
+
+	// Lines counted by the lexer in string literals between the previous gap and this gap
+	int lines;
+};
+
+// Statement text split into significant parts and gaps
+struct StatementScan
+{
+	const char *start;
+	size_t len;
+
+	std::vector<StatementGap> gaps;
+
+	// Lines in string literals after the last gap, and all lines counted by the lexer in the statement
+	int tail_lines;
+	int total_lines;
+
+	// Significant text with a single marker for each gap, and its hash
+	std::string normalized;
+	unsigned long long hash;
+
+	StatementScan() { start = NULL; len = 0; tail_lines = 0; total_lines = 0; hash = 0; }
+};
+
+// Token of the recorded conversion or a gap that is taken from the replayed statement
+struct StatementMemoPiece
+{
+	Token *token;
+	int gap;
+};
+
+// Recorded conversion of a statement
+struct StatementMemoEntry
+{
+	std::string normalized;
+
+	// Conversion changed whitespace or comments, so the entry is reused only for the same text
+	bool layout;
+	std::string raw;
+
+	std::vector<StatementMemoPiece> pieces;
+
+	StatementMemoEntry() { layout = false; }
+
+	~StatementMemoEntry()
+	{
+		for(std::vector<StatementMemoPiece>::iterator i = pieces.begin(); i != pieces.end(); i++)
+			delete (*i).token;
+	}
+};
+
+// Converted INSERT INTO ... VALUES head of literal-only INSERT statements
+struct StatementMemoHead
+{
+	std::string source;
+	std::string target;
+};
+
+class StatementMemo
+{
+	// Recorded statements by hash of the normalized text
+	std::unordered_map<unsigned long long, StatementMemoEntry*> _entries;
+	// Statements seen once, they are recorded when seen again
+	std::unordered_set<unsigned long long> _seen;
+	// Recorded INSERT heads by hash of the source text
+	std::unordered_map<unsigned long long, StatementMemoHead> _heads;
+
+public:
+	// Statements looked up and reused
+	int statements;
+	int hits;
+
+	StatementMemo() { statements = 0; hits = 0; }
+	~StatementMemo() { Clear(); }
+
+	// Find the recorded conversion of the statement
+	StatementMemoEntry* Find(StatementScan &scan)
+	{
+		std::unordered_map<unsigned long long, StatementMemoEntry*>::iterator i = _entries.find(scan.hash);
+
+		if(i == _entries.end())
+			return NULL;
+
+		StatementMemoEntry *entry = i->second;
+
+		if(entry->normalized != scan.normalized)
+			return NULL;
+
+		if(entry->layout && (entry->raw.length() != scan.len || memcmp(entry->raw.c_str(), scan.start, scan.len) != 0))
+			return NULL;
+
+		return entry;
+	}
+
+	// Check whether the statement was seen before, it is marked as seen
+	bool Seen(StatementScan &scan)
+	{
+		return !_seen.insert(scan.hash).second;
+	}
+
+	// Add the recorded conversion, the memo takes ownership
+	void Add(StatementScan &scan, StatementMemoEntry *entry)
+	{
+		if(entry == NULL)
+			return;
+
+		std::unordered_map<unsigned long long, StatementMemoEntry*>::iterator i = _entries.find(scan.hash);
+
+		if(i != _entries.end())
+		{
+			delete i->second;
+			i->second = entry;
+		}
+		else
+		if(_entries.size() < STATEMENT_MEMO_ENTRIES)
+			_entries[scan.hash] = entry;
+		else
+			delete entry;
+	}
+
+	// Find the converted INSERT head, NULL if it was not recorded
+	const std::string* FindHead(const char *source, size_t len)
+	{
+		std::unordered_map<unsigned long long, StatementMemoHead>::iterator i = _heads.find(Hash(source, len));
+
+		if(i == _heads.end() || i->second.source.length() != len || memcmp(i->second.source.c_str(), source, len) != 0)
+			return NULL;
+
+		return &i->second.target;
+	}
+
+	// Add the converted INSERT head
+	void AddHead(const char *source, size_t len, const std::string &target)
+	{
+		if(_heads.size() >= STATEMENT_MEMO_ENTRIES)
+			return;
+
+		StatementMemoHead &head = _heads[Hash(source, len)];
+
+		head.source.assign(source, len);
+		head.target = target;
+	}
+
+	// Remove all recorded statements, counters are kept
+	void Clear()
+	{
+		for(std::unordered_map<unsigned long long, StatementMemoEntry*>::iterator i = _entries.begin(); i != _entries.end(); i++)
+			delete i->second;
+
+		_entries.clear();
+		_seen.clear();
+		_heads.clear();
+	}
+
+	// FNV-1a hash of the normalized text
+	static unsigned long long Hash(const std::string &str)
+	{
+		return Hash(str.c_str(), str.length());
+	}
+
+	static unsigned long long Hash(const char *str, size_t len)
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+
+		for(size_t i = 0; i < len; i++)
+			hash = (hash ^ (unsigned char)str[i]) * 1099511628211ULL;
+
+		return hash;
+	}
+};
+
+#endif // sqlines_memo_h
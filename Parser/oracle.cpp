@@ -357,74 +357,84 @@ bool SqlParser::ParseOracleLobStorageClause(Token *lob)
 }
 
 // Oracle partitions definitions
-bool SqlParser::ParseOraclePartitions(Token *token)
+bool SqlParser::ParseOraclePartitions(Token *token, Token *table_name)
 {
     if(token == nullptr)
 		return false;
 
-	// LOCAL or GLOBAL can be specified for index partition
-    Token *local = token->Compare("LOCAL", L"LOCAL", 5) ? token : nullptr;
-    Token *global = nullptr;
-	
-    if(local == nullptr && token->Compare("GLOBAL", L"GLOBAL", 6))
-		global = token;
-
-    if(local != nullptr || global != nullptr)
+	// LOCAL partitioned index, index partitions always match the table partitions in MySQL
+    if(token->Compare("LOCAL", L"LOCAL", 5) == true)
 	{
-		Token::Remove(token);
+		// A dummy tokens to parse PARTITION and SUBPARTITION definitions for index
+		Token part, subpart;
 
-        if(global != nullptr)
-			token = GetNextToken();
-	}
+		ParseOraclePartition(&part, &subpart, nullptr);
 
-    Token *subpartition = nullptr;
+		Token::Remove(token, GetLastToken());
+		return true;
+	}
 
-	// PARTITION BY is not specified for LOCAL partitioned indexes
-    if(local == nullptr)
+	// GLOBAL index partitioning is not supported in MySQL
+    if(token->Compare("GLOBAL", L"GLOBAL", 6) == true)
 	{
-		// PARTITION BY clause
-		if(ParseOraclePartitionsBy(token) == false)
-			return false;
+		Token *partition = GetNextWordToken("PARTITION", L"PARTITION", 9);
 
-		subpartition = GetNextWordToken("SUBPARTITION", L"SUBPARTITION", 12);
-
-		// SUBPARTITION clause can follow
-        if(subpartition != nullptr)
+        if(partition != nullptr)
 		{
-			ParseOraclePartitionsBy(subpartition);
+			OraclePartitions parts;
 
-			// SUBPARTITION TEMPLATE
-			Token *subpartition2 = GetNextWordToken("SUBPARTITION", L"SUBPARTITION", 12);
-            Token *template_ = nullptr;
-
-            if(subpartition2 != nullptr)
-			{
-				template_ = GetNextWordToken("TEMPLATE", L"TEMPLATE", 8);
+			ParseOraclePartitionsBy(partition, &parts.part);
+			ParseOraclePartition(partition, nullptr, &parts);
 
-				// Subpartition template definition
-                ParseOraclePartition(nullptr, subpartition2);
-			}
+			CREATE_TAB_STMS_STATS("Global partitioned index removed")
 		}
 
-		// PARTITION definition including subpartitions
-		ParseOraclePartition(token, subpartition);
+		Token::Remove(token, GetLastToken());
+		return true;
 	}
-	else
+
+    if(token->Compare("PARTITION", L"PARTITION", 9) == false)
+		return false;
+
+	OraclePartitions parts;
+
+	// PARTITION BY clause
+	if(ParseOraclePartitionsBy(token, &parts.part) == false)
+		return false;
+
+	Token *subpartition = GetNextWordToken("SUBPARTITION", L"SUBPARTITION", 12);
+
+	// SUBPARTITION clause can follow
+    if(subpartition != nullptr)
 	{
-		// A dummy tokens to parse PARTITION and SUBPARTITION definitions for index
-		Token part, subpart;
+		ParseOraclePartitionsBy(subpartition, &parts.subpart);
 
-		// PARTITION definition including subpartitions for LOCAL index
-		ParseOraclePartition(&part, &subpart);
+		// SUBPARTITION TEMPLATE
+		Token *subpartition2 = GetNextWordToken("SUBPARTITION", L"SUBPARTITION", 12);
+
+        if(subpartition2 != nullptr)
+		{
+			Token *template_ = GetNextWordToken("TEMPLATE", L"TEMPLATE", 8);
+
+			parts.subpart_defs.push_back(std::make_pair(subpartition2, Nvl(template_, subpartition2)));
+
+			// Subpartition template definition
+            ParseOraclePartition(nullptr, subpartition2, &parts);
+		}
 	}
 
+	// PARTITION definition including subpartitions
+	ParseOraclePartition(token, subpartition, &parts);
+
+	OracleConvertPartitions(table_name, &parts);
+
 	return true;
 }
 
 // Oracle partition or subpartition type and columns 
-bool SqlParser::ParseOraclePartitionsBy(Token *token)
+bool SqlParser::ParseOraclePartitionsBy(Token *token, PartitionsBy *by)
 {
-    if(token == nullptr)
+    if(token == nullptr || by == nullptr)
 		return false;
 		
     Token *partition = token->Compare("PARTITION", L"PARTITION", 9) ? token : nullptr;
@@ -436,67 +446,104 @@ bool SqlParser::ParseOraclePartitionsBy(Token *token)
     if(partition == nullptr && subpartition == nullptr)
 		return false;
 
-	/*Token *by */ (void) GetNextWordToken("BY", L"BY", 2);
+	Token *by_ = GetNextWordToken("BY", L"BY", 2);
 
-	// RANGE, HASH or LIST
-	Token *range = GetNextWordToken("RANGE", L"RANGE", 5);
-    Token *hash = nullptr;
-    Token *list = nullptr;
-	
-    if(range == nullptr)
-		hash = GetNextWordToken("HASH", L"HASH", 4);
+    if(by_ == nullptr)
+		return false;
 
-    if(range == nullptr && hash == nullptr)
-		list = GetNextWordToken("LIST", L"LIST", 4);
+	by->start = token;
 
-	Token *open = GetNextCharToken('(', L'(');
+	// RANGE, HASH, LIST, or REFERENCE and SYSTEM that are not supported in MySQL
+	by->type = GetNextToken();
 
-    if(open == nullptr)
-		return false;
+	Token *open = GetNextCharToken('(', L'(');
 
 	// Multiple columns can be specified
-	while(true)
+    while(open != nullptr)
 	{
 		Token *column = GetNextIdentToken();
 
         if(column == nullptr)
 			break;
 
+		by->columns.push_back(column);
+
 		Token *comma = GetNextCharToken(',', ',');
 
         if(comma == nullptr)
 			break;
 	}
 
-    /*Token *close */ GetNextCharToken(')', L')');
+    if(open != nullptr)
+		/*Token *close */ GetNextCharToken(')', L')');
 
-	// SUBPARTITIONS num
-    if(subpartition != nullptr)
+	// INTERVAL (expr) for automatically created range partitions
+	Token *interval = (partition != nullptr) ? GetNextWordToken("INTERVAL", L"INTERVAL", 8) : nullptr;
+
+    if(interval != nullptr)
+	{
+		Token *open_interval = GetNextCharToken('(', L'(');
+		Token *exp = GetNextToken();
+
+		ParseExpression(exp);
+
+		Token *close_interval = GetNextCharToken(')', L')');
+
+		// Only the initial partitions are created in MySQL
+        if(open_interval != nullptr && close_interval != nullptr)
+		{
+			Token::Remove(interval, close_interval);
+			CREATE_TAB_STMS_STATS("Interval partitioning removed")
+		}
+	}
+
+	// PARTITIONS num or SUBPARTITIONS num
+	Token *partitions = nullptr;
+	
+    if(partition != nullptr)
+		partitions = GetNextWordToken("PARTITIONS", L"PARTITIONS", 10);
+	else
+		partitions = GetNextWordToken("SUBPARTITIONS", L"SUBPARTITIONS", 13);
+
+    if(partitions != nullptr)
+		by->count = GetNextNumberToken();
+
+	// STORE IN (tablespace, ...)
+	Token *store = GetNextWordToken("STORE", L"STORE", 5);
+
+    if(store != nullptr)
 	{
-		Token *subpartitions = GetNextWordToken("SUBPARTITIONS", L"SUBPARTITIONS", 13);
-        Token *num = nullptr;
+		/*Token *in */ (void) GetNextWordToken("IN", L"IN", 2);
+		/*Token *open_store */ (void) GetNextCharToken('(', L'(');
 
-        if(subpartitions != nullptr)
+		while(true)
 		{
-			num = GetNextToken();
+			Token *tablespace = GetNextIdentToken();
 
-			Token::Remove(subpartitions, num);
+            if(tablespace == nullptr || GetNextCharToken(',', L',') == nullptr)
+				break;
 		}
+
+		Token *close_store = GetNextCharToken(')', L')');
+
+		Token::Remove(store, close_store);
 	}
 
+	by->end = GetLastToken();
+
 	return true;
 }
 
-// Oracle PARTITION or SUBPARTITION definition clause 
-bool SqlParser::ParseOraclePartition(Token *partition, Token *subpartition)
+// Oracle PARTITION or SUBPARTITION definition clause, returns the number of definitions 
+int SqlParser::ParseOraclePartition(Token *partition, Token *subpartition, OraclePartitions *parts)
 {
 	// Both partition and subpartition parameters can be NULL for LOCAL partitioned indexes
 	Token *open = GetNextCharToken('(', L'(');
 
     if(open == nullptr)
-		return false;
+		return 0;
 
-	bool exists = false;
+	int count = 0;
 
 	// List of partition/subpartition definitions can be specified
 	while(true)
@@ -516,26 +563,24 @@ bool SqlParser::ParseOraclePartition(Token *partition, Token *subpartition)
         if(name == nullptr)
 			break;
 
-		exists = true;
+		count++;
 
 		// VALUES clause (optional for example for index)
 		Token *values = GetNextWordToken("VALUES", L"VALUES", 6);
 
         if(values != nullptr)
 		{
-			// LESS THAN
-            /*Token *less */(void) GetNextWordToken("LESS", L"LESS", 4);
-            /*Token *than */(void) GetNextWordToken("THAN", L"THAN", 4);
+			// VALUES LESS THAN for range, VALUES for list partitions
+            Token *less = GetNextWordToken("LESS", L"LESS", 4);
 
-			/*Token *open_range */ (void) GetNextCharToken('(', L'(');
-			Token *exp = GetNextToken();
-
-			// Expression to define the partition range			
-            ParseExpression(exp);
-
-			Token *close_range = GetNextCharToken(')', L')');
+            if(less != nullptr)
+				/*Token *than */(void) GetNextWordToken("THAN", L"THAN", 4);
+			else
+            if(partition != nullptr && parts != nullptr)
+				parts->list_values.push_back(values);
 
-            if(close_range == nullptr)
+			// Only partition values are converted, subpartitioning by range and list is not supported in MySQL
+            if(ParseOraclePartitionValues((partition != nullptr) ? parts : nullptr) == false)
 				break;
 		}
 
@@ -544,7 +589,7 @@ bool SqlParser::ParseOraclePartition(Token *partition, Token *subpartition)
 
 		// Now parse SUBPARTITION definitions for the current PARTITION recursively
         if(partition != nullptr && subpartition != nullptr)
-            ParseOraclePartition(nullptr, subpartition);
+            ParseOraclePartition(nullptr, subpartition, parts);
 
 		// Partition definitions are comma separated
 		Token *comma = GetNextCharToken(',', L',');
@@ -555,340 +600,1562 @@ bool SqlParser::ParseOraclePartition(Token *partition, Token *subpartition)
 
 	Token *close = GetNextCharToken(')', L')');
 
-	// PARTITION BY was removed, so remove partition definitions as well
-    if(partition != nullptr && partition->IsRemoved())
-		Token::Remove(open, close);
-	else
-	// SUBPARTITION BY was removed
-    if(partition == nullptr && subpartition != nullptr && subpartition->IsRemoved())
-		Token::Remove(open, close);
+	// Subpartition definitions are removed, and only the number of subpartitions is specified in MySQL
+    if(partition == nullptr && parts != nullptr && close != nullptr)
+	{
+		parts->subpart_defs.push_back(std::make_pair(open, close));
 
-	return exists;
+        if(count > parts->subpart_count)
+			parts->subpart_count = count;
+	}
+
+	return count;
 }
 
-// Oracle and PostgreSQL variable declaration block
-bool SqlParser::ParseOracleVariableDeclarationBlock(Token *declare)
+// Oracle partition VALUES LESS THAN (...) or VALUES (...) list
+bool SqlParser::ParseOraclePartitionValues(OraclePartitions *parts)
 {
-	bool exists = false;
+	Token *open = GetNextCharToken('(', L'(');
 
-	// declare points to AS keyword for outer procedural block
+    if(open == nullptr)
+		return false;
 
-	// Remove DECLARE for SQL Server, MySQL as it will be specified before each variable
-	if(Token::Compare(declare, "DECLARE", L"DECLARE", 7) == true)
+	while(true)
 	{
-		Token::Remove(declare);
-    }
+		Token *exp = GetNextToken();
 
-    // Last token of last declared variable (not cursor) in the current PL/SQL DECLARE block
-    Token *last_declare_var = nullptr;
+        if(exp == nullptr)
+			break;
 
-    // Cursor definitions
-	ListWM cursors;
+		PartitionValue value;
+		value.start = exp;
 
-	// Process declaration statements until BEGIN
-	while(true)
-	{
-		// Variable name
-		Token *name = GetNextIdentToken();
+        if(exp->Compare("MAXVALUE", L"MAXVALUE", 8) == true)
+			value.kind = PART_VALUE_MAXVALUE;
+		else
+        if(exp->Compare("DEFAULT", L"DEFAULT", 7) == true)
+			value.kind = PART_VALUE_DEFAULT;
+		else
+		{
+			// Expression to define the partition range or list value
+			ParseExpression(exp);
+		}
 
-        if(name == nullptr)
+		value.end = GetLastToken();
+
+        if(value.kind != PART_VALUE_MAXVALUE && value.kind != PART_VALUE_DEFAULT)
+			value.kind = GetOraclePartitionValueKind(value.start, value.end, value.literal);
+
+        if(parts != nullptr)
+			parts->values.push_back(value);
+
+		Token *comma = GetNextCharToken(',', L',');
+
+        if(comma == nullptr)
 			break;
+	}
 
-		// Exit if BEGIN matched, or PROCEDURE/FUNCTION in package body
-        if(TOKEN_CMP(name, "BEGIN") || (_spl_package != nullptr && (TOKEN_CMP(name, "PROCEDURE") || TOKEN_CMP(name, "FUNCTION"))))
+	Token *close = GetNextCharToken(')', L')');
+
+	return (close != nullptr);
+}
+
+// Get the kind of partition value, and the literal for dates
+int SqlParser::GetOraclePartitionValueKind(Token *start, Token *end, std::string &literal)
+{
+	// Source tokens of the value, TO_DATE('value', 'format', 'nls') has most tokens
+	Token *tokens[10];
+	int count = 0;
+
+	for(Token *token = start; token != nullptr; token = token->next)
+	{
+        if(token->IsBlank() == false && token->type != TOKEN_COMMENT)
 		{
-			PushBack(name);
-			break;
+			if(count == 10)
+				return PART_VALUE_OTHER;
+
+			tokens[count++] = token;
 		}
 
-		// CURSOR cur IS SELECT definition, PRAGMA or forward declaration for exception
-		if(ParseOracleCursorDeclaration(name, &cursors) || ParseOracleObjectType(name) ||
-			ParseOraclePragma(name) || ParseOracleException(name))
+		if(token == end)
+			break;
+	}
+
+	bool time = false;
+
+	// Number, string or NULL
+	if(count == 1)
+	{
+		if(tokens[0]->type == TOKEN_STRING)
+			return PART_VALUE_STRING;
+
+		if(tokens[0]->IsNumeric() == true)
+			return PART_VALUE_NUMBER;
+
+		if(tokens[0]->Compare("NULL", L"NULL", 4) == true)
+			return PART_VALUE_NULL;
+	}
+	else
+	// Negative number
+	if(count == 2 && (tokens[0]->Compare('-', L'-') == true || tokens[0]->Compare('+', L'+') == true) && tokens[1]->IsNumeric() == true)
+		return PART_VALUE_NUMBER;
+	else
+	// DATE 'YYYY-MM-DD' and TIMESTAMP 'YYYY-MM-DD HH24:MI:SS' literals
+	if(count == 2 && tokens[1]->type == TOKEN_STRING && 
+		(tokens[0]->Compare("DATE", L"DATE", 4) == true || tokens[0]->Compare("TIMESTAMP", L"TIMESTAMP", 9) == true))
+	{
+		if(GetOracleDateLiteral(tokens[1], nullptr, literal, &time) == true)
+			return time ? PART_VALUE_DATETIME : PART_VALUE_DATE;
+	}
+	else
+	// TO_DATE('value', 'format'), the third NLS parameter is ignored
+	if((count == 6 || count == 8) && tokens[0]->Compare("TO_DATE", L"TO_DATE", 7) == true && 
+		tokens[1]->Compare('(', L'(') == true && tokens[2]->type == TOKEN_STRING && 
+		tokens[3]->Compare(',', L',') == true && tokens[4]->type == TOKEN_STRING && tokens[count - 1]->Compare(')', L')') == true)
+	{
+		if(GetOracleDateLiteral(tokens[2], tokens[4], literal, &time) == true)
+			return time ? PART_VALUE_DATETIME : PART_VALUE_DATE;
+	}
+
+	return PART_VALUE_OTHER;
+}
+
+// Get 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MI:SS' literal for Oracle date string and format, ISO format if format is not set
+bool SqlParser::GetOracleDateLiteral(Token *value, Token *format, std::string &literal, bool *time)
+{
+	static const char *months[] = { "JANUARY", "FEBRUARY", "MARCH", "APRIL", "MAY", "JUNE", "JULY", 
+		"AUGUST", "SEPTEMBER", "OCTOBER", "NOVEMBER", "DECEMBER" };
+
+    if(value == nullptr || value->str == nullptr || value->len < 2)
+		return false;
+
+	// Skip quotes
+	const char *v = value->str + 1;
+	const char *v_end = value->str + value->len - 1;
+
+	const char *f = "YYYY-MM-DD HH24:MI:SS.FF";
+	const char *f_end = f + strlen(f);
+
+	// ISO literal can end after any element
+	bool iso = (format == nullptr);
+
+    if(format != nullptr)
+	{
+        if(format->str == nullptr || format->len < 2)
+			return false;
+
+		f = format->str + 1;
+		f_end = format->str + format->len - 1;
+	}
+
+	int year = -1, month = -1, day = -1, hour = 0, minute = 0, second = 0;
+	bool fraction = false;
+
+	while(f < f_end)
+	{
+		// Leading and trailing spaces are allowed in the value
+		while(v < v_end && *v == ' ')
+			v++;
+
+        if(*f == ' ')
 		{
-			exists = true;
+			f++;
 			continue;
 		}
 
-		_spl_variables.Add(name);
-		exists = true;
+        if(iso && v == v_end)
+			break;
 
-		// Add DECLARE before name in SQL Server, Sybase and MySQL
-		Prepend(name, "DECLARE ", L"DECLARE ", 8, declare);
+		int *field = nullptr;
+		int digits = 2;
+		bool sign = false;
 
-		// Optional CONSTANT
-        /*Token *constant */(void) TOKEN_GETNEXTW("CONSTANT");
+        if(_strnicmp(f, "SYYYY", 5) == 0)
+		{
+			field = &year; digits = 4; sign = true; f += 5;
+		}
+		else
+        if(_strnicmp(f, "YYYY", 4) == 0 || _strnicmp(f, "RRRR", 4) == 0)
+		{
+			field = &year; digits = 4; f += 4;
+		}
+		else
+        if(_strnicmp(f, "MONTH", 5) == 0 || _strnicmp(f, "MON", 3) == 0)
+		{
+			f += (_strnicmp(f, "MONTH", 5) == 0) ? 5 : 3;
 
-		Token *data_type = GetNextToken();
+			const char *name = v;
 
-		// Check and resolve Oracle %TYPE and %ROWTYPE variable
-		bool typed = ParseTypedVariable(name, data_type);
+            while(v < v_end && ((*v >= 'a' && *v <= 'z') || (*v >= 'A' && *v <= 'Z')))
+				v++;
 
-		// Get the parameter data type
-		if(typed == false)
-			ParseDataType(data_type, SQL_SCOPE_VAR_DECL);
+			// Full or 3-letter month name
+            for(int i = 0; i < 12 && (v - name) >= 3; i++)
+			{
+                if((size_t)(v - name) <= strlen(months[i]) && _strnicmp(name, months[i], v - name) == 0)
+					month = i + 1;
+			}
 
-		// Propagate data type to variable
-		name->data_type = data_type->data_type;
-		name->data_subtype = data_type->data_subtype;
+            if(month == -1)
+				return false;
 
-        /*Token *data_type_end*/(void) GetLastToken();
+			continue;
+		}
+		else
+        if(_strnicmp(f, "MM", 2) == 0)
+		{
+			field = &month; f += 2;
+		}
+		else
+        if(_strnicmp(f, "DD", 2) == 0)
+		{
+			field = &day; f += 2;
+		}
+		else
+        if(_strnicmp(f, "HH24", 4) == 0)
+		{
+			field = &hour; f += 4;
+		}
+		else
+        if(_strnicmp(f, "HH", 2) == 0)
+		{
+			field = &hour; f += 2;
+		}
+		else
+        if(_strnicmp(f, "MI", 2) == 0)
+		{
+			field = &minute; f += 2;
+		}
+		else
+        if(_strnicmp(f, "SS", 2) == 0)
+		{
+			field = &second; f += 2;
+		}
+		else
+		// Fraction of seconds must be zero
+        if(_strnicmp(f, "FF", 2) == 0)
+		{
+			f += 2;
 
-		// Optional initialization value := value in Oracle and = value in PostgreSQL
-		Token *colon = GetNextCharToken(':', L':');
-		Token *equal = GetNextCharToken('=', L'=');
-        Token *default_ = nullptr;
+            while(f < f_end && *f >= '0' && *f <= '9')
+				f++;
 
-		// DEFAULT keyword can be also specified
-        if(equal == nullptr)
-			default_ = GetNext("DEFAULT", L"DEFAULT", 7);
+            while(v < v_end && *v >= '0' && *v <= '9')
+			{
+                if(*v != '0')
+					fraction = true;
 
-        if(colon != nullptr || equal != nullptr || default_ != nullptr)
+				v++;
+			}
+
+			continue;
+		}
+		else
+		// Delimiter
+        if(!((*f >= 'a' && *f <= 'z') || (*f >= 'A' && *f <= 'Z') || (*f >= '0' && *f <= '9')))
 		{
-			Token *exp = GetNextToken();
+            if(v == v_end || *v != *f)
+				return false;
 
-			// Parse initialization expression
-			ParseExpression(exp);
+			f++;
+			v++;
 
-			// In MySQL use DEFAULT keyword
-            if(equal != nullptr)
-			{
-				Token::Change(equal, " DEFAULT ", L" DEFAULT ", 9);
-				Token::Remove(colon);
-			}
+			continue;
 		}
+		else
+			return false;
 
-		// ; after each declaration
-		Token *semi = GetNextCharToken(';', L';');
+        if(sign && v < v_end && (*v == '-' || *v == '+'))
+		{
+            if(*v == '-')
+				return false;
 
-        last_declare_var = Nvl(semi, GetLastToken());
+			v++;
+		}
 
-        // Check if we are in the outer BEGIN block
-        if(_spl_begin_blocks.GetCount() == 0)
+		int num = 0;
+		int len = 0;
+
+        while(v < v_end && *v >= '0' && *v <= '9' && len < digits)
 		{
-            _spl_last_outer_declare_var = last_declare_var;
-			_spl_last_outer_declare_varname = name;
+			num = num * 10 + (*v - '0');
+			v++;
+			len++;
 		}
 
-        if(semi == nullptr)
-			break;
+        if(len == 0 || (field == &year && len != 4))
+			return false;
+
+		*field = num;
+	}
+
+	while(v < v_end && *v == ' ')
+		v++;
+
+    if(v != v_end || fraction)
+		return false;
+
+    if(year < 1 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59)
+		return false;
+
+	char buf[80];
+
+    if(hour != 0 || minute != 0 || second != 0)
+	{
+		sprintf(buf, "'%04d-%02d-%02d %02d:%02d:%02d'", year, month, day, hour, minute, second);
+		*time = true;
+	}
+	else
+	{
+		sprintf(buf, "'%04d-%02d-%02d'", year, month, day);
+		*time = false;
+	}
+
+	literal = buf;
+
+	return true;
+}
+
+// Convert Oracle partitioning clause to MySQL, or remove it if it cannot be converted
+void SqlParser::OracleConvertPartitions(Token *table_name, OraclePartitions *parts)
+{
+    if(parts == nullptr || parts->part.start == nullptr)
+		return;
+
+	Token *last = GetLastToken();
+
+	PartitionsBy &part = parts->part;
+	PartitionsBy &subpart = parts->subpart;
+
+	bool range = TOKEN_CMP(part.type, "RANGE");
+	bool list = TOKEN_CMP(part.type, "LIST");
+	bool hash = TOKEN_CMP(part.type, "HASH");
+
+    if(!range && !list && !hash)
+		parts->error = "Reference and system partitioning removed";
+
+	bool date = false, datetime = false, string = false, number = false, null = false;
+
+	for(size_t i = 0; i < parts->values.size(); i++)
+	{
+		int kind = parts->values[i].kind;
+
+        if(kind == PART_VALUE_DATE)
+			date = true;
+		else
+        if(kind == PART_VALUE_DATETIME)
+			datetime = true;
+		else
+        if(kind == PART_VALUE_STRING)
+			string = true;
+		else
+        if(kind == PART_VALUE_NUMBER)
+			number = true;
+		else
+        if(kind == PART_VALUE_NULL)
+			null = true;
+		else
+        if(kind == PART_VALUE_DEFAULT)
+			parts->error = "List partitioning with DEFAULT partition removed";
+		else
+        if(kind == PART_VALUE_OTHER)
+			parts->error = "Partitioning with bound expressions removed";
+	}
+
+    if(list && part.columns.size() > 1)
+		parts->error = "Multi-column list partitioning removed";
+
+	// Only HASH subpartitions of RANGE and LIST partitions are supported in MySQL
+	bool sub = (subpart.start != nullptr);
+
+    if(sub && (hash || !TOKEN_CMP(subpart.type, "HASH")))
+	{
+		CREATE_TAB_STMS_STATS("Subpartitioning removed")
+		sub = false;
+	}
+
+	// All unique keys must include all columns of the partitioning expression
+    if(parts->error == nullptr)
+	{
+		std::vector<Token*> columns = part.columns;
+
+        if(sub)
+			columns.insert(columns.end(), subpart.columns.begin(), subpart.columns.end());
+
+        if(OracleCheckPartitionKeys(table_name, columns) == false)
+			parts->error = "Partitioning with unique key not including partition columns removed";
+	}
+
+    if(parts->error != nullptr)
+	{
+		CREATE_TAB_STMS_STATS(parts->error)
+
+		Token::Remove(part.start, last);
+		return;
+	}
+
+	// Subpartitions
+    if(subpart.start != nullptr)
+	{
+		for(size_t i = 0; i < parts->subpart_defs.size(); i++)
+		{
+			Token *first = parts->subpart_defs[i].first;
+			Token *second = parts->subpart_defs[i].second;
+
+			Token::Remove(first, second);
+
+			Token *prev = first->prev;
+			bool newline = false;
+
+            while(prev != nullptr && (prev->IsBlank() == true || prev->type == TOKEN_COMMENT))
+			{
+                if(prev->Compare('\n', L'\n') == true)
+					newline = true;
+
+				prev = prev->prev;
+			}
+
+			Token *comma = Token::SkipSpaces(second->next);
+
+			// Keep the comma on the line of the previous partition when definitions are on separate lines
+            if(newline == true && prev != nullptr && TOKEN_CMPC(comma, ','))
+			{
+				Token::Remove(comma);
+				AppendNoFormat(prev, ",", L",", 1);
+			}
+		}
+
+        if(sub == false)
+			Token::Remove(subpart.start, subpart.end);
+		else
+		{
+            if(subpart.columns.size() != 1 || OracleIsIntegerColumn(table_name, subpart.columns[0]) == false)
+				TOKEN_CHANGE(subpart.type, "KEY");
+
+            if(subpart.count == nullptr && parts->subpart_count > 0)
+			{
+				char num[32];
+				sprintf(num, " SUBPARTITIONS %d", parts->subpart_count);
+
+				AppendNoFormat(subpart.end, num, nullptr, strlen(num));
+			}
+
+			CREATE_TAB_STMS_STATS("SUBPARTITION BY HASH")
+		}
+	}
+
+    if(range)
+	{
+		bool to_days = (part.columns.size() == 1 && date && !datetime && !string && !number);
+		bool columns = (!to_days && (part.columns.size() > 1 || datetime || string || date));
+
+		// Date bounds of a single column
+        if(to_days)
+		{
+			PrependNoFormat(part.columns[0], "TO_DAYS(", L"TO_DAYS(", 8);
+			AppendNoFormat(part.columns[0], ")", L")", 1);
+		}
+		else
+		// Bounds are literals for multiple columns, strings and date with time
+        if(columns)
+			AppendNoFormat(part.type, " COLUMNS", L" COLUMNS", 8);
+
+		for(size_t i = 0; i < parts->values.size(); i++)
+		{
+			PartitionValue &value = parts->values[i];
+
+            if(value.kind != PART_VALUE_DATE && value.kind != PART_VALUE_DATETIME)
+				continue;
+
+			std::string literal = to_days ? "TO_DAYS(" + value.literal + ")" : value.literal;
+			TokenStr str(literal);
+
+			Token::ChangeNoFormat(value.start, str);
+
+            if(value.start != value.end)
+				Token::Remove(value.start->next, value.end);
+		}
+
+		CREATE_TAB_STMS_STATS("PARTITION BY RANGE")
+	}
+	else
+    if(list)
+	{
+		// Integer values are required unless LIST COLUMNS is used
+        if(date || datetime || string || (!number && !null))
+			AppendNoFormat(part.type, " COLUMNS", L" COLUMNS", 8);
+
+		for(size_t i = 0; i < parts->list_values.size(); i++)
+			AppendNoFormat(parts->list_values[i], " IN", L" IN", 3);
+
+		for(size_t i = 0; i < parts->values.size(); i++)
+		{
+			PartitionValue &value = parts->values[i];
+
+            if(value.kind != PART_VALUE_DATE && value.kind != PART_VALUE_DATETIME)
+				continue;
+
+			TokenStr str(value.literal);
+
+			Token::ChangeNoFormat(value.start, str);
+
+            if(value.start != value.end)
+				Token::Remove(value.start->next, value.end);
+		}
+
+		CREATE_TAB_STMS_STATS("PARTITION BY LIST")
+	}
+	else
+    if(hash)
+	{
+		// HASH requires an integer expression, KEY uses the internal hash function for any columns
+        if(part.columns.size() != 1 || OracleIsIntegerColumn(table_name, part.columns[0]) == false)
+			TOKEN_CHANGE(part.type, "KEY");
+
+		CREATE_TAB_STMS_STATS("PARTITION BY HASH")
+	}
+}
+
+// Check that all primary and unique keys of the table include the columns
+bool SqlParser::OracleCheckPartitionKeys(Token *table_name, std::vector<Token*> &columns)
+{
+	std::vector<std::vector<Token*> > keys;
+
+	// CREATE TABLE AS SELECT does not define keys
+    if(GetTableKeys(table_name, keys) == false)
+		return true;
+
+	for(size_t k = 0; k < keys.size(); k++)
+	{
+		for(size_t i = 0; i < columns.size(); i++)
+		{
+			bool found = false;
+
+			for(size_t j = 0; j < keys[k].size() && !found; j++)
+				found = Token::Compare(columns[i], keys[k][j]);
+
+            if(found == false)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Check whether the column of the table has an integer data type
+bool SqlParser::OracleIsIntegerColumn(Token *table_name, Token *column)
+{
+    if(table_name == nullptr || column == nullptr)
+		return false;
+
+	std::unordered_map<Token*, std::vector<Book*> >::iterator t = _table_column_books.find(table_name);
+
+    if(t == _table_column_books.end())
+		return false;
+
+	for(size_t i = 0; i < t->second.size(); i++)
+	{
+		Book *book = t->second[i];
+
+        if(Token::Compare(book->name2, column) == false)
+			continue;
+
+		Token *type = Token::SkipSpaces(book->name2->next);
+
+        if(type == nullptr || type->data_type != TOKEN_DT_NUMBER)
+			return false;
+
+        if(type->data_subtype == TOKEN_DT2_INT)
+			return true;
+
+		return Token::CompareTarget(type, "INT", L"INT", 3) || Token::CompareTarget(type, "BIGINT", L"BIGINT", 6) ||
+			Token::CompareTarget(type, "SMALLINT", L"SMALLINT", 8) || Token::CompareTarget(type, "TINYINT", L"TINYINT", 7) ||
+			Token::CompareTarget(type, "MEDIUMINT", L"MEDIUMINT", 9);
+	}
+
+	return false;
+}
+
+// Check whether all columns of the table have data types supported by MEMORY engine
+bool SqlParser::OracleIsMemoryEngineTable(Token *table_name)
+{
+    if(table_name == nullptr)
+		return false;
+
+	// LOBs, long types, JSON, XML and spatial types (source or target names)
+	static const char *unsupported[] = { "TEXT", "BLOB", "LONG", "JSON", "XML", "BFILE", "GEOMETRY", nullptr };
+
+	std::unordered_map<Token*, std::vector<Book*> >::iterator t = _table_column_books.find(table_name);
+
+    if(t == _table_column_books.end())
+		return false;
+
+	bool columns = false;
+
+	for(size_t c = 0; c < t->second.size(); c++)
+	{
+		Book *book = t->second[c];
+
+		Token *type = Token::SkipSpaces(book->name2->next);
+
+        if(type == nullptr)
+			return false;
+
+		std::string name;
+		GetTargetText(type, type, name);
+
+		for(size_t i = 0; i < name.length(); i++)
+			name[i] = (char)toupper(name[i]);
+
+		for(int i = 0; unsupported[i] != nullptr; i++)
+		{
+            if(name.find(unsupported[i]) != std::string::npos)
+				return false;
+		}
+
+		columns = true;
+	}
+
+	return columns;
+}
+
+// Oracle and PostgreSQL variable declaration block
+bool SqlParser::ParseOracleVariableDeclarationBlock(Token *declare)
+{
+	bool exists = false;
+
+	// declare points to AS keyword for outer procedural block
+
+	// Remove DECLARE for SQL Server, MySQL as it will be specified before each variable
+	if(Token::Compare(declare, "DECLARE", L"DECLARE", 7) == true)
+	{
+		Token::Remove(declare);
+    }
+
+    // Last token of last declared variable (not cursor) in the current PL/SQL DECLARE block
+    Token *last_declare_var = nullptr;
+
+    // Cursor definitions
+	ListWM cursors;
+
+	// Process declaration statements until BEGIN
+	while(true)
+	{
+		// Variable name
+		Token *name = GetNextIdentToken();
+
+        if(name == nullptr)
+			break;
+
+		// Exit if BEGIN matched, or PROCEDURE/FUNCTION in package body
+        if(TOKEN_CMP(name, "BEGIN") || (_spl_package != nullptr && (TOKEN_CMP(name, "PROCEDURE") || TOKEN_CMP(name, "FUNCTION"))))
+		{
+			PushBack(name);
+			break;
+		}
+
+		// CURSOR cur IS SELECT definition, PRAGMA or forward declaration for exception
+		if(ParseOracleCursorDeclaration(name, &cursors) || ParseOracleObjectType(name) ||
+			ParseOraclePragma(name) || ParseOracleException(name))
+		{
+			exists = true;
+			continue;
+		}
+
+		_spl->variables.Add(name);
+		exists = true;
+
+		// Add DECLARE before name in SQL Server, Sybase and MySQL
+		Prepend(name, "DECLARE ", L"DECLARE ", 8, declare);
+
+		// Optional CONSTANT
+        /*Token *constant */(void) TOKEN_GETNEXTW("CONSTANT");
+
+		Token *data_type = GetNextToken();
+
+		// Check and resolve Oracle %TYPE and %ROWTYPE variable
+		bool typed = ParseTypedVariable(name, data_type);
+
+		// Get the parameter data type
+		if(typed == false)
+			ParseDataType(data_type, SQL_SCOPE_VAR_DECL);
+
+		// Propagate data type to variable
+		name->data_type = data_type->data_type;
+		name->data_subtype = data_type->data_subtype;
+
+        /*Token *data_type_end*/(void) GetLastToken();
+
+		// Optional initialization value := value in Oracle and = value in PostgreSQL
+		Token *colon = GetNextCharToken(':', L':');
+		Token *equal = GetNextCharToken('=', L'=');
+        Token *default_ = nullptr;
+
+		// DEFAULT keyword can be also specified
+        if(equal == nullptr)
+			default_ = GetNext("DEFAULT", L"DEFAULT", 7);
+
+        if(colon != nullptr || equal != nullptr || default_ != nullptr)
+		{
+			Token *exp = GetNextToken();
+
+			// Parse initialization expression
+			ParseExpression(exp);
+
+			// In MySQL use DEFAULT keyword
+            if(equal != nullptr)
+			{
+				Token::Change(equal, " DEFAULT ", L" DEFAULT ", 9);
+				Token::Remove(colon);
+			}
+		}
+
+		// ; after each declaration
+		Token *semi = GetNextCharToken(';', L';');
+
+        last_declare_var = Nvl(semi, GetLastToken());
+
+        // Check if we are in the outer BEGIN block
+        if(_spl->begin_blocks.GetCount() == 0)
+		{
+            _spl->last_outer_declare_var = last_declare_var;
+			_spl->last_outer_declare_varname = name;
+		}
+
+        if(semi == nullptr)
+			break;
+	}
+
+	// Generate variables for cursor parameters 
+    if(exists == true && _spl->cursor_params.GetCount() > 0)
+	{
+        for(ListwmItem *i = _spl->cursor_params.GetFirst(); i != nullptr; i = i->next)
+		{
+			Token *cursor = (Token*)i->value;
+			Token *name = (Token*)i->value2;
+			Token *param = (Token*)i->value3;
+			Token *data_type = (Token*)i->value4;
+
+			Prepend(cursor, "DECLARE ", L"DECLARE ", 8);
+
+			// The target value of parameter already contains variable name
+			PrependCopy(cursor, param);
+			Prepend(cursor, " ", L" ", 1);
+			
+			Token *last_added = PrependCopy(cursor, data_type);
+
+			// The lengths for some cursor variables can be set later
+			_spl->cursor_vars.Add(name, param, last_added);
+
+            if(i->next != nullptr)
+				Prepend(cursor, ";\n", L";\n", 2);
+			else
+				Prepend(cursor, ";\n\n", L";\n\n", 3);
+		}
+	}
+
+    // Cursors must be after all variables in MySQL and MariaDB, so move them if required
+    if(exists == true && last_declare_var != nullptr &&
+        cursors.GetCount() > 0)
+	{
+        for(ListwmItem *i = cursors.GetFirst(); i != nullptr; i = i->next)
+		{
+            Token *cursor = (Token*)i->value;
+			Token *semi = (Token*)i->value2;
+
+            // Cursor goes before the last variable
+            if(cursor->remain_size > last_declare_var->remain_size)
+            {
+                AppendNewlineCopy(last_declare_var, cursor, semi, 2, false);
+                Token::Remove(cursor, semi);
+            }
+        }
+    }
+
+	_declare_format = declare;
+	_spl->last_declare = GetLastToken();
+
+	return exists;
+}
+
+// CURSOR cur(params) IS SELECT definition
+bool SqlParser::ParseOracleCursorDeclaration(Token *cursor, ListWM *cursors)
+{
+    if(cursor == nullptr)
+		return false;
+
+	if(cursor->Compare("CURSOR", L"CURSOR", 6) == false)
+		return false;
+
+	Token *name = GetNextIdentToken();
+
+    if(name == nullptr)
+		return false;
+
+	_spl->declared_cursors.Add(name);
+	_spl->current_declaring_cursor = name;
+	_spl->current_declaring_cursor_uses_vars = false;
+
+	// Optional cursor parameters
+	Token *open = GetNextCharToken('(', L'(');
+    Token *close = nullptr;
+
+	bool params_exist = false;
+
+    if(open != nullptr)
+	{
+		// Cursor parameters are used as local variable in the following SELECT
+		EnterLocalVariablesBlock();
+
+		params_exist = true;
+
+		while(true)
+		{
+			// Parameter name
+			Token *param = GetNextIdentToken();
+
+            if(param == nullptr)
+				break;
+
+			// Optional IN keyword
+			/*Token *in */ (void) GetNextWordToken("IN", L"IN", 2);
+
+			Token *data_type = GetNextToken();
+
+			// Check and resolve Oracle %TYPE variable
+			bool typed = ParseTypedVariable(param, data_type);
+
+			// Get the parameter data type
+			if(!typed)
+				ParseDataType(data_type, SQL_SCOPE_CURSOR_PARAMS);
+
+			// SQL Server does support parameters, and cursor get all variable values during declaration,
+			// not during OPEN cursor, so DECLARE is moved before OPEN 
+			// MySQL also does not support cursor parameters
+
+			// Generate variable not substitute with actual values (especially if they are constants)
+			// to increase chance that SQL execution plan is re-used
+
+			// Define variable name to use instead of parameter 
+			TokenStr str;
+
+			str.Append(name);
+			str.Append("_", L"_", 1);
+			str.Append(param);
+				
+			// Save variable name
+			Token::ChangeNoFormat(param, str);
+			Token::Remove(param, data_type);
+
+			// Save information about cursor parameters (variables will be generated for MySQL i.e.)
+			_spl->cursor_params.Add(cursor, name, param, data_type);
+
+			_spl->variables.Add(param);
+
+			// Next must be comma if list continues
+			Token *comma = GetNextCharToken(',', L',');
+
+            if(comma == nullptr)
+				break;
+
+			Token::Remove(comma);
+		}
+
+		close = GetNextCharToken(')', L')');
+
+		Token::Remove(open);
+		Token::Remove(close);
+	}
+
+	Token *is = GetNextWordToken("IS", L"IS", 2);
+
+	// FOR in SQL Server, MySQL
+	Token::Change(is, "FOR", L"FOR", 3);
+
+	// For SQL Server, MySQL change to DECLARE name CURSOR
+	Token::Change(cursor, "DECLARE", L"DECLARE", 7);
+	Append(name, " CURSOR", L"CURSOR", 7, cursor); 
+	
+
+	// SELECT can be optionally enclosed with ()
+	Token *open_sel = TOKEN_GETNEXT('(');
+	//Token *select = GetNextSelectStartKeyword();
+
+    //if(select != nullptr)
+	//{
+    //	ParseSelectStatement(select, 0, SQL_SEL_CURSOR, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+	//
+	//	_spl->declared_cursors_select.Add(name, select, GetLastToken());
+	//}
+
+	/*Token *close_sel */ TOKEN_GETNEXTP(open_sel, ')');
+
+	// ; after each declaration
+	Token *semi = GetNextCharToken(';', L';');
+
+    // Save cursor definitions for the current declaration block
+    if(cursors != nullptr)
+        cursors->Add(cursor, GetLastToken(semi));
+
+
+	// End of scope for cursor parameters
+	if(params_exist == true)
+		LeaveLocalVariablesBlock();
+
+    _spl->current_declaring_cursor = nullptr;
+
+	return true;
+}
+
+// Oracle object type declaration
+bool SqlParser::ParseOracleObjectType(Token *type)
+{
+    if(type == nullptr)
+		return false;
+
+	if(!TOKEN_CMP(type, "TYPE"))
+		return false;
+
+	Token *name = GetNextToken();
+
+    if(name == nullptr)
+		return false;
+
+	Token *is = TOKEN_GETNEXTW("IS");
+	Token *table = TOKEN_GETNEXTWP(is, "TABLE");
+	Token *of = TOKEN_GETNEXTWP(table, "OF");
+
+	// TYPE typeTab IS TABLE OF data_type INDEX BY BINARY_INTEGER;
+    if(table != nullptr && of != nullptr)
+	{
+		Token *data_type = GetNextToken();
+		ParseDataType(data_type, SQL_SCOPE_OBJ_TYPE_DECL);
+
+		_spl_obj_type_table.Add(name, data_type);
+
+		Token *index = TOKEN_GETNEXTW("INDEX");
+		Token *by = TOKEN_GETNEXTWP(index, "BY");
+        /*Token *binary_integer */(void) TOKEN_GETNEXTWP(by, "BINARY_INTEGER");
+
+        /*Token *semi */(void) TOKEN_GETNEXT(';');
+
+	}
+
+	return true;
+}
+
+// Register TABLE OF and VARRAY OF types declared before the procedure body
+void SqlParser::OracleCollectionTypes(Token *begin)
+{
+    if(begin == nullptr)
+		return;
+
+	Token *start = begin;
+
+	// Declarations follow PROCEDURE or FUNCTION
+	while(start->prev != nullptr && TOKEN_CMP(start, "PROCEDURE") == false && TOKEN_CMP(start, "FUNCTION") == false)
+		start = start->prev;
+
+	for(Token *token = start; token != nullptr && token != begin; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMP(token, "TYPE") == false)
+			continue;
+
+		// TYPE name IS TABLE OF data_type or TYPE name IS VARRAY(n) OF data_type
+		Token *name = GetNextPatternToken(token);
+		Token *is = GetNextPatternToken(name);
+		Token *table = GetNextPatternToken(is);
+		Token *of = GetNextPatternToken(table);
+
+        if(TOKEN_CMP(is, "IS") == false && TOKEN_CMP(is, "AS") == false)
+			continue;
+
+        if(TOKEN_CMP(table, "VARRAY") && TOKEN_CMPC(of, '('))
+			of = GetNextPatternToken(GetClosingParenthesis(of, begin));
+
+        if((TOKEN_CMP(table, "TABLE") || TOKEN_CMP(table, "VARRAY")) && TOKEN_CMP(of, "OF"))
+			_spl_obj_type_table.Add(name, GetNextPatternToken(of));
+	}
+}
+
+// Check whether the collection variable declared before the procedure body holds records, false if its type is not known
+bool SqlParser::OracleIsRecordCollection(Token *var, Token *begin, bool *record)
+{
+    if(var == nullptr || begin == nullptr || record == nullptr)
+		return false;
+
+	Token *start = begin;
+
+	while(start->prev != nullptr && TOKEN_CMP(start, "PROCEDURE") == false && TOKEN_CMP(start, "FUNCTION") == false)
+		start = start->prev;
+
+	Token *type = nullptr;
+	Token *prev = nullptr;
+
+	// var type_name;
+	for(Token *token = start; token != nullptr && token != begin; token = GetNextPatternToken(token))
+	{
+        if(Token::Compare(token, var) == true && (TOKEN_CMPC(prev, ';') || TOKEN_CMP(prev, "IS") || TOKEN_CMP(prev, "AS")))
+			type = GetNextPatternToken(token);
+
+		prev = token;
+	}
+
+	Token *data_type = nullptr;
+
+	// The type of this procedure is registered last
+	for(ListwmItem *item = _spl_obj_type_table.GetFirst(); item != nullptr && type != nullptr; item = item->next)
+	{
+        if(Token::Compare((Token*)item->value, type) == true)
+			data_type = (Token*)item->value2;
+	}
+
+    if(data_type == nullptr)
+		return false;
+
+	Token *percent = GetNextPatternToken(data_type);
+
+	// TABLE OF table%ROWTYPE or TABLE OF table.column%TYPE
+    if(TOKEN_CMPC(percent, '%'))
+	{
+		*record = TOKEN_CMP(GetNextPatternToken(percent), "ROWTYPE");
+		return true;
+	}
+
+	*record = false;
+
+	// TYPE data_type IS RECORD
+	for(Token *token = start; token != nullptr && token != begin; token = GetNextPatternToken(token))
+	{
+		Token *name = GetNextPatternToken(token);
+
+        if(TOKEN_CMP(token, "TYPE") && Token::Compare(name, data_type) == true && 
+			TOKEN_CMP(GetNextPatternToken(GetNextPatternToken(name)), "RECORD"))
+			*record = true;
+	}
+
+	return true;
+}
+
+// Convert BULK COLLECT into session temporary tables, and FORALL statements using them to set-based statements
+void SqlParser::OracleBulkOperations(Token *begin, Token *end)
+{
+    if(begin == nullptr)
+		return;
+
+	std::vector<OracleBulkCollect> bulks;
+	std::vector<OracleForall> foralls;
+
+	Token *select = nullptr;
+	int depth = 0;
+
+	for(Token *token = GetNextPatternToken(begin); token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+			depth++;
+		else
+        if(TOKEN_CMPC(token, ')'))
+			depth--;
+		else
+        if(TOKEN_CMPC(token, ';'))
+			select = nullptr;
+		else
+        if(depth == 0 && TOKEN_CMP(token, "SELECT"))
+			select = token;
+		else
+		// SELECT ... BULK COLLECT INTO c1 [, c2 ...] FROM ...; or FETCH cur BULK COLLECT INTO ... [LIMIT n];
+        if(TOKEN_CMP(token, "BULK") && TOKEN_CMP(GetNextPatternToken(token), "COLLECT"))
+		{
+			OracleBulkCollect bulk;
+			bulk.select = select;
+			bulk.bulk = token;
+
+			Token *into = GetNextPatternToken(GetNextPatternToken(token));
+			Token *from = nullptr;
+
+			for(Token *cur = TOKEN_CMP(into, "INTO") ? GetNextPatternToken(into) : nullptr; cur != nullptr && cur != end; 
+				cur = GetNextPatternToken(cur))
+			{
+				bulk.collections.push_back(cur);
+				bulk.into_last = cur;
+
+				from = GetNextPatternToken(cur);
+
+                if(TOKEN_CMPC(from, ',') == false)
+					break;
+
+				cur = from;
+			}
+
+			int level = 0;
+
+			for(Token *cur = from; cur != nullptr && cur != end; cur = GetNextPatternToken(cur))
+			{
+                if(TOKEN_CMPC(cur, '('))
+					level++;
+				else
+                if(TOKEN_CMPC(cur, ')'))
+					level--;
+				else
+                if(TOKEN_CMPC(cur, ';') && level == 0)
+				{
+					bulk.end = cur;
+					break;
+				}
+			}
+
+			bulk.convert = (select != nullptr && TOKEN_CMP(from, "FROM") && bulk.end != nullptr);
+			bulks.push_back(bulk);
+		}
+		else
+        if(TOKEN_CMP(token, "FORALL"))
+		{
+			OracleForall forall;
+
+            if(OracleForallStatement(token, end, bulks, forall) == false)
+				forall.bulk = -1;
+
+			foralls.push_back(forall);
+		}
+	}
+
+    if(bulks.empty())
+		return;
+
+	OracleCollectionTypes(begin);
+
+	// Collections can be used only by BULK COLLECT and FORALL statements converted together
+	size_t f = 0;
+
+	for(Token *token = GetNextPatternToken(begin); token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+		bool skipped = false;
+
+		for(size_t i = 0; i < bulks.size() && !skipped; i++)
+		{
+            if(token == bulks[i].bulk && bulks[i].into_last != nullptr)
+			{
+				token = bulks[i].into_last;
+				skipped = true;
+			}
+		}
+
+		for(; f < foralls.size() && !skipped && token == foralls[f].forall; f++)
+		{
+            if(foralls[f].bulk != -1)
+			{
+				token = foralls[f].end;
+				skipped = true;
+			}
+		}
+
+        if(skipped == true)
+			continue;
+
+		for(int i = GetBulkCollection(bulks, token, (int)bulks.size() - 1, nullptr); i != -1; i = GetBulkCollection(bulks, token, i - 1, nullptr))
+			bulks[i].convert = false;
+	}
+
+	for(size_t i = 0; i < bulks.size(); i++)
+	{
+		OracleBulkCollect &bulk = bulks[i];
+
+        if(bulk.convert == false)
+			continue;
+
+		Token *first = GetNextPatternToken(bulk.select);
+
+        if(TOKEN_CMP(first, "DISTINCT") || TOKEN_CMP(first, "UNIQUE") || TOKEN_CMP(first, "ALL"))
+			first = GetNextPatternToken(first);
+
+		// Last token of each select item, and whether it is an alias
+		Token *item_last = nullptr;
+		Token *item_prev = nullptr;
+		bool star = false;
+		int count = 0;
+		int level = 0;
+
+		for(Token *token = first; token != nullptr && token != bulk.end; token = GetNextPatternToken(token))
+		{
+            if(level == 0 && (TOKEN_CMPC(token, ',') || token == bulk.bulk))
+			{
+                if(item_last == nullptr)
+					break;
+
+                if(TOKEN_CMPC(item_last, '*') || item_last->str[item_last->len - 1] == '*')
+					star = true;
+
+				bulk.items.push_back(item_last);
+				bulk.aliases.push_back(count > 1 && (TOKEN_CMP(item_prev, "AS") || item_prev->chr == 0 || TOKEN_CMPC(item_prev, ')')) && 
+					item_last->chr == 0 && item_last->type != TOKEN_STRING && item_last->type != TOKEN_NUMBER);
+
+                if(token == bulk.bulk)
+					break;
+
+				item_last = nullptr;
+				item_prev = nullptr;
+				count = 0;
+				continue;
+			}
+
+            if(TOKEN_CMPC(token, '('))
+				level++;
+			else
+            if(TOKEN_CMPC(token, ')'))
+				level--;
+
+			item_prev = item_last;
+			item_last = token;
+			count++;
+		}
+
+		// Collection of records is filled by a single INTO variable, use of fields decides when the type is not declared
+		bool declared = (bulk.collections.size() == 1 && OracleIsRecordCollection(bulk.collections[0], begin, &bulk.record));
+
+        if(declared == false && bulk.collections.size() == 1)
+			bulk.record = (star == true || bulk.items.size() > 1);
+
+		for(size_t j = 0; declared == false && bulk.collections.size() == 1 && j < foralls.size(); j++)
+		{
+            if(foralls[j].bulk != (int)i)
+				continue;
+
+			for(size_t k = 0; k < foralls[j].fields.size(); k++)
+				bulk.record = bulk.record || (foralls[j].fields[k] != nullptr);
+
+			bulk.record = bulk.record || foralls[j].whole_record;
+		}
+
+		// Scalar collections are referenced as c(i), collections of records as c(i).field
+		for(size_t j = 0; j < foralls.size(); j++)
+		{
+            if(foralls[j].bulk != (int)i)
+				continue;
+
+			for(size_t k = 0; k < foralls[j].fields.size(); k++)
+			{
+                if(bulk.record != (foralls[j].fields[k] != nullptr || foralls[j].whole_record))
+					bulk.convert = false;
+			}
+		}
+
+		// Each scalar collection holds a single column
+        if(bulk.record == false && (star == true || bulk.items.size() != bulk.collections.size()))
+			bulk.convert = false;
+
+		// Columns of the temporary table
+        if(bulk.record == true)
+			bulk.columns_known = (star == false && GetQueryColumnNames(bulk.select, bulk.bulk, bulk.columns));
+		else
+		{
+			for(size_t j = 0; j < bulk.collections.size(); j++)
+				bulk.columns.push_back(std::string(bulk.collections[j]->str, bulk.collections[j]->len));
+
+			bulk.columns_known = true;
+		}
+
+		std::string table(bulk.collections[0]->str, bulk.collections[0]->len);
+
+		// Check that all FORALL statements can be joined with the temporary table
+		for(size_t j = 0; j < foralls.size() && bulk.convert; j++)
+		{
+            if(foralls[j].bulk != (int)i || foralls[j].whole_record == true)
+				continue;
+
+            if(JoinSetBasedStatement(foralls[j].stmt, foralls[j].end, foralls[j].values, foralls[j].where_, foralls[j].refs_in_where, 
+				table, bulk.columns_known ? &bulk.columns : nullptr, nullptr, nullptr, begin, true) == nullptr)
+				bulk.convert = false;
+		}
+	}
+
+	// Other BULK COLLECT into the same collection is not converted
+	for(bool changed = true; changed; )
+	{
+		changed = false;
+
+		for(size_t i = 0; i < bulks.size(); i++)
+		{
+			for(size_t j = 0; bulks[i].convert == false && j < bulks[i].collections.size(); j++)
+			{
+				for(int k = GetBulkCollection(bulks, bulks[i].collections[j], (int)bulks.size() - 1, nullptr); k != -1; 
+					k = GetBulkCollection(bulks, bulks[i].collections[j], k - 1, nullptr))
+				{
+					changed = changed || bulks[k].convert;
+					bulks[k].convert = false;
+				}
+			}
+		}
 	}
 
-	// Generate variables for cursor parameters 
-    if(exists == true && _spl_cursor_params.GetCount() > 0)
+	for(size_t i = 0; i < bulks.size(); i++)
 	{
-        for(ListwmItem *i = _spl_cursor_params.GetFirst(); i != nullptr; i = i->next)
-		{
-			Token *cursor = (Token*)i->value;
-			Token *name = (Token*)i->value2;
-			Token *param = (Token*)i->value3;
-			Token *data_type = (Token*)i->value4;
-
-			Prepend(cursor, "DECLARE ", L"DECLARE ", 8);
+		OracleBulkCollect &bulk = bulks[i];
 
-			// The target value of parameter already contains variable name
-			PrependCopy(cursor, param);
-			Prepend(cursor, " ", L" ", 1);
-			
-			Token *last_added = PrependCopy(cursor, data_type);
+		if(_stats != nullptr)
+		{
+			StatsSummaryItem ssi(bulk.convert ? STATS_CONV_OK : STATS_CONV_WARN);
+			_stats->ProceduralStatements(bulk.convert ? "BULK COLLECT converted to temporary table" : 
+				"BULK COLLECT not converted to temporary table", &ssi, Nvl(bulk.select, bulk.bulk), Nvl(bulk.end, bulk.bulk));
+		}
 
-			// The lengths for some cursor variables can be set later
-			_spl_cursor_vars.Add(name, param, last_added);
+        if(bulk.convert == false)
+			continue;
 
-            if(i->next != nullptr)
-				Prepend(cursor, ";\n", L";\n", 2);
-			else
-				Prepend(cursor, ";\n\n", L";\n\n", 3);
-		}
-	}
+		std::string table(bulk.collections[0]->str, bulk.collections[0]->len);
 
-    // Cursors must be after all variables in MySQL and MariaDB, so move them if required
-    if(exists == true && last_declare_var != nullptr &&
-        cursors.GetCount() > 0)
-	{
-        for(ListwmItem *i = cursors.GetFirst(); i != nullptr; i = i->next)
+		// Name the select items after the scalar collections
+		for(size_t j = 0; bulk.record == false && j < bulk.items.size(); j++)
 		{
-            Token *cursor = (Token*)i->value;
-			Token *semi = (Token*)i->value2;
+			Token *name = bulk.collections[j];
 
-            // Cursor goes before the last variable
-            if(cursor->remain_size > last_declare_var->remain_size)
-            {
-                AppendNewlineCopy(last_declare_var, cursor, semi, 2, false);
-                Token::Remove(cursor, semi);
-            }
-        }
-    }
+            if(bulk.aliases[j] == true)
+				Token::ChangeNoFormat(bulk.items[j], name->str, name->wstr, name->len);
+			else
+			{
+				std::string as = " AS ";
+				as.append(name->str, name->len);
 
-	_declare_format = declare;
-	_spl_last_declare = GetLastToken();
+				AppendNoFormat(bulk.items[j], as.c_str(), nullptr, as.length());
+			}
+		}
 
-	return exists;
-}
+		// SELECT ... INTO becomes CREATE TEMPORARY TABLE c AS SELECT ...
+		std::string create = "DROP TEMPORARY TABLE IF EXISTS " + table + ";\n" + GetLineIndent(bulk.select) + 
+			"CREATE TEMPORARY TABLE " + table + " AS ";
 
-// CURSOR cur(params) IS SELECT definition
-bool SqlParser::ParseOracleCursorDeclaration(Token *cursor, ListWM *cursors)
-{
-    if(cursor == nullptr)
-		return false;
+		PrependNoFormat(bulk.select, create.c_str(), nullptr, create.length());
 
-	if(cursor->Compare("CURSOR", L"CURSOR", 6) == false)
-		return false;
+		// Remove BULK COLLECT INTO with the spaces after
+		for(Token *token = bulk.bulk; token != nullptr; token = token->next)
+		{
+			Token::Remove(token, false);
 
-	Token *name = GetNextIdentToken();
+            if(token == bulk.into_last)
+				break;
+		}
 
-    if(name == nullptr)
-		return false;
+		// FORALL statements join the temporary table
+		for(size_t j = 0; j < foralls.size(); j++)
+		{
+			OracleForall &forall = foralls[j];
 
-	_spl_declared_cursors.Add(name);
-	_spl_current_declaring_cursor = name;
-	_spl_current_declaring_cursor_uses_vars = false;
+            if(forall.bulk != (int)i)
+				continue;
 
-	// Optional cursor parameters
-	Token *open = GetNextCharToken('(', L'(');
-    Token *close = nullptr;
+			const char *kind = nullptr;
 
-	bool params_exist = false;
+			// INSERT INTO table VALUES c(i) becomes INSERT INTO table SELECT * FROM c
+            if(forall.whole_record == true)
+			{
+				Token::Change(forall.values, "SELECT * FROM", L"SELECT * FROM", 13);
+				kind = "INSERT ... SELECT";
+			}
+			else
+				kind = JoinSetBasedStatement(forall.stmt, forall.end, forall.values, forall.where_, forall.refs_in_where, 
+					table, bulk.columns_known ? &bulk.columns : nullptr, nullptr, nullptr, begin);
 
-    if(open != nullptr)
-	{
-		// Cursor parameters are used as local variable in the following SELECT
-		EnterLocalVariablesBlock();
+			// c(i) becomes c.c for scalar collections, c(i).field becomes c.field
+			for(size_t k = 0; k < forall.refs.size(); k++)
+			{
+				Token *ref = forall.refs[k];
+				Token *open = GetNextPatternToken(ref);
+				Token *index = GetNextPatternToken(open);
+				Token *close = GetNextPatternToken(index);
 
-		params_exist = true;
+				std::string column = table;
 
-		while(true)
-		{
-			// Parameter name
-			Token *param = GetNextIdentToken();
+                if(bulk.record == false)
+				{
+					column += ".";
+					column.append(ref->str, ref->len);
+				}
 
-            if(param == nullptr)
-				break;
+				Token::ChangeNoFormat(ref, column.c_str(), nullptr, column.length());
+				Token::Remove(open);
+				Token::Remove(index);
+				Token::Remove(close);
+			}
 
-			// Optional IN keyword
-			/*Token *in */ (void) GetNextWordToken("IN", L"IN", 2);
+			// Remove FORALL ... with the indent of the statement
+			for(Token *token = forall.forall; token != nullptr; token = token->next)
+			{
+				Token::Remove(token, false);
 
-			Token *data_type = GetNextToken();
+                if(token == forall.stmt->prev)
+					break;
+			}
 
-			// Check and resolve Oracle %TYPE variable
-			bool typed = ParseTypedVariable(param, data_type);
+			if(_stats != nullptr)
+			{
+				std::string value = std::string("FORALL rewritten to ") + kind;
 
-			// Get the parameter data type
-			if(!typed)
-				ParseDataType(data_type, SQL_SCOPE_CURSOR_PARAMS);
+				StatsSummaryItem ssi(STATS_CONV_OK);
+				_stats->ProceduralStatements(value.c_str(), &ssi, forall.forall, forall.end);
+			}
 
-			// SQL Server does support parameters, and cursor get all variable values during declaration,
-			// not during OPEN cursor, so DECLARE is moved before OPEN 
-			// MySQL also does not support cursor parameters
+			forall.bulk = -2;
+		}
+	}
 
-			// Generate variable not substitute with actual values (especially if they are constants)
-			// to increase chance that SQL execution plan is re-used
+	// FORALL statements left as they are
+	for(size_t j = 0; j < foralls.size() && _stats != nullptr; j++)
+	{
+        if(foralls[j].bulk == -2)
+			continue;
 
-			// Define variable name to use instead of parameter 
-			TokenStr str;
+		StatsSummaryItem ssi(STATS_CONV_WARN);
+		_stats->ProceduralStatements("FORALL not rewritten to set-based statement", &ssi, foralls[j].forall, Nvl(foralls[j].end, foralls[j].forall));
+	}
+}
 
-			str.Append(name);
-			str.Append("_", L"_", 1);
-			str.Append(param);
-				
-			// Save variable name
-			Token::ChangeNoFormat(param, str);
-			Token::Remove(param, data_type);
+// Get FORALL i IN 1..c.COUNT or FORALL i IN c.FIRST..c.LAST statement referencing collections as c(i)
+bool SqlParser::OracleForallStatement(Token *forall, Token *end, std::vector<OracleBulkCollect> &bulks, OracleForall &stmt)
+{
+	stmt.forall = forall;
+	stmt.index = GetNextPatternToken(forall);
 
-			// Save information about cursor parameters (variables will be generated for MySQL i.e.)
-			_spl_cursor_params.Add(cursor, name, param, data_type);
+	Token *in = GetNextPatternToken(stmt.index);
 
-			_spl_variables.Add(param);
+    if(stmt.index == nullptr || TOKEN_CMP(in, "IN") == false)
+		return false;
 
-			// Next must be comma if list continues
-			Token *comma = GetNextCharToken(',', L',');
+	// Bounds without spaces, SAVE EXCEPTIONS, INDICES OF and VALUES OF are not converted
+	std::string bounds;
 
-            if(comma == nullptr)
-				break;
+	for(Token *token = GetNextPatternToken(in); token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMP(token, "INSERT") || TOKEN_CMP(token, "UPDATE") || TOKEN_CMP(token, "DELETE"))
+		{
+			stmt.stmt = token;
+			break;
+		}
 
-			Token::Remove(comma);
+		for(size_t i = 0; token->str != nullptr && i < token->len; i++)
+		{
+            if(Str::IsSpace(token->str[i]) == false)
+				bounds += token->str[i];
 		}
+	}
 
-		close = GetNextCharToken(')', L')');
+    if(stmt.stmt == nullptr)
+		return false;
 
-		Token::Remove(open);
-		Token::Remove(close);
-	}
+	int depth = 0;
 
-	Token *is = GetNextWordToken("IS", L"IS", 2);
+	for(Token *token = GetNextPatternToken(stmt.stmt); token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+			depth++;
+		else
+        if(TOKEN_CMPC(token, ')'))
+			depth--;
+		else
+        if(TOKEN_CMPC(token, ';') && depth == 0)
+		{
+			stmt.end = token;
+			break;
+		}
+		else
+        if(depth == 0 && TOKEN_CMP(token, "VALUES"))
+			stmt.values = token;
+		else
+        if(depth == 0 && TOKEN_CMP(token, "WHERE"))
+			stmt.where_ = token;
+		else
+		// Values returned into collections, or the index used as a value
+        if(TOKEN_CMP(token, "RETURNING") || TOKEN_CMP(token, "RETURN") || Token::Compare(token, stmt.index) == true)
+			return false;
+		else
+		{
+			bool prefix = false;
+			int bulk = GetBulkCollection(bulks, token, (int)bulks.size() - 1, &prefix);
 
-	// FOR in SQL Server, MySQL
-	Token::Change(is, "FOR", L"FOR", 3);
+            if(bulk == -1)
+				continue;
 
-	// For SQL Server, MySQL change to DECLARE name CURSOR
-	Token::Change(cursor, "DECLARE", L"DECLARE", 7);
-	Append(name, " CURSOR", L"CURSOR", 7, cursor); 
-	
+			Token *open = GetNextPatternToken(token);
+			Token *index = GetNextPatternToken(open);
+			Token *close = GetNextPatternToken(index);
 
-	// SELECT can be optionally enclosed with ()
-	Token *open_sel = TOKEN_GETNEXT('(');
-	//Token *select = GetNextSelectStartKeyword();
+			// Collection methods, or an element with other index
+            if(prefix == true || TOKEN_CMPC(open, '(') == false || Token::Compare(index, stmt.index) == false || TOKEN_CMPC(close, ')') == false)
+				return false;
 
-    //if(select != nullptr)
-	//{
-    //	ParseSelectStatement(select, 0, SQL_SEL_CURSOR, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
-	//
-	//	_spl_declared_cursors_select.Add(name, select, GetLastToken());
-	//}
+			// All collections are filled by the same BULK COLLECT
+            if(stmt.bulk != -1 && stmt.bulk != bulk)
+				return false;
 
-	/*Token *close_sel */ TOKEN_GETNEXTP(open_sel, ')');
+			stmt.bulk = bulk;
+			stmt.refs.push_back(token);
 
-	// ; after each declaration
-	Token *semi = GetNextCharToken(';', L';');
+			// .field follows ) without spaces
+			Token *field = close->next;
 
-    // Save cursor definitions for the current declaration block
-    if(cursors != nullptr)
-        cursors->Add(cursor, GetLastToken(semi));
+            if(field == nullptr || field->str == nullptr || field->len < 2 || field->str[0] != '.')
+				field = nullptr;
 
+			stmt.fields.push_back(field);
 
-	// End of scope for cursor parameters
-	if(params_exist == true)
-		LeaveLocalVariablesBlock();
+			// INSERT INTO table VALUES c(i) inserts the whole record
+            if(field == nullptr && stmt.values != nullptr && GetNextPatternToken(stmt.values) == token && 
+				TOKEN_CMPC(GetNextPatternToken(close), ';'))
+				stmt.whole_record = true;
 
-    _spl_current_declaring_cursor = nullptr;
+            if(stmt.where_ != nullptr)
+				stmt.refs_in_where = true;
 
-	return true;
-}
+			token = close;
+		}
+	}
 
-// Oracle object type declaration
-bool SqlParser::ParseOracleObjectType(Token *type)
-{
-    if(type == nullptr)
+    if(stmt.end == nullptr || stmt.bulk == -1)
 		return false;
 
-	if(!TOKEN_CMP(type, "TYPE"))
-		return false;
+	// 1..c.COUNT or c.FIRST..c.LAST
+	for(size_t i = 0; i < bulks[stmt.bulk].collections.size(); i++)
+	{
+		Token *collection = bulks[stmt.bulk].collections[i];
+		std::string name(collection->str, collection->len);
 
-	Token *name = GetNextToken();
+		std::string count = "1.." + name + ".COUNT";
+		std::string first_last = name + ".FIRST.." + name + ".LAST";
 
-    if(name == nullptr)
-		return false;
+        if(_stricmp(bounds.c_str(), count.c_str()) == 0 || _stricmp(bounds.c_str(), first_last.c_str()) == 0)
+			return true;
+	}
 
-	Token *is = TOKEN_GETNEXTW("IS");
-	Token *table = TOKEN_GETNEXTWP(is, "TABLE");
-	Token *of = TOKEN_GETNEXTWP(table, "OF");
+	return false;
+}
 
-	// TYPE typeTab IS TABLE OF data_type INDEX BY BINARY_INTEGER;
-    if(table != nullptr && of != nullptr)
-	{
-		Token *data_type = GetNextToken();
-		ParseDataType(data_type, SQL_SCOPE_OBJ_TYPE_DECL);
+// Get the last BULK COLLECT up to the specified one filling the collection referenced by the token, prefix is set 
+// for collection methods
+int SqlParser::GetBulkCollection(std::vector<OracleBulkCollect> &bulks, Token *token, int last, bool *prefix)
+{
+    if(token == nullptr || token->str == nullptr || token->chr != 0)
+		return -1;
 
-		_spl_obj_type_table.Add(name, data_type);
+	for(int i = last; i >= 0; i--)
+	{
+		for(size_t j = 0; j < bulks[i].collections.size(); j++)
+		{
+			Token *collection = bulks[i].collections[j];
 
-		Token *index = TOKEN_GETNEXTW("INDEX");
-		Token *by = TOKEN_GETNEXTWP(index, "BY");
-        /*Token *binary_integer */(void) TOKEN_GETNEXTWP(by, "BINARY_INTEGER");
+            if(Token::Compare(token, collection) == true)
+				return i;
 
-        /*Token *semi */(void) TOKEN_GETNEXT(';');
+			// c.COUNT, c.FIRST..c.LAST
+            if(token->len > collection->len && Token::Compare(token, collection->str, collection->wstr, 0, collection->len) && 
+				TOKEN_CMPCP(token, '.', collection->len))
+			{
+                if(prefix != nullptr)
+					*prefix = true;
 
+				return i;
+			}
+		}
 	}
 
-	return true;
+	return -1;
 }
 
 // Oracle object type assignment statement - tab_type_var(index) := expression
@@ -965,9 +2232,9 @@ bool SqlParser::ParseOracleException(Token *name)
 void SqlParser::OracleAppendDataTypeSizes()
 {
 	// Variables generated for cursor parameters
-	if(_spl_cursor_vars.GetCount() > 0)
+	if(_spl->cursor_vars.GetCount() > 0)
 	{
-		ListwmItem *item = _spl_cursor_vars.GetFirst();
+		ListwmItem *item = _spl->cursor_vars.GetFirst();
 
         while(item != nullptr)
 		{
@@ -1051,24 +2318,129 @@ bool SqlParser::ParseOracleRownumCondition(Token *first, Token *op, Token *secon
 
 	// rownum can be at any side of the expression
 	bool rownum1 = first->Compare("rownum", L"rownum", 6);
-    bool rownum2 = (first == nullptr) ? second->Compare("rownum", L"rownum", 6) : false;
+    bool rownum2 = second->Compare("rownum", L"rownum", 6);
 
 	if(rownum1 == false && rownum2 == false)
 		return false;
 
 	int limit = -1;
+	int value = rownum1 ? second->GetInt() : first->GetInt();
+
+	// <= and >= operators
+	bool equal = (op->next != nullptr && op->next->Compare('=', L'=') == true);
+
+	// rownum <= n, rownum < n, n >= rownum and n > rownum
+    if((rownum1 && op->Compare('<', L'<') == true) || (rownum2 && op->Compare('>', L'>') == true))
+		limit = equal ? value : value - 1;
+	else
+	// rownum = 1
+    if(op->Compare('=', L'=') == true && value == 1)
+		limit = 1;
+	else
+	// rownum BETWEEN 1 AND n, other ranges select no rows in Oracle
+    if(rownum1 && op->Compare("BETWEEN", L"BETWEEN", 7) == true && GetNextPatternToken(op)->GetInt() == 1)
+		limit = value;
+
+	// Conditions that do not limit the number of rows are not converted, and only one condition per WHERE
+    if(limit < 1 || rowlimit == nullptr || _rownum_first != nullptr)
+		return false;
+
+	// The condition is removed when the whole WHERE clause is parsed, it must not be combined with OR
+	_rownum_first = first;
+	_rownum_last = second;
+
+	*rowlimit = limit;
+
+	return true;
+}
+
+// Remove rownum condition if it is a top-level AND condition of WHERE clause, otherwise it is not converted
+bool SqlParser::RemoveOracleRownumCondition(Token *select, Token *where_, Token *where_end, Token *rownum_first, Token *rownum_last, bool aggregate)
+{
+    if(rownum_first == nullptr || where_ == nullptr || where_end == nullptr)
+		return false;
+
+	// MySQL does not support LIMIT in IN, ALL, ANY and SOME subqueries
+	Token *open = GetPrevToken(select);
+	Token *pred = TOKEN_CMPC(open, '(') ? GetPrevToken(open) : nullptr;
+
+    if(aggregate == true || TOKEN_CMP(pred, "IN") || TOKEN_CMP(pred, "ALL") || TOKEN_CMP(pred, "ANY") || TOKEN_CMP(pred, "SOME"))
+	{
+        if(_stats != nullptr)
+		{
+			StatsSummaryItem ssi(STATS_CONV_WARN);
+			_stats->Statements(aggregate ? "ROWNUM condition in aggregate query not converted" : 
+				"ROWNUM condition in IN, ALL, ANY or SOME subquery not converted", &ssi, rownum_first, rownum_last);
+		}
+
+		return false;
+	}
+
+	int level = 0;
+	bool top = false;
+	bool or_ = false;
+
+	for(Token *token = where_->next; token != nullptr; token = token->next)
+	{
+        if(token == rownum_first)
+			top = (level == 0);
+
+        if(token->IsRemoved() == false)
+		{
+            if(TOKEN_CMPC(token, '('))
+				level++;
+			else
+            if(TOKEN_CMPC(token, ')'))
+				level--;
+			else
+            if(level == 0 && TOKEN_CMP(token, "OR"))
+				or_ = true;
+		}
+
+        if(token == where_end)
+			break;
+	}
+
+    if(top == false || or_ == true)
+	{
+        if(_stats != nullptr)
+		{
+			StatsSummaryItem ssi(STATS_CONV_WARN);
+			_stats->Statements("ROWNUM condition combined with OR not converted", &ssi, rownum_first, rownum_last);
+		}
+
+		return false;
+	}
+
+	Token::Remove(rownum_first, rownum_last);
+
+	Token *prev = rownum_first->prev;
 
-	// Get row limit value
-	if(rownum1 == true)
-		limit = second->GetInt();
+	while(prev != nullptr && prev->IsBlank() == true)
+		prev = prev->prev;
+
+	// Remove AND before the condition, or after it when the condition goes first
+    if(TOKEN_CMP(prev, "AND"))
+		Token::Remove(prev);
 	else
-		limit = first->GetInt();
+	{
+		Token *and_ = GetNextPatternToken(rownum_last);
+
+        if(TOKEN_CMP(and_, "AND"))
+			Token::Remove(and_);
+	}
 
-	// If target not Oracle remove condition
-	Token::Remove(first, second);
+	// No conditions anymore, remove WHERE
+	for(Token *token = where_->next; token != nullptr; token = token->next)
+	{
+        if(token->IsRemoved() == false && token->IsBlank() == false && token->type != TOKEN_COMMENT)
+			return true;
+
+        if(token == where_end)
+			break;
+	}
 
-    if(rowlimit != nullptr)
-		*rowlimit = limit;
+	Token::Remove(where_);
 
 	return true;
 }
@@ -1363,7 +2735,7 @@ void SqlParser::OracleContinueHandlerForInsert(Token *insert)
         Token *error = nullptr;
 
 		// Find native error code by condition name
-		ListwmItem *i = Find(_spl_user_exceptions, cur->name);
+		ListwmItem *i = Find(_spl->user_exceptions, cur->name);
 
         if(i != nullptr)
 			error = (Token*)i->value2;
@@ -1445,7 +2817,7 @@ void SqlParser::OracleContinueHandlerForUpdate(Token *update)
 void SqlParser::OracleMoveBeginAfterDeclare(Token *create, Token *as, Token *begin, Token *body_start)
 {
 	// No declaration statements
-    if(_spl_last_declare == nullptr)
+    if(_spl->last_declare == nullptr)
 	{
 		// Oracle requires IS keyword
         if(as == nullptr)
@@ -1494,7 +2866,7 @@ void SqlParser::OracleMoveBeginAfterDeclare(Token *create, Token *as, Token *beg
 void SqlParser::OracleAddOutRefcursor(Token *create, Token *name, Token *last_param)
 {
 	// No result sets
-	if(_spl_result_sets == 0)
+	if(_spl->result_sets == 0)
 		return;
 
 	CopyPaste *cur = _copypaste.GetFirstNoCurrent();
@@ -1535,7 +2907,7 @@ void SqlParser::OracleAddOutRefcursor(Token *create, Token *name, Token *last_pa
 	}
 
 	// Find generated cursor names for standalone SELECT statements returning a result set
-    for(TokenStr *t = _spl_result_set_generated_cursors.GetFirst(); t != nullptr; t = t->next)
+    for(TokenStr *t = _spl->result_set_generated_cursors.GetFirst(); t != nullptr; t = t->next)
 	{
 		if(num > 0)
 			AppendNoFormat(append, ", ", L", ", 2);
@@ -1547,7 +2919,7 @@ void SqlParser::OracleAddOutRefcursor(Token *create, Token *name, Token *last_pa
 	}
 
 	// Find cursor name for prepared statements with return
-    for(ListwmItem *i = _spl_prepared_stmts_cursors_with_return.GetFirst(); i != nullptr; i = i->next)
+    for(ListwmItem *i = _spl->prepared_stmts_cursors_with_return.GetFirst(); i != nullptr; i = i->next)
 	{
 		Token *cursor = (Token*)i->value;
 
@@ -1572,14 +2944,14 @@ void SqlParser::OracleTruncateTemporaryTablesWithReplace()
 	//	Token *table_name = (Token*)i->value;
 
  //       if(i->prev == nullptr)
-	//		Prepend(_spl_first_non_declare, "\n", L"\n", 1);
+	//		Prepend(_spl->first_non_declare, "\n", L"\n", 1);
 
-	//	Prepend(_spl_first_non_declare, "EXECUTE IMMEDIATE 'TRUNCATE TABLE ", L"EXECUTE IMMEDIATE 'TRUNCATE TABLE ", 34);
-	//	PrependCopy(_spl_first_non_declare, table_name);
-	//	Prepend(_spl_first_non_declare, "';\n", L"';\n", 3);
+	//	Prepend(_spl->first_non_declare, "EXECUTE IMMEDIATE 'TRUNCATE TABLE ", L"EXECUTE IMMEDIATE 'TRUNCATE TABLE ", 34);
+	//	PrependCopy(_spl->first_non_declare, table_name);
+	//	Prepend(_spl->first_non_declare, "';\n", L"';\n", 3);
 
  //       if(i->next == nullptr)
-	//		Prepend(_spl_first_non_declare, "\n", L"\n", 1);
+	//		Prepend(_spl->first_non_declare, "\n", L"\n", 1);
 	//}
 }
 
@@ -1605,13 +2977,13 @@ void SqlParser::OracleMoveSelectOutofIf(Token *stmt_start, Token *select, Token
 	// Remove SELECT in IF
 	Token::Remove(open->next, close);
 
-	_spl_moved_if_select++;
+	_spl->moved_if_select++;
 }
 
 // Add declarations for SELECT statement moved out of IF condition
 void SqlParser::OracleIfSelectDeclarations()
 {
-	if(_spl_moved_if_select == 0)
+	if(_spl->moved_if_select == 0)
 		return;
 
 	//Token *append = GetDeclarationAppend();
@@ -0,0 +1,74 @@
+// Oracle partitioning clause collected while parsed, and converted to MySQL partitioning at its end
+
+#ifndef sqlines_partitions_h
+#define sqlines_partitions_h
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "token.h"
+
+// Kind of VALUES LESS THAN and VALUES list item
+#define PART_VALUE_NUMBER		1
+#define PART_VALUE_STRING		2
+#define PART_VALUE_DATE			3		// Date literal, the time is midnight
+#define PART_VALUE_DATETIME		4		// Date and time literal
+#define PART_VALUE_MAXVALUE		5
+#define PART_VALUE_NULL			6
+#define PART_VALUE_DEFAULT		7
+#define PART_VALUE_OTHER		8		// Expression that is not allowed in MySQL
+
+// Partition bound or list value
+struct PartitionValue
+{
+	Token *start;
+	Token *end;
+	int kind;
+
+	// 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MI:SS' for date values
+	std::string literal;
+
+	PartitionValue() { start = NULL; end = NULL; kind = PART_VALUE_OTHER; }
+};
+
+// PARTITION BY or SUBPARTITION BY clause
+struct PartitionsBy
+{
+	// PARTITION or SUBPARTITION keyword, and RANGE, LIST, HASH or other type
+	Token *start;
+	Token *type;
+
+	std::vector<Token*> columns;
+
+	// PARTITIONS or SUBPARTITIONS num
+	Token *count;
+
+	// Last token of the clause
+	Token *end;
+
+	PartitionsBy() { start = NULL; type = NULL; count = NULL; end = NULL; }
+};
+
+// Partitioning clause of CREATE TABLE
+struct OraclePartitions
+{
+	PartitionsBy part;
+	PartitionsBy subpart;
+
+	// Bounds and values of all partitions
+	std::vector<PartitionValue> values;
+	// VALUES keyword of each LIST partition
+	std::vector<Token*> list_values;
+
+	// SUBPARTITION TEMPLATE and subpartition definitions of partitions (first and last tokens)
+	std::vector<std::pair<Token*, Token*> > subpart_defs;
+	// Maximum number of subpartitions in the template or a partition
+	int subpart_count;
+
+	// Reason why partitioning cannot be converted
+	const char *error;
+
+	OraclePartitions() { subpart_count = 0; error = NULL; }
+};
+
+#endif // sqlines_partitions_h
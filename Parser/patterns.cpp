@@ -5,61 +5,260 @@
 #include "sqlparser.h"
 
 // Try to recognize well-known patterns in Oracle trigger
-bool SqlParser::ParseCreateTriggerOraclePattern(Token *create, Token *table, Token *when, Token *insert)
+bool SqlParser::ParseCreateTriggerOraclePattern(Token *create, Token *table, Token *when, Token *insert, Token *condition, 
+													Token *begin, Token *end, Token *last)
 {
-	bool exists = false;
+    if(create == nullptr || table == nullptr || end == nullptr || last == nullptr)
+		return false;
 
-	return exists;
+	// Only BEFORE INSERT trigger can assign the column value
+    if(TOKEN_CMP(when, "BEFORE") == false || insert == nullptr || TOKEN_CMP(begin, "BEGIN") == false)
+		return false;
+
+	Token *token = GetNextPatternToken(begin);
+	Token *nextval = nullptr;
+	Token *column = nullptr;
+
+	// The only statement of the trigger assigns the next value of the sequence to :NEW.column
+    if(SelectNextvalFromDual(&token, &nextval, &column) == false && AssignNextval(&token, &nextval, &column) == false)
+		return false;
+
+    if(token != end)
+		return false;
+
+	// WHEN (NEW.column IS NULL) condition does not change the pattern
+    if(condition != nullptr && IsTriggerColumnNull(condition, begin, column) == false)
+		return false;
+
+	Token col_name;
+
+	SplitTriggerNewColumn(column, &col_name);
+
+	// Column definition of the last CREATE TABLE for the table
+	Book *col_end = GetColumnBookmark(table, &col_name);
+
+    if(col_end == nullptr)
+		return false;
+
+	SequenceTrigger trigger;
+
+	trigger.create = create;
+	trigger.end = last;
+	trigger.nextval = nextval;
+	trigger.table = col_end->name;
+	trigger.column = col_end->name2;
+	trigger.column_end = col_end->book;
+
+	// The last sequence with this name defined before the trigger
+	std::unordered_map<std::string, int>::iterator i = _sequence_index.find(GetSequenceKey(nextval));
+
+    if(i != _sequence_index.end())
+		trigger.sequence = i->second;
+
+	_sequence_triggers.push_back(trigger);
+
+	return true;
 }
 
 // SELECT seq.NEXTVAL INTO :new.col FROM dual in Oracle
-bool SqlParser::SelectNextvalFromDual(Token **sequence, Token **column)
+bool SqlParser::SelectNextvalFromDual(Token **token, Token **sequence, Token **column)
 {
-	Token *select = GetNextWordToken("SELECT", L"SELECT", 6);
-
-    if(select == nullptr)
+    if(token == nullptr || TOKEN_CMP(*token, "SELECT") == false)
 		return false;
 
 	// Sequence name with NEXTVAL pseudocolumn
-	Token *seq = GetNextIdentToken();
+	Token *seq = GetNextPatternToken(*token);
+
+    if(IsNextvalReference(seq) == false)
+		return false;
 
 	// INTO clause
-	Token *into = GetNextWordToken("INTO", L"INTO", 4);
+	Token *into = GetNextPatternToken(seq);
 
-    if(into == nullptr)
+    if(TOKEN_CMP(into, "INTO") == false)
 		return false;
 
-	// Column name possible with :NEW
-	Token *col = GetNextIdentToken();
+	// Column name with :NEW
+	Token *next = GetNextPatternToken(into);
+	Token *col = GetTriggerNewColumn(&next);
+
+    if(col == nullptr)
+		return false;
 
 	// FROM dual
-	/*Token *from */ (void) GetNextWordToken("FROM", L"FROM", 4);
-	Token *dual = GetNextWordToken("dual", L"dual", 4);
-	/*Token *semi1 */ (void) GetNextCharToken(';', L';');
+    if(TOKEN_CMP(next, "FROM") == false)
+		return false;
+
+	Token *dual = GetNextPatternToken(next);
+	Token *semi = GetNextPatternToken(dual);
 
-    if(dual == nullptr)
+    if(TOKEN_CMP(dual, "dual") == false || TOKEN_CMPC(semi, ';') == false)
 		return false;
 
-	// END must follow SELECT
-	Token *end = GetNextWordToken("END", L"END", 3);
-	
-	bool exists = false;
+	*token = GetNextPatternToken(semi);
 
-	// SELECT NEXTVAL FROM dual pattern matched
-    if(end != nullptr)
-	{
-		PushBack(end);
+    if(sequence != nullptr)
+		*sequence = seq;
 
-        if(sequence != nullptr)
-			*sequence = seq;
+    if(column != nullptr)
+		*column = col;
 
-        if(column != nullptr)
-			*column = col;
+	return true;
+}
 
-		exists = true;
-	}
+// :new.col := seq.NEXTVAL in Oracle
+bool SqlParser::AssignNextval(Token **token, Token **sequence, Token **column)
+{
+    if(token == nullptr)
+		return false;
 
-	return exists;
+	Token *next = *token;
+	Token *col = GetTriggerNewColumn(&next);
+
+    if(col == nullptr)
+		return false;
+
+	// := operator
+	Token *equal = GetNextPatternToken(next);
+
+    if(TOKEN_CMPC(next, ':') == false || TOKEN_CMPC(equal, '=') == false)
+		return false;
+
+	// Sequence name with NEXTVAL pseudocolumn
+	Token *seq = GetNextPatternToken(equal);
+	Token *semi = GetNextPatternToken(seq);
+
+    if(IsNextvalReference(seq) == false || TOKEN_CMPC(semi, ';') == false)
+		return false;
+
+	*token = GetNextPatternToken(semi);
+
+    if(sequence != nullptr)
+		*sequence = seq;
+
+    if(column != nullptr)
+		*column = col;
+
+	return true;
+}
+
+// WHEN (NEW.col IS NULL) condition of Oracle trigger
+bool SqlParser::IsTriggerColumnNull(Token *condition, Token *begin, Token *column)
+{
+	Token *next = GetNextPatternToken(condition);
+	int open = 0;
+
+	for(; TOKEN_CMPC(next, '('); next = GetNextPatternToken(next))
+		open++;
+
+	Token *col = GetTriggerNewColumn(&next);
+
+	Token col_name;
+	Token ref_name;
+
+    if(col == nullptr || SplitTriggerNewColumn(col, &col_name) == false || SplitTriggerNewColumn(column, &ref_name) == false ||
+		Token::Compare(&col_name, &ref_name) == false)
+		return false;
+
+	Token *null = GetNextPatternToken(next);
+
+    if(TOKEN_CMP(next, "IS") == false || TOKEN_CMP(null, "NULL") == false)
+		return false;
+
+	next = GetNextPatternToken(null);
+
+	for(; open > 0 && TOKEN_CMPC(next, ')'); next = GetNextPatternToken(next))
+		open--;
+
+	return (open == 0 && next == begin);
+}
+
+// :NEW.col or NEW.col reference in Oracle trigger, the token is moved after the reference
+Token* SqlParser::GetTriggerNewColumn(Token **token)
+{
+    if(token == nullptr || *token == nullptr)
+		return nullptr;
+
+	Token *col = *token;
+
+	// : can be a separate token
+    if(TOKEN_CMPC(col, ':'))
+		col = GetNextPatternToken(col);
+
+	Token name;
+
+    if(SplitTriggerNewColumn(col, &name) == false)
+		return nullptr;
+
+	*token = GetNextPatternToken(col);
+
+	return col;
+}
+
+// Get the column name from :NEW.col reference, NEW can be renamed by REFERENCING clause
+bool SqlParser::SplitTriggerNewColumn(Token *ref, Token *column)
+{
+    if(ref == nullptr || column == nullptr || ref->type == TOKEN_SYMBOL)
+		return false;
+
+	Token corr;
+
+	SplitIdentifier(ref, &corr, column);
+
+    if(column->str == nullptr)
+		return false;
+
+	size_t start = TOKEN_CMPCP(&corr, ':', 0) ? 1 : 0;
+	Token *new_name = _spl->new_correlation_name;
+
+    if(corr.len == start + 3 && Token::Compare(&corr, "NEW", L"NEW", start, 3) == true)
+		return true;
+
+    if(new_name != nullptr && new_name->str != nullptr && corr.len == start + new_name->len && 
+		Token::Compare(&corr, new_name->str, new_name->wstr, start, new_name->len) == true)
+		return true;
+
+	return false;
+}
+
+// Check for seq.NEXTVAL or seq.CURRVAL reference, any sequence if the name is not set
+bool SqlParser::IsSequenceReference(Token *ref, Token *name)
+{
+    if(ref == nullptr || ref->str == nullptr || ref->len <= 8 || (ref->flags & TOKEN_INSERTED))
+		return false;
+
+	size_t len = ref->len - 8;
+
+    if(Token::Compare(ref, ".NEXTVAL", L".NEXTVAL", len, 8) == false && Token::Compare(ref, ".CURRVAL", L".CURRVAL", len, 8) == false)
+		return false;
+
+    if(name == nullptr)
+		return true;
+
+	return (name->str != nullptr && name->len == len && Token::Compare(ref, name->str, name->wstr, 0, len) == true);
+}
+
+// Check for seq.NEXTVAL reference
+bool SqlParser::IsNextvalReference(Token *ref)
+{
+    if(IsSequenceReference(ref, nullptr) == false)
+		return false;
+
+	return Token::Compare(ref, ".NEXTVAL", L".NEXTVAL", ref->len - 8, 8);
+}
+
+// Get the next token skipping blanks, comments and generated tokens
+Token* SqlParser::GetNextPatternToken(Token *token)
+{
+    if(token == nullptr)
+		return nullptr;
+
+	Token *next = token->next;
+
+	while(next != nullptr && (next->IsBlank() == true || next->type == TOKEN_COMMENT || (next->flags & TOKEN_INSERTED)))
+		next = next->next;
+
+	return next;
 }
 
 // Patterns in (SELECT ...) expression
@@ -73,3 +272,613 @@ bool SqlParser::ParseSelectExpressionPattern(Token *open, Token *select)
 	return exists;
 }
 
+
+// Deterministic built-in functions allowed in the statement of cursor FOR loop rewritten to set-based statement
+static const char *g_set_based_functions[] = { "ABS", "AVG", "CAST", "CEIL", "COALESCE", "CONCAT", "COUNT", "DECODE",
+	"FLOOR", "GREATEST", "INSTR", "LEAST", "LENGTH", "LOWER", "LPAD", "LTRIM", "MAX", "MIN", "MOD", "NVL", "NVL2",
+	"REPLACE", "ROUND", "RPAD", "RTRIM", "SUBSTR", "SUM", "TO_CHAR", "TO_DATE", "TO_NUMBER", "TRIM", "TRUNC", "UPPER", nullptr };
+
+// Keywords that can be followed by (
+static const char *g_set_based_keywords[] = { "ALL", "AND", "ANY", "ELSE", "EXISTS", "IN", "NOT", "OR", "SELECT", "SET",
+	"SOME", "THEN", "VALUES", "WHEN", "WHERE", nullptr };
+
+// Rewrite cursor FOR loop performing a single INSERT, UPDATE or DELETE statement to set-based statement
+bool SqlParser::OracleCursorForLoop(Token *for_, Token *begin, Token *end, Token **next)
+{
+	// FOR rec IN (SELECT ...) LOOP or FOR rec IN cursor LOOP
+	Token *rec = GetNextPatternToken(for_);
+	Token *in = GetNextPatternToken(rec);
+	Token *cursor = GetNextPatternToken(in);
+
+    if(rec == nullptr || TOKEN_CMP(in, "IN") == false || cursor == nullptr || 
+		(cursor->type != TOKEN_WORD && cursor->type != TOKEN_IDENT && TOKEN_CMPC(cursor, '(') == false))
+		return false;
+
+	Token *query_first = nullptr;
+	Token *query_last = nullptr;
+	Token *loop = nullptr;
+
+	// Inline query, the range is with parentheses
+    if(TOKEN_CMPC(cursor, '('))
+	{
+		Token *select = GetNextPatternToken(cursor);
+
+        if(TOKEN_CMP(select, "SELECT") == false && TOKEN_CMP(select, "WITH") == false)
+			return false;
+
+		query_first = cursor;
+		query_last = GetClosingParenthesis(cursor, end);
+		loop = GetNextPatternToken(query_last);
+	}
+	else
+	{
+		loop = GetNextPatternToken(cursor);
+
+		// Cursor with parameters
+        if(TOKEN_CMPC(loop, '('))
+			loop = GetNextPatternToken(GetClosingParenthesis(loop, end));
+		else
+			GetDeclaredCursorQuery(cursor, begin, &query_first, &query_last);
+	}
+
+	// Numeric FOR loop
+    if(TOKEN_CMP(loop, "LOOP") == false)
+		return false;
+
+	Token *stmt = GetNextPatternToken(loop);
+	Token *end_loop = nullptr;
+	int depth = 0;
+
+	// Find END LOOP of this loop
+	for(Token *token = stmt; token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMP(token, "END") && TOKEN_CMP(GetNextPatternToken(token), "LOOP"))
+		{
+            if(depth == 0)
+			{
+				end_loop = token;
+				break;
+			}
+
+			depth--;
+			token = GetNextPatternToken(token);
+		}
+		else
+        if(TOKEN_CMP(token, "LOOP"))
+			depth++;
+	}
+
+	Token *end_semi = GetNextPatternToken(GetNextPatternToken(end_loop));
+
+    if(end_loop == nullptr || TOKEN_CMPC(end_semi, ';') == false)
+		return false;
+
+	// The loop body is a single DML statement using the record fields only
+	Token *semi = nullptr;
+	Token *values = nullptr;
+	Token *where_ = nullptr;
+	bool rec_in_where = false;
+	bool convert = (query_first != nullptr && query_last != nullptr) &&
+		(TOKEN_CMP(stmt, "INSERT") || TOKEN_CMP(stmt, "UPDATE") || TOKEN_CMP(stmt, "DELETE"));
+
+	Token *prev = stmt;
+	depth = 0;
+
+	for(Token *token = GetNextPatternToken(stmt); convert && token != nullptr && token != end_loop; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+			depth++;
+		else
+        if(TOKEN_CMPC(token, ')'))
+			depth--;
+		else
+        if(TOKEN_CMPC(token, ';') && depth == 0)
+		{
+			semi = token;
+			break;
+		}
+		else
+        if(depth == 0 && TOKEN_CMP(token, "VALUES"))
+			values = token;
+		else
+        if(depth == 0 && TOKEN_CMP(token, "WHERE"))
+			where_ = token;
+		else
+		// The whole record is passed, or values are returned into variables
+        if(Token::Compare(token, rec) == true || TOKEN_CMP(token, "RETURNING") || TOKEN_CMP(token, "RETURN"))
+			convert = false;
+		else
+		// rec.field
+        if(token->len > rec->len && Token::Compare(token, rec->str, nullptr, 0, rec->len) && TOKEN_CMPCP(token, '.', rec->len))
+		{
+            if(where_ != nullptr)
+				rec_in_where = true;
+		}
+		else
+		// Function call that can have side effects, the table name can be followed by column list in INSERT
+        if((token->type == TOKEN_WORD || token->type == TOKEN_IDENT || token->type == TOKEN_KEYWORD || token->type == TOKEN_FUNCTION) &&
+			TOKEN_CMPC(GetNextPatternToken(token), '(') &&
+			TOKEN_CMP(prev, "INTO") == false)
+		{
+			bool known = false;
+
+			for(int i = 0; g_set_based_functions[i] != nullptr && !known; i++)
+				known = Token::Compare(token, g_set_based_functions[i], nullptr, strlen(g_set_based_functions[i]));
+
+			for(int i = 0; g_set_based_keywords[i] != nullptr && !known; i++)
+				known = Token::Compare(token, g_set_based_keywords[i], nullptr, strlen(g_set_based_keywords[i]));
+
+            if(known == false)
+				convert = false;
+		}
+
+		prev = token;
+	}
+
+    if(semi == nullptr || GetNextPatternToken(semi) != end_loop)
+		convert = false;
+
+	std::vector<std::string> columns;
+	bool columns_known = GetQueryColumnNames(query_first, query_last, columns);
+
+	const char *kind = nullptr;
+
+    if(convert == true)
+	{
+		std::string query;
+		GetTargetText(query_first, query_last, query);
+
+        if(TOKEN_CMPC(query_first, '(') == false)
+			query = "(" + query + ")";
+
+		query += " ";
+		query.append(rec->str, rec->len);
+
+		kind = JoinSetBasedStatement(stmt, semi, values, where_, rec_in_where, query, columns_known ? &columns : nullptr, query_first, query_last, begin);
+	}
+
+	// Description of the rewrite
+	std::string value;
+
+    if(kind != nullptr)
+		value = std::string("Cursor FOR loop rewritten to ") + kind;
+
+	if(_stats != nullptr)
+	{
+		StatsSummaryItem ssi(kind != nullptr ? STATS_CONV_OK : STATS_CONV_WARN);
+		_stats->ProceduralStatements(kind != nullptr ? value.c_str() : "Cursor FOR loop not rewritten to set-based statement", &ssi, for_, end_semi);
+	}
+
+    if(kind == nullptr)
+		return false;
+
+	// Remove FOR ... LOOP with the indent of the statement, and END LOOP; with the preceding newline
+	for(Token *token = for_; token != nullptr; token = token->next)
+	{
+		Token::Remove(token, false);
+
+        if(token == stmt->prev)
+			break;
+	}
+
+	for(Token *token = semi->next; token != nullptr; token = token->next)
+	{
+		Token::Remove(token, false);
+
+        if(token == end_semi)
+			break;
+	}
+
+    if(next != nullptr)
+		*next = GetNextPatternToken(end_semi);
+
+	return true;
+}
+
+// Join the rows to INSERT, UPDATE or DELETE statement executed for each of them, returns the kind of the set-based statement
+// (the statement is not changed when only checked)
+const char* SqlParser::JoinSetBasedStatement(Token *stmt, Token *semi, Token *values, Token *where_, bool rows_in_where, 
+	std::string &rows, std::vector<std::string> *columns, Token *query_first, Token *query_last, Token *begin, bool check_only)
+{
+    if(stmt == nullptr || semi == nullptr)
+		return nullptr;
+
+	// Target table and alias of UPDATE and DELETE
+	Token *delete_from = TOKEN_CMP(stmt, "DELETE") ? GetNextPatternToken(stmt) : nullptr;
+	Token *table = TOKEN_CMP(delete_from, "FROM") ? GetNextPatternToken(delete_from) : GetNextPatternToken(stmt);
+	Token *alias = GetNextPatternToken(table);
+
+    if(TOKEN_CMP(alias, "SET") || alias == where_)
+		alias = nullptr;
+
+	std::vector<std::string> no_columns;
+	std::vector<std::string> &names = (columns != nullptr) ? *columns : no_columns;
+
+	// Unqualified references to columns of the rows are ambiguous in the set-based statement
+	std::vector<Token*> ambiguous;
+	std::vector<bool> subqueries;
+	int subquery = 0;
+
+	for(Token *token = TOKEN_CMP(stmt, "INSERT") ? values : GetNextPatternToken(Nvl(alias, table)); token != nullptr && token != semi;
+		token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+		{
+			subqueries.push_back(TOKEN_CMP(GetNextPatternToken(token), "SELECT"));
+			subquery += subqueries.back() ? 1 : 0;
+		}
+		else
+        if(TOKEN_CMPC(token, ')') && subqueries.empty() == false)
+		{
+			subquery -= subqueries.back() ? 1 : 0;
+			subqueries.pop_back();
+		}
+		else
+        if(IsQueryColumnReference(token, names) == true)
+		{
+			// Procedure variables in VALUES would be replaced by the columns, subqueries can refer to their tables
+            if(TOKEN_CMP(stmt, "INSERT") || subquery > 0)
+				return nullptr;
+
+			ambiguous.push_back(token);
+		}
+	}
+
+	const char *kind = nullptr;
+
+	// INSERT INTO table [(columns)] VALUES (...) becomes INSERT INTO table [(columns)] SELECT ... FROM rows
+    if(TOKEN_CMP(stmt, "INSERT"))
+	{
+		Token *open = GetNextPatternToken(values);
+		Token *close = GetClosingParenthesis(open, semi);
+
+        if(TOKEN_CMP(GetNextPatternToken(stmt), "INTO") && TOKEN_CMPC(open, '(') && close != nullptr && GetNextPatternToken(close) == semi)
+		{
+			kind = "INSERT ... SELECT";
+
+            if(check_only == true)
+				return kind;
+
+			Token::Change(values, "SELECT", L"SELECT", 6);
+			Token::Remove(open);
+			Token::Remove(close);
+
+			std::string from = " FROM " + rows;
+			AppendNoFormat(close, from.c_str(), nullptr, from.length());
+		}
+	}
+	else
+	// UPDATE and DELETE join the rows, they are matched by the columns of rows in WHERE
+    if(columns != nullptr && where_ != nullptr && rows_in_where == true)
+	{
+		Token *after = GetNextPatternToken(Nvl(alias, table));
+		bool same_table = false;
+
+		// MySQL does not allow selecting from the modified table
+		for(Token *token = query_first; token != nullptr; token = GetNextPatternToken(token))
+		{
+            if(Token::Compare(token, table) == true)
+				same_table = true;
+
+            if(token == query_last)
+				break;
+		}
+
+		std::string target;
+		GetTargetText(Nvl(alias, table), Nvl(alias, table), target);
+
+		std::string join = ", " + rows;
+
+		// When several rows match one target row, the multi-table UPDATE assigns it only once, so the
+		// values accumulated from the target columns (SET cnt = cnt + 1) would differ from the loop
+        if(same_table == false && TOKEN_CMP(stmt, "UPDATE") && TOKEN_CMP(after, "SET") && 
+			IsUpdateSetReadingTarget(after, where_, table, alias, begin) == false)
+		{
+			kind = "multi-table UPDATE";
+
+            if(check_only == true)
+				return kind;
+
+			AppendNoFormat(Nvl(alias, table), join.c_str(), nullptr, join.length());
+		}
+		else
+        if(same_table == false && TOKEN_CMP(stmt, "DELETE") && after == where_)
+		{
+			kind = "multi-table DELETE";
+
+            if(check_only == true)
+				return kind;
+
+			// DELETE [FROM] table becomes DELETE table FROM table, rows
+			std::string from = " " + target;
+
+            if(TOKEN_CMP(delete_from, "FROM") == false)
+				from += " FROM";
+
+			AppendNoFormat(stmt, from.c_str(), nullptr, from.length());
+			AppendNoFormat(Nvl(alias, table), join.c_str(), nullptr, join.length());
+		}
+
+		// Qualify columns of the modified table
+		for(size_t i = 0; i < ambiguous.size() && kind != nullptr; i++)
+		{
+			std::string column = target + ".";
+			PrependNoFormat(ambiguous[i], column.c_str(), nullptr, column.length());
+		}
+	}
+
+	return kind;
+}
+
+// Get names of the select list columns, false if the names are not known
+bool SqlParser::GetQueryColumnNames(Token *first, Token *last, std::vector<std::string> &names, bool *all_named)
+{
+	Token *select = TOKEN_CMPC(first, '(') ? GetNextPatternToken(first) : first;
+
+    if(TOKEN_CMP(select, "SELECT") == false)
+		return false;
+
+	Token *token = GetNextPatternToken(select);
+
+    if(TOKEN_CMP(token, "DISTINCT") || TOKEN_CMP(token, "UNIQUE") || TOKEN_CMP(token, "ALL"))
+		token = GetNextPatternToken(token);
+
+	Token *item_last = nullptr;
+	Token *item_prev = nullptr;
+	int items = 0;
+	int depth = 0;
+
+    if(all_named != nullptr)
+		*all_named = true;
+
+	for(; token != nullptr; token = GetNextPatternToken(token))
+	{
+		bool end = (depth == 0 && (TOKEN_CMPC(token, ',') || TOKEN_CMP(token, "FROM") || token == last));
+
+        if(end == true)
+		{
+            if(item_last == nullptr || TOKEN_CMPC(item_last, '*') || 
+				(item_last->len > 1 && item_last->str != nullptr && item_last->str[item_last->len - 1] == '*'))
+				return false;
+
+			// Column, or alias after AS or an expression
+			bool alias = (items > 1 && (TOKEN_CMP(item_prev, "AS") || item_prev->chr == 0 || TOKEN_CMPC(item_prev, ')')));
+
+            if((items == 1 || alias) && item_last->chr == 0 && item_last->type != TOKEN_STRING && item_last->type != TOKEN_NUMBER)
+			{
+				size_t start = item_last->len;
+
+				// Column name without the table qualifier
+				while(start > 0 && item_last->str[start - 1] != '.')
+					start--;
+
+				names.push_back(std::string(item_last->str + start, item_last->len - start));
+			}
+			else
+            if(all_named != nullptr)
+				*all_named = false;
+
+            if(TOKEN_CMPC(token, ',') == false)
+				break;
+
+			item_last = nullptr;
+			item_prev = nullptr;
+			items = 0;
+			continue;
+		}
+
+        if(TOKEN_CMPC(token, '('))
+			depth++;
+		else
+        if(TOKEN_CMPC(token, ')'))
+			depth--;
+
+		item_prev = item_last;
+		item_last = token;
+		items++;
+	}
+
+	return true;
+}
+
+// Check for unqualified reference to a column of the query
+bool SqlParser::IsQueryColumnReference(Token *token, std::vector<std::string> &columns)
+{
+    if(token == nullptr || token->str == nullptr || token->chr != 0 || token->type == TOKEN_STRING || token->type == TOKEN_NUMBER ||
+		memchr(token->str, '.', token->len) != nullptr || TOKEN_CMPC(GetNextPatternToken(token), '('))
+		return false;
+
+	for(size_t i = 0; i < columns.size(); i++)
+	{
+        if(Token::Compare(token, columns[i].c_str(), nullptr, columns[i].length()) == true)
+			return true;
+	}
+
+	return false;
+}
+
+// Expression keywords that are not references to columns
+static const char *g_set_expression_keywords[] = { "AND", "CASE", "CURRENT_DATE", "CURRENT_TIMESTAMP", "ELSE", "END", "FALSE", "IS", 
+	"LIKE", "NOT", "NULL", "OR", "SYSDATE", "SYSTIMESTAMP", "THEN", "TRUE", "WHEN", nullptr };
+
+// Check whether values assigned in UPDATE SET are calculated from the columns of the updated table
+bool SqlParser::IsUpdateSetReadingTarget(Token *set, Token *where_, Token *table, Token *alias, Token *begin)
+{
+	Token *target = Nvl(alias, table);
+	bool value = false;
+	int depth = 0;
+
+	for(Token *token = GetNextPatternToken(set); token != nullptr && token != where_; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+		{
+			// Subqueries can refer to the updated table
+            if(value == true && TOKEN_CMP(GetNextPatternToken(token), "SELECT"))
+				return true;
+
+			depth++;
+		}
+		else
+        if(TOKEN_CMPC(token, ')'))
+			depth--;
+		else
+		// Next column = value assignment
+        if(TOKEN_CMPC(token, ',') && depth == 0)
+			value = false;
+		else
+        if(TOKEN_CMPC(token, '=') && depth == 0)
+			value = true;
+		else
+		// Collection element c(i), the index is not a column
+        if(value == true && TOKEN_CMPC(GetNextPatternToken(token), '(') && IsDeclaredVariable(token, begin) == true)
+		{
+			Token *close = GetClosingParenthesis(GetNextPatternToken(token), where_);
+
+            if(close == nullptr)
+				return true;
+
+			token = close;
+		}
+		else
+        if(value == true && token->str != nullptr && token->chr == 0 && token->type != TOKEN_STRING && 
+			token->type != TOKEN_NUMBER && token->IsNumeric() == false && token->type != TOKEN_KEYWORD && token->type != TOKEN_FUNCTION &&
+			TOKEN_CMPC(GetNextPatternToken(token), '(') == false)
+		{
+			const char *dot = (const char*)memchr(token->str, '.', token->len);
+
+			// target.column, while rec.field refers to the rows
+            if(dot != nullptr)
+			{
+                if((size_t)(dot - token->str) == target->len && Token::Compare(token, target->str, nullptr, 0, target->len))
+					return true;
+
+				continue;
+			}
+
+			bool known = IsDeclaredVariable(token, begin);
+
+			for(int i = 0; g_set_expression_keywords[i] != nullptr && !known; i++)
+				known = Token::Compare(token, g_set_expression_keywords[i], nullptr, strlen(g_set_expression_keywords[i]));
+
+			// Unqualified names refer to the columns of the updated table first
+            if(known == false)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+// Check whether the name is a parameter or variable declared before the procedure body
+bool SqlParser::IsDeclaredVariable(Token *name, Token *begin)
+{
+    if(name == nullptr || begin == nullptr)
+		return false;
+
+	Token *start = begin;
+
+	// Declarations follow PROCEDURE or FUNCTION
+	while(start->prev != nullptr && TOKEN_CMP(start, "PROCEDURE") == false && TOKEN_CMP(start, "FUNCTION") == false)
+		start = start->prev;
+
+	Token *prev = nullptr;
+
+	for(Token *token = start; token != nullptr && token != begin; token = GetNextPatternToken(token))
+	{
+		// Skip cursor queries, they refer to columns
+        if(TOKEN_CMP(token, "CURSOR"))
+		{
+			while(token != nullptr && token != begin && TOKEN_CMPC(token, ';') == false)
+				token = GetNextPatternToken(token);
+
+            if(token == nullptr || token == begin)
+				break;
+		}
+		else
+		// Parameter follows ( or , and variable follows IS, AS or ;
+        if(Token::Compare(token, name) == true && (TOKEN_CMPC(prev, '(') || TOKEN_CMPC(prev, ',') || TOKEN_CMPC(prev, ';') || 
+			TOKEN_CMP(prev, "IS") || TOKEN_CMP(prev, "AS") || TOKEN_CMP(prev, "DECLARE")))
+			return true;
+
+		prev = token;
+	}
+
+	return false;
+}
+
+// Get the query of the cursor without parameters declared before the procedure body
+bool SqlParser::GetDeclaredCursorQuery(Token *cursor, Token *begin, Token **first, Token **last)
+{
+    if(cursor == nullptr || begin == nullptr)
+		return false;
+
+	Token *start = begin;
+
+	// Declarations follow PROCEDURE or FUNCTION
+	while(start->prev != nullptr && TOKEN_CMP(start, "PROCEDURE") == false && TOKEN_CMP(start, "FUNCTION") == false)
+		start = start->prev;
+
+	for(Token *token = start; token != nullptr && token != begin; token = GetNextPatternToken(token))
+	{
+		// CURSOR name IS query;
+        if(TOKEN_CMP(token, "CURSOR") == false || Token::Compare(GetNextPatternToken(token), cursor) == false)
+			continue;
+
+		Token *is = GetNextPatternToken(GetNextPatternToken(token));
+
+        if(TOKEN_CMP(is, "IS") == false)
+			return false;
+
+		Token *query = GetNextPatternToken(is);
+		Token *query_last = nullptr;
+		int depth = 0;
+
+		for(Token *cur = query; cur != nullptr && cur != begin; cur = GetNextPatternToken(cur))
+		{
+            if(TOKEN_CMPC(cur, '('))
+				depth++;
+			else
+            if(TOKEN_CMPC(cur, ')'))
+				depth--;
+			else
+            if(TOKEN_CMPC(cur, ';') && depth == 0)
+			{
+				*first = query;
+				*last = query_last;
+
+				return (query_last != nullptr);
+			}
+
+			query_last = cur;
+		}
+
+		return false;
+	}
+
+	return false;
+}
+
+// Get ) closing the parenthesis
+Token* SqlParser::GetClosingParenthesis(Token *open, Token *end)
+{
+    if(open == nullptr)
+		return nullptr;
+
+	int depth = 0;
+
+	for(Token *token = open; token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(TOKEN_CMPC(token, '('))
+			depth++;
+		else
+        if(TOKEN_CMPC(token, ')'))
+		{
+			depth--;
+
+            if(depth == 0)
+				return token;
+		}
+	}
+
+	return nullptr;
+}
@@ -2,8 +2,117 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <set>
 #include "sqlparser.h"
 
+// Emulation of Oracle sequences in MySQL, added once to the file before the first emulated sequence
+static const char *g_sequence_emulation =
+	"-- Emulation of Oracle sequences, a session takes the next values from the block of CACHE values it reserved,\n"
+	"-- and the row of the sequence is locked only when a new block is reserved\n"
+	"CREATE TABLE IF NOT EXISTS sqlines_sequences\n"
+	"(\n"
+	"  name VARCHAR(128) NOT NULL PRIMARY KEY,\n"
+	"  next_value DECIMAL(28) NOT NULL,\n"
+	"  increment_by DECIMAL(28) NOT NULL,\n"
+	"  min_value DECIMAL(28) NOT NULL,\n"
+	"  max_value DECIMAL(28) NOT NULL,\n"
+	"  cache_size INT NOT NULL,\n"
+	"  cycle_option TINYINT NOT NULL\n"
+	") ENGINE = InnoDB;\n"
+	"\n"
+	"-- Blocks reserved by sessions, a row is changed by its session only\n"
+	"CREATE TABLE IF NOT EXISTS sqlines_sequence_blocks\n"
+	"(\n"
+	"  name VARCHAR(128) NOT NULL,\n"
+	"  session_id BIGINT UNSIGNED NOT NULL,\n"
+	"  current_value DECIMAL(28) NOT NULL,\n"
+	"  next_value DECIMAL(28) NOT NULL,\n"
+	"  increment_by DECIMAL(28) NOT NULL,\n"
+	"  remaining INT NOT NULL,\n"
+	"  PRIMARY KEY (name, session_id)\n"
+	") ENGINE = InnoDB;\n"
+	"\n"
+	"-- Functions modify data, so log_bin_trust_function_creators = 1 is required when binary logging is enabled\n"
+	"DROP FUNCTION IF EXISTS NextVal;\n"
+	"DROP FUNCTION IF EXISTS LastVal;\n"
+	"\n"
+	"DELIMITER //\n"
+	"\n"
+	"CREATE FUNCTION NextVal(p_name VARCHAR(128)) RETURNS DECIMAL(28)\n"
+	"  NOT DETERMINISTIC MODIFIES SQL DATA\n"
+	"BEGIN\n"
+	"  DECLARE v_value, v_inc, v_min, v_max DECIMAL(28);\n"
+	"  DECLARE v_cache, v_remaining INT;\n"
+	"  DECLARE v_cycle TINYINT;\n"
+	"  DECLARE v_block INT DEFAULT NULL;\n"
+	"  DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;\n"
+	"\n"
+	"  -- Non-locking read, other sessions do not change the block of this session\n"
+	"  SELECT next_value, increment_by, remaining INTO v_value, v_inc, v_block\n"
+	"  FROM sqlines_sequence_blocks WHERE name = p_name AND session_id = CONNECTION_ID();\n"
+	"\n"
+	"  IF v_block IS NOT NULL AND v_block > 0 THEN\n"
+	"    UPDATE sqlines_sequence_blocks SET current_value = v_value, next_value = v_value + v_inc, remaining = v_block - 1\n"
+	"    WHERE name = p_name AND session_id = CONNECTION_ID();\n"
+	"\n"
+	"    RETURN v_value;\n"
+	"  END IF;\n"
+	"\n"
+	"  SET v_inc = NULL;\n"
+	"\n"
+	"  -- Reserve a new block, concurrent sessions get disjoint blocks\n"
+	"  SELECT next_value, increment_by, min_value, max_value, cache_size, cycle_option\n"
+	"  INTO v_value, v_inc, v_min, v_max, v_cache, v_cycle\n"
+	"  FROM sqlines_sequences WHERE name = p_name FOR UPDATE;\n"
+	"\n"
+	"  IF v_inc IS NULL THEN\n"
+	"    SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence does not exist';\n"
+	"  END IF;\n"
+	"\n"
+	"  IF v_value > v_max OR v_value < v_min THEN\n"
+	"    IF v_cycle = 0 THEN\n"
+	"      SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence exceeds MAXVALUE or MINVALUE';\n"
+	"    END IF;\n"
+	"\n"
+	"    SET v_value = IF(v_inc > 0, v_min, v_max);\n"
+	"  END IF;\n"
+	"\n"
+	"  -- Block is limited by MAXVALUE or MINVALUE\n"
+	"  SET v_remaining = LEAST(v_cache, FLOOR(IF(v_inc > 0, v_max - v_value, v_min - v_value) / v_inc) + 1);\n"
+	"\n"
+	"  UPDATE sqlines_sequences SET next_value = v_value + v_inc * v_remaining WHERE name = p_name;\n"
+	"\n"
+	"  IF v_block IS NULL THEN\n"
+	"    INSERT INTO sqlines_sequence_blocks (name, session_id, current_value, next_value, increment_by, remaining)\n"
+	"    VALUES (p_name, CONNECTION_ID(), v_value, v_value + v_inc, v_inc, v_remaining - 1);\n"
+	"  ELSE\n"
+	"    UPDATE sqlines_sequence_blocks SET current_value = v_value, next_value = v_value + v_inc, increment_by = v_inc,\n"
+	"      remaining = v_remaining - 1\n"
+	"    WHERE name = p_name AND session_id = CONNECTION_ID();\n"
+	"  END IF;\n"
+	"\n"
+	"  RETURN v_value;\n"
+	"END//\n"
+	"\n"
+	"CREATE FUNCTION LastVal(p_name VARCHAR(128)) RETURNS DECIMAL(28)\n"
+	"  NOT DETERMINISTIC READS SQL DATA\n"
+	"BEGIN\n"
+	"  DECLARE v_value DECIMAL(28) DEFAULT NULL;\n"
+	"  DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;\n"
+	"\n"
+	"  SELECT current_value INTO v_value\n"
+	"  FROM sqlines_sequence_blocks WHERE name = p_name AND session_id = CONNECTION_ID();\n"
+	"\n"
+	"  IF v_value IS NULL THEN\n"
+	"    SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence CURRVAL is not yet defined in this session';\n"
+	"  END IF;\n"
+	"\n"
+	"  RETURN v_value;\n"
+	"END//\n"
+	"\n"
+	"DELIMITER ;\n"
+	"\n";
+
 // Post conversion when all tokens processed
 void SqlParser::Post()
 {
@@ -14,4 +123,628 @@ void SqlParser::Post()
 	{
 		bookmark = bookmark->next;
 	}
+
+	// Output is not generated in assessment-only mode, so rewriting passes are skipped
+	if(_option_assess_only)
+		return;
+
+	// Sequences assigned to columns by triggers
+	PostSequenceTriggers();
+
+	// Other sequences are emulated
+	PostSequenceEmulation();
+
+	// Sequences converted and referenced in this file, checked across files at the end
+	PostSequenceUsage();
+
+	// Cursor FOR loops performing a single DML statement
+	PostCursorForLoops();
+
+	// BULK COLLECT and FORALL statements
+	PostBulkOperations();
+
+	// Optimizer hints in SELECT, UPDATE and DELETE statements
+	PostOptimizerHints();
+
+	// Global temporary tables are created in sessions
+	if(_option_session_temp_tables)
+		PostSessionTempTables();
+
+	// Merge single-row INSERT statements
+	if(_option_insert_batch > 1)
+		PostInsertBatches();
+}
+
+// Merge consecutive single-row INSERT statements with the same head into multi-row INSERT statements
+void SqlParser::PostInsertBatches()
+{
+	Book *prev = nullptr;
+
+	// Target of INSERT INTO ... VALUES of the current batch
+	std::string head;
+
+	int rows = 0;
+	size_t size = 0;
+
+	for(Book *cur = _bookmarks.GetFirstNoCurrent(); cur != nullptr; cur = cur->next)
+	{
+		if(cur->type != BOOK_INSERT_ROW)
+			continue;
+
+		std::string cur_head;
+		GetTargetText(cur->name, cur->name2->prev, cur_head);
+
+		// Size of the row with ; that becomes a comma
+		size_t row_size = 0;
+
+		for(Token *token = cur->name2; token != nullptr; token = token->next)
+		{
+			row_size += token->GetTargetLength();
+
+			if(token == cur->book)
+				break;
+		}
+
+		// Only whitespace can be between statements, comments and other statements end the batch
+		size_t gap_size = 0;
+		bool gap = (prev != nullptr);
+
+		for(Token *token = (prev != nullptr) ? prev->book->next : nullptr; gap; token = token->next)
+		{
+			if(token == cur->name)
+				break;
+
+			if(token == nullptr || !token->IsBlank())
+				gap = false;
+			else
+				gap_size += token->GetTargetLength();
+		}
+
+		if(gap && rows < _option_insert_batch && cur_head == head && size + gap_size + row_size <= (size_t)_option_max_allowed_packet)
+		{
+			TOKEN_CHANGE(prev->book, ",");
+
+			// Whitespace between statements is kept
+			for(Token *token = cur->name; token != cur->name2; token = token->next)
+				Token::Remove(token, false);
+
+			size += gap_size + row_size;
+			rows++;
+		}
+		else
+		{
+			head = cur_head;
+			size = head.length() + row_size;
+			rows = 1;
+		}
+
+		prev = cur;
+	}
+}
+
+// Convert sequences assigned to columns by BEFORE INSERT triggers to AUTO_INCREMENT columns
+void SqlParser::PostSequenceTriggers()
+{
+    if(_sequence_triggers.empty())
+		return;
+
+	// The first sequence with the name, used by triggers created before the sequence
+	std::unordered_map<std::string, int> first_sequences;
+
+	for(size_t i = 0; i < _sequences.size(); i++)
+		first_sequences.insert(std::pair<std::string, int>(GetNameKey(_sequences[i].name), (int)i));
+
+	// Triggers of each sequence
+	std::vector<std::vector<size_t> > seq_triggers(_sequences.size());
+	std::set<Token*> trigger_refs;
+
+	for(size_t i = 0; i < _sequence_triggers.size(); i++)
+	{
+		SequenceTrigger &trigger = _sequence_triggers[i];
+
+		// Sequence is defined after the trigger
+        if(trigger.sequence == -1)
+		{
+			std::unordered_map<std::string, int>::iterator j = first_sequences.find(GetSequenceKey(trigger.nextval));
+
+            if(j != first_sequences.end())
+				trigger.sequence = j->second;
+		}
+
+        if(trigger.sequence != -1)
+			seq_triggers[trigger.sequence].push_back(i);
+
+		trigger_refs.insert(trigger.nextval);
+	}
+
+	// Number of NEXTVAL and CURRVAL references in other statements by sequence, they need the sequence
+	std::unordered_map<std::string, int> other_refs;
+
+	for(Token *token = _tokens.GetFirstNoCurrent(); token != nullptr; token = token->next)
+	{
+        if(IsSequenceReference(token, nullptr) == true && trigger_refs.find(token) == trigger_refs.end())
+			other_refs[GetSequenceKey(token)]++;
+	}
+
+	// Only one AUTO_INCREMENT column is allowed in the table
+	std::set<Token*> auto_tables;
+
+	for(size_t i = 0; i < _sequences.size(); i++)
+	{
+		OracleSequence &seq = _sequences[i];
+
+        if(seq_triggers[i].empty())
+			continue;
+
+		SequenceTrigger *first = &_sequence_triggers[seq_triggers[i][0]];
+
+		bool convert = true;
+
+		// Sequence shared by tables or columns
+		for(size_t j = 1; j < seq_triggers[i].size() && convert; j++)
+		{
+            if(_sequence_triggers[seq_triggers[i][j]].column_end != first->column_end)
+				convert = false;
+		}
+
+        if(other_refs.find(GetNameKey(seq.name)) != other_refs.end())
+			convert = false;
+
+		// The table is defined more than once, so the trigger can apply to another definition
+        if(_table_definitions[GetNameKey(first->table)] > 1)
+			convert = false;
+
+		// Increment is set for the server or session in MySQL, and AUTO_INCREMENT does not cycle
+        if((seq.increment_by != nullptr && TOKEN_CMP(seq.increment_by, "1") == false) || seq.cycle == true)
+			convert = false;
+
+		// AUTO_INCREMENT column must be an integer and the first column of a key
+        if(convert == true)
+		{
+			std::vector<std::vector<Token*> > keys;
+			bool key = false;
+
+            if(auto_tables.find(first->table) == auto_tables.end() && OracleIsIntegerColumn(first->table, first->column) == true &&
+				GetTableKeys(first->table, keys) == true)
+			{
+				for(size_t k = 0; k < keys.size() && !key; k++)
+					key = (keys[k].empty() == false && Token::Compare(keys[k][0], first->column) == true);
+			}
+
+			convert = key;
+		}
+
+        if(convert == false)
+		{
+			CREATE_TAB_STMS_STATS("Sequence and trigger not converted to AUTO_INCREMENT")
+			continue;
+		}
+
+		AppendNoFormat(first->column_end, " AUTO_INCREMENT", L" AUTO_INCREMENT", 15);
+
+		// START WITH becomes the initial AUTO_INCREMENT value of the table
+        if(seq.start_with != nullptr && seq.start_with->IsNumeric() == true && TOKEN_CMP(seq.start_with, "1") == false)
+		{
+			std::unordered_map<Token*, Book*>::iterator col_all_end = _table_end_books.find(first->table);
+
+            if(col_all_end != _table_end_books.end())
+			{
+				std::string option(" AUTO_INCREMENT = ");
+				option.append(seq.start_with->str, seq.start_with->len);
+
+				AppendNoFormat(col_all_end->second->book, option.c_str(), nullptr, option.length());
+			}
+		}
+
+		// Triggers and sequence are not needed anymore
+		for(size_t j = 0; j < seq_triggers[i].size(); j++)
+			RemoveStatement(_sequence_triggers[seq_triggers[i][j]].create, _sequence_triggers[seq_triggers[i][j]].end);
+
+		RemoveStatement(seq.create, seq.end);
+
+		seq.auto_increment = true;
+		auto_tables.insert(first->table);
+
+		CREATE_TAB_STMS_STATS("Sequence and trigger converted to AUTO_INCREMENT")
+	}
+}
+
+// Record sequences converted to AUTO_INCREMENT and sequences referenced in the file (the references in removed triggers are not counted)
+void SqlParser::PostSequenceUsage()
+{
+	std::set<std::string> refs;
+
+	for(Token *token = _tokens.GetFirstNoCurrent(); token != nullptr; token = token->next)
+	{
+        if(token->IsRemoved() == false && IsSequenceReference(token, nullptr) == true)
+			refs.insert(GetSequenceKey(token));
+	}
+
+	for(std::set<std::string>::iterator i = refs.begin(); i != refs.end(); i++)
+	{
+		SequenceUsage usage;
+
+		usage.name = *i;
+		usage.file = _option_cur_file;
+
+		_sequence_usage.push_back(usage);
+	}
+
+	for(size_t i = 0; i < _sequences.size(); i++)
+	{
+        if(_sequences[i].auto_increment == false)
+			continue;
+
+		SequenceUsage usage;
+
+		usage.name = GetNameKey(_sequences[i].name);
+		usage.file = _option_cur_file;
+		usage.auto_increment = true;
+
+		_sequence_usage.push_back(usage);
+	}
+}
+
+// Replace sequences that are not converted to AUTO_INCREMENT with rows of the sequence emulation table
+void SqlParser::PostSequenceEmulation()
+{
+	bool emulation = false;
+
+	for(size_t i = 0; i < _sequences.size(); i++)
+	{
+		OracleSequence &seq = _sequences[i];
+
+        if(seq.auto_increment == true)
+			continue;
+
+		std::string inc = GetSequenceValue(seq.increment_by, "1");
+		bool desc = (inc[0] == '-');
+
+		// Oracle defaults depend on the direction of the sequence
+		std::string min = GetSequenceValue(seq.min_value, desc ? "-999999999999999999999999999" : "1");
+		std::string max = GetSequenceValue(seq.max_value, desc ? "-1" : "9999999999999999999999999999");
+		std::string start = GetSequenceValue(seq.start_with, desc ? max.c_str() : min.c_str());
+
+		// CACHE 20 is the default, NOCACHE reserves a single value
+		std::string cache = seq.nocache ? "1" : GetSequenceValue(seq.cache, "20");
+
+		std::string stmt;
+
+        if(emulation == false)
+		{
+			stmt = g_sequence_emulation;
+			emulation = true;
+		}
+
+		stmt += "INSERT INTO sqlines_sequences (name, next_value, increment_by, min_value, max_value, cache_size, cycle_option)\n";
+		stmt += "  VALUES ('";
+		stmt.append(seq.name->str, seq.name->len);
+		stmt += "', " + start + ", " + inc + ", " + min + ", " + max + ", " + cache + ", " + (seq.cycle ? "1" : "0") + ");";
+
+		Token::Remove(seq.create, seq.end);
+		AppendNoFormat(seq.end, stmt.c_str(), nullptr, stmt.length());
+
+		CREATE_TAB_STMS_STATS("Sequence emulated with cached blocks of values")
+	}
+}
+
+// Rewrite cursor FOR loops in procedures and functions to set-based statements
+void SqlParser::PostCursorForLoops()
+{
+	std::vector<std::pair<Token*, Token*> > bodies;
+	GetProcedureBodies(bodies);
+
+	for(size_t i = 0; i < bodies.size(); i++)
+	{
+		Token *token = GetNextPatternToken(bodies[i].first);
+
+		while(token != nullptr && token != bodies[i].second)
+		{
+			Token *next = nullptr;
+
+            if(TOKEN_CMP(token, "FOR") && OracleCursorForLoop(token, bodies[i].first, bodies[i].second, &next) == true)
+				token = next;
+			else
+				token = GetNextPatternToken(token);
+		}
+	}
+}
+
+// Convert BULK COLLECT and FORALL in procedures and functions to temporary tables and set-based statements
+void SqlParser::PostBulkOperations()
+{
+	std::vector<std::pair<Token*, Token*> > bodies;
+	GetProcedureBodies(bodies);
+
+	for(size_t i = 0; i < bodies.size(); i++)
+		OracleBulkOperations(bodies[i].first, bodies[i].second);
+}
+
+// Convert Oracle optimizer hints to MySQL optimizer and index hints
+void SqlParser::PostOptimizerHints()
+{
+	for(Token *token = _tokens.GetFirstNoCurrent(); token != nullptr; token = token->next)
+	{
+        if(token->type != TOKEN_COMMENT || token->len < 5 || token->IsRemoved() || strncmp(token->str, "/*+", 3) != 0)
+			continue;
+
+		// Hint immediately follows the statement keyword
+		Token *stmt = token->prev;
+
+		while(stmt != nullptr && stmt->IsBlank())
+			stmt = stmt->prev;
+
+        if(stmt != nullptr && stmt->IsRemoved() == false &&
+			(TOKEN_CMP(stmt, "SELECT") || TOKEN_CMP(stmt, "UPDATE") || TOKEN_CMP(stmt, "DELETE")))
+			OptimizerHints(stmt, token);
+	}
+}
+
+// Create global temporary tables as TEMPORARY tables in procedures and functions using them
+void SqlParser::PostSessionTempTables()
+{
+    if(_temp_tables.empty())
+		return;
+
+	// Tables are created by sessions, the global definition is kept as a comment
+	for(size_t i = 0; i < _temp_tables.size(); i++)
+	{
+		Comment(_temp_tables[i].create, _temp_tables[i].end);
+		CREATE_TAB_STMS_STATS("Global temporary table created as TEMPORARY table in procedures")
+	}
+
+	std::vector<std::pair<Token*, Token*> > bodies;
+	GetProcedureBodies(bodies);
+
+	for(size_t i = 0; i < bodies.size(); i++)
+		PostSessionTempTablesUnit(bodies[i].first, bodies[i].second);
+}
+
+// Create temporary tables at the beginning of the procedure body, and emulate ON COMMIT DELETE ROWS at commit points
+void SqlParser::PostSessionTempTablesUnit(Token *begin, Token *end)
+{
+	ClearSplScope();
+
+	// ; of COMMIT and ROLLBACK statements
+	std::vector<Token*> commits;
+
+	Token *prev = begin;
+
+	for(Token *token = GetNextPatternToken(begin); token != nullptr && token != end; token = GetNextPatternToken(token))
+	{
+        if(token->IsRemoved())
+			continue;
+
+		// ROLLBACK TO SAVEPOINT does not end the transaction
+        if(TOKEN_CMP(token, "COMMIT") || (TOKEN_CMP(token, "ROLLBACK") && TOKEN_CMP(GetNextPatternToken(token), "TO") == false))
+		{
+			Token *semi = GetNextPatternToken(token);
+
+			while(semi != nullptr && semi != end && semi->Compare(';', L';') == false)
+				semi = GetNextPatternToken(semi);
+
+            if(semi != nullptr && semi != end)
+				commits.push_back(semi);
+		}
+		else
+		// Table reference, not a qualified column
+        if(prev->Compare('.', L'.') == false)
+		{
+			for(size_t i = 0; i < _temp_tables.size(); i++)
+			{
+                if(Token::Compare(token, _temp_tables[i].name) == false)
+					continue;
+
+				bool created = false;
+
+				for(ListwItem *j = _spl->created_session_tables.GetFirst(); j != nullptr && !created; j = j->next)
+					created = ((Token*)j->value == _temp_tables[i].name);
+
+                if(created == false)
+					_spl->created_session_tables.Add(_temp_tables[i].name);
+
+				break;
+			}
+		}
+
+		prev = token;
+	}
+
+	std::string indent = GetLineIndent(GetNextPatternToken(begin));
+
+	for(ListwItem *i = _spl->created_session_tables.GetFirst(); i != nullptr; i = i->next)
+	{
+		Token *name = (Token*)i->value;
+		OracleTempTable *temp = nullptr;
+
+		for(size_t j = 0; j < _temp_tables.size() && temp == nullptr; j++)
+		{
+            if(_temp_tables[j].name == name)
+				temp = &_temp_tables[j];
+		}
+
+		// IF NOT EXISTS as the table can be already created by another procedure in the session
+		std::string columns;
+		GetTargetText(temp->name, temp->close, columns);
+
+		std::string stmt = "\n" + indent + "CREATE TEMPORARY TABLE IF NOT EXISTS ";
+
+		for(size_t j = 0; j < columns.length(); j++)
+		{
+			stmt += columns[j];
+
+            if(columns[j] == '\n')
+				stmt += indent;
+		}
+
+        if(OracleIsMemoryEngineTable(temp->name) == true)
+		{
+			stmt += " ENGINE = MEMORY";
+			CREATE_TAB_STMS_STATS("Global temporary table created with MEMORY engine")
+		}
+
+		stmt += ";";
+
+		AppendNoFormat(begin, stmt.c_str(), nullptr, stmt.length());
+
+        if(temp->delete_rows == false)
+			continue;
+
+		// Rows are deleted at the end of transaction
+		for(size_t j = 0; j < commits.size(); j++)
+		{
+			std::string truncate = "\n" + GetLineIndent(commits[j]) + "TRUNCATE TABLE ";
+			truncate.append(name->str, name->len);
+			truncate += ";";
+
+			AppendNoFormat(commits[j], truncate.c_str(), nullptr, truncate.length());
+
+			CREATE_TAB_STMS_STATS("ON COMMIT DELETE ROWS emulated with TRUNCATE")
+		}
+	}
+
+	ClearSplScope();
+}
+
+// Get the numeric value of the sequence option, or the default value
+std::string SqlParser::GetSequenceValue(Token *value, const char *default_value)
+{
+    if(value == nullptr || value->str == nullptr || value->IsNumeric() == false)
+		return default_value;
+
+	return std::string(value->str, value->len);
+}
+
+// Remove the statement with / terminator and blank lines after it
+void SqlParser::RemoveStatement(Token *first, Token *last)
+{
+    if(first == nullptr || last == nullptr)
+		return;
+
+	Token::Remove(first, last);
+
+	Token *remove_last = nullptr;
+	bool slash = false;
+
+	for(Token *token = last->next; token != nullptr; token = token->next)
+	{
+		// / terminator of SQL*Plus can follow the statement
+        if(slash == false && token->Compare('/', L'/') == true)
+			slash = true;
+		else
+        if(token->IsBlank() == false)
+			break;
+		else
+        if(token->Compare('\n', L'\n') == false)
+			continue;
+
+		remove_last = token;
+	}
+
+    if(remove_last != nullptr)
+		Token::Remove(last->next, remove_last);
+}
+
+// Find bodies of procedures and functions, BEGIN and the token following the body
+void SqlParser::GetProcedureBodies(std::vector<std::pair<Token*, Token*> > &bodies)
+{
+	Token *prev = nullptr;
+	Token *unit = nullptr;
+	Token *begin = nullptr;
+
+	for(Token *token = _tokens.GetFirstNoCurrent(); token != nullptr; token = token->next)
+	{
+        if(token->IsBlank() == true || token->type == TOKEN_COMMENT || (token->flags & TOKEN_INSERTED) || token->IsRemoved())
+			continue;
+
+		// CREATE [OR REPLACE] [EDITIONABLE] PROCEDURE | FUNCTION
+		bool start = ((TOKEN_CMP(token, "PROCEDURE") || TOKEN_CMP(token, "FUNCTION")) &&
+			(TOKEN_CMP(prev, "CREATE") || TOKEN_CMP(prev, "REPLACE") || TOKEN_CMP(prev, "EDITIONABLE") || TOKEN_CMP(prev, "NONEDITIONABLE")));
+
+		// Next CREATE statement or / terminator at the beginning of line
+		bool end = TOKEN_CMP(token, "CREATE");
+
+        if(token->Compare('/', L'/') == true)
+		{
+			Token *line = token->prev;
+
+			while(line != nullptr && (line->Compare(' ', L' ') == true || line->Compare('\t', L'\t') == true))
+				line = line->prev;
+
+			end = (line == nullptr || line->Compare('\n', L'\n') == true);
+		}
+
+        if(begin != nullptr && (start == true || end == true))
+		{
+			bodies.push_back(std::pair<Token*, Token*>(begin, token));
+			begin = nullptr;
+		}
+
+        if(start == true)
+			unit = token;
+		else
+        if(end == true)
+			unit = nullptr;
+		else
+		// Body follows the declarations
+        if(unit != nullptr && begin == nullptr && TOKEN_CMP(token, "BEGIN"))
+			begin = token;
+
+		prev = token;
+	}
+
+    if(begin != nullptr)
+		bodies.push_back(std::pair<Token*, Token*>(begin, (Token*)nullptr));
+}
+
+// Get spaces and tabs at the beginning of the line containing the token
+std::string SqlParser::GetLineIndent(Token *token)
+{
+	std::string indent;
+
+    if(token == nullptr)
+		return indent;
+
+	for(Token *cur = token->prev; cur != nullptr; cur = cur->prev)
+	{
+        if(cur->Compare('\n', L'\n') == true)
+			break;
+
+		// Use the indent of the line only
+        if(cur->Compare(' ', L' ') == false && cur->Compare('\t', L'\t') == false)
+			indent.clear();
+		else
+			indent.insert(0, 1, cur->chr);
+	}
+
+	return indent;
+}
+
+// Get the target text of tokens from first to last
+void SqlParser::GetTargetText(Token *first, Token *last, std::string &text)
+{
+	size_t len = 0;
+
+	for(Token *token = first; token != nullptr; token = token->next)
+	{
+		len += token->GetTargetLength();
+
+		if(token == last)
+			break;
+	}
+
+	char *target = new char[len + 1];
+	int target_len = 0;
+
+	for(Token *token = first; token != nullptr; token = token->next)
+	{
+		token->AppendTarget(target, &target_len);
+
+		if(token == last)
+			break;
+	}
+
+	text.assign(target, target_len);
+
+	delete [] target;
 }
@@ -1,11 +1,47 @@
 #include <stdio.h>
 #include <string.h>
+#include <thread>
 #include "report.h"
 #include "sqlparser.h"
 #include "str.h"
 #include "doc.h"
 #include "file.h"
 
+// Report macro names by id
+static const char *g_report_macros[] = 
+{
+	"summary",
+	"datatypes_table",
+	"udt_datatypes_table",
+	"udt_datatype_dtl_table",
+	"datatype_dtl_table",
+	"builtin_func_table",
+	"builtin_func_dtl_table",
+	"udf_func_table",
+	"seq_table",
+	"seq_dtl_table",
+	"seq_opt_dtl_table",
+	"seq_ref_table",
+	"seq_ref_dtl_table",
+	"system_proc_table",
+	"system_proc_dtl_table",
+	"statements_table",
+	"crtab_stmt_table",
+	"alttab_stmt_table",
+	"select_stmt_table",
+	"crproc_stmt_table",
+	"pl_statements",
+	"pl_statements_exceptions",
+	"packages",
+	"pkg_statements_items",
+	"quoted_idents_table",
+	"nonascii_idents",
+	"strings_table",
+	"numbers_table",
+	"words_table",
+	"delimiters_table"
+};
+
 // Constructor
 Report::Report()
 {
@@ -14,11 +50,21 @@ Report::Report()
 	_report_snippets_path = SQLEXEC_REPORT_SNIPPETS;
 
     _summary = "";
+	_stats = nullptr;
 	
 	_source = 0;
 	_target = 0;
 	_source_url = "";
 	_target_url = "";
+
+	_tpl_input = nullptr;
+	_snippets_page = 0;
+}
+
+// Destructor
+Report::~Report()
+{
+	delete[] _tpl_input;
 }
 
 // Create a report file by template
@@ -30,6 +76,7 @@ void Report::CreateReport(Stats *stats, int source, int target, const char *summ
 	_source = source;
 	_target = target;
     _summary = summary;
+	_stats = stats;
 
 	_source_name = GetDbName(_source);
 	_target_name = GetDbName(_target);
@@ -37,13 +84,201 @@ void Report::CreateReport(Stats *stats, int source, int target, const char *summ
 	_source_url = GetUrlName(_source);
 	_target_url = GetUrlName(_target);
 
+	// Template is compiled once and reused for subsequent reports
+	if(_tpl_input == nullptr && !CompileTemplate())
+		return;
+
+    FILE *file = fopen(_report_path, "w+");
+	FILE *snippets_file = fopen(_report_snippets_path, "w+");
+    
+    if(file == nullptr)
+    {
+        printf("\n\nError: Cannot create report file %s", _report_path);
+        return;
+    }
+
+    if(snippets_file == nullptr)
+    {
+        printf("\n\nError: Cannot create report snippets file %s", _report_snippets_path);
+        return;
+    }
+
+	// Sections are streamed to the files as rows are rendered
+	ReportWriter data(file);
+	ReportWriter snippets(snippets_file);
+
+	// Position of the rendered section by macro id
+	std::map<int, size_t> rendered;
+	std::vector<ReportTask> tasks;
+
+	// Number of times each macro is used in the template
+	std::map<int, int> occurrences;
+
+	for(size_t i = 0; i < _tpl_segments.size(); i++)
+	{
+		if(_tpl_segments[i].type == REPORT_SEGMENT_MACRO && _tpl_segments[i].macro != -1)
+			occurrences[_tpl_segments[i].macro]++;
+	}
+
+	// When snippets are split to pages, sections do not share any output and are rendered in parallel
+	if(_snippets_page > 0)
+	{
+		for(size_t i = 0; i < _tpl_segments.size(); i++)
+		{
+			ReportSegment &segment = _tpl_segments[i];
+
+			if(segment.type != REPORT_SEGMENT_MACRO || !IsDataInSection(stats, segment.macro) || 
+				rendered.find(segment.macro) != rendered.end())
+				continue;
+
+			rendered[segment.macro] = tasks.size();
+
+			tasks.push_back(ReportTask());
+			tasks.back().segment = i;
+		}
+
+		RenderSections(stats, tasks);
+	}
+
+	size_t i = 0;
+
+	while(i < _tpl_segments.size())
+	{
+		ReportSegment &segment = _tpl_segments[i];
+
+		// Forward template text to the report files as is
+		if(segment.type == REPORT_SEGMENT_TEXT)
+		{
+			data.Write(segment.str, segment.len);
+			snippets.Write(segment.str, segment.len);
+		}
+		else
+		// Skip the entire section if there is no data for it
+		if(segment.type == REPORT_SEGMENT_IFEXISTS)
+		{
+			if(!IsDataInSection(stats, segment.macro))
+			{
+				i = segment.skip_to;
+				continue;
+			}
+		}
+		else
+		{
+			std::map<int, size_t>::iterator r = rendered.find(segment.macro);
+
+			// Macro used more than once is rendered at its first use, and its snippets are written once
+			if(r == rendered.end() && occurrences[segment.macro] > 1)
+			{
+				r = rendered.insert(std::make_pair(segment.macro, tasks.size())).first;
+
+				tasks.push_back(ReportTask());
+				tasks.back().segment = i;
+				tasks.back().written = true;
+
+				ReportWriter section_data(&tasks.back().data);
+
+				{
+					ReportSnippets section_snippets(snippets, _report_snippets_path, segment.name, _snippets_page);
+					GetReportSection(stats, segment.macro, segment.name, section_data, section_snippets);
+				}
+
+				section_data.Flush();
+			}
+
+			if(r != rendered.end())
+			{
+				ReportTask &task = tasks[r->second];
+
+				data += task.data;
+
+				if(!task.written)
+				{
+					snippets += task.index;
+					task.written = true;
+				}
+			}
+			else
+			{
+				ReportSnippets section_snippets(snippets, _report_snippets_path, segment.name, _snippets_page);
+				GetReportSection(stats, segment.macro, segment.name, data, section_snippets);
+			}
+		}
+
+		i++;
+	}
+
+	data.Flush();
+	snippets.Flush();
+
+    fclose(file);
+	fclose(snippets_file);
+
+	if(!_export_path.empty())
+		CreateExport(stats);
+
+	stats->CloseSnippetFiles();
+}
+
+// Render sections in parallel when their snippets are written to separate pages
+void Report::RenderSections(Stats *stats, std::vector<ReportTask> &tasks)
+{
+	if(tasks.empty())
+		return;
+
+	size_t workers = std::thread::hardware_concurrency();
+
+	if(workers == 0)
+		workers = 1;
+
+	if(workers > tasks.size())
+		workers = tasks.size();
+
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+
+	for(size_t i = 0; i < workers; i++)
+		threads.push_back(std::thread(&Report::RenderSectionsWorker, this, stats, &tasks, &next));
+
+	for(std::vector<std::thread>::iterator i = threads.begin(); i != threads.end(); i++)
+		(*i).join();
+}
+
+// Take the next section and render it to memory, snippets pages are written to their files
+void Report::RenderSectionsWorker(Stats *stats, std::vector<ReportTask> *tasks, std::atomic<size_t> *next)
+{
+	while(true)
+	{
+		size_t cur = (*next)++;
+
+		if(cur >= tasks->size())
+			break;
+
+		ReportTask &task = (*tasks)[cur];
+		ReportSegment &segment = _tpl_segments[task.segment];
+
+		ReportWriter data(&task.data);
+		ReportWriter index(&task.index);
+
+		{
+			ReportSnippets section_snippets(index, _report_snippets_path, segment.name, _snippets_page);
+			GetReportSection(stats, segment.macro, segment.name, data, section_snippets);
+		}
+
+		data.Flush();
+		index.Flush();
+	}
+}
+
+// Read the template and split it to text and macro segments
+bool Report::CompileTemplate()
+{
 	// Report template file size
 	int tpl_size = File::GetFileSize(_tpl_path);
 
 	if(tpl_size == -1)
 	{
         printf("\n\nError: Cannot open report template file %s", _tpl_path);
-        return;
+        return false;
 	}
  
 	char *tpl_input = new char[(size_t)tpl_size + 1];
@@ -52,686 +287,637 @@ void Report::CreateReport(Stats *stats, int source, int target, const char *summ
 	if(File::GetContent(_tpl_path, tpl_input, (size_t)tpl_size) == -1)
 	{
         delete[] tpl_input;
-		return;
+		return false;
 	}
 
 	tpl_input[tpl_size] = '\x0';
 
-	const char *cur = tpl_input;
+	_tpl_input = tpl_input;
+	_tpl_segments.clear();
 
-    FILE *file = fopen(_report_path, "w+");
-	FILE *snippets_file = fopen(_report_snippets_path, "w+");
-    
-    if(file == nullptr)
-    {
-        printf("\n\nError: Cannot create report file %s", _report_path);
-        return;
-    }
+	// Positions to continue from when ifexists conditions are false
+	std::vector<std::pair<size_t, const char*> > skips;
 
-    if(snippets_file == nullptr)
-    {
-        printf("\n\nError: Cannot create report snippets file %s", _report_snippets_path);
-        return;
-    }
+	const char *cur = tpl_input;
+	const char *text = cur;
 
     while(*cur != '\x0')
     {
         // Check for <?macro?> replacement macro
         if(cur[0] == '<' && cur[1] == '?')
         {
-			std::string macro;
-            std::string data;
-			std::string snippets;
+			if(cur > text)
+				AddTemplateSegment(REPORT_SEGMENT_TEXT, text, cur - text);
+
+			const char *start = cur;
 
 			cur += 2;
 
             while(*cur != '\x0' && *cur != '?')
-            {
-				macro += *cur;
 				cur++;
-            }
+
+			std::string macro(start + 2, cur - start - 2);
 
 			// Check for <?ifexists:macro> condition
 			if(_strnicmp(macro.c_str(), "ifexists:", 9) == 0)
-				cur = ProcessReportIfExists(stats, cur, macro.c_str() + 9);
-			else
 			{
-				GetReportSection(stats, macro, data, snippets); 
-
-				fprintf(file, "%s", data.c_str());
-				fprintf(snippets_file, "%s", snippets.c_str());
+				AddTemplateSegment(REPORT_SEGMENT_IFEXISTS, start, cur - start, macro.c_str() + 9);
+				skips.push_back(std::pair<size_t, const char*>(_tpl_segments.size() - 1, FindIfExistsEnd(cur, macro.c_str() + 9)));
 			}
+			else
+				AddTemplateSegment(REPORT_SEGMENT_MACRO, start, cur - start, macro.c_str());
 
 			// Consume closing ?>
 			if(*cur == '?' && cur[1] == '>')
 				cur += 2;
+
+			text = cur;
        }
-       // Forward character to the report file as is
        else
-       {
-			fputc(*cur, file);
-			fputc(*cur, snippets_file);
-
 			cur++;
-		}
     }
 
-    delete[] tpl_input;
+	if(cur > text)
+		AddTemplateSegment(REPORT_SEGMENT_TEXT, text, cur - text);
 
-    fclose(file);
-	fclose(snippets_file);
+	// Resolve the segments to continue from
+	for(std::vector<std::pair<size_t, const char*> >::iterator i = skips.begin(); i != skips.end(); i++)
+	{
+		size_t skip_to = (*i).first + 1;
+
+		while(skip_to < _tpl_segments.size() && _tpl_segments[skip_to].str < (*i).second)
+			skip_to++;
+
+		_tpl_segments[(*i).first].skip_to = skip_to;
+	}
+
+	return true;
 }
 
-// Check if there is data in section by name
-bool Report::IsDataInSection(Stats *stats, const char *macro)
+// Add a compiled template segment, macro names are resolved to ids
+void Report::AddTemplateSegment(short type, const char *str, size_t len, const char *macro)
 {
-	if((_stricmp(macro, "datatypes_table") == 0 && stats->_data_types.size() > 0) ||
-		(_stricmp(macro, "udt_datatypes_table") == 0 && stats->_udt_data_types.size() > 0) ||
-		(_stricmp(macro, "udt_datatype_dtl_table") == 0 && stats->_udt_data_types_dtl.size() > 0) ||
-		(_stricmp(macro, "datatype_dtl_table") == 0 && stats->_data_types_dtl.size() > 0) ||
-		(_stricmp(macro, "builtin_func_table") == 0 && stats->_builtin_func.size() > 0) ||
-		(_stricmp(macro, "builtin_func_dtl_table") == 0 && stats->_builtin_func_dtl.size() > 0) ||
-		(_stricmp(macro, "udf_func_table") == 0 && stats->_udf_func.size() > 0) ||
-		(_stricmp(macro, "seq_table") == 0 && stats->_sequences.size() > 0) ||
-		(_stricmp(macro, "seq_dtl_table") == 0 && stats->_sequences_dtl.size() > 0) ||
-		(_stricmp(macro, "seq_opt_dtl_table") == 0 && stats->_sequences_opt_dtl.size() > 0) ||
-		(_stricmp(macro, "seq_ref_table") == 0 && stats->_sequences_ref.size() > 0) ||
-		(_stricmp(macro, "seq_ref_dtl_table") == 0 && stats->_sequences_ref_dtl.size() > 0) ||
-		(_stricmp(macro, "system_proc_table") == 0 && stats->_system_proc.size() > 0) ||
-		(_stricmp(macro, "system_proc_dtl_table") == 0 && stats->_system_proc_dtl.size() > 0) ||
-		(_stricmp(macro, "statements_table") == 0 && stats->_statements.size() > 0) ||
-		(_stricmp(macro, "crtab_stmt_table") == 0 && stats->_crtab_statements.size() > 0) ||
-		(_stricmp(macro, "alttab_stmt_table") == 0 && stats->_alttab_statements.size() > 0) ||
-		(_stricmp(macro, "select_stmt_table") == 0 && stats->_select_statements_dtl.size() > 0) ||
-		(_stricmp(macro, "crproc_stmt_table") == 0 && stats->_crproc_statements_dtl.size() > 0) ||
-		(_stricmp(macro, "pl_statements") == 0 && stats->_pl_statements.size() > 0) ||
-		(_stricmp(macro, "pl_statements_exceptions") == 0 && stats->_pl_statements_exceptions.size() > 0) ||
-		(_stricmp(macro, "packages") == 0 && stats->_packages.size() > 0) ||
-		(_stricmp(macro, "pkg_statements_items") == 0 && stats->_pkg_statements_items.size() > 0) ||
-		(_stricmp(macro, "quoted_idents_table") == 0 && stats->_quoted_idents.size() > 0) ||
-		(_stricmp(macro, "nonascii_idents") == 0 && stats->_non_7bit_ascii_idents.size() > 0) ||
-		(_stricmp(macro, "strings_table") == 0 && stats->_strings.size() > 0) ||
-		(_stricmp(macro, "numbers_table") == 0 && stats->_numbers.size() > 0) ||
-		(_stricmp(macro, "words_table") == 0 && stats->_words.size() > 0) ||
-		(_stricmp(macro, "delimiters_table") == 0 && stats->_delimiters.size() > 0))
-		return true;
+	ReportSegment segment;
 
-	return false;
+	segment.type = type;
+	segment.str = str;
+	segment.len = len;
+
+	if(macro != nullptr)
+	{
+		segment.name = macro;
+		segment.macro = GetMacroId(macro);
+	}
+
+	_tpl_segments.push_back(segment);
 }
 
-// Handle <?ifexists:macro> condition
-const char* Report::ProcessReportIfExists(Stats *stats, const char *cur_tpl, const char *macro)
+// Find the position after <?/ifexists:macro?> end of condition
+const char* Report::FindIfExistsEnd(const char *cur_tpl, const char *macro)
 {
 	const char *cur = cur_tpl;
 
-	// Skip the entire section if there is no data for it
-	if(!IsDataInSection(stats, macro))
+	while(*cur != '\x0')
 	{
-		while(*cur != '\x0')
+		// Check for <?/...> end of ifexists
+		if(cur[0] == '<' && cur[1] == '?' && cur[2] == '/')
 		{
-			// Check for <?/...> end of ifexists
-			if(cur[0] == '<' && cur[1] == '?' && cur[2] == '/')
-			{
-				std::string end_macro;
+			cur += 3;
 
-				cur += 3;
+			const char *end_macro = cur;
 
-				while(*cur != '\x0' && *cur != '?')
-				{
-					end_macro += *cur;
-					cur++;
-				}
+			while(*cur != '\x0' && *cur != '?')
+				cur++;
 
-				if(_strnicmp(end_macro.c_str(), "ifexists:", 9) == 0 && strcmp(macro, end_macro.c_str() + 9) == 0)
-				{
-					// Consume closing >
-					if(*cur == '>')
-						cur++;
+			if(_strnicmp(end_macro, "ifexists:", 9) == 0 && strlen(macro) == (size_t)(cur - end_macro - 9) && 
+				strncmp(macro, end_macro + 9, cur - end_macro - 9) == 0)
+			{
+				// Consume closing ?>
+				if(*cur == '?' && cur[1] == '>')
+					cur += 2;
 
-					break;
-				}
+				break;
 			}
-			else
-				cur++;
-       }
+		}
+		else
+			cur++;
 	}
 
 	return cur;
 }
 
-// Fill the specified report section
-void Report::GetReportSection(Stats *stats, std::string &macro, std::string &data, std::string &snippets)
+// Get the macro id by name, -1 if the macro is unknown
+int Report::GetMacroId(const char *macro)
 {
-    char num[12];
-
-    int distinct = 0;
-    int occurrences = 0; 
-
-    // Table of all data types
-	if(_stricmp(macro.c_str(), "datatypes_table") == 0 && stats->_data_types.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Data Type</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_data_types, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct data types, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all user-defined and derived data types
-    if(_stricmp(macro.c_str(), "udt_datatypes_table") == 0 && stats->_udt_data_types.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Type</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_udt_data_types, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " types, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all user-defined and derived data type details
-    if(_stricmp(macro.c_str(), "udt_datatype_dtl_table") == 0 && stats->_udt_data_types_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Type</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_udt_data_types_dtl, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " types, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of data type details
-    if(_stricmp(macro.c_str(), "datatype_dtl_table") == 0 && stats->_data_types_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Data Type</th><th>" + _target_name + " Type</th><th>Notes</th><th>Occurrences</th></tr>\n";
-
-        GetReportSectionRows(stats->_data_types_dtl, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct data type specifications, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all built-in functions
-    if(_stricmp(macro.c_str(), "builtin_func_table") == 0 && stats->_builtin_func.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Function</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_builtin_func, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct functions, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all built-in functions details
-    if(_stricmp(macro.c_str(), "builtin_func_dtl_table") == 0 && stats->_builtin_func_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Function</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_builtin_func_dtl, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " function specifications, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all user-defined functions
-    if(_stricmp(macro.c_str(), "udf_func_table") == 0 && stats->_udf_func.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Function</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_udf_func, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct functions, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-	else
-    // Sequences
-    if(_stricmp(macro.c_str(), "seq_table") == 0 && stats->_sequences.size() > 0)
-    {
-		data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_sequences, data, snippets, &distinct, &occurrences);
-
-		data += "</table>";
-        data += "<p><b>Total:</b> ";
-		sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct statement";
-		data += SUFFIX(distinct);
-		data += ", ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrence";
-		data += SUFFIX(occurrences);
-		data += ".</p>";
-    }
-	else
-    // Sequence options
-    if(_stricmp(macro.c_str(), "seq_dtl_table") == 0 && stats->_sequences_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>"+ _source_name + " Option</th><th>Description</th><th>"+ _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_sequences_dtl, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-		sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct option";
-		data += SUFFIX(distinct);
-		data += ", ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrence";
-		data += SUFFIX(occurrences);
-		data += ".</p>";
-    }
-	else
-    // Sequence option details
-    if(_stricmp(macro.c_str(), "seq_opt_dtl_table") == 0 && stats->_sequences_opt_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Option</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_sequences_opt_dtl, data, snippets, &distinct, &occurrences, false, false, false);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-		sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct option value";
-		data += SUFFIX(distinct);
-		data += ", ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrence";
-		data += SUFFIX(occurrences);
-		data += ".</p>";
-    }
-	else
-    // Sequence references
-    if(_stricmp(macro.c_str(), "seq_ref_table") == 0 && stats->_sequences_ref.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Reference</th><th>Description</th><th>Conversion</th><th>Count</th></tr>";
+	for(int i = 0; i < REPORT_MACROS; i++)
+	{
+		if(_stricmp(macro, g_report_macros[i]) == 0)
+			return i;
+	}
 
-        GetReportSectionRows(macro, stats->_sequences_ref, data, snippets, &distinct, &occurrences);
+	return -1;
+}
 
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-		sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrence";
-		data += SUFFIX(occurrences);
-		data += ".</p>";
-    }
-	else
-    // Sequence reference details
-    if(_stricmp(macro.c_str(), "seq_ref_dtl_table") == 0 && stats->_sequences_ref_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Reference</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_sequences_ref_dtl, data, snippets, &distinct, &occurrences, false, false);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-		sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct reference";
-		data += SUFFIX(distinct);
-		data += ", ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrence";
-		data += SUFFIX(occurrences);
-		data += ".</p>";
-    }
-    else
-    // Table of all system procedures
-    if(_stricmp(macro.c_str(), "system_proc_table") == 0 && stats->_system_proc.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Procedure</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_system_proc, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct procedures, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all system procedures details
-    if(_stricmp(macro.c_str(), "system_proc_dtl_table") == 0 && stats->_system_proc_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Procedure</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_system_proc_dtl, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct procedures, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all statements
-    if(_stricmp(macro.c_str(), "statements_table") == 0 && stats->_statements.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_statements, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct statements, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of CREATE TABLE statements details
-    if(_stricmp(macro.c_str(), "crtab_stmt_table") == 0 && stats->_crtab_statements.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Details</th><th>Occurrences</th></tr>";
+// Check if there is data in section by id
+bool Report::IsDataInSection(Stats *stats, int macro_id)
+{
+	switch(macro_id)
+	{
+		case REPORT_DATATYPES_TABLE: return stats->_data_types.size() > 0;
+		case REPORT_UDT_DATATYPES_TABLE: return stats->_udt_data_types.size() > 0;
+		case REPORT_UDT_DATATYPE_DTL_TABLE: return stats->_udt_data_types_dtl.size() > 0;
+		case REPORT_DATATYPE_DTL_TABLE: return stats->_data_types_dtl.size() > 0;
+		case REPORT_BUILTIN_FUNC_TABLE: return stats->_builtin_func.size() > 0;
+		case REPORT_BUILTIN_FUNC_DTL_TABLE: return stats->_builtin_func_dtl.size() > 0;
+		case REPORT_UDF_FUNC_TABLE: return stats->_udf_func.size() > 0;
+		case REPORT_SEQ_TABLE: return stats->_sequences.size() > 0;
+		case REPORT_SEQ_DTL_TABLE: return stats->_sequences_dtl.size() > 0;
+		case REPORT_SEQ_OPT_DTL_TABLE: return stats->_sequences_opt_dtl.size() > 0;
+		case REPORT_SEQ_REF_TABLE: return stats->_sequences_ref.size() > 0;
+		case REPORT_SEQ_REF_DTL_TABLE: return stats->_sequences_ref_dtl.size() > 0;
+		case REPORT_SYSTEM_PROC_TABLE: return stats->_system_proc.size() > 0;
+		case REPORT_SYSTEM_PROC_DTL_TABLE: return stats->_system_proc_dtl.size() > 0;
+		case REPORT_STATEMENTS_TABLE: return stats->_statements.size() > 0;
+		case REPORT_CRTAB_STMT_TABLE: return stats->_crtab_statements.size() > 0;
+		case REPORT_ALTTAB_STMT_TABLE: return stats->_alttab_statements.size() > 0;
+		case REPORT_SELECT_STMT_TABLE: return stats->_select_statements_dtl.size() > 0;
+		case REPORT_CRPROC_STMT_TABLE: return stats->_crproc_statements_dtl.size() > 0;
+		case REPORT_PL_STATEMENTS: return stats->_pl_statements.size() > 0;
+		case REPORT_PL_STATEMENTS_EXCEPTIONS: return stats->_pl_statements_exceptions.size() > 0;
+		case REPORT_PACKAGES: return stats->_packages.size() > 0;
+		case REPORT_PKG_STATEMENTS_ITEMS: return stats->_pkg_statements_items.size() > 0;
+		case REPORT_QUOTED_IDENTS_TABLE: return stats->_quoted_idents.size() > 0;
+		case REPORT_NONASCII_IDENTS: return stats->_non_7bit_ascii_idents.size() > 0;
+		case REPORT_STRINGS_TABLE: return stats->_strings.size() > 0;
+		case REPORT_NUMBERS_TABLE: return stats->_numbers.size() > 0;
+		case REPORT_WORDS_TABLE: return stats->_words.size() > 0;
+		case REPORT_DELIMITERS_TABLE: return stats->_delimiters.size() > 0;
+	}
 
-        GetReportSectionRows(stats->_crtab_statements, data, &distinct, &occurrences);
+	return false;
+}
 
-        data += "</table>";
-    }
-    else
-    // Table of ALTER TABLE statements details
-    if(_stricmp(macro.c_str(), "alttab_stmt_table") == 0 && stats->_alttab_statements.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Details</th><th>Occurrences</th></tr>";
+// Fill the specified report section
+void Report::GetReportSection(Stats *stats, int macro_id, const std::string &macro, ReportWriter &data, ReportSnippets &snippets)
+{
+    int distinct = 0;
+    int occurrences = 0; 
 
-        GetReportSectionRows(stats->_alttab_statements, data, &distinct, &occurrences);
+    // Sections without data are not rendered
+    if(macro_id != REPORT_SUMMARY && !IsDataInSection(stats, macro_id))
+        return;
 
-        data += "</table>";
-    }
-	else
-	// SELECT statements details
-	if(_stricmp(macro.c_str(), "select_stmt_table") == 0 && stats->_select_statements_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Issue</th><th>Description</th><th>Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_select_statements_dtl, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct issues, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-	else
-    // Create procedure details
-    if(_stricmp(macro.c_str(), "crproc_stmt_table") == 0 && stats->_crproc_statements_dtl.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Issue</th><th>Description</th><th>Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_crproc_statements_dtl, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct issues, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all procedural statements
-    if(_stricmp(macro.c_str(), "pl_statements") == 0 && stats->_pl_statements.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_pl_statements, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct statements, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-	else
-    // Exceptions details
-    if(_stricmp(macro.c_str(), "pl_statements_exceptions") == 0 && stats->_pl_statements_exceptions.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Handler</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_pl_statements_exceptions, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct exception conditions, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-	else
-    // Table of all built-in packages
-    if(_stricmp(macro.c_str(), "packages") == 0 && stats->_packages.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Package</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_packages, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct packages, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-	else
-    // Table of all built-in packages details
-    if(_stricmp(macro.c_str(), "pkg_statements_items") == 0 && stats->_pkg_statements_items.size() > 0)
-    {
-        data += "<table><tr><th></th><th>" + _source_name + " Package</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
-
-        GetReportSectionRows(macro, stats->_pkg_statements_items, data, snippets, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct items, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all double quoted identifiers
-    if(_stricmp(macro.c_str(), "quoted_idents_table") == 0 && stats->_quoted_idents.size() > 0)
+    switch(macro_id)
     {
-        data += "<table><tr><th></th><th>Identifier</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_quoted_idents, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct quoted identifiers, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
+        // Table of all data types
+        case REPORT_DATATYPES_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Data Type</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_data_types, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct data types, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all user-defined and derived data types
+        case REPORT_UDT_DATATYPES_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Type</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_udt_data_types, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " types, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all user-defined and derived data type details
+        case REPORT_UDT_DATATYPE_DTL_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Type</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_udt_data_types_dtl, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " types, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of data type details
+        case REPORT_DATATYPE_DTL_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Data Type</th><th>" + _target_name + " Type</th><th>Notes</th><th>Occurrences</th></tr>\n";
+
+            GetReportSectionRows(stats->_data_types_dtl, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct data type specifications, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all built-in functions
+        case REPORT_BUILTIN_FUNC_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Function</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_builtin_func, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct functions, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all built-in functions details
+        case REPORT_BUILTIN_FUNC_DTL_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Function</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_builtin_func_dtl, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " function specifications, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all user-defined functions
+        case REPORT_UDF_FUNC_TABLE:
+            data += "<table><tr><th></th><th>Function</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_udf_func, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct functions, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Sequences
+        case REPORT_SEQ_TABLE:
+			data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_sequences, data, snippets, &distinct, &occurrences);
+
+			data += "</table>";
+            data += "<p><b>Total:</b> ";
+			data.Int(distinct);
+            data += " distinct statement";
+			data += SUFFIX(distinct);
+			data += ", ";
+            data.Int(occurrences);
+            data += " occurrence";
+			data += SUFFIX(occurrences);
+			data += ".</p>";
+            break;
+
+        // Sequence options
+        case REPORT_SEQ_DTL_TABLE:
+            data += "<table><tr><th></th><th>"+ _source_name + " Option</th><th>Description</th><th>"+ _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_sequences_dtl, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+			data.Int(distinct);
+            data += " distinct option";
+			data += SUFFIX(distinct);
+			data += ", ";
+            data.Int(occurrences);
+            data += " occurrence";
+			data += SUFFIX(occurrences);
+			data += ".</p>";
+            break;
+
+        // Sequence option details
+        case REPORT_SEQ_OPT_DTL_TABLE:
+            data += "<table><tr><th></th><th>Option</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_sequences_opt_dtl, data, snippets, &distinct, &occurrences, false, false, false);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+			data.Int(distinct);
+            data += " distinct option value";
+			data += SUFFIX(distinct);
+			data += ", ";
+            data.Int(occurrences);
+            data += " occurrence";
+			data += SUFFIX(occurrences);
+			data += ".</p>";
+            break;
+
+        // Sequence references
+        case REPORT_SEQ_REF_TABLE:
+            data += "<table><tr><th></th><th>Reference</th><th>Description</th><th>Conversion</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_sequences_ref, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+			data.Int(occurrences);
+            data += " occurrence";
+			data += SUFFIX(occurrences);
+			data += ".</p>";
+            break;
+
+        // Sequence reference details
+        case REPORT_SEQ_REF_DTL_TABLE:
+            data += "<table><tr><th></th><th>Reference</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_sequences_ref_dtl, data, snippets, &distinct, &occurrences, false, false);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+			data.Int(distinct);
+            data += " distinct reference";
+			data += SUFFIX(distinct);
+			data += ", ";
+            data.Int(occurrences);
+            data += " occurrence";
+			data += SUFFIX(occurrences);
+			data += ".</p>";
+            break;
+
+        // Table of all system procedures
+        case REPORT_SYSTEM_PROC_TABLE:
+            data += "<table><tr><th></th><th>Procedure</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_system_proc, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct procedures, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all system procedures details
+        case REPORT_SYSTEM_PROC_DTL_TABLE:
+            data += "<table><tr><th></th><th>Procedure</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_system_proc_dtl, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct procedures, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all statements
+        case REPORT_STATEMENTS_TABLE:
+            data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_statements, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct statements, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of CREATE TABLE statements details
+        case REPORT_CRTAB_STMT_TABLE:
+            data += "<table><tr><th></th><th>Details</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_crtab_statements, data, &distinct, &occurrences);
+
+            data += "</table>";
+            break;
+
+        // Table of ALTER TABLE statements details
+        case REPORT_ALTTAB_STMT_TABLE:
+            data += "<table><tr><th></th><th>Details</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_alttab_statements, data, &distinct, &occurrences);
+
+            data += "</table>";
+            break;
+
+        // SELECT statements details
+        case REPORT_SELECT_STMT_TABLE:
+            data += "<table><tr><th></th><th>Issue</th><th>Description</th><th>Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_select_statements_dtl, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct issues, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Create procedure details
+        case REPORT_CRPROC_STMT_TABLE:
+            data += "<table><tr><th></th><th>Issue</th><th>Description</th><th>Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_crproc_statements_dtl, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct issues, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all procedural statements
+        case REPORT_PL_STATEMENTS:
+            data += "<table><tr><th></th><th>" + _source_name + " Statement</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_pl_statements, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct statements, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Exceptions details
+        case REPORT_PL_STATEMENTS_EXCEPTIONS:
+            data += "<table><tr><th></th><th>" + _source_name + " Handler</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_pl_statements_exceptions, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct exception conditions, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all built-in packages
+        case REPORT_PACKAGES:
+            data += "<table><tr><th></th><th>" + _source_name + " Package</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_packages, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct packages, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all built-in packages details
+        case REPORT_PKG_STATEMENTS_ITEMS:
+            data += "<table><tr><th></th><th>" + _source_name + " Package</th><th>Description</th><th>" + _target_name + " Conversion</th><th>Complexity</th><th>Count</th></tr>";
+
+            GetReportSectionRows(macro, stats->_pkg_statements_items, data, snippets, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct items, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all double quoted identifiers
+        case REPORT_QUOTED_IDENTS_TABLE:
+            data += "<table><tr><th></th><th>Identifier</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_quoted_idents, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct quoted identifiers, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all non-ASCII 7-bit identifiers
+        case REPORT_NONASCII_IDENTS:
+            data += "<table><tr><th></th><th>Identifier</th><th>Count</th></tr>";
+
+            GetReportSectionRows(stats->_non_7bit_ascii_idents, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct identifiers, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all single quoted string literals
+        case REPORT_STRINGS_TABLE:
+            data += "<table><tr><th></th><th>String Literal</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_strings, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct string literals, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all numeric literals
+        case REPORT_NUMBERS_TABLE:
+            data += "<table><tr><th></th><th>Numeric Literal</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_numbers, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct numeric literals, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all words
+        case REPORT_WORDS_TABLE:
+            data += "<table><tr><th></th><th>Words</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_words, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct words, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Table of all delimiters
+        case REPORT_DELIMITERS_TABLE:
+            data += "<table><tr><th></th><th>Delimiters</th><th>Occurrences</th></tr>";
+
+            GetReportSectionRows(stats->_delimiters, data, &distinct, &occurrences);
+
+            data += "</table>";
+            data += "<p><b>Total:</b> ";
+            data.Int(distinct);
+            data += " distinct delimiters, ";
+            data.Int(occurrences);
+            data += " occurrences.</p>";
+            break;
+
+        // Summary
+        case REPORT_SUMMARY:
+            data += _summary;
+            break;
     }
-	else
-    // Table of all non-ASCII 7-bit identifiers
-    if(_stricmp(macro.c_str(), "nonascii_idents") == 0 && stats->_non_7bit_ascii_idents.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Identifier</th><th>Count</th></tr>";
-
-        GetReportSectionRows(stats->_non_7bit_ascii_idents, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct identifiers, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all single quoted string literals
-    if(_stricmp(macro.c_str(), "strings_table") == 0 && stats->_strings.size() > 0)
-    {
-        data += "<table><tr><th></th><th>String Literal</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_strings, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct string literals, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all numeric literals
-    if(_stricmp(macro.c_str(), "numbers_table") == 0 && stats->_numbers.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Numeric Literal</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_numbers, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct numeric literals, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all words
-    if(_stricmp(macro.c_str(), "words_table") == 0 && stats->_words.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Words</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_words, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct words, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Table of all delimiters
-    if(_stricmp(macro.c_str(), "delimiters_table") == 0 && stats->_delimiters.size() > 0)
-    {
-        data += "<table><tr><th></th><th>Delimiters</th><th>Occurrences</th></tr>";
-
-        GetReportSectionRows(stats->_delimiters, data, &distinct, &occurrences);
-
-        data += "</table>";
-        data += "<p><b>Total:</b> ";
-        sprintf(num, "%d", distinct);
-        data += num;
-        data += " distinct delimiters, ";
-        sprintf(num, "%d", occurrences);
-        data += num;
-        data += " occurrences.</p>";
-    }
-    else
-    // Summary
-    if(_stricmp(macro.c_str(), "summary") == 0)
-        data += _summary;
 }
 
 // Get report section
-void Report::GetReportSectionRows(std::string section, std::map<std::string, StatsSummaryItem> &values, std::string &data, 
-									std::string &snippets, int *distinct, int *occurrences)
+void Report::GetReportSectionRows(const std::string &section, StatsMap<StatsSummaryItem> &values, ReportWriter &data, 
+									ReportSnippets &section_snippets, int *distinct, int *occurrences)
 {
-    char num[12];
-
     int row = 1;
     int dist = 0;
     int occur = 0;
 
-    for(std::map<std::string, StatsSummaryItem>::iterator i = values.begin(); i != values.end(); i++, row++)
+    std::vector<std::pair<const std::string*, StatsSummaryItem*> > sorted;
+
+	// Items are unordered while collected, sort them once for rendering
+	values.GetSorted(_stats->_keys, sorted);
+
+    for(std::vector<std::pair<const std::string*, StatsSummaryItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++, row++)
     {
+		ReportWriter &snippets = section_snippets.NextItem();
+
         data += "<tr><td>";
-        sprintf(num, "%d", row);
-        data += num;
+        data.Int(row);
         data += "</td><td><a href=\"";
-		data += _report_snippets_path;
+		data += section_snippets.GetPagePath();
 		data += "#";
 		data += section;
 		data += "_";
-		data += (*i).first;
+		data += *(*i).first;
 		data += "\">";
-        data += (*i).first;
+        data += *(*i).first;
         data += "</a></td><td>";
 
-		StatsSummaryItem &item = (*i).second;
+		StatsSummaryItem &item = *(*i).second;
 		int cnt = 0;
 
 		data += item.desc;
@@ -741,8 +927,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		if(item.conv_undef > 0)
 		{
 			data += "<span class=\"td_warn1\">Requires Evaluation: ";
-			sprintf(num, "%d", item.conv_undef);
-			data += num;
+			data.Int(item.conv_undef);
             data += "</span> ";
 			data += SQLINES_REPORT_WARN_MARK;
 			cnt++;
@@ -755,8 +940,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += " ";
 
 			data += "Warnings: ";
-			sprintf(num, "%d", item.conv_warn);
-			data += num;
+			data.Int(item.conv_warn);
 			data += " ";
 			data += SQLINES_REPORT_WARN_MARK;
 			cnt++;
@@ -769,8 +953,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += " ";
 
 			data += "SQLines Can Convert: ";
-			sprintf(num, "%d", item.conv_ok);
-			data += num;
+			data.Int(item.conv_ok);
 			data += " ";
 			data += SQLINES_REPORT_OK_MARK;
 			cnt++;
@@ -783,8 +966,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += " ";
 
 			data += "No Conversion Required: ";
-			sprintf(num, "%d", item.conv_no_need);
-			data += num;
+			data.Int(item.conv_no_need);
 			data += " ";
 			data += SQLINES_REPORT_OK_MARK;
 			cnt++;
@@ -797,8 +979,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += " ";
 
 			data += "Cannot Migrate As Is: ";
-			sprintf(num, "%d", item.conv_error);
-			data += num;
+			data.Int(item.conv_error);
 			data += " ";
 			data += SQLINES_REPORT_ERROR_MARK;
 		}
@@ -809,8 +990,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		if(item.complexity_very_low > 0)
 		{
 			data += "Very low: ";
-			sprintf(num, "%d", item.complexity_very_low);
-			data += num;
+			data.Int(item.complexity_very_low);
 		}
 
 		if(item.complexity_low > 0)
@@ -819,8 +999,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += ", ";
 
 			data += "Low: ";
-			sprintf(num, "%d", item.complexity_low);
-			data += num;
+			data.Int(item.complexity_low);
 		}
 
 		if(item.complexity_medium > 0)
@@ -829,8 +1008,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += ", ";
 
 			data += "Medium: ";
-			sprintf(num, "%d", item.complexity_medium);
-			data += num;
+			data.Int(item.complexity_medium);
 		}
 
 		if(item.complexity_high > 0)
@@ -839,8 +1017,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += ", ";
 
 			data += "High: ";
-			sprintf(num, "%d", item.complexity_high);
-			data += num;
+			data.Int(item.complexity_high);
 		}
 	
 		if(item.complexity_very_high > 0)
@@ -850,13 +1027,11 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 				data += ", ";
 
 			data += "Very high: ";
-			sprintf(num, "%d", item.complexity_very_high);
-			data += num;
+			data.Int(item.complexity_very_high);
 		}
 
 		data += "</td><td>";
-        sprintf(num, "%d", item.occurrences);
-        data += num;
+        data.Int(item.occurrences);
         data += "</td></tr>\n";
 
         dist++;
@@ -867,34 +1042,35 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		snippets += "<a name=\"";
 		snippets += section;
 		snippets += "_";
-		snippets += (*i).first;
+		snippets += *(*i).first;
 		snippets += "\"></a>";
 
 		snippets += "<p>";
-		snippets += (*i).first;
+		snippets += *(*i).first;
 		snippets += " - ";
 		snippets += item.desc;
 		snippets += "</p>";
 
 		snippets += "<table><th></th><th>Filename:line</th><th>Source Code Snippet</th>";
 
-		// Get code snippets
-		for(std::list<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
+		std::string text;
+
+		// Get code snippets, the text is read from source files
+		for(std::vector<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
 		{
-			StatsSnippetItem sitem = *s;
+			StatsSnippetItem &sitem = *s;
 
 			snippets += "<tr><td>";
-			sprintf(num, "%d", srow);
-			snippets += num;
+			snippets.Int(srow);
 			snippets += "</td><td>";
 
-			snippets += sitem.filename;
+			snippets += _stats->GetSnippetFileName(sitem);
 			snippets += ":";
-			sprintf(num, "%d", sitem.line);
-			snippets += num;
+			snippets.Int(sitem.line);
 
 			snippets += "</td><td><pre>";
-			snippets += sitem.snippet;
+			_stats->GetSnippet(sitem, text, section_snippets._files);
+			snippets += text;
 			snippets += "</pre>";
 
 			snippets += "</td></tr>\n";
@@ -911,32 +1087,36 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 }
 
 // Get report section
-void Report::GetReportSectionRows(std::string section, std::map<std::string, StatsDetailItem> &values, std::string &data, 
-									std::string &snippets, int *distinct, int *occurrences, bool desc, bool note,
+void Report::GetReportSectionRows(const std::string &section, StatsMap<StatsDetailItem> &values, ReportWriter &data, 
+									ReportSnippets &section_snippets, int *distinct, int *occurrences, bool desc, bool note,
 									bool complexity)
 {
-    char num[12];
-
     int row = 1;
     int dist = 0;
     int occur = 0;
 
-    for(std::map<std::string, StatsDetailItem>::iterator i = values.begin(); i != values.end(); i++, row++)
+    std::vector<std::pair<const std::string*, StatsDetailItem*> > sorted;
+
+	// Items are unordered while collected, sort them once for rendering
+	values.GetSorted(_stats->_keys, sorted);
+
+    for(std::vector<std::pair<const std::string*, StatsDetailItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++, row++)
     {
+		ReportWriter &snippets = section_snippets.NextItem();
+
  		data += "<tr><td>";
-        sprintf(num, "%d", row);
-        data += num;
+        data.Int(row);
         data += "</td><td><a href=\"";
-		data += _report_snippets_path;
+		data += section_snippets.GetPagePath();
 		data += "#";
 		data += section;
 		data += "_";
-		data += (*i).first;
+		data += *(*i).first;
 		data += "\">";
-        data += (*i).first;
+        data += *(*i).first;
         data += "</a></td>";
 
-		StatsDetailItem &item = (*i).second;
+		StatsDetailItem &item = *(*i).second;
 
 		// Description
 		if(desc)
@@ -998,8 +1178,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		}
 
 		data += "<td>";
-        sprintf(num, "%d", item.count);
-        data += num;
+        data.Int(item.count);
         data += "</td></tr>";		
 
         dist++;
@@ -1010,34 +1189,35 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		snippets += "<a name=\"";
 		snippets += section;
 		snippets += "_";
-		snippets += (*i).first;
+		snippets += *(*i).first;
 		snippets += "\"></a>";
 
 		snippets += "<p>";
-		snippets += (*i).first;
+		snippets += *(*i).first;
 		snippets += " - ";
 		snippets += item.desc;
 		snippets += "</p>";
 
 		snippets += "<table><th></th><th>Filename:line</th><th>Source Code Snippet</th>";
 
-		// Get code snippets
-		for(std::list<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
+		std::string text;
+
+		// Get code snippets, the text is read from source files
+		for(std::vector<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
 		{
-			StatsSnippetItem sitem = *s;
+			StatsSnippetItem &sitem = *s;
 
 			snippets += "<tr><td>";
-			sprintf(num, "%d", srow);
-			snippets += num;
+			snippets.Int(srow);
 			snippets += "</td><td>";
 
-			snippets += sitem.filename;
+			snippets += _stats->GetSnippetFileName(sitem);
 			snippets += ":";
-			sprintf(num, "%d", sitem.line);
-			snippets += num;
+			snippets.Int(sitem.line);
 
 			snippets += "</td><td><pre>";
-			snippets += sitem.snippet;
+			_stats->GetSnippet(sitem, text, section_snippets._files);
+			snippets += text;
 			snippets += "</pre>";
 
 			snippets += "</td></tr>\n";
@@ -1054,32 +1234,34 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 }
 
 // Get report section
-void Report::GetReportSectionRows(std::map<std::string, StatsItem> &values, std::string &data,
+void Report::GetReportSectionRows(StatsMap<StatsItem> &values, ReportWriter &data,
                                   int *distinct, int *occurrences)
 {
-    char num[12];
-
     int row = 1;
     int dist = 0;
     int occur = 0;
 
-    for(std::map<std::string, StatsItem>::iterator i = values.begin(); i != values.end(); i++, row++)
+    std::vector<std::pair<const std::string*, StatsItem*> > sorted;
+
+	// Items are unordered while collected, sort them once for rendering
+	values.GetSorted(_stats->_keys, sorted);
+
+    for(std::vector<std::pair<const std::string*, StatsItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++, row++)
     {
         data += "<tr><td>";
-        sprintf(num, "%d", row);
-        data += num;
+        data.Int(row);
         data += "</td><td>";
-        data += (*i).first;
+        data += *(*i).first;
         data += "</td>";
 
         // The source was modified
-        if(!(*i).second.t_value.empty())
+        if(!(*i).second->t_value.empty())
         {
 			data += "<td>";
-            data += (*i).second.t_value;
+            data += (*i).second->t_value;
 			data += "</td><td>";
                 
-			if((*i).second.conv_status == STATS_CONV_ERROR)
+			if((*i).second->conv_status == STATS_CONV_ERROR)
             {
                 data += "Cannot Migrate As Is ";
 				data += SQLINES_REPORT_ERROR_MARK;
@@ -1094,10 +1276,10 @@ void Report::GetReportSectionRows(std::map<std::string, StatsItem> &values, std:
         else
         {
 			data += "<td>";
-            data += (*i).first;
+            data += *(*i).first;
 			data += "</td><td>";
 
-			if(!((*i).second.conv_status == STATS_CONV_NO_NEED))
+			if(!((*i).second->conv_status == STATS_CONV_NO_NEED))
             {
                 data += "Requires Evaluation ";
 				data += SQLINES_REPORT_WARN_MARK;
@@ -1110,12 +1292,11 @@ void Report::GetReportSectionRows(std::map<std::string, StatsItem> &values, std:
         }
 
         data += "</td><td>";
-        sprintf(num, "%d", (*i).second.occurrences);
-        data += num;
+        data.Int((*i).second->occurrences);
         data += "</td></tr>\n";
 
         dist++;
-        occur += (*i).second.occurrences;        
+        occur += (*i).second->occurrences;        
     }
 
     if(distinct != nullptr)
@@ -1125,29 +1306,30 @@ void Report::GetReportSectionRows(std::map<std::string, StatsItem> &values, std:
         *occurrences = occur;
 }
 
-void Report::GetReportSectionRows(std::map<std::string, int> &values, std::string &data,
+void Report::GetReportSectionRows(StatsMap<int> &values, ReportWriter &data,
                                   int *distinct, int *occurrences)
 {
-    char num[12];
-
     int row = 1;
     int dist = 0;
     int occur = 0;
 
-    for(std::map<std::string, int>::iterator i = values.begin(); i != values.end(); i++, row++)
+    std::vector<std::pair<const std::string*, int*> > sorted;
+
+	// Items are unordered while collected, sort them once for rendering
+	values.GetSorted(_stats->_keys, sorted);
+
+    for(std::vector<std::pair<const std::string*, int*> >::iterator i = sorted.begin(); i != sorted.end(); i++, row++)
     {
         data += "<tr><td>";
-        sprintf(num, "%d", row);
-        data += num;
+        data.Int(row);
         data += "</td><td>";
-        sprintf(num, "%d", (*i).second);
-        data += (*i).first;
+        data += *(*i).first;
         data += "</td><td>";
-        data += num;
+        data.Int(*(*i).second);
         data += "</td></tr>";
 
         dist++;
-        occur += (*i).second;        
+        occur += *(*i).second;        
     }
 
     if(distinct != nullptr)
@@ -1157,6 +1339,427 @@ void Report::GetReportSectionRows(std::map<std::string, int> &values, std::strin
         *occurrences = occur;
 }
 
+// Write all statistics collections to the export file, JSON or CSV by extension
+void Report::CreateExport(Stats *stats)
+{
+	FILE *file = fopen(_export_path.c_str(), "w");
+
+	if(file == nullptr)
+	{
+		printf("\n\nError: Cannot create report export file %s", _export_path.c_str());
+		return;
+	}
+
+	bool json = (_export_path.length() >= 5 && _stricmp(_export_path.c_str() + _export_path.length() - 5, ".json") == 0);
+	int rows = 0;
+
+	ReportWriter out(file);
+
+	if(json)
+		out += "[";
+	else
+	{
+		out += SQLEXEC_REPORT_EXPORT_COLUMNS;
+		out += "\n";
+	}
+
+	for(int i = 0; i < REPORT_MACROS; i++)
+		ExportSection(stats, i, out, json, &rows);
+
+	if(json)
+		out += "\n]\n";
+
+	out.Flush();
+	fclose(file);
+}
+
+// Write the statistics collection of the section
+void Report::ExportSection(Stats *stats, int macro_id, ReportWriter &out, bool json, int *rows)
+{
+	const char *section = g_report_macros[macro_id];
+
+	switch(macro_id)
+	{
+		case REPORT_DATATYPES_TABLE: ExportRows(section, stats->_data_types, out, json, rows); break;
+		case REPORT_UDT_DATATYPES_TABLE: ExportRows(section, stats->_udt_data_types, out, json, rows); break;
+		case REPORT_UDT_DATATYPE_DTL_TABLE: ExportRows(section, stats->_udt_data_types_dtl, out, json, rows); break;
+		case REPORT_DATATYPE_DTL_TABLE: ExportRows(section, stats->_data_types_dtl, out, json, rows); break;
+		case REPORT_BUILTIN_FUNC_TABLE: ExportRows(section, stats->_builtin_func, out, json, rows); break;
+		case REPORT_BUILTIN_FUNC_DTL_TABLE: ExportRows(section, stats->_builtin_func_dtl, out, json, rows); break;
+		case REPORT_UDF_FUNC_TABLE: ExportRows(section, stats->_udf_func, out, json, rows); break;
+		case REPORT_SEQ_TABLE: ExportRows(section, stats->_sequences, out, json, rows); break;
+		case REPORT_SEQ_DTL_TABLE: ExportRows(section, stats->_sequences_dtl, out, json, rows); break;
+		case REPORT_SEQ_OPT_DTL_TABLE: ExportRows(section, stats->_sequences_opt_dtl, out, json, rows); break;
+		case REPORT_SEQ_REF_TABLE: ExportRows(section, stats->_sequences_ref, out, json, rows); break;
+		case REPORT_SEQ_REF_DTL_TABLE: ExportRows(section, stats->_sequences_ref_dtl, out, json, rows); break;
+		case REPORT_SYSTEM_PROC_TABLE: ExportRows(section, stats->_system_proc, out, json, rows); break;
+		case REPORT_SYSTEM_PROC_DTL_TABLE: ExportRows(section, stats->_system_proc_dtl, out, json, rows); break;
+		case REPORT_STATEMENTS_TABLE: ExportRows(section, stats->_statements, out, json, rows); break;
+		case REPORT_CRTAB_STMT_TABLE: ExportRows(section, stats->_crtab_statements, out, json, rows); break;
+		case REPORT_ALTTAB_STMT_TABLE: ExportRows(section, stats->_alttab_statements, out, json, rows); break;
+		case REPORT_SELECT_STMT_TABLE: ExportRows(section, stats->_select_statements_dtl, out, json, rows); break;
+		case REPORT_CRPROC_STMT_TABLE: ExportRows(section, stats->_crproc_statements_dtl, out, json, rows); break;
+		case REPORT_PL_STATEMENTS: ExportRows(section, stats->_pl_statements, out, json, rows); break;
+		case REPORT_PL_STATEMENTS_EXCEPTIONS: ExportRows(section, stats->_pl_statements_exceptions, out, json, rows); break;
+		case REPORT_PACKAGES: ExportRows(section, stats->_packages, out, json, rows); break;
+		case REPORT_PKG_STATEMENTS_ITEMS: ExportRows(section, stats->_pkg_statements_items, out, json, rows); break;
+		case REPORT_QUOTED_IDENTS_TABLE: ExportRows(section, stats->_quoted_idents, out, json, rows); break;
+		case REPORT_NONASCII_IDENTS: ExportRows(section, stats->_non_7bit_ascii_idents, out, json, rows); break;
+		case REPORT_STRINGS_TABLE: ExportRows(section, stats->_strings, out, json, rows); break;
+		case REPORT_NUMBERS_TABLE: ExportRows(section, stats->_numbers, out, json, rows); break;
+		case REPORT_WORDS_TABLE: ExportRows(section, stats->_words, out, json, rows); break;
+		case REPORT_DELIMITERS_TABLE: ExportRows(section, stats->_delimiters, out, json, rows); break;
+	}
+}
+
+// Export items with the number of occurrences only
+void Report::ExportRows(const char *section, StatsMap<int> &values, ReportWriter &out, bool json, int *rows)
+{
+	std::vector<std::pair<const std::string*, int*> > sorted;
+	values.GetSorted(_stats->_keys, sorted);
+
+	for(std::vector<std::pair<const std::string*, int*> >::iterator i = sorted.begin(); i != sorted.end(); i++)
+	{
+		ReportExportRow row;
+
+		row.item = (*i).first;
+		row.occurrences = *(*i).second;
+
+		ExportRow(section, row, out, json, rows);
+	}
+}
+
+// Export items with the conversion result
+void Report::ExportRows(const char *section, StatsMap<StatsItem> &values, ReportWriter &out, bool json, int *rows)
+{
+	std::vector<std::pair<const std::string*, StatsItem*> > sorted;
+	values.GetSorted(_stats->_keys, sorted);
+
+	for(std::vector<std::pair<const std::string*, StatsItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++)
+	{
+		StatsItem &item = *(*i).second;
+		ReportExportRow row;
+
+		row.item = (*i).first;
+		row.target = &item.t_value;
+		row.note = &item.notes;
+		row.occurrences = item.occurrences;
+
+		if(item.conv_status >= STATS_CONV_UNDEFINED && item.conv_status <= STATS_CONV_ERROR)
+			row.conv[item.conv_status - STATS_CONV_UNDEFINED] = item.occurrences;
+
+		ExportRow(section, row, out, json, rows);
+	}
+}
+
+// Export summary items
+void Report::ExportRows(const char *section, StatsMap<StatsSummaryItem> &values, ReportWriter &out, bool json, int *rows)
+{
+	std::vector<std::pair<const std::string*, StatsSummaryItem*> > sorted;
+	values.GetSorted(_stats->_keys, sorted);
+
+	for(std::vector<std::pair<const std::string*, StatsSummaryItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++)
+	{
+		StatsSummaryItem &item = *(*i).second;
+		ReportExportRow row;
+
+		row.item = (*i).first;
+		row.desc = &item.desc;
+		row.occurrences = item.occurrences;
+
+		row.conv[0] = item.conv_undef;
+		row.conv[1] = item.conv_no_need;
+		row.conv[2] = item.conv_ok;
+		row.conv[3] = item.conv_warn;
+		row.conv[4] = item.conv_error;
+
+		row.complexity[0] = item.complexity_very_low;
+		row.complexity[1] = item.complexity_low;
+		row.complexity[2] = item.complexity_medium;
+		row.complexity[3] = item.complexity_high;
+		row.complexity[4] = item.complexity_very_high;
+
+		ExportRow(section, row, out, json, rows);
+	}
+}
+
+// Export detail items
+void Report::ExportRows(const char *section, StatsMap<StatsDetailItem> &values, ReportWriter &out, bool json, int *rows)
+{
+	std::vector<std::pair<const std::string*, StatsDetailItem*> > sorted;
+	values.GetSorted(_stats->_keys, sorted);
+
+	for(std::vector<std::pair<const std::string*, StatsDetailItem*> >::iterator i = sorted.begin(); i != sorted.end(); i++)
+	{
+		StatsDetailItem &item = *(*i).second;
+		ReportExportRow row;
+
+		row.item = (*i).first;
+		row.desc = &item.desc;
+		row.note = &item.note;
+		row.occurrences = item.count;
+
+		if(item.conv_status >= STATS_CONV_UNDEFINED && item.conv_status <= STATS_CONV_ERROR)
+			row.conv[item.conv_status - STATS_CONV_UNDEFINED] = item.count;
+
+		if(item.complexity >= STATS_CONV_VERY_LOW && item.complexity <= STATS_CONV_VERY_HIGH)
+			row.complexity[item.complexity - STATS_CONV_VERY_LOW] = item.count;
+
+		ExportRow(section, row, out, json, rows);
+	}
+}
+
+// Write an export item as CSV line or JSON object
+void Report::ExportRow(const char *section, ReportExportRow &row, ReportWriter &out, bool json, int *rows)
+{
+	static const char *columns[] = { "section", "item", "target", "description", "note", "occurrences", "conv_undef", "conv_no_need", 
+		"conv_ok", "conv_warn", "conv_error", "complexity_very_low", "complexity_low", "complexity_medium", "complexity_high", "complexity_very_high" };
+
+	std::string section_name(section);
+	const std::string *values[] = { &section_name, row.item, row.target, row.desc, row.note };
+
+	if(json)
+		out += ((*rows > 0) ? ",\n  {" : "\n  {");
+
+	for(int i = 0; i < 16; i++)
+	{
+		if(i > 0)
+			out += json ? ", " : ",";
+
+		if(json)
+		{
+			out += '"';
+			out += columns[i];
+			out += "\": ";
+		}
+
+		if(i < 5)
+			ExportValue(values[i], out, json);
+		else
+		if(i == 5)
+			out.Int(row.occurrences);
+		else
+		if(i < 11)
+			out.Int(row.conv[i - 6]);
+		else
+			out.Int(row.complexity[i - 11]);
+	}
+
+	out += json ? "}" : "\n";
+
+	(*rows)++;
+}
+
+// Write an escaped string value, quotes are used in CSV only when required
+void Report::ExportValue(const std::string *value, ReportWriter &out, bool json)
+{
+	if(value == nullptr)
+	{
+		if(json)
+			out += "\"\"";
+
+		return;
+	}
+
+	if(json)
+	{
+		out += '"';
+
+		for(size_t i = 0; i < value->length(); i++)
+		{
+			char c = (*value)[i];
+
+			if(c == '"' || c == '\\')
+			{
+				out += '\\';
+				out += c;
+			}
+			else
+			if(c == '\n')
+				out += "\\n";
+			else
+			if(c == '\r')
+				out += "\\r";
+			else
+			if(c == '\t')
+				out += "\\t";
+			else
+			if((unsigned char)c < 0x20)
+				out += ' ';
+			else
+				out += c;
+		}
+
+		out += '"';
+		return;
+	}
+
+	if(value->find_first_of(",\"\r\n") == std::string::npos)
+	{
+		out += *value;
+		return;
+	}
+
+	out += '"';
+
+	for(size_t i = 0; i < value->length(); i++)
+	{
+		if((*value)[i] == '"')
+			out += '"';
+
+		out += (*value)[i];
+	}
+
+	out += '"';
+}
+
+// Constructor
+ReportSnippets::ReportSnippets(ReportWriter &index, const char *index_path, const std::string &section, int page_items) :
+	_index(index)
+{
+	_index_path = index_path;
+	_section = section;
+	_page_items = page_items;
+
+	_page = 0;
+	_items = 0;
+	_total_items = 0;
+
+	_page_file = nullptr;
+	_page_writer = nullptr;
+
+	// All snippets are written to the snippets file
+	if(_page_items <= 0)
+		_page_path = _index_path;
+}
+
+// Destructor
+ReportSnippets::~ReportSnippets()
+{
+	if(_page_writer != nullptr)
+		ClosePage(true);
+
+	for(std::map<int, FILE*>::iterator i = _files.begin(); i != _files.end(); i++)
+		fclose(i->second);
+}
+
+// Get the output for the next item, a new page is started when the current one is full
+ReportWriter& ReportSnippets::NextItem()
+{
+	if(_page_items <= 0)
+		return _index;
+
+	if(_page_writer != nullptr && _items >= _page_items)
+		ClosePage(false);
+
+	if(_page_writer == nullptr)
+		OpenPage();
+
+	_items++;
+	_total_items++;
+
+	return *_page_writer;
+}
+
+// Get the file name of the page, sqlines_report_snippets_<section>_<page>.html
+std::string ReportSnippets::GetPagePath(int page)
+{
+	std::string path = _index_path;
+	size_t ext = path.rfind('.');
+
+	if(ext != std::string::npos)
+		path.erase(ext);
+
+	char num[12];
+	sprintf(num, "%d", page);
+
+	path += "_";
+	path += _section;
+	path += "_";
+	path += num;
+	path += ".html";
+
+	return path;
+}
+
+// Start the next snippets page
+void ReportSnippets::OpenPage()
+{
+	_page++;
+	_items = 0;
+	_page_path = GetPagePath(_page);
+
+	_page_file = fopen(_page_path.c_str(), "w+");
+
+	// If the page cannot be created, its content is discarded
+	if(_page_file == nullptr)
+		printf("\n\nError: Cannot create report snippets file %s", _page_path.c_str());
+
+	_page_writer = new ReportWriter(_page_file);
+
+	ReportWriter &out = *_page_writer;
+
+	out += "<html><head><meta charset=\"utf-8\"><title>";
+	out += _section;
+	out += " - ";
+	out.Int(_page);
+	out += "</title></head><body>\n<p><a href=\"";
+	out += _index_path;
+	out += "\">Index</a></p>\n";
+}
+
+// Finish the current page and add it to the index
+void ReportSnippets::ClosePage(bool last)
+{
+	if(_page_writer != nullptr)
+	{
+		ReportWriter &out = *_page_writer;
+
+		out += "\n<p>";
+
+		if(_page > 1)
+		{
+			out += "<a href=\"";
+			out += GetPagePath(_page - 1);
+			out += "\">Previous</a> ";
+		}
+
+		out += "<a href=\"";
+		out += _index_path;
+		out += "\">Index</a>";
+
+		if(!last)
+		{
+			out += " <a href=\"";
+			out += GetPagePath(_page + 1);
+			out += "\">Next</a>";
+		}
+
+		out += "</p>\n</body></html>\n";
+		out.Flush();
+
+		delete _page_writer;
+		_page_writer = nullptr;
+	}
+
+	if(_page_file != nullptr)
+	{
+		fclose(_page_file);
+		_page_file = nullptr;
+	}
+
+	// Index entry with the range of items on the page
+	_index += "<p><a href=\"";
+	_index += _page_path;
+	_index += "\">";
+	_index += _section;
+	_index += " ";
+	_index.Int(_total_items - _items + 1);
+	_index += "-";
+	_index.Int(_total_items);
+	_index += "</a></p>\n";
+}
+
 // Get the database name to use in reports
 const char* Report::GetDbName(int type)
 {
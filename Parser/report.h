@@ -5,12 +5,56 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <atomic>
 #include "stats.h"
+#include "reportwriter.h"
 
 #define SQLEXEC_REPORT_FILE         "sqlines_report.html"
 #define SQLEXEC_REPORT_SNIPPETS     "sqlines_report_snippets.html"
 #define SQLEXEC_REPORT_TEMPLATE     "sqlines_report.tpl"
 
+// Statistics export columns (CSV header)
+#define SQLEXEC_REPORT_EXPORT_COLUMNS "section,item,target,description,note,occurrences,conv_undef,conv_no_need,conv_ok,conv_warn,conv_error,complexity_very_low,complexity_low,complexity_medium,complexity_high,complexity_very_high"
+
+// Report macros by id
+#define REPORT_SUMMARY                      0
+#define REPORT_DATATYPES_TABLE              1
+#define REPORT_UDT_DATATYPES_TABLE          2
+#define REPORT_UDT_DATATYPE_DTL_TABLE       3
+#define REPORT_DATATYPE_DTL_TABLE           4
+#define REPORT_BUILTIN_FUNC_TABLE           5
+#define REPORT_BUILTIN_FUNC_DTL_TABLE       6
+#define REPORT_UDF_FUNC_TABLE               7
+#define REPORT_SEQ_TABLE                    8
+#define REPORT_SEQ_DTL_TABLE                9
+#define REPORT_SEQ_OPT_DTL_TABLE            10
+#define REPORT_SEQ_REF_TABLE                11
+#define REPORT_SEQ_REF_DTL_TABLE            12
+#define REPORT_SYSTEM_PROC_TABLE            13
+#define REPORT_SYSTEM_PROC_DTL_TABLE        14
+#define REPORT_STATEMENTS_TABLE             15
+#define REPORT_CRTAB_STMT_TABLE             16
+#define REPORT_ALTTAB_STMT_TABLE            17
+#define REPORT_SELECT_STMT_TABLE            18
+#define REPORT_CRPROC_STMT_TABLE            19
+#define REPORT_PL_STATEMENTS                20
+#define REPORT_PL_STATEMENTS_EXCEPTIONS     21
+#define REPORT_PACKAGES                     22
+#define REPORT_PKG_STATEMENTS_ITEMS         23
+#define REPORT_QUOTED_IDENTS_TABLE          24
+#define REPORT_NONASCII_IDENTS              25
+#define REPORT_STRINGS_TABLE                26
+#define REPORT_NUMBERS_TABLE                27
+#define REPORT_WORDS_TABLE                  28
+#define REPORT_DELIMITERS_TABLE             29
+#define REPORT_MACROS                       30
+
+// Compiled template segment types
+#define REPORT_SEGMENT_TEXT                 0
+#define REPORT_SEGMENT_MACRO                1
+#define REPORT_SEGMENT_IFEXISTS             2
+
 #define SUFFIX(int_value)				((int_value == 1) ? "" : "s")
 #define SUFFIX2(int_value, str1, str2)	((int_value == 1) ? str1 : str2)
 
@@ -18,6 +62,95 @@
 #define SQLINES_REPORT_WARN_MARK    "<span style=\"color:red\"><strong>!</strong></span>"
 #define SQLINES_REPORT_ERROR_MARK   "<span style=\"color:red\"><strong>&#x2715;</strong></span>"
 
+// Template text, <?macro?> or <?ifexists:macro?> condition
+struct ReportSegment
+{
+	short type;
+
+	// Position in the template
+	const char *str;
+	size_t len;
+
+	// Macro name and id, -1 for unknown macros
+	std::string name;
+	int macro;
+
+	// Segment to continue from when the ifexists condition is false
+	size_t skip_to;
+
+	ReportSegment() { type = REPORT_SEGMENT_TEXT; str = nullptr; len = 0; macro = -1; skip_to = 0; }
+};
+
+// Section rendered by a worker thread
+struct ReportTask
+{
+	// Template segment with the section macro
+	size_t segment;
+
+	// Rendered report rows and snippets index entries
+	std::string data;
+	std::string index;
+
+	// Snippets index is written at the first use of the macro only
+	bool written;
+
+	ReportTask() { segment = 0; written = false; }
+};
+
+// Statistics item in the export, counts are indexed by conversion status and complexity
+struct ReportExportRow
+{
+	const std::string *item;
+	const std::string *target;
+	const std::string *desc;
+	const std::string *note;
+
+	int occurrences;
+	int conv[5];
+	int complexity[5];
+
+	ReportExportRow() { item = nullptr; target = nullptr; desc = nullptr; note = nullptr; occurrences = 0; 
+		memset(conv, 0, sizeof(conv)); memset(complexity, 0, sizeof(complexity)); }
+};
+
+// Snippets output of a section, written to the snippets file or split to pages of N items
+class ReportSnippets
+{
+	// Snippets file, or the index page when snippets are split to pages
+	ReportWriter &_index;
+	std::string _index_path;
+
+	std::string _section;
+	int _page_items;
+
+	// Current page and the number of items written to it
+	int _page;
+	int _items;
+	int _total_items;
+	std::string _page_path;
+
+	FILE *_page_file;
+	ReportWriter *_page_writer;
+
+public:
+	// Source files opened to read snippets of this section
+	std::map<int, FILE*> _files;
+
+	ReportSnippets(ReportWriter &index, const char *index_path, const std::string &section, int page_items);
+	~ReportSnippets();
+
+	// Get the output for the next item, a new page is started when the current one is full
+	ReportWriter& NextItem();
+	// Get the file the current item is written to
+	const std::string& GetPagePath() { return _page_path; }
+
+private:
+	// Get the file name of the page
+	std::string GetPagePath(int page);
+	void OpenPage();
+	void ClosePage(bool last);
+};
+
 class Report
 {
     const char *_tpl_path;
@@ -26,6 +159,9 @@ class Report
 
     const char *_summary;
 
+	// Statistics the report is created for
+	Stats *_stats;
+
 	// Source and target databases
 	int _source;
 	int _target;
@@ -37,24 +173,57 @@ class Report
 	const char *_source_url;
 	const char *_target_url;
 
+	// Template content and its segments, compiled once
+	char *_tpl_input;
+	std::vector<ReportSegment> _tpl_segments;
+
+	// Number of items per snippets page, 0 to write all snippets to a single file
+	int _snippets_page;
+	// Statistics export file (JSON or CSV by extension), empty if not required
+	std::string _export_path;
+
 public:
     Report();
+	~Report();
 
     // Create a report file by template
     void CreateReport(Stats *stats, int source, int target, const char *summary);
 
+	void SetSnippetsPage(int items) { _snippets_page = items; }
+	void SetExportPath(const char *path) { _export_path = (path != nullptr) ? path : ""; }
+
 private:
+	// Read the template and split it to text and macro segments
+	bool CompileTemplate();
+	void AddTemplateSegment(short type, const char *str, size_t len, const char *macro = nullptr);
+	// Find the position after <?/ifexists:macro?> end of condition
+	const char* FindIfExistsEnd(const char *cur_tpl, const char *macro);
+	// Get the macro id by name
+	int GetMacroId(const char *macro);
+
     // Fill the specified report section
-    void GetReportSection(Stats *stats, std::string &macro, std::string &data, std::string &snippets); 
-    void GetReportSectionRows(std::map<std::string, int> &values, std::string &data, int *distinct, int *occurrences);
-    void GetReportSectionRows(std::map<std::string, StatsItem> &values, std::string &data, int *distinct, int *occurrences);
-	void GetReportSectionRows(std::string section, std::map<std::string, StatsSummaryItem> &values, std::string &data, std::string &snippets, int *distinct, int *occurrences);
-	void GetReportSectionRows(std::string section, std::map<std::string, StatsDetailItem> &values, std::string &data, std::string &snippets, int *distinct, int *occurrences, bool desc = true, bool note = true, bool complexity = true);
-
-	// Check if there is data in section by name
-	bool IsDataInSection(Stats *stats, const char *macro);
-	// Handle <?ifexists:macro> condition
-	const char* ProcessReportIfExists(Stats *stats, const char *cur_tpl, const char *macro);
+    void GetReportSection(Stats *stats, int macro_id, const std::string &macro, ReportWriter &data, ReportSnippets &snippets); 
+    void GetReportSectionRows(StatsMap<int> &values, ReportWriter &data, int *distinct, int *occurrences);
+    void GetReportSectionRows(StatsMap<StatsItem> &values, ReportWriter &data, int *distinct, int *occurrences);
+	void GetReportSectionRows(const std::string &section, StatsMap<StatsSummaryItem> &values, ReportWriter &data, ReportSnippets &section_snippets, int *distinct, int *occurrences);
+	void GetReportSectionRows(const std::string &section, StatsMap<StatsDetailItem> &values, ReportWriter &data, ReportSnippets &section_snippets, int *distinct, int *occurrences, bool desc = true, bool note = true, bool complexity = true);
+
+	// Render sections in parallel when their snippets are written to separate pages
+	void RenderSections(Stats *stats, std::vector<ReportTask> &tasks);
+	void RenderSectionsWorker(Stats *stats, std::vector<ReportTask> *tasks, std::atomic<size_t> *next);
+
+	// Write all statistics collections to the export file
+	void CreateExport(Stats *stats);
+	void ExportSection(Stats *stats, int macro_id, ReportWriter &out, bool json, int *rows);
+	void ExportRows(const char *section, StatsMap<int> &values, ReportWriter &out, bool json, int *rows);
+	void ExportRows(const char *section, StatsMap<StatsItem> &values, ReportWriter &out, bool json, int *rows);
+	void ExportRows(const char *section, StatsMap<StatsSummaryItem> &values, ReportWriter &out, bool json, int *rows);
+	void ExportRows(const char *section, StatsMap<StatsDetailItem> &values, ReportWriter &out, bool json, int *rows);
+	void ExportRow(const char *section, ReportExportRow &row, ReportWriter &out, bool json, int *rows);
+	void ExportValue(const std::string *value, ReportWriter &out, bool json);
+
+	// Check if there is data in section by id
+	bool IsDataInSection(Stats *stats, int macro_id);
 
 	// Get the database name to use in reports
 	const char *GetDbName(int type);
@@ -0,0 +1,107 @@
+// ReportWriter class - Buffered writer that streams report content to a file or memory
+
+#ifndef sqlines_reportwriter_h
+#define sqlines_reportwriter_h
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+// Buffer size in bytes
+#define REPORT_WRITER_BUFFER		65536
+
+class ReportWriter
+{
+	FILE *file;
+	// Memory output, used when sections are rendered in parallel
+	std::string *out;
+
+	char buffer[REPORT_WRITER_BUFFER];
+	size_t used;
+
+public:
+	ReportWriter(FILE *f)
+	{
+		file = f;
+		out = NULL;
+		used = 0;
+	}
+
+	ReportWriter(std::string *o)
+	{
+		file = NULL;
+		out = o;
+		used = 0;
+	}
+
+	~ReportWriter()
+	{
+		Flush();
+	}
+
+	// Write data, it is copied into the buffer and written by blocks
+	void Write(const char *data, size_t len)
+	{
+		if(data == NULL)
+			return;
+
+		// Large blocks are written directly
+		if(len >= REPORT_WRITER_BUFFER)
+		{
+			Flush();
+
+			if(file != NULL)
+				fwrite(data, 1, len, file);
+			else
+			if(out != NULL)
+				out->append(data, len);
+
+			return;
+		}
+
+		if(used + len > REPORT_WRITER_BUFFER)
+			Flush();
+
+		memcpy(buffer + used, data, len);
+		used += len;
+	}
+
+	ReportWriter& operator+=(const char *data) { if(data != NULL) Write(data, strlen(data)); return *this; }
+	ReportWriter& operator+=(const std::string &data) { Write(data.c_str(), data.length()); return *this; }
+	ReportWriter& operator+=(char c) { Write(&c, 1); return *this; }
+
+	// Write integer value without formatting through sprintf
+	void Int(int value)
+	{
+		char num[12];
+		char *cur = num + sizeof(num);
+
+		unsigned int uvalue = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+
+		do
+		{
+			*--cur = (char)('0' + uvalue % 10);
+			uvalue /= 10;
+
+		} while(uvalue > 0);
+
+		if(value < 0)
+			*--cur = '-';
+
+		Write(cur, num + sizeof(num) - cur);
+	}
+
+	// Write the buffered data to the file
+	void Flush()
+	{
+		if(used > 0 && file != NULL)
+			fwrite(buffer, 1, used, file);
+		else
+		if(used > 0 && out != NULL)
+			out->append(buffer, used);
+
+		used = 0;
+	}
+};
+
+#endif // sqlines_reportwriter_h
@@ -24,12 +24,22 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
     Token *where_end = nullptr;
 
     Token *order = nullptr;
+    Token *order_end = nullptr;
 
 	int rowlimit = 0;
 
+	// Oracle rownum condition in WHERE
+    Token *rownum_first = nullptr;
+    Token *rownum_last = nullptr;
+
 	// Row limit specified in SELECT list and SELECT options
     Token *rowlimit_slist = nullptr;
     Token *rowlimit_soptions = nullptr;
+
+	// OFFSET value, and the first and last tokens of OFFSET and FETCH FIRST clauses
+    Token *rowlimit_offset = nullptr;
+    Token *rowlimit_start = nullptr;
+    Token *rowlimit_end = nullptr;
 	
 	bool rowlimit_percent = false;
 
@@ -74,10 +84,15 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
 	SelectSetOutColsDataTypes(out_cols, &from_table_end);
 
 	// WHERE
-	ParseWhereClause(SQL_STMT_SELECT, &where_, &where_end, &rowlimit);
+	ParseWhereClause(SQL_STMT_SELECT, &where_, &where_end, &rowlimit, &rownum_first, &rownum_last);
 
 	// GROUP BY
-	ParseSelectGroupBy();
+	bool group_by = ParseSelectGroupBy();
+
+	// Oracle rownum condition is converted to LIMIT when it is not combined with OR, not used in aggregate
+	// query (rownum limits the rows before aggregation) and not in IN subquery
+    if(rowlimit > 0 && RemoveOracleRownumCondition(select, where_, where_end, rownum_first, rownum_last, agg_func || group_by) == false)
+		rowlimit = 0;
 
 	// HAVING clause
 	ParseSelectHaving();
@@ -89,10 +104,9 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
 	if(select_scope == SQL_SEL_SET_UNION)
 		return true;
 
-	Token *pre_order = GetLastToken();
-
 	// ORDER BY
-	ParseSelectOrderBy(&order);
+    if(ParseSelectOrderBy(&order) == true)
+		order_end = GetLastToken();
 
 	// Add row limitation that was defined in WHERE clause (rownum in Oracle)
 	if(rowlimit > 0)
@@ -100,7 +114,8 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
         /*Token *last */ GetLastToken();
 	}
 
-	ParseSelectOptions(select, from_end, where_, order, &rowlimit_soptions, &rowlimit);
+	ParseSelectOptions(select, from_end, where_, order, &rowlimit_soptions, &rowlimit, &rowlimit_offset, &rowlimit_percent, 
+		&rowlimit_start, &rowlimit_end);
 
 	// No assignment and it is a result set for outer SELECT in a procedure
     if(into == false && select_scope == 0 && block_scope == SQL_BLOCK_PROC)
@@ -115,9 +130,9 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
         PrependNoFormat(select, cursor);
         Prepend(select, " FOR ", L" FOR ", 5);
 
-        _spl_result_set_generated_cursors.Add(cursor);
+        _spl->result_set_generated_cursors.Add(cursor);
 
-		_spl_result_sets++;
+		_spl->result_sets++;
 
         if(result_sets != nullptr)
 			*result_sets = (*result_sets) + 1;
@@ -130,8 +145,9 @@ bool SqlParser::ParseSelectStatement(Token *select, int block_scope, int select_
 	}
 
 	// Convert row limits
-    if(rowlimit_slist != nullptr || rowlimit_soptions != nullptr || rowlimit > 0)
-		SelectConvertRowlimit(select, from, from_end, where_, where_end, pre_order, order, rowlimit_slist, rowlimit_soptions, rowlimit, rowlimit_percent);
+    if(rowlimit_slist != nullptr || rowlimit_soptions != nullptr || rowlimit_offset != nullptr || rowlimit > 0)
+		SelectConvertRowlimit(select, select_list_end, from, order, order_end, rowlimit_slist, rowlimit_soptions, rowlimit_offset, 
+			rowlimit_start, rowlimit_end, rowlimit, rowlimit_percent);
 
 	// Implement CONTINUE handler for NOT FOUND in Oracle
     if(into == true && agg_func == false)
@@ -711,7 +727,8 @@ bool SqlParser::GetJoinKeywords(Token *token, Token **left_right_full, Token **o
 }
 
 // WHERE clause in SELECT statement
-bool SqlParser::ParseWhereClause(int stmt_scope, Token **where_out, Token **where_end_out, int *rowlimit)
+bool SqlParser::ParseWhereClause(int stmt_scope, Token **where_out, Token **where_end_out, int *rowlimit, 
+	Token **rownum_first_out, Token **rownum_last_out)
 {
 	Token *where_ = GetNextWordToken("WHERE", L"WHERE", 5);
 
@@ -727,11 +744,24 @@ bool SqlParser::ParseWhereClause(int stmt_scope, Token **where_out, Token **wher
 
 	int count = 0;
 
+	// Rownum condition of the outer WHERE clause when parsing a subquery
+	Token *rownum_first = _rownum_first;
+	Token *rownum_last = _rownum_last;
+
+	_rownum_first = nullptr;
+	_rownum_last = nullptr;
+
 	ParseBooleanExpression(SQL_BOOL_WHERE, where_, &count, rowlimit);
 
-	// If Oracle rownum condition is set, and there are no conditions anymore remove WHERE
-    if(rowlimit != nullptr && *rowlimit > 0 && count == 0)
-		Token::Remove(where_);
+	// Oracle rownum condition is converted when the whole statement is parsed
+    if(rownum_first_out != nullptr && rownum_last_out != nullptr)
+	{
+		*rownum_first_out = _rownum_first;
+		*rownum_last_out = _rownum_last;
+	}
+
+	_rownum_first = rownum_first;
+	_rownum_last = rownum_last;
 
     if(where_end_out != nullptr)
 		*where_end_out = GetLastToken();
@@ -761,7 +791,7 @@ bool SqlParser::ParseWhereCurrentOfCursor(int stmt_scope)
 
 	// Save updatable cursor
 	if(stmt_scope == SQL_STMT_UPDATE || stmt_scope == SQL_STMT_DELETE)
-		_spl_updatable_current_of_cursors.Add(cursor);
+		_spl->updatable_current_of_cursors.Add(cursor);
 
 	return true;
 }
@@ -918,7 +948,8 @@ bool SqlParser::ParseSelectSetOperator(int block_scope, int /*select_scope*/)
 
 // SELECT statements options at the end of the statement
 bool SqlParser::ParseSelectOptions(Token * /*select*/, Token * /*from_end*/, Token * /*where_*/, Token * /*order*/, 
-									Token **rowlimit_soptions, int *rowlimit)
+									Token **rowlimit_soptions, int *rowlimit, Token **rowlimit_offset, bool *rowlimit_percent,
+									Token **rowlimit_start, Token **rowlimit_end)
 {
 	bool exists = false;
 
@@ -995,6 +1026,90 @@ bool SqlParser::ParseSelectOptions(Token * /*select*/, Token * /*from_end*/, Tok
 			exists = true;
 			continue;
 		}
+		else
+		// Oracle OFFSET num ROWS
+		if(option->Compare("OFFSET", L"OFFSET", 6) == true)
+		{
+			Token *num = GetNextToken();
+			Token *rows = GetNextWordToken("ROWS", L"ROWS", 4);
+
+            if(rows == nullptr)
+				rows = GetNextWordToken("ROW", L"ROW", 3);
+
+            if(rowlimit_offset != nullptr)
+				*rowlimit_offset = num;
+
+            if(rowlimit_start != nullptr && rowlimit_end != nullptr)
+			{
+				*rowlimit_start = option;
+				*rowlimit_end = Nvl(rows, num);
+			}
+
+			exists = true;
+			continue;
+		}
+		else
+		// Oracle FETCH FIRST | NEXT [num [PERCENT]] ROW | ROWS ONLY | WITH TIES
+		if(option->Compare("FETCH", L"FETCH", 5) == true)
+		{
+			Token *first = GetNextWordToken("FIRST", L"FIRST", 5);
+
+            if(first == nullptr)
+				first = GetNextWordToken("NEXT", L"NEXT", 4);
+
+			Token *num = GetNextToken();
+            Token *percent = nullptr;
+            Token *rows = nullptr;
+
+			// FETCH FIRST ROW ONLY
+            if(TOKEN_CMP(num, "ROW") || TOKEN_CMP(num, "ROWS"))
+			{
+				rows = num;
+				num = nullptr;
+			}
+			else
+			{
+				percent = GetNextWordToken("PERCENT", L"PERCENT", 7);
+				rows = GetNextWordToken("ROWS", L"ROWS", 4);
+
+                if(rows == nullptr)
+					rows = GetNextWordToken("ROW", L"ROW", 3);
+			}
+
+			Token *only = GetNextWordToken("ONLY", L"ONLY", 4);
+
+			// WITH TIES is not converted, OFFSET is kept with it
+            if(only != nullptr)
+			{
+                if(rowlimit_start != nullptr && rowlimit_end != nullptr)
+				{
+                    if(*rowlimit_start == nullptr)
+						*rowlimit_start = option;
+
+					*rowlimit_end = only;
+				}
+
+                if(num != nullptr && rowlimit_soptions != nullptr)
+					*rowlimit_soptions = num;
+				else
+                if(num == nullptr && rowlimit != nullptr)
+					*rowlimit = 1;
+
+                if(rowlimit_percent != nullptr)
+					*rowlimit_percent = (percent != nullptr);
+			}
+			else
+			{
+                if(rowlimit_offset != nullptr)
+					*rowlimit_offset = nullptr;
+
+                if(rowlimit_start != nullptr)
+					*rowlimit_start = nullptr;
+			}
+
+			exists = true;
+			continue;
+		}
 
 		PushBack(option);
 		break;
@@ -1051,63 +1166,140 @@ void SqlParser::SelectSetOutColsDataTypes(ListW *out_cols, ListWM *from_table_en
 	}
 }
 
-// Convert row limits specified in SELECT
-void SqlParser::SelectConvertRowlimit(Token *select, Token *from, Token *from_end, Token *where_, 
-										Token *where_end, Token *pre_order, Token *order, 
-										Token *rowlimit_slist, Token *rowlimit_soptions, int rowlimit, 
-										bool rowlimit_percent)
+// Convert row limits specified in SELECT to LIMIT, row limits in percent are converted using window functions
+void SqlParser::SelectConvertRowlimit(Token *select, Token *select_list_end, Token *from, Token *order, Token *order_end, 
+										Token *rowlimit_slist, Token *rowlimit_soptions, Token *rowlimit_offset, 
+										Token *rowlimit_start, Token *rowlimit_end, int rowlimit, bool rowlimit_percent)
 {
 	// One of limits should be set
-    if(rowlimit_slist == nullptr && rowlimit_soptions == nullptr && rowlimit == 0)
+    if(rowlimit_slist == nullptr && rowlimit_soptions == nullptr && rowlimit_offset == nullptr && rowlimit == 0)
 		return;
 
-	int limit = rowlimit;
+	Token *count = Nvl(rowlimit_slist, rowlimit_soptions);
+	int limit = (count != nullptr) ? count->GetInt() : rowlimit;
 
-    if(rowlimit_slist != nullptr)
-		limit = rowlimit_slist->GetInt();
+	// Row limit in percent
+    if(rowlimit_percent == true)
+	{
+		SelectConvertRowlimitPercent(select, select_list_end, from, order, order_end, count, rowlimit_offset, 
+			rowlimit_start, rowlimit_end, limit);
+		return;
+	}
+
+    if(rowlimit_start != nullptr)
+		Token::Remove(rowlimit_start, rowlimit_end);
+
+	Token *end = GetLastToken();
+
+	// LIMIT goes after ORDER BY, rownum condition in WHERE is already removed
+	Append(end, " LIMIT ", L" LIMIT ", 7, select);
+
+    if(count != nullptr)
+		AppendCopy(end, count);
+	else
+    if(rowlimit > 0)
+		Append(end, rowlimit);
+	// OFFSET without FETCH FIRST, MySQL requires the row count
 	else
-    if(rowlimit_soptions != nullptr)
-		limit = rowlimit_soptions->GetInt();
+		AppendNoFormat(end, "18446744073709551615", L"18446744073709551615", 20);
 
+    if(rowlimit_offset != nullptr)
+	{
+		Append(end, " OFFSET ", L" OFFSET ", 8, select);
+		AppendCopy(end, rowlimit_offset);
+	}
+}
+
+// FETCH FIRST n PERCENT ROWS ONLY numbers rows by a window function in a subquery, the source is read once
+void SqlParser::SelectConvertRowlimitPercent(Token *select, Token *select_list_end, Token *from, Token *order, Token *order_end, 
+										Token *count, Token *offset, Token *rowlimit_start, Token *rowlimit_end, int limit)
+{
 	// 100 percent
-	if(limit == 100 && rowlimit_percent == true)
+    if(limit == 100 && offset == nullptr)
+	{
+		Token::Remove(rowlimit_start, rowlimit_end);
+		return;
+	}
+
+	Token *first = GetNextPatternToken(select);
+
+	// Window functions are evaluated before DISTINCT
+    if(count == nullptr || TOKEN_CMP(first, "DISTINCT") || TOKEN_CMP(first, "UNIQUE"))
+		return;
+
+	std::vector<std::string> names;
+	bool all_named = false;
+
+	// Outer query selects the columns of the original select list by names
+    if(GetQueryColumnNames(select, from, names, &all_named) == false || all_named == false)
 		return;
 
+	// Column positions in ORDER BY cannot be used in the window
+	for(Token *token = order, *prev = nullptr; token != nullptr; prev = token, token = GetNextPatternToken(token))
+	{
+        if(token->type == TOKEN_NUMBER && (TOKEN_CMP(prev, "BY") || TOKEN_CMPC(prev, ',')))
+			return;
+
+        if(token == order_end)
+			break;
+	}
+
+	Token::Remove(rowlimit_start, rowlimit_end);
+
+	// SELECT list, ROW_NUMBER() OVER (ORDER BY ...) AS sqlines_rn, COUNT(*) OVER () AS sqlines_cnt FROM ...
+	Append(select_list_end, ", ROW_NUMBER() OVER (", L", ROW_NUMBER() OVER (", 21, select);
+
+    if(order != nullptr)
+	{
+		AppendCopy(select_list_end, order, order_end);
+		Token::Remove(order, order_end);
+	}
+
+	Append(select_list_end, ") AS ", L") AS ", 5, select);
+	AppendNoFormat(select_list_end, "sqlines_rn", L"sqlines_rn", 10);
+	Append(select_list_end, ", COUNT(*) OVER () AS ", L", COUNT(*) OVER () AS ", 22, select);
+	AppendNoFormat(select_list_end, "sqlines_cnt", L"sqlines_cnt", 11);
+
+	std::string list;
+
+	for(size_t i = 0; i < names.size(); i++)
+	{
+        if(i > 0)
+			list += ", ";
+
+		list += names[i];
+	}
+
+	Prepend(select, "SELECT ", L"SELECT ", 7, select);
+	PrependNoFormat(select, list.c_str(), nullptr, list.length());
+	Prepend(select, " FROM (", L" FROM (", 7, select);
+
+	// ) sqlines_rl WHERE [sqlines_rn > offset AND] sqlines_rn <= [offset +] CEIL(n * sqlines_cnt / 100) ORDER BY sqlines_rn
 	Token *end = GetLastToken();
 
-	// ROWNUM in Oracle
-    // No ORDER BY, just add a condition to WHERE
-    if(order == nullptr)
-    {
-        // No WHERE clause too
-        if(where_ == nullptr)
-            end = Append(from_end, " WHERE ", L" WHERE ", 7, select);
-        else
-            end = Append(where_end, " AND ", L" AND ", 5, where_);
-    }
-    // ORDER BY exists so a subquery must be used
-    else
-    {
-        Prepend(select, "SELECT * FROM (", L"SELECT * FROM (", 15);
-        Append(end, ") WHERE ", L") WHERE ", 8, select);
-    }
-
-    AppendNoFormat(end, "rownum <= ", L"rownum <= ", 10);
-
-    if(rowlimit_slist != nullptr || rowlimit_soptions != nullptr)
-        AppendCopy(end, Nvl(rowlimit_slist, rowlimit_soptions));
-    else
-        Append(end, rowlimit);
-
-    // Row limit in percent
-    if(rowlimit_percent == true)
-    {
-        Append(end, "/100 * ", L"/100 * ", 7);
-        Append(end, "\n (SELECT COUNT(*) ", L"\n (SELECT COUNT(*) ", 19, select);
+	AppendNoFormat(end, ") sqlines_rl", L") sqlines_rl", 12);
+	Append(end, " WHERE ", L" WHERE ", 7, select);
 
-        // Copy FROM, WHERE, UNION, GROUP BY, HAVING COUNT, but not ORDER BY
-        AppendCopy(end, from, pre_order);
+    if(offset != nullptr)
+	{
+		AppendNoFormat(end, "sqlines_rn > ", L"sqlines_rn > ", 13);
+		AppendCopy(end, offset);
+		Append(end, " AND ", L" AND ", 5, select);
+	}
+
+	AppendNoFormat(end, "sqlines_rn <= ", L"sqlines_rn <= ", 14);
+
+    if(offset != nullptr)
+	{
+		AppendCopy(end, offset);
+		AppendNoFormat(end, " + ", L" + ", 3);
+	}
 
-        Append(end, ")", L")", 1);
-    }
+	Append(end, "CEIL(", L"CEIL(", 5, select);
+	AppendCopy(end, count);
+	AppendNoFormat(end, " * ", L" * ", 3);
+	AppendNoFormat(end, "sqlines_cnt", L"sqlines_cnt", 11);
+	AppendNoFormat(end, " / 100)", L" / 100)", 7);
+	Append(end, " ORDER BY ", L" ORDER BY ", 10, select);
+	AppendNoFormat(end, "sqlines_rn", L"sqlines_rn", 10);
 }
@@ -0,0 +1,78 @@
+// Oracle sequences and triggers assigning their values collected while parsed, and converted at the end of file
+
+#ifndef sqlines_sequences_h
+#define sqlines_sequences_h
+
+#include <string>
+#include "token.h"
+
+// CREATE SEQUENCE statement
+struct OracleSequence
+{
+	Token *create;
+	Token *name;
+	// Last token of the statement
+	Token *end;
+
+	// START WITH, INCREMENT BY, MINVALUE, MAXVALUE and CACHE values
+	Token *start_with;
+	Token *increment_by;
+	Token *min_value;
+	Token *max_value;
+	Token *cache;
+
+	// NOCACHE and CYCLE options are set
+	bool nocache;
+	bool cycle;
+
+	// Sequence converted to AUTO_INCREMENT
+	bool auto_increment;
+
+	OracleSequence()
+	{
+		create = NULL; name = NULL; end = NULL; start_with = NULL; increment_by = NULL; min_value = NULL; max_value = NULL; cache = NULL;
+		nocache = false; cycle = false; auto_increment = false;
+	}
+};
+
+// BEFORE INSERT row trigger that only assigns the next value of a sequence to a column of the table
+struct SequenceTrigger
+{
+	// CREATE and the last token of the trigger
+	Token *create;
+	Token *end;
+
+	// seq.NEXTVAL reference
+	Token *nextval;
+
+	// Table and column names, and the end of the column definition in CREATE TABLE
+	Token *table;
+	Token *column;
+	Token *column_end;
+
+	// Index of the sequence defined before the trigger, -1 if it is defined later
+	int sequence;
+
+	SequenceTrigger()
+	{
+		create = NULL; end = NULL; nextval = NULL; table = NULL; column = NULL; column_end = NULL; sequence = -1;
+	}
+};
+
+// Sequence converted to AUTO_INCREMENT or referenced in a file, collected for all files converted by the parser
+// as a sequence converted in one file can be referenced in another
+struct SequenceUsage
+{
+	std::string name;
+	std::string file;
+
+	// Converted to AUTO_INCREMENT, otherwise referenced
+	bool auto_increment;
+
+	SequenceUsage()
+	{
+		auto_increment = false;
+	}
+};
+
+#endif // sqlines_sequences_h
@@ -0,0 +1,242 @@
+// SplState - Procedural scope state of the current procedure, function or trigger
+
+#ifndef sqlines_splstate_h
+#define sqlines_splstate_h
+
+#include "token.h"
+#include "arena.h"
+#include "listt.h"
+#include "listw.h"
+#include "listwm.h"
+
+// The state is allocated from a per-routine arena together with list items, and released by the arena rewind
+struct SplState
+{
+	// Current procedural scope (procedure, function, trigger i.e.)
+	int scope;
+
+	// Name of current procedure (function, trigger)
+	Token *name;
+	// Start token of procedure, function or trigger (usually it is CREATE keyword)
+	Token *start;
+
+	// Current variables and parameters
+	ListW variables;
+	ListW parameters;
+
+	// Outer BEGIN keyword
+	Token *outer_begin;
+	// Standalone BEGIN levels in the current procedure (each BEGIN entry is cleared on block exit)
+	ListW begin_blocks;
+
+	// Outer AS or IS keyword
+	Token *outer_as;
+
+	// Last declare statement before the first non-declare statement
+	Token *last_declare;
+	// First non-declare statement in procedure or function
+	Token *first_non_declare;
+
+	// Last statement in procedure or function
+	Token *last_stmt;
+
+	// Last token of last declared variable (not cursor) in the outer PL/SQL DECLARE block
+	Token *last_outer_declare_var;
+	Token *last_outer_declare_varname;
+
+	// Number of result sets returned from procedure
+	int result_sets;
+	// Result set cursor names (declared cursor with return)
+	ListW result_set_cursors;
+	// Result set generated cursor names (for standalone SELECT returning a result set)
+	ListT<TokenStr> result_set_generated_cursors;
+
+	// Delimiter is set at the end of procedure
+	bool delimiter_set;
+	// User-defined exceptions and condition handlers
+	ListWM user_exceptions;
+
+	// NEW and OLD correlation name in trigger
+	Token *new_correlation_name;
+	Token *old_correlation_name;
+	// Referenced NEW and OLD columns
+	ListW tr_new_columns;
+	ListW tr_old_columns;
+
+	// Outer block label in DB2 procedure
+	Token *outer_label;
+	// Oracle PL/SQL cursor parameters
+	ListWM cursor_params;
+	// Variables generated for Oracle PL/SQL parameters
+	ListWM cursor_vars;
+	// The names and definitions of declared cursors
+	ListW declared_cursors;
+	ListW declared_cursors_using_vars;
+	ListWM declared_cursors_stmts;
+	// Current declaring cursor
+	Token *current_declaring_cursor;
+	// Current declaring cursor uses procedural variables
+	bool current_declaring_cursor_uses_vars;
+	// Cursor for which updates WHERE CURRENT OF is performed
+	ListW updatable_current_of_cursors;
+	// Declared cursors and their SELECT statements
+	ListWM declared_cursors_select;
+	// Declared cursors and their select list expressions
+	ListWM declared_cursors_select_first_exp;
+	ListWM declared_cursors_select_exp;
+
+	// Declared record variables %ROWTYPE
+	ListW rowtype_vars;
+	// Referenced %ROWTYPE record fields
+	ListWM rowtype_fields;
+	// Fetch into record referenced
+	ListW rowtype_fetches;
+
+	// Implicit rowtype created by for cursor loops
+	ListWM implicit_rowtype_vars;
+	// Implicit rowtype fields
+	ListWM implicit_rowtype_fields;
+	// Generated FETCH statements to emulate cursor loops
+	ListWM implicit_rowtype_fetches;
+
+	// Declared local temporary tables, table variables
+	ListW declared_local_tables;
+	// Created session temporary tables
+	ListW created_session_tables;
+
+	// Closing parenthesis ) after parameter list
+	Token *param_close;
+
+	// RETURNS, RETURN, RETURNING keyword
+	Token *returns;
+
+	// Generated OUT variable names for Informix RETURNING clause
+	ListWM returning_out_names;
+	// Function returns integer data type
+	bool return_int;
+
+	// Number of FOREACH statements in the current procedure (function, trigger)
+	int foreach_num;
+	// Number of RETURN WITH RESUME in procedure
+	int return_with_resume;
+	// Number of RETURN statements in procedure
+	int return_num;
+
+	// Table name from last INSERT statement
+	Token *last_insert_table_name;
+	// Cursor name from last OPEN statement
+	Token *last_open_cursor_name;
+	// Cursor name from last FETCH statement
+	Token *last_fetch_cursor_name;
+	// List of OPEN cursor statemenents
+	ListWM open_cursors;
+
+	// Prepared statements id
+	ListWM prepared_stmts;
+	// Cursors for prepared statements
+	ListWM prepared_stmts_cursors;
+	ListWM prepared_stmts_cursors_with_return;
+
+	// Fields of implicit records created by FOR loops
+	ListWM implicit_record_fields;
+
+	// Result set locators associated with procedures
+	ListWM rs_locator_procedures;
+
+	// Loops level in the current procedure (each loop entry is cleared on loop exit)
+	ListW loops;
+	// Number of loop labels already generated in the current procedure
+	int loop_labels;
+
+	// Stored procedures calls inside procedural block
+	ListWM sp_calls;
+
+	// Number of SELECT statements moved out of IF boolean condition
+	int moved_if_select;
+
+	// Procedure converted to function
+	bool proc_to_func;
+	// Function converted to procedure
+	bool func_to_proc;
+	// Handler for NOT FOUND condition
+	bool not_found_handler;
+	bool need_not_found_handler;
+
+	// Monday is 1 day, Sunday is 7 (false if it is unknown from context)
+	bool monday_1;
+
+	// Constructor sets the initial state of the procedural scope
+	SplState(Arena *arena)
+	{
+		scope = 0;
+		name = nullptr;
+		start = nullptr;
+		outer_begin = nullptr;
+		outer_as = nullptr;
+		last_declare = nullptr;
+		first_non_declare = nullptr;
+		last_stmt = nullptr;
+		last_outer_declare_var = nullptr;
+		last_outer_declare_varname = nullptr;
+		result_sets = 0;
+		delimiter_set = false;
+		new_correlation_name = nullptr;
+		old_correlation_name = nullptr;
+		outer_label = nullptr;
+		current_declaring_cursor = nullptr;
+		current_declaring_cursor_uses_vars = false;
+		param_close = nullptr;
+		returns = nullptr;
+		return_int = false;
+		foreach_num = 0;
+		return_with_resume = 0;
+		return_num = 0;
+		last_insert_table_name = nullptr;
+		last_open_cursor_name = nullptr;
+		last_fetch_cursor_name = nullptr;
+		loop_labels = 0;
+		moved_if_select = 0;
+		proc_to_func = false;
+		func_to_proc = false;
+		not_found_handler = false;
+		need_not_found_handler = false;
+		monday_1 = false;   // means unknown from context
+
+		// List items are allocated from the same arena
+		variables.SetArena(arena);
+		parameters.SetArena(arena);
+		begin_blocks.SetArena(arena);
+		result_set_cursors.SetArena(arena);
+		user_exceptions.SetArena(arena);
+		tr_new_columns.SetArena(arena);
+		tr_old_columns.SetArena(arena);
+		cursor_params.SetArena(arena);
+		cursor_vars.SetArena(arena);
+		declared_cursors.SetArena(arena);
+		declared_cursors_using_vars.SetArena(arena);
+		declared_cursors_stmts.SetArena(arena);
+		updatable_current_of_cursors.SetArena(arena);
+		declared_cursors_select.SetArena(arena);
+		declared_cursors_select_first_exp.SetArena(arena);
+		declared_cursors_select_exp.SetArena(arena);
+		rowtype_vars.SetArena(arena);
+		rowtype_fields.SetArena(arena);
+		rowtype_fetches.SetArena(arena);
+		implicit_rowtype_vars.SetArena(arena);
+		implicit_rowtype_fields.SetArena(arena);
+		implicit_rowtype_fetches.SetArena(arena);
+		declared_local_tables.SetArena(arena);
+		created_session_tables.SetArena(arena);
+		returning_out_names.SetArena(arena);
+		open_cursors.SetArena(arena);
+		prepared_stmts.SetArena(arena);
+		prepared_stmts_cursors.SetArena(arena);
+		prepared_stmts_cursors_with_return.SetArena(arena);
+		implicit_record_fields.SetArena(arena);
+		rs_locator_procedures.SetArena(arena);
+		loops.SetArena(arena);
+		sp_calls.SetArena(arena);
+	}
+};
+
+#endif // sqlines_splstate_h
@@ -1,6 +1,7 @@
 // SQLParser Class
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "sqlparser.h"
 #include "str.h"
@@ -32,19 +33,39 @@ SqlParser::SqlParser()
 	_remain_size = 0;
 	_line = 1;
 
+    _spl = nullptr;
 	ClearSplScope();
 
     _spl_package = nullptr;
     _declare_format = nullptr;
     _push_back_token = nullptr;
+	_create_index_table = nullptr;
+	_rownum_first = nullptr;
+	_rownum_last = nullptr;
 
 	_option_rems = false;
+	_option_assess_only = false;
+	_option_snippets = 0;
+	_option_snippets_page = 0;
+	_option_memo = true;
+	_option_insert_batch = 0;
+	_option_max_allowed_packet = INSERT_BATCH_MAX_PACKET;
+	_option_session_temp_tables = false;
+	_option_mysql_version = 0;
 
     _stats = nullptr;
     _report = nullptr;
+	_inventory = nullptr;
 }
 
-SqlParser::~SqlParser() {}
+SqlParser::~SqlParser()
+{
+	// Procedural state is placed into the arena, only its destructor is called
+    if(_spl != nullptr)
+		_spl->~SplState();
+
+	delete _inventory;
+}
 
 // Set target programming language
 void SqlParser::SetLang(const char *value, bool source)
@@ -67,17 +88,63 @@ void SqlParser::SetOption(const char *option, const char *value)
     if(option == nullptr)
 		return;
 
-    // Perform an assessment
-    if(_stricmp(option, "-a") == 0)
+    // Perform an assessment, -a_only also skips generating the output
+    if(_stricmp(option, "-a") == 0 || _stricmp(option, "-a_only") == 0)
     {
-		_stats = new Stats();
-        _report = new Report();
+		if(_stats == nullptr)
+		{
+			_stats = new Stats();
+			_report = new Report();
+
+			if(_option_snippets > 0)
+				_stats->SetSnippetsLimit(_option_snippets);
+		}
+
+		if(_stricmp(option, "-a_only") == 0)
+			_option_assess_only = true;
     }
+	else
+	// Object inventory, the value is the output file (CSV or JSON by extension)
+	if(_stricmp(option, "-inventory") == 0)
+	{
+		if(_inventory == nullptr)
+			_inventory = new Inventory(value);
+	}
 	else
 	// Remove schema name option
 	if(_stricmp(option, "-rems") == 0)
 		_option_rems = true;
 	else
+	// Parse each statement even if it repeats an earlier one
+	if(_stricmp(option, "-nomemo") == 0)
+		_option_memo = false;
+	else
+	// Merge consecutive single-row INSERT statements into multi-row INSERT with up to the specified number of rows
+    if(_stricmp(option, "-insert_batch") == 0 && value != nullptr)
+		_option_insert_batch = atoi(value);
+	else
+	// Maximum size of multi-row INSERT in bytes
+    if(_stricmp(option, "-max_allowed_packet") == 0 && value != nullptr)
+	{
+		_option_max_allowed_packet = atoi(value);
+
+		if(_option_max_allowed_packet <= 0)
+			_option_max_allowed_packet = INSERT_BATCH_MAX_PACKET;
+	}
+	else
+	// Create global temporary tables in sessions by procedures using them
+	if(_stricmp(option, "-session_temp_tables") == 0)
+		_option_session_temp_tables = true;
+	else
+	// Target MySQL version (5.7, 8.0.13 i.e.), features of later versions are emulated
+    if(_stricmp(option, "-mysql_version") == 0 && value != nullptr)
+	{
+		int major = 0, minor = 0, patch = 0;
+		sscanf(value, "%d.%d.%d", &major, &minor, &patch);
+
+		_option_mysql_version = major * 10000 + minor * 100 + patch;
+	}
+	else
 	// Schema mapping
     if(_stricmp(option, "-smap") == 0 && value != nullptr)
 		SetSchemaMapping(value);
@@ -108,12 +175,39 @@ void SqlParser::SetOption(const char *option, const char *value)
     if(_stricmp(option, "-set_explicit_schema") == 0 && value != nullptr)
 		_option_set_explicit_schema = value;
 	else
+	// Maximum number of code snippets per assessment item
+    if(_stricmp(option, "-snippets") == 0 && value != nullptr)
+	{
+		_option_snippets = atoi(value);
+
+		if(_stats != nullptr && _option_snippets > 0)
+			_stats->SetSnippetsLimit(_option_snippets);
+	}
+	else
+	// Number of items per snippets page, the snippets file becomes an index of pages
+    if(_stricmp(option, "-snippets_page") == 0 && value != nullptr)
+		_option_snippets_page = atoi(value);
+	else
+	// Export all assessment statistics to JSON or CSV file (by extension)
+    if(_stricmp(option, "-report_export") == 0 && value != nullptr)
+		_option_report_export = value;
+	else
+	// Path to the current file to read snippets from when the report is created
+    if(_stricmp(option, "__cur_path__") == 0 && value != nullptr)
+	{
+        if(_stats != nullptr)
+			_stats->SetSourcePath(value);
+	}
+	else
     if(_stricmp(option, "__cur_file__") == 0 && value != nullptr)
 	{
 		_option_cur_file = value;
 
         if(_stats != nullptr)
 			_stats->SetSourceFile(value);
+
+		if(_inventory != nullptr)
+			_inventory->SetSourceFile(value);
 	}
 }
 
@@ -131,6 +225,13 @@ int SqlParser::Convert(const char *input, int size, const char **output, int *ou
 
 	ClearSplScope();
 
+	// Statements are reused within the file only
+	_memo.Clear();
+
+	// Snippets refer to the input by position
+	if(_stats != nullptr)
+		_stats->SetSourceInput(input, size);
+
 	// Byte order mark for Unicode
 	GetBomToken();
 
@@ -144,13 +245,30 @@ int SqlParser::Convert(const char *input, int size, const char **output, int *ou
 
 		int result_sets = 0;
 
-		// Parser high-level token
-		Parse(token, SQL_SCOPE_FREE, &result_sets);
+		// Parser high-level token, repeated statements reuse the recorded conversion
+		ParseWithMemo(token, &result_sets);
 	}
 
 	Post();
 
-	CreateOutputString(output, out_size);
+	// Only statistics are collected in assessment-only mode, so the target is not materialized
+	if(_option_assess_only)
+	{
+		if(output != nullptr)
+			*output = nullptr;
+
+		if(out_size != nullptr)
+			*out_size = 0;
+	}
+	else
+		CreateOutputString(output, out_size);
+
+	// Trace records of the file are written, the trace file stays open for the next file
+	if(_stats != nullptr)
+	{
+		_stats->SetSourceInput(nullptr, 0);
+		_stats->FlushTrace();
+	}
 
 	// Delete global items since they point to deleted source code
 	_udt.DeleteAll();
@@ -159,6 +277,16 @@ int SqlParser::Convert(const char *input, int size, const char **output, int *ou
 	_bookmarks.DeleteAll();
 	_tokens.DeleteAll();
 
+	_column_books.clear();
+	_table_column_books.clear();
+	_table_end_books.clear();
+	_table_definitions.clear();
+
+	_sequences.clear();
+	_sequence_triggers.clear();
+	_sequence_index.clear();
+	_temp_tables.clear();
+
     if(lines != nullptr)
 		*lines = _line;
 
@@ -614,6 +742,159 @@ Token* SqlParser::GetNextStringToken()
 	return token;
 }
 
+// Get the next comma-separated literals (numbers, strings and NULL) as a single token, the bytes are copied as is
+Token* SqlParser::GetNextLiteralsToken()
+{
+	// Assessment collects statistics for each expression (NULL is counted as a function i.e.)
+	if(_stats != nullptr || _push_back_token != nullptr || _next_start == nullptr || _remain_size <= 0)
+		return nullptr;
+
+	const char *start = _next_start;
+
+	int lines = 0;
+	const char *last = ScanLiterals(start, start + _remain_size, &lines);
+
+	if(last == nullptr)
+		return nullptr;
+
+	Token *token = new Token();
+	token->type = TOKEN_LITERALS;
+	token->str = start;
+	token->len = last - start;
+	token->line = _line;
+
+	_line += lines;
+
+	_remain_size -= (int)(last - start);
+	_next_start = last;
+
+	token->remain_size = _remain_size;
+	token->next_start = _next_start;
+
+	_tokens.Add(token);
+
+	return token;
+}
+
+// Get the end of comma-separated literals, the last literal must be followed by , or ), nullptr if no literal found
+const char* SqlParser::ScanLiterals(const char *cur, const char *end, int *lines)
+{
+	// End of the last literal that is followed by , or ) and lines before it
+	const char *last = nullptr;
+	int last_lines = 0;
+
+	int count = 0;
+
+	while(true)
+	{
+		count += SkipLiteralSpaces(&cur, end);
+
+		if(cur >= end)
+			break;
+
+		// String literal, '' is an escaped quote
+		if(*cur == '\'')
+		{
+			cur++;
+
+			while(cur < end)
+			{
+				if(*cur == '\'')
+				{
+					if(cur + 1 < end && cur[1] == '\'')
+					{
+						cur += 2;
+						continue;
+					}
+
+					break;
+				}
+
+				if(*cur == '\n')
+					count++;
+
+				cur++;
+			}
+
+			if(cur >= end)
+				break;
+
+			cur++;
+		}
+		else
+		// NULL
+		if(end - cur >= 4 && _strnicmp(cur, "NULL", 4) == 0)
+			cur += 4;
+		else
+		// Number with an optional sign, fraction and exponent
+		{
+			if(*cur == '-' || *cur == '+')
+				cur++;
+
+			const char *digits = cur;
+
+			while(cur < end && ((*cur >= '0' && *cur <= '9') || *cur == '.'))
+				cur++;
+
+			if(cur == digits)
+				break;
+
+			if(cur + 1 < end && (*cur == 'e' || *cur == 'E'))
+			{
+				cur++;
+
+				if(*cur == '-' || *cur == '+')
+					cur++;
+
+				while(cur < end && *cur >= '0' && *cur <= '9')
+					cur++;
+			}
+		}
+
+		const char *literal_end = cur;
+		int literal_lines = count;
+
+		count += SkipLiteralSpaces(&cur, end);
+
+		// Literal must be a whole item, not a part of an expression
+		if(cur >= end || (*cur != ',' && *cur != ')'))
+			break;
+
+		last = literal_end;
+		last_lines = literal_lines;
+
+		if(*cur == ')')
+			break;
+
+		// Comma is included only if another literal follows it
+		cur++;
+	}
+
+	if(lines != nullptr)
+		*lines = last_lines;
+
+	return last;
+}
+
+// Skip spaces between literals, and return the number of lines counted as the lexer does
+int SqlParser::SkipLiteralSpaces(const char **cur, const char *end)
+{
+	int lines = 0;
+
+	while(*cur < end && (**cur == ' ' || **cur == '\t' || **cur == '\r' || **cur == '\n'))
+	{
+		const char *c = *cur;
+
+		// Sometimes a newline is represented single \r (0D), not followed by \n
+		if(*c == '\n' || (*c == '\r' && c + 1 < end && c[1] != '\n'))
+			lines++;
+
+		(*cur)++;
+	}
+
+	return lines;
+}
+
 // Get the previous non-blank, non comment token
 Token* SqlParser::GetPrevToken(Token *token)
 {
@@ -756,13 +1037,13 @@ Token* SqlParser::GetLastToken()
 // Get a procedure or function variable token by name
 Token* SqlParser::GetVariable(Token *name)
 {
-    if(name == nullptr || _spl_variables.GetCount() == 0)
+    if(name == nullptr || _spl->variables.GetCount() == 0)
         return nullptr;
 
     Token *token = nullptr;
 
 	// Start from the end of list as the local block variables have priority
-    for(ListwItem *i = _spl_variables.GetLast(); i != nullptr; i = i->prev)
+    for(ListwItem *i = _spl->variables.GetLast(); i != nullptr; i = i->prev)
 	{
 		// Local block boundary
 		if(i->value == (void*)-3)
@@ -782,7 +1063,7 @@ Token* SqlParser::GetVariable(Token *name)
 void SqlParser::EnterLocalVariablesBlock()
 {
 	// -3 block boundary
-	_spl_variables.Add((void*)-3);
+	_spl->variables.Add((void*)-3);
 }
 
 // Leave the block with own local variables
@@ -791,7 +1072,7 @@ void SqlParser::LeaveLocalVariablesBlock()
     ListwItem *boundary = nullptr;
 
 	// Find the last boundary
-    for(ListwItem *i = _spl_variables.GetLast(); i != nullptr; i = i->prev)
+    for(ListwItem *i = _spl->variables.GetLast(); i != nullptr; i = i->prev)
 	{
 		// Local block boundary
 		if(i->value == (void*)-3)
@@ -806,19 +1087,19 @@ void SqlParser::LeaveLocalVariablesBlock()
 		return;
 
 	// Remove local block variables
-	_spl_variables.DeleteSince(boundary);
+	_spl->variables.DeleteSince(boundary);
 }
 
 // Get a procedure or function parameter by name
 Token* SqlParser::GetParameter(Token *name)
 {
-    if(name == nullptr || _spl_parameters.GetCount() == 0)
+    if(name == nullptr || _spl->parameters.GetCount() == 0)
         return nullptr;
 
     Token *token = nullptr;
 
 	// Find the parameter
-    for(ListwItem *i = _spl_parameters.GetFirst(); i != nullptr; i = i->next)
+    for(ListwItem *i = _spl->parameters.GetFirst(); i != nullptr; i = i->next)
 	{
 		if(Token::Compare((Token*)i->value, name) == true)
 		{
@@ -1422,6 +1703,10 @@ Token* SqlParser::Append(Token *token, const char *str, const wchar_t *wstr, siz
     append->prev = nullptr;
     append->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(append->source_allocated && append->str != nullptr)
+		append->str = Str::GetCopy(append->str, append->len);
+
     append->t_str = nullptr;
     append->t_wstr = nullptr;
 	append->t_len = 0;
@@ -1514,6 +1799,10 @@ void SqlParser::AppendFirst(Token *token, const char *str, const wchar_t *wstr,
     append->prev = nullptr;
     append->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(append->source_allocated && append->str != nullptr)
+		append->str = Str::GetCopy(append->str, append->len);
+
     append->t_str = nullptr;
     append->t_wstr = nullptr;
 	append->t_len = 0;
@@ -1538,6 +1827,10 @@ Token* SqlParser::AppendNoFormat(Token *token, const char *str, const wchar_t *
     append->prev = nullptr;
     append->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(append->source_allocated && append->str != nullptr)
+		append->str = Str::GetCopy(append->str, append->len);
+
 	append->t_str = Str::GetCopy(str, len);
     append->t_wstr = nullptr;
 	append->t_len = len;
@@ -1568,6 +1861,10 @@ void SqlParser::AppendFirstNoFormat(Token *token, const char *str, const wchar_t
     append->prev = nullptr;
     append->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(append->source_allocated && append->str != nullptr)
+		append->str = Str::GetCopy(append->str, append->len);
+
 	append->t_str = Str::GetCopy(str, len);
     append->t_wstr = nullptr;
 	append->t_len = len;
@@ -1712,6 +2009,10 @@ Token* SqlParser::Prepend(Token *token, const char *str, const wchar_t *wstr, si
 
     prepend->prev = nullptr;
     prepend->next = nullptr;
+
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(prepend->source_allocated && prepend->str != nullptr)
+		prepend->str = Str::GetCopy(prepend->str, prepend->len);
     prepend->t_str = nullptr;
     prepend->t_wstr = nullptr;
 	prepend->t_len = 0;
@@ -1754,6 +2055,10 @@ Token* SqlParser::PrependNoFormat(Token *token, const char *str, const wchar_t *
     prepend->prev = nullptr;
     prepend->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(prepend->source_allocated && prepend->str != nullptr)
+		prepend->str = Str::GetCopy(prepend->str, prepend->len);
+
 	prepend->t_str = Str::GetCopy(str, len);
     prepend->t_wstr = nullptr;
 	prepend->t_len = len;
@@ -1864,6 +2169,10 @@ void SqlParser::PrependFirstNoFormat(Token *token, const char *str, const wchar_
     prepend->prev = nullptr;
     prepend->next = nullptr;
 
+	// Reallocate source if the token owns it, otherwise it is deleted twice
+	if(prepend->source_allocated && prepend->str != nullptr)
+		prepend->str = Str::GetCopy(prepend->str, prepend->len);
+
 	prepend->t_str = Str::GetCopy(str, len);
     prepend->t_wstr = nullptr;
 	prepend->t_len = len;
@@ -1964,9 +2273,39 @@ int SqlParser::CreateReport(const char *summary)
 {
     if(_report != nullptr)
     {
+		_report->SetSnippetsPage(_option_snippets_page);
+		_report->SetExportPath(_option_report_export.c_str());
+
         _report->CreateReport(_stats, _source, _target, summary);
         return 0;
     }
 
     return -1;
 }
+
+// Scan the input for object headers and block extents without conversion
+int SqlParser::ScanInventory(const char *input, int size, int *lines)
+{
+	if(_inventory == nullptr)
+		return -1;
+
+	return _inventory->Scan(input, size, lines);
+}
+
+// Write the inventory file
+int SqlParser::CreateInventory()
+{
+	if(_inventory == nullptr)
+		return -1;
+
+	return _inventory->Write();
+}
+
+// Get the number of found objects by type as text
+const char* SqlParser::GetInventorySummary()
+{
+	if(_inventory == nullptr)
+		return "";
+
+	return _inventory->GetSummary();
+}
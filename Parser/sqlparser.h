@@ -5,13 +5,21 @@
 
 #include <stdio.h>
 #include <map>
+#include <unordered_map>
 #include "token.h"
 #include "stats.h"
 #include "report.h"
+#include "inventory.h"
 #include "listt.h"
 #include "listw.h"
 #include "listwm.h"
+#include "arena.h"
+#include "splstate.h"
 #include "doc.h"
+#include "memo.h"
+#include "partitions.h"
+#include "sequences.h"
+#include "temptables.h"
 
 // Conversion level
 #define LEVEL_APP			1
@@ -122,6 +130,13 @@
 #define BOOK_CI_START			5			// CREATE INDEX start
 #define BOOK_CI_END				6			// CREATE INDEX end
 #define BOOK_USER_EXCEPTION		7			// User-defined exception
+#define BOOK_INSERT_ROW			8			// Single-row INSERT, name - INSERT, name2 - ( of values, book - ;
+
+// Default maximum size of multi-row INSERT in bytes (max_allowed_packet in MySQL)
+#define INSERT_BATCH_MAX_PACKET		4194304
+
+// MySQL version supporting functional key parts in indexes
+#define MYSQL_FUNCTIONAL_KEY_PARTS	80013
 
 // Cope, Paste and Cut scopes
 #define COPY_SCOPE_PROC		1			// Procedure, function, trigger or outer anonymous block
@@ -256,6 +271,12 @@ class SqlParser
 
 	// Bookmarks
 	ListT<Book> _bookmarks;
+	// Last column definition by table and column name, column definitions and their end by CREATE TABLE
+	std::unordered_map<std::string, Book*> _column_books;
+	std::unordered_map<Token*, std::vector<Book*> > _table_column_books;
+	std::unordered_map<Token*, Book*> _table_end_books;
+	// Number of CREATE TABLE statements by table name
+	std::unordered_map<std::string, int> _table_definitions;
 	// Copy, Paste and Cut blocks
 	ListT<CopyPaste> _copypaste;
 
@@ -265,165 +286,16 @@ class SqlParser
 	// Scope list
 	ListWM _scope;
 
-	// Current procedural scope (procedure, function, trigger i.e.)
-	int _spl_scope;
-
-	// Name of current procedure (function, trigger)
-	Token *_spl_name;
-	// Start token of procedure, function or trigger (usually it is CREATE keyword)
-	Token *_spl_start;
-
-
-	// Current variables and parameters
-	ListW _spl_variables;
-	ListW _spl_parameters;
-
-	// Outer BEGIN keyword
-    Token *_spl_outer_begin;
-    // Standalone BEGIN levels in the current procedure (each BEGIN entry is cleared on block exit)
-    ListW _spl_begin_blocks;
-
-	// Outer AS or IS keyword
-    Token *_spl_outer_as;
-
-    // Last declare statement before the first non-declare statement
-	Token *_spl_last_declare;
-    // First non-declare statement in procedure or function
-	Token *_spl_first_non_declare;
-
-	// Last statement in procedure or function
-	Token *_spl_last_stmt;
-
-    // Last token of last declared variable (not cursor) in the outer PL/SQL DECLARE block
-    Token *_spl_last_outer_declare_var;
-	Token *_spl_last_outer_declare_varname;
-    
-	// Number of result sets returned from procedure
-	int _spl_result_sets;
-	// Result set cursor names (declared cursor with return)
-	ListW _spl_result_set_cursors;
-	// Result set generated cursor names (for standalone SELECT returning a result set)
-	ListT<TokenStr> _spl_result_set_generated_cursors;
-	
-	// Delimiter is set at the end of procedure
-	bool _spl_delimiter_set;
-	// User-defined exceptions and condition handlers
-	ListWM _spl_user_exceptions;
-
-	// NEW and OLD correlation name in trigger
-	Token *_spl_new_correlation_name;
-	Token *_spl_old_correlation_name;
-	// Referenced NEW and OLD columns
-	ListW _spl_tr_new_columns;
-	ListW _spl_tr_old_columns;
-
-	// Outer block label in DB2 procedure
-	Token *_spl_outer_label;
-	// Oracle PL/SQL cursor parameters
-	ListWM _spl_cursor_params;
-	// Variables generated for Oracle PL/SQL parameters
-	ListWM _spl_cursor_vars;
-	// The names and definitions of declared cursors
-	ListW _spl_declared_cursors;
-	ListW _spl_declared_cursors_using_vars;
-	ListWM _spl_declared_cursors_stmts;
-	// Current declaring cursor
-	Token *_spl_current_declaring_cursor;
-	// Current declaring cursor uses procedural variables
-	bool _spl_current_declaring_cursor_uses_vars;
-	// Cursor for which updates WHERE CURRENT OF is performed
-	ListW _spl_updatable_current_of_cursors;
-	// Declared cursors and their SELECT statements
-	ListWM _spl_declared_cursors_select;
-	// Declared cursors and their select list expressions
-	ListWM _spl_declared_cursors_select_first_exp;
-	ListWM _spl_declared_cursors_select_exp;
+	// Procedural scope state of the current procedure, function or trigger (allocated from _spl_arena)
+	SplState *_spl;
+	// Arena for procedural scope state, rewound after each procedure, function or trigger
+	Arena _spl_arena;
 
 	// The current PL/SQL package
 	Token *_spl_package;
-	// Declared record variables %ROWTYPE
-	ListW _spl_rowtype_vars;
-	// Referenced %ROWTYPE record fields
-	ListWM _spl_rowtype_fields;
-	// Fetch into record referenced
-	ListW _spl_rowtype_fetches;
 	// TYPE name OF TABLE datatype
 	ListWM _spl_obj_type_table;
 
-	// Implicit rowtype created by for cursor loops
-	ListWM _spl_implicit_rowtype_vars;
-	// Implicit rowtype fields
-	ListWM _spl_implicit_rowtype_fields;
-	// Generated FETCH statements to emulate cursor loops
-	ListWM _spl_implicit_rowtype_fetches;
-
-	// Declared local temporary tables, table variables
-	ListW _spl_declared_local_tables;
-	// Created session temporary tables
-	ListW _spl_created_session_tables;
-
-
-	// Closing parenthesis ) after parameter list
-	Token *_spl_param_close;
-	
-	// RETURNS, RETURN, RETURNING keyword
-	Token *_spl_returns;
-
-	// Generated OUT variable names for Informix RETURNING clause
-	ListWM _spl_returning_out_names;
-	// Function returns integer data type
-	bool _spl_return_int;
-
-	// Number of FOREACH statements in the current procedure (function, trigger)
-	int _spl_foreach_num;
-	// Number of RETURN WITH RESUME in procedure
-	int _spl_return_with_resume;
-	// Number of RETURN statements in procedure
-	int _spl_return_num;
-
-	// Table name from last INSERT statement
-	Token *_spl_last_insert_table_name;
-	// Cursor name from last OPEN statement
-	Token *_spl_last_open_cursor_name;
-	// Cursor name from last FETCH statement
-	Token *_spl_last_fetch_cursor_name;
-	// List of OPEN cursor statemenents 
-	ListWM _spl_open_cursors;
-
-	// Prepared statements id
-	ListWM _spl_prepared_stmts;
-	// Cursors for prepared statements
-	ListWM _spl_prepared_stmts_cursors;
-	ListWM _spl_prepared_stmts_cursors_with_return;
-
-	// Fields of implicit records created by FOR loops
-	ListWM _spl_implicit_record_fields;
-	
-	// Result set locators associated with procedures
-	ListWM _spl_rs_locator_procedures;
-
-    // Loops level in the current procedure (each loop entry is cleared on loop exit)
-    ListW _spl_loops;
-    // Number of loop labels already generated in the current procedure
-    int _spl_loop_labels;
-
-	// Stored procedures calls inside procedural block
-	ListWM _spl_sp_calls;
-
-	// Number of SELECT statements moved out of IF boolean condition
-	int _spl_moved_if_select;
-
-	// Procedure converted to function
-	bool _spl_proc_to_func;
-	// Function converted to procedure
-	bool _spl_func_to_proc;
-    // Handler for NOT FOUND condition
-    bool _spl_not_found_handler;
-	bool _spl_need_not_found_handler;
-
-	// Monday is 1 day, Sunday is 7 (false if it is unknown from context)
-	bool _spl_monday_1;
-
 	// User-defined data types
 	ListWM _udt;
 
@@ -436,11 +308,50 @@ class SqlParser
 	// Push back token
 	Token *_push_back_token;
 
+	// Table of CREATE INDEX, its columns get the data types of their definitions
+	Token *_create_index_table;
+
+	// First and last tokens of Oracle rownum condition found in the current WHERE clause
+	Token *_rownum_first;
+	Token *_rownum_last;
+
 	// Options
 	bool _option_rems;
+	// Assessment only, the output is not generated
+	bool _option_assess_only;
+	// Maximum number of code snippets per assessment item (0 for default)
+	int _option_snippets;
+	// Number of items per snippets page (0 for a single snippets file)
+	int _option_snippets_page;
+	// Statistics export file
+	std::string _option_report_export;
 	std::string _option_oracle_plsql_number_mapping;
 	std::string _option_set_explicit_schema;
 	std::string _option_cur_file;
+	// Reuse conversions of repeated top-level statements
+	bool _option_memo;
+	// Maximum number of rows in multi-row INSERT (0 if single-row INSERT statements are not merged)
+	int _option_insert_batch;
+	// Maximum size of multi-row INSERT in bytes
+	int _option_max_allowed_packet;
+	// Create global temporary tables as session temporary tables in procedures using them
+	bool _option_session_temp_tables;
+	// Target MySQL version as major * 10000 + minor * 100 + patch (0 for the latest version)
+	int _option_mysql_version;
+
+	// Recorded conversions of repeated statements in the current file
+	StatementMemo _memo;
+
+	// Sequences and triggers assigning sequence values to columns in the current file
+	std::vector<OracleSequence> _sequences;
+	std::vector<SequenceTrigger> _sequence_triggers;
+	// Index of the last sequence by name
+	std::unordered_map<std::string, int> _sequence_index;
+	// Sequences converted and referenced in all files (not cleared for the next file)
+	std::vector<SequenceUsage> _sequence_usage;
+
+	// Global temporary tables in the current file
+	std::vector<OracleTempTable> _temp_tables;
 
 	// Mappings
 	StringMap _object_map;
@@ -451,6 +362,9 @@ class SqlParser
     Stats *_stats;
     Report *_report;
 
+	// Object inventory (scan only, no conversion)
+	Inventory *_inventory;
+
 public:
 	SqlParser();
 	~SqlParser();
@@ -470,6 +384,20 @@ public:
 
 	// Post conversion when all tokens processed
 	void Post();
+	void PostInsertBatches();
+	void PostSequenceTriggers();
+	void PostSequenceEmulation();
+	void PostSequenceUsage();
+	std::string GetSequenceValue(Token *value, const char *default_value);
+	void PostCursorForLoops();
+	void PostBulkOperations();
+	void PostOptimizerHints();
+	void PostSessionTempTables();
+	void PostSessionTempTablesUnit(Token *begin, Token *end);
+	void RemoveStatement(Token *first, Token *last);
+	void GetTargetText(Token *first, Token *last, std::string &text);
+	std::string GetLineIndent(Token *token);
+	void GetProcedureBodies(std::vector<std::pair<Token*, Token*> > &bodies);
 
 	// Get next token from the input
 	Token* GetNextToken();
@@ -487,6 +415,9 @@ public:
 	Token* GetNextNumberToken();
 	Token* GetNextNumberToken(Token *prev);
 	Token* GetNextStringToken();
+	Token* GetNextLiteralsToken();
+	const char* ScanLiterals(const char *cur, const char *end, int *lines);
+	int SkipLiteralSpaces(const char **cur, const char *end);
 	Token* GetPrevToken(Token *token);
 	Token* GetLastToken();
 	Token* GetLastToken(Token *last);
@@ -506,8 +437,8 @@ public:
 	void EnterLocalVariablesBlock();
 	void LeaveLocalVariablesBlock();
 
-	void AddVariable(Token *name) { _spl_variables.Add(name); }
-	void AddParameter(Token *name) { _spl_parameters.Add(name); }
+	void AddVariable(Token *name) { _spl->variables.Add(name); }
+	void AddParameter(Token *name) { _spl->parameters.Add(name); }
 
 	// Return the last fetched token to the input
 	void PushBack(Token *token);
@@ -562,6 +493,10 @@ public:
 	Book* GetBookmark(int type, Token *name); 
 	Book* GetBookmark(int type, Token *name, Token *name2); 
 	Book* GetBookmark2(int type, Token *name); 
+	Book* GetColumnBookmark(Token *table, Token *column);
+	std::string GetNameKey(const char *str, size_t len);
+	std::string GetNameKey(Token *name, Token *name2 = NULL);
+	std::string GetSequenceKey(Token *ref);
 
 	// Copy, Paste and Cut operations
 	void Cut(int scope, int type, Token *name, Token *start, Token *end);
@@ -581,6 +516,7 @@ public:
 	
 	// Parser functions
 	void Parse(Token *token, int scope, int *result_sets);
+	void ParseWithMemo(Token *token, int *result_sets);
 	bool ParseStatement(Token *token, int scope, int *result_sets);
 	bool ParseDataType(Token *type, int clause_scope = SQL_SCOPE_TAB_COLS);
 	bool ParseTypedVariable(Token *var, Token *ref_type);
@@ -653,16 +589,19 @@ public:
 	bool ParseCreateTable(Token *create, Token *table);
 	bool ParseCreateTablespace(Token *create, Token *tablespace);
 	bool ParseCreateIndex(Token *create, Token *unique, Token *index);
+	void ConvertIndexExpression(Token *index, Token *table, Token *first, Token *last, std::string &columns, int *num);
+	Token* GetCreateTableColumnType(Token *table, Token *column);
 	bool ParseCreateTrigger(Token *create, Token *or_, Token *trigger);
-	bool ParseCreateTriggerBody(Token *create, Token *name, Token *table, Token *when, Token *insert, Token *update, Token *delete_, Token **end);
-	bool ParseCreateTriggerOraclePattern(Token *create, Token *table, Token *when, Token *insert);
+	bool ParseCreateTriggerBody(Token *create, Token *name, Token **end);
+	bool ParseCreateTriggerOraclePattern(Token *create, Token *table, Token *when, Token *insert, Token *condition, Token *begin, Token *end, Token *last);
+	bool ParseCreateSequence(Token *create, Token *sequence);
 	bool ParseCreateType(Token *create, Token *type);
-	bool ParseSequenceOptions(Token **start_with, Token **increment_by, StatsSummaryItem &sti);
+	bool ParseSequenceOptions(OracleSequence *sequence, StatsSummaryItem &sti);
 	bool ParseCreateView(Token *create, Token *materialized, Token *view);
 	bool ParseDropStatement(Token *drop);
 	bool ParseDropTableStatement(Token *drop, Token *table);
 	bool ParseDropTriggerStatement(Token *drop, Token *trigger);
-	bool ParseInsertStatement(Token *insert);
+	bool ParseInsertStatement(Token *insert, Token **values_open = NULL);
 	bool ParseSelectStatement(Token *token, int block_scope, int select_scope, int *result_sets, Token **list_end, ListW *exp_starts, ListW *out_cols, ListW *into_cols, int *appended_subquery_aliases, Token **from_end, Token **where_end);
 	bool ParseSelectExpressionPattern(Token *open, Token *select); 
 	bool ParseTruncateStatement(Token *truncate, int scope);
@@ -813,6 +752,11 @@ public:
 	bool ParseOracleVariableDeclarationBlock(Token *declare);
 	bool ParseOracleCursorDeclaration(Token *cursor, ListWM *cursors);
 	bool ParseOracleObjectType(Token *type);
+	void OracleCollectionTypes(Token *begin);
+	bool OracleIsRecordCollection(Token *var, Token *begin, bool *record);
+	void OracleBulkOperations(Token *begin, Token *end);
+	bool OracleForallStatement(Token *forall, Token *end, std::vector<OracleBulkCollect> &bulks, OracleForall &stmt);
+	int GetBulkCollection(std::vector<OracleBulkCollect> &bulks, Token *token, int last, bool *prefix);
 	bool ParseOracleObjectTypeAssignment(Token *name);
 	bool ParseOraclePragma(Token *pragma);
 	bool ParseOracleException(Token *name);
@@ -828,29 +772,40 @@ public:
 	bool ParseSelectFromClause(Token *select, bool nested_from, Token **from, Token **from_end, int *appended_subquery_aliases, bool dummy_not_required, ListWM *from_table_end);
 	bool ParseJoinClause(Token *first, Token *second, bool first_is_subquery, ListWM *from_table_end);
 	bool GetJoinKeywords(Token *token, Token **left_right_full, Token **outer_inner, Token **join);
-	bool ParseWhereClause(int stmt_scope, Token **where_, Token **where_end, int *rowlimit = NULL);
+	bool ParseWhereClause(int stmt_scope, Token **where_, Token **where_end, int *rowlimit = NULL, Token **rownum_first = NULL, Token **rownum_last = NULL);
 	bool ParseWhereCurrentOfCursor(int stmt_scope);
 	bool ParseSelectGroupBy();
 	bool ParseSelectHaving();
 	bool ParseSelectOrderBy(Token **order);
 	bool ParseSelectSetOperator(int block_scope, int select_scope);
-	bool ParseSelectOptions(Token *select, Token *from_end, Token *where_, Token *order, Token **rowlimit_soptions, int *rowlimit);
+	bool ParseSelectOptions(Token *select, Token *from_end, Token *where_, Token *order, Token **rowlimit_soptions, int *rowlimit,
+		Token **rowlimit_offset = NULL, bool *rowlimit_percent = NULL, Token **rowlimit_start = NULL, Token **rowlimit_end = NULL);
 	void SelectSetOutColsDataTypes(ListW *out_cols, ListWM *from_table_end);
-	void SelectConvertRowlimit(Token *select, Token *from, Token *from_end, Token *where_, Token *where_end, Token *pre_order, Token *order, Token *rowlimit_slist, Token *rowlimit_soptions, int rowlimit, bool rowlimit_percent);
+	void SelectConvertRowlimit(Token *select, Token *select_list_end, Token *from, Token *order, Token *order_end, Token *rowlimit_slist, Token *rowlimit_soptions, Token *rowlimit_offset, Token *rowlimit_start, Token *rowlimit_end, int rowlimit, bool rowlimit_percent);
+	void SelectConvertRowlimitPercent(Token *select, Token *select_list_end, Token *from, Token *order, Token *order_end, Token *count, Token *offset, Token *rowlimit_start, Token *rowlimit_end, int limit);
 	
-	bool ParseTempTableOptions(Token *table_name, Token **start, Token **end, bool *no_data);
+	bool ParseTempTableOptions(Token *table_name, Token **start, Token **end, bool *no_data, bool *delete_rows = NULL);
 	bool ParseStorageClause(Token *table_name, Token **id_start, Token **comment, Token *last_colname, Token *last_colend);
 	bool ParseCreateIndexOptions();
 	bool OpenWithReturnCursor(Token *name);
 
-	bool ParseOracleStorageClause();
+	bool ParseOracleStorageClause(bool remove_tablespace = true);
 	bool ParseOracleStorageClause(Token *storage);
 	bool ParseOracleLobStorageClause(Token *lob);
-	bool ParseOraclePartitions(Token *token);
-	bool ParseOraclePartitionsBy(Token *token);
-	bool ParseOraclePartition(Token *partition, Token *subpartition);
+	bool ParseOraclePartitions(Token *token, Token *table_name);
+	bool ParseOraclePartitionsBy(Token *token, PartitionsBy *by);
+	int ParseOraclePartition(Token *partition, Token *subpartition, OraclePartitions *parts);
+	bool ParseOraclePartitionValues(OraclePartitions *parts);
+	int GetOraclePartitionValueKind(Token *start, Token *end, std::string &literal);
+	bool GetOracleDateLiteral(Token *value, Token *format, std::string &literal, bool *time);
+	void OracleConvertPartitions(Token *table_name, OraclePartitions *parts);
+	bool OracleCheckPartitionKeys(Token *table_name, std::vector<Token*> &columns);
+	bool GetTableKeys(Token *table_name, std::vector<std::vector<Token*> > &keys);
+	bool OracleIsIntegerColumn(Token *table_name, Token *column);
+	bool OracleIsMemoryEngineTable(Token *table_name);
 	bool ParseOracleOuterJoin(Token *exp_start, Token *column);
 	bool ParseOracleRownumCondition(Token *first, Token *op, Token *second, int *rowlimit);
+	bool RemoveOracleRownumCondition(Token *select, Token *where_, Token *where_end, Token *rownum_first, Token *rownum_last, bool aggregate);
 	bool RecognizeOracleDateFormat(Token *str, TokenStr &format);
 	void OracleEmulateIdentity(Token *create, Token *table, Token *column, Token *last, Token *id_start, Token *id_inc, bool id_default);
 	void OracleExitHandlersToException(Token *end);
@@ -875,7 +830,30 @@ public:
 	void AddGeneratedVariables();
 
 	// Patterns
-	bool SelectNextvalFromDual(Token **sequence, Token **column);
+	bool SelectNextvalFromDual(Token **token, Token **sequence, Token **column);
+	bool AssignNextval(Token **token, Token **sequence, Token **column);
+	bool IsTriggerColumnNull(Token *condition, Token *begin, Token *column);
+	Token* GetTriggerNewColumn(Token **token);
+	bool SplitTriggerNewColumn(Token *ref, Token *column);
+	bool IsSequenceReference(Token *ref, Token *name);
+	bool IsNextvalReference(Token *ref);
+	Token* GetNextPatternToken(Token *token);
+	bool OracleCursorForLoop(Token *for_, Token *begin, Token *end, Token **next);
+	const char* JoinSetBasedStatement(Token *stmt, Token *semi, Token *values, Token *where_, bool rows_in_where, 
+		std::string &rows, std::vector<std::string> *columns, Token *query_first, Token *query_last, Token *begin, bool check_only = false);
+	bool GetDeclaredCursorQuery(Token *cursor, Token *begin, Token **first, Token **last);
+	bool IsDeclaredVariable(Token *name, Token *begin);
+	bool GetQueryColumnNames(Token *first, Token *last, std::vector<std::string> &names, bool *all_named = NULL);
+	bool IsQueryColumnReference(Token *token, std::vector<std::string> &columns);
+	bool IsUpdateSetReadingTarget(Token *set, Token *where_, Token *table, Token *alias, Token *begin);
+	Token* GetClosingParenthesis(Token *open, Token *end);
+
+	// Optimizer hints
+	void OptimizerHints(Token *stmt, Token *comment);
+	const char* OptimizerHint(Token *stmt, std::string &name, std::vector<std::string> &args, 
+		std::vector<std::pair<Token*, Token*> > &tables, std::vector<std::string> &index_hints, std::string &target);
+	void GetHintTableReferences(Token *stmt, std::vector<std::pair<Token*, Token*> > &tables);
+	Token* GetNextHintToken(Token *token);
 
 	// Identifiers
 	void ConvertIdentifier(Token *token, int expected_type = 0, int scope = 0);
@@ -955,6 +933,33 @@ public:
 
     // Create report file
     int CreateReport(const char *summary); 
+
+	// Scan the input for object headers and block extents without conversion
+	int ScanInventory(const char *input, int size, int *lines);
+	// Write the inventory file
+	int CreateInventory();
+	// Get the number of found objects by type as text
+	const char* GetInventorySummary();
+
+	// Get the peak memory used by procedural scope state and lists
+	size_t GetSplPeakMemory() { return _spl_arena.GetPeakSize(); }
+	// Get the number of statements looked up in the statement memo and reused
+	void GetMemoStats(int *statements, int *hits) { *statements = _memo.statements; *hits = _memo.hits; }
+	SequenceUsage* GetSequenceUsage(size_t num) { return (num < _sequence_usage.size()) ? &_sequence_usage[num] : NULL; }
+
+	// Statement memo (memo.cpp)
+	int GetMemoStatementKind(Token *token);
+	bool ParseInsertLiterals(Token *insert, int *result_sets);
+	bool ScanInsertLiterals(const char **head_end, const char **open, const char **semi, int *open_lines, int *lines);
+	bool ScanMemoIdentifier(const char **cur, const char *end);
+	void GetMemoBeforeFlags(Token *before, std::vector<int> &flags);
+	bool IsMemoBeforeChanged(Token *before, std::vector<int> &flags);
+	bool ScanMemoStatement(Token *first, StatementScan &scan);
+	void RecordMemoStatement(Token *before, StatementScan &scan);
+	int GetMemoGap(Token *token, StatementScan &scan, int prev_gap, bool *changed);
+	void ReplayMemoStatement(Token *first, StatementScan &scan, StatementMemoEntry *entry);
+	void SkipMemoInput(const char *to);
+	Token* CopyMemoToken(Token *source);
 };
 
 #endif // sqlines_sqlparser_h
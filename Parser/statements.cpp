@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "sqlparser.h"
+#include "str.h"
 
 bool SqlParser::ParseStatement(Token *token, int scope, int *result_sets)
 {
@@ -12,6 +13,8 @@ bool SqlParser::ParseStatement(Token *token, int scope, int *result_sets)
     bool exists = false;
     bool proc = false;
 
+    Token *values_open = nullptr;
+
     // ALTER statement
     if(token->Compare("ALTER", L"ALTER", 5) == true)
         exists = ParseAlterStatement(token, result_sets, &proc);
@@ -30,7 +33,7 @@ bool SqlParser::ParseStatement(Token *token, int scope, int *result_sets)
     else
     // INSERT statement
     if(token->Compare("INSERT", L"INSERT", 6) == true)
-        exists = ParseInsertStatement(token);
+        exists = ParseInsertStatement(token, &values_open);
 	else
 	// UPDATE
 	if(token->Compare("UPDATE", L"UPDATE", 6) == true)
@@ -41,7 +44,11 @@ bool SqlParser::ParseStatement(Token *token, int scope, int *result_sets)
         return false;
 
     // Optional delimiter at the end of the statement
-    /*Token *semi */ (void) GetNextCharToken(';', L';');
+    Token *semi = GetNextCharToken(';', L';');
+
+    // Single-row INSERT can be merged with the next INSERT into the same table
+    if(values_open != nullptr && semi != nullptr && scope == SQL_SCOPE_FREE && _option_insert_batch > 1)
+        Bookmark(BOOK_INSERT_ROW, token, values_open, semi);
 
     return exists;
 }
@@ -146,6 +153,10 @@ bool SqlParser::ParseCreateStatement(Token *create, int *result_sets, bool *proc
         exists = ParseCreateTable(create, next);
     }
     else
+    // CREATE SEQUENCE
+    if(next->Compare("SEQUENCE", L"SEQUENCE", 8) == true)
+        exists = ParseCreateSequence(create, next);
+    else
     // CREATE TABLESPACE
     if(next->Compare("TABLESPACE", L"TABLESPACE", 10) == true)
         exists = ParseCreateTablespace(create, next);
@@ -413,6 +424,9 @@ bool SqlParser::ParseCreateTable(Token *create, Token *token)
     Token *last_colname = nullptr;
     Token *last_colend = nullptr;
 
+    // Global temporary table with the column list
+    OracleTempTable temp;
+
     // CREATE TABLE AS SELECT
     Token *as = TOKEN_GETNEXTW("AS");
 
@@ -444,6 +458,18 @@ bool SqlParser::ParseCreateTable(Token *create, Token *token)
         // Save bookmark to the end of columns but before storage and other properties
         Book *col_end = Bookmark(BOOK_CTC_ALL_END, table, close);
 
+        // ON COMMIT clause of global temporary table
+        if(_obj_scope == SQL_SCOPE_TEMP_TABLE)
+        {
+            temp.create = create;
+            temp.name = table;
+            temp.close = close;
+
+            ParseTempTableOptions(table, nullptr, nullptr, nullptr, &temp.delete_rows);
+        }
+
+        // Storage and partitioning clauses
+        ParseStorageClause(table, &id_start, nullptr, last_colname, last_colend);
     }
 
     /*Token *semi */(void) GetNext(';', L';');
@@ -453,16 +479,22 @@ bool SqlParser::ParseCreateTable(Token *create, Token *token)
     // Save bookmark to the end of CREATE TABLE
     Bookmark(BOOK_CT_END, table, last);
 
+    if(temp.close != nullptr)
+    {
+        temp.end = last;
+        _temp_tables.push_back(temp);
+    }
+
     // For add sequence and trigger to emulate identity column
     if(id_col != nullptr)
     {
         OracleEmulateIdentity(create, table, id_col, last, id_start, id_inc, id_default);
     }
 
-    if(_spl_first_non_declare == nullptr)
-        _spl_first_non_declare = create;
+    if(_spl->first_non_declare == nullptr)
+        _spl->first_non_declare = create;
 
-    _spl_last_stmt = create;
+    _spl->last_stmt = create;
 
     return true;
 }
@@ -541,6 +573,41 @@ bool SqlParser::ParseCreateTablespace(Token *create, Token *tablespace)
     return exists;
 }
 
+// CREATE SEQUENCE statement
+bool SqlParser::ParseCreateSequence(Token *create, Token *sequence)
+{
+    STATS_DECL
+    STMS_STATS_V("CREATE SEQUENCE", create)
+
+    if(sequence == nullptr)
+        return false;
+
+    // Sequence name
+    Token *name = GetNextIdentToken(SQL_IDENT_OBJECT);
+
+    if(name == nullptr)
+        return false;
+
+    OracleSequence seq;
+
+    seq.create = create;
+    seq.name = name;
+
+    ParseSequenceOptions(&seq, ssi);
+
+    /*Token *semi */ (void) GetNextCharToken(';', L';');
+
+    seq.end = GetLastToken();
+
+    SEQ_STATS_V("CREATE SEQUENCE", create)
+
+    // Converted at the end of file when triggers using the sequence are known
+    _sequences.push_back(seq);
+    _sequence_index[GetNameKey(seq.name)] = (int)_sequences.size() - 1;
+
+    return true;
+}
+
 // CREATE INDEX
 bool SqlParser::ParseCreateIndex(Token *create, Token *unique, Token *index)
 {
@@ -572,6 +639,11 @@ bool SqlParser::ParseCreateIndex(Token *create, Token *unique, Token *index)
     // Open (
     /*Token *open */ (void) GetNextCharToken('(', L'(');
 
+    // Generated columns for expressions of function-based index
+    std::string gen_columns;
+    int gen_num = 0;
+
+    _create_index_table = table;
 
     // Handle index columns
     while(true)
@@ -584,6 +656,11 @@ bool SqlParser::ParseCreateIndex(Token *create, Token *unique, Token *index)
         // Parse column as expression as it can be a function-based indes
         ParseExpression(col);
 
+        Token *col_end = GetLastToken();
+
+        if(col_end != col)
+            ConvertIndexExpression(name, table, col, col_end, gen_columns, &gen_num);
+
         Token *next = GetNextToken();
 
         if(next == nullptr)
@@ -601,9 +678,21 @@ bool SqlParser::ParseCreateIndex(Token *create, Token *unique, Token *index)
         break;
     }
 
+    _create_index_table = nullptr;
+
     // Close )
     /*Token *close */ (void) GetNextCharToken(')', L')');
 
+    // Generated columns are added to the table before the index is created
+    if(!gen_columns.empty())
+    {
+        std::string table_name;
+        GetTargetText(table, table, table_name);
+
+        std::string alter = "ALTER TABLE " + table_name + gen_columns + ";\n";
+        PrependNoFormat(create, alter.c_str(), nullptr, alter.length());
+    }
+
     ParseCreateIndexOptions();
 
     Token *last = GetLastToken();
@@ -614,6 +703,135 @@ bool SqlParser::ParseCreateIndex(Token *create, Token *unique, Token *index)
     return true;
 }
 
+// Functions returning the data type of their first argument
+static const char *g_index_same_type_functions[] = { "LEFT", "LOWER", "LTRIM", "RTRIM", "SUBSTR", "SUBSTRING", "TRIM",
+    "TRUNCATE", "UPPER", nullptr };
+
+// Convert expression of function-based index to functional key part, or STORED generated column for earlier MySQL versions
+void SqlParser::ConvertIndexExpression(Token *index, Token *table, Token *first, Token *last, std::string &columns, int *num)
+{
+    if(index == nullptr || first == nullptr || last == nullptr)
+        return;
+
+    std::string type;
+
+    if(_option_mysql_version != 0 && _option_mysql_version < MYSQL_FUNCTIONAL_KEY_PARTS && first->type == TOKEN_FUNCTION &&
+        GetClosingParenthesis(GetNextPatternToken(first), nullptr) == last)
+    {
+        Token *column = nullptr;
+        Token *column_type = nullptr;
+        bool same_type = true;
+
+        for(Token *token = first; token != nullptr; token = token->next)
+        {
+            if(token->type == TOKEN_FUNCTION && !token->IsRemoved())
+            {
+                std::string func;
+                GetTargetText(token, token, func);
+
+                bool found = false;
+
+                for(int i = 0; g_index_same_type_functions[i] != nullptr && !found; i++)
+                    found = (_stricmp(func.c_str(), g_index_same_type_functions[i]) == 0);
+
+                // TRUNC(date) returns date
+                if(token == first && _stricmp(func.c_str(), "DATE") == 0)
+                    type = "DATE";
+                else
+                if(!found)
+                    same_type = false;
+            }
+            else
+            if(column == nullptr && (token->type == TOKEN_WORD || token->type == TOKEN_IDENT))
+            {
+                column = token;
+                column_type = GetCreateTableColumnType(table, token);
+            }
+
+            if(token == last)
+                break;
+        }
+
+        // Data type of the column from CREATE TABLE or meta information
+        if(type.empty() && same_type && column_type != nullptr)
+        {
+            Token *type_end = column_type;
+            Token *open = GetNextPatternToken(column_type);
+
+            if(TOKEN_CMPC(open, '('))
+                type_end = GetClosingParenthesis(open, nullptr);
+
+            GetTargetText(column_type, Nvl(type_end, column_type), type);
+        }
+        else
+        if(type.empty() && same_type && column != nullptr)
+        {
+            const char *meta_type = GetMetaType(table, column);
+
+            if(meta_type != nullptr)
+                type = meta_type;
+        }
+    }
+
+    if(!type.empty())
+    {
+        std::string index_name;
+        GetTargetText(index, index, index_name);
+
+        // Column is named after the index without schema
+        size_t dot = index_name.find_last_of('.');
+
+        if(dot != std::string::npos)
+            index_name.erase(0, dot + 1);
+
+        std::string column = index_name + "_expr";
+
+        if(++(*num) > 1)
+        {
+            char number[11];
+            column += Str::IntToString(*num, number);
+        }
+
+        std::string exp;
+        GetTargetText(first, last, exp);
+
+        columns += (*num > 1) ? ", " : " ";
+        columns += "ADD COLUMN " + column + " " + type + " AS (" + exp + ") STORED";
+
+        Token::Remove(first, last);
+        AppendNoFormat(last, column.c_str(), nullptr, column.length());
+    }
+    else
+    {
+        // Expression in functional key part is enclosed in parentheses
+        PREPEND_NOFMT(first, "(");
+        APPEND_NOFMT(last, ")");
+    }
+
+    if(_stats != nullptr)
+    {
+        bool supported = (!type.empty() || _option_mysql_version == 0 || _option_mysql_version >= MYSQL_FUNCTIONAL_KEY_PARTS);
+        const char *value = "Function-based index converted to functional key part";
+
+        if(!type.empty())
+            value = "Function-based index converted to generated column";
+        else
+        if(!supported)
+            value = "Function-based index not converted to generated column";
+
+        StatsSummaryItem ssi(supported ? STATS_CONV_OK : STATS_CONV_WARN);
+        _stats->Statements(value, &ssi, first, last);
+    }
+}
+
+// Get the data type of the column in the last CREATE TABLE for the table
+Token* SqlParser::GetCreateTableColumnType(Token *table, Token *column)
+{
+    Book *book = GetColumnBookmark(table, column);
+
+    return (book != nullptr) ? GetNextPatternToken(book->name2) : nullptr;
+}
+
 // CREATE FUNCTION
 bool SqlParser::ParseCreateFunction(Token *create, Token *or_, Token *replace, Token *function)
 {
@@ -625,8 +843,8 @@ bool SqlParser::ParseCreateFunction(Token *create, Token *or_, Token *replace, T
 
     ClearSplScope();
 
-    _spl_scope = SQL_SCOPE_FUNC;
-    _spl_start = create;
+    _spl->scope = SQL_SCOPE_FUNC;
+    _spl->start = create;
 
     // Function name
     Token* name = GetNextIdentToken(SQL_IDENT_OBJECT, SQL_SCOPE_FUNC);
@@ -634,12 +852,12 @@ bool SqlParser::ParseCreateFunction(Token *create, Token *or_, Token *replace, T
     if(name == NULL)
         return false;
 
-    _spl_name = name;
+    _spl->name = name;
 
     // Check if it is specified to convert function to procedure
-    _spl_func_to_proc = IsFuncToProc(name);
+    _spl->func_to_proc = IsFuncToProc(name);
 
-    if(_spl_func_to_proc)
+    if(_spl->func_to_proc)
         TOKEN_CHANGE(function, "PROCEDURE");
 
     // Support OR REPLACE clause (always set it)
@@ -769,7 +987,7 @@ bool SqlParser::ParseFunctionParameters(Token *function_name)
             break;
     }
 
-    _spl_param_close =  TOKEN_GETNEXT(')');
+    _spl->param_close =  TOKEN_GETNEXT(')');
 
     return true;
 }
@@ -778,7 +996,7 @@ bool SqlParser::ParseFunctionParameters(Token *function_name)
 void SqlParser::SplPostActions()
 {
     // Add declarations for SELECT statement moved out of IF condition
-    if(_spl_moved_if_select > 0)
+    if(_spl->moved_if_select > 0)
         OracleIfSelectDeclarations();
 
     // Remove Copy/Paste blocks
@@ -801,8 +1019,8 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
 
     ClearSplScope();
 
-    _spl_scope = SQL_SCOPE_TRIGGER;
-    _spl_start = create;
+    _spl->scope = SQL_SCOPE_TRIGGER;
+    _spl->start = create;
 
     // Support OR REPLACE clause; always set it
     if(or_ == nullptr)
@@ -814,7 +1032,7 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
     if(name == nullptr)
         return false;
 
-    _spl_name = name;
+    _spl->name = name;
 
     Token *on = nullptr;
     Token *table = nullptr;
@@ -904,7 +1122,7 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
             // AS is optional
             /*Token *as */ (void) GetNextWordToken("AS", L"AS", 2);
 
-            _spl_new_correlation_name = GetNextToken();
+            _spl->new_correlation_name = GetNextToken();
 
             continue;
         }
@@ -915,7 +1133,7 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
             // AS is optional
             /*Token *as */ (void) GetNextWordToken("AS", L"AS", 2);
 
-            _spl_old_correlation_name = GetNextToken();
+            _spl->old_correlation_name = GetNextToken();
 
             continue;
         }
@@ -962,9 +1180,15 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
         Leave(SQL_SCOPE_TRG_WHEN_CONDITION);
     }
 
+    // BEGIN follows the trigger header
+    Token *begin = GetNextPatternToken(GetLastToken());
     Token *end = nullptr;
 
-    ParseCreateTriggerBody(create, name, table, when, insert, update, delete_, &end);
+    ParseCreateTriggerBody(create, name, &end);
+
+    // Try to recognize a pattern in the row trigger for INSERT only
+    if(row != nullptr && update == nullptr && delete_ == nullptr)
+        ParseCreateTriggerOraclePattern(create, table, when, insert, when2, begin, end, GetLastToken());
 
     // Remove Copy/Paste blocks
     ClearCopy(COPY_SCOPE_PROC);
@@ -975,26 +1199,10 @@ bool SqlParser::ParseCreateTrigger(Token *create, Token *or_, Token *trigger)
     return true;
 }
 // Body of CREATE TRIGGER statement
-bool SqlParser::ParseCreateTriggerBody(Token *create, Token *name, Token *table, Token *when,
-                                            Token *insert, Token * /*update*/, Token * /*delete_*/, Token **end_out)
+bool SqlParser::ParseCreateTriggerBody(Token *create, Token *name, Token **end_out)
 {
     Token *begin = GetNextWordToken("BEGIN", L"BEGIN", 5);
 
-
-    // Try to recognize a pattern in the trigger body
-    bool pattern = ParseCreateTriggerOraclePattern(create, table, when, insert);
-
-    // If pattern matched, remove the trigger
-    if(pattern == true)
-    {
-        Token *end = GetNextWordToken("END", L"END", 3);
-        Token *semi = GetNextCharToken(';', L';');
-
-        Token *last = (semi == nullptr) ? end : semi;
-
-        Token::Remove(create, last);
-    }
-
     bool frontier = (begin != nullptr) ? true : false;
 
     ParseBlock(SQL_BLOCK_PROC, frontier, SQL_SCOPE_TRIGGER, nullptr);
@@ -1099,7 +1307,7 @@ bool SqlParser::ParseDropTableStatement(Token *drop, Token *table)
 
     // Check if a temporary table is removed
 
-    for(ListwItem *i = _spl_created_session_tables.GetFirst(); i != nullptr; i = i->next)
+    for(ListwItem *i = _spl->created_session_tables.GetFirst(); i != nullptr; i = i->next)
     {
         Token *temp = (Token*)i->value;
 
@@ -1109,7 +1317,7 @@ bool SqlParser::ParseDropTableStatement(Token *drop, Token *table)
             Token::Change(drop, "TRUNCATE", L"TRUNCATE", 8);
 
             // If inside a procedure block surround with EXECUTE IMMEDIATE
-            if(_spl_scope == SQL_SCOPE_PROC || _spl_scope == SQL_SCOPE_FUNC || _spl_scope == SQL_SCOPE_TRIGGER)
+            if(_spl->scope == SQL_SCOPE_PROC || _spl->scope == SQL_SCOPE_FUNC || _spl->scope == SQL_SCOPE_TRIGGER)
             {
                 Prepend(drop, "EXECUTE IMMEDIATE '", L"EXECUTE IMMEDIATE '", 19);
                 AppendNoFormat(table_name, "'", L"'", 1);
@@ -1290,7 +1498,7 @@ bool SqlParser::ParseCreateView(Token *create, Token *materialized, Token *view)
 }
 
 // INSERT statement
-bool SqlParser::ParseInsertStatement(Token *insert)
+bool SqlParser::ParseInsertStatement(Token *insert, Token **values_open)
 {
     if(insert == nullptr)
         return false;
@@ -1308,7 +1516,7 @@ bool SqlParser::ParseInsertStatement(Token *insert)
     if(table_name == nullptr)
         return false;
 
-    _spl_last_insert_table_name = table_name;
+    _spl->last_insert_table_name = table_name;
 
     // Optional column list
     Token *open1 = GetNextCharToken('(', L'(');
@@ -1382,18 +1590,28 @@ bool SqlParser::ParseInsertStatement(Token *insert)
             if(open2 == nullptr)
                 return false;
 
+            // Single row is reported to merge it with other INSERT statements
+            if(values_open != nullptr && rows == 0)
+                *values_open = open2;
+
             int num = 0;
 
             // Get list of values
             while(true)
             {
-                // Insert expression
-                Token *exp = GetNextToken();
+                // Literals do not need conversion, so they are taken as a single token up to the next expression
+                Token *exp = GetNextLiteralsToken();
 
+                // Insert expression
                 if(exp == nullptr)
-                    break;
+                {
+                    exp = GetNextToken();
 
-                ParseExpression(exp);
+                    if(exp == nullptr)
+                        break;
+
+                    ParseExpression(exp);
+                }
 
                 // Comma or )
                 close2 = GetNextToken();
@@ -1423,6 +1641,9 @@ bool SqlParser::ParseInsertStatement(Token *insert)
                 if(rows == 1)
                     Token::Remove(values);
 
+                if(values_open != nullptr)
+                    *values_open = nullptr;
+
                 Prepend(open2, " SELECT ", L" SELECT ", 8, values);
                 Append(close2, " FROM ", L" FROM ", 6, values);
                 AppendNoFormat(close2, "dual", L"dual", 4);
@@ -1446,6 +1667,9 @@ bool SqlParser::ParseInsertStatement(Token *insert)
 
         if(returning != nullptr)
         {
+            if(values_open != nullptr)
+                *values_open = nullptr;
+
             Token *col = GetNextIdentToken(SQL_IDENT_COLUMN_SINGLE);
             /*Token *into */(void) TOKEN_GETNEXTWP(col, "INTO");
             /*Token *var */(void) GetNextIdentToken();
@@ -1495,7 +1719,7 @@ bool SqlParser::ParseUpdateStatement(Token *update)
 
     STATS_DECL
     STMS_STATS(update);
-    _spl_last_fetch_cursor_name = NULL;
+    _spl->last_fetch_cursor_name = NULL;
 
     // Table name
     Token *name = GetNextIdentToken(SQL_IDENT_OBJECT);
@@ -1714,7 +1938,7 @@ bool SqlParser::ParseSplEndName(Token *name, Token * /*end*/)
     }
     else
     // Compare with label name, label is without : here
-    if(_spl_outer_label != nullptr && Token::Compare(_spl_outer_label, next, _spl_outer_label->len-1) == true)
+    if(_spl->outer_label != nullptr && Token::Compare(_spl->outer_label, next, _spl->outer_label->len-1) == true)
     {
         // Remove for other databases
         Token::Remove(next);
@@ -1791,11 +2015,11 @@ bool SqlParser::ParseFunctionBody(Token *create, Token *function, Token *name, T
 
     bool frontier = (begin != NULL) ? true : false;
 
-    _spl_begin_blocks.Add(GetLastToken(begin));
+    _spl->begin_blocks.Add(GetLastToken(begin));
 
     ParseBlock(SQL_BLOCK_PROC, frontier, SQL_SCOPE_FUNC, NULL);
 
-    _spl_begin_blocks.DeleteLast();
+    _spl->begin_blocks.DeleteLast();
 
     Token *end = GetNextWordToken("END", L"END", 3);
 
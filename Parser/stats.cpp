@@ -1,5 +1,4 @@
 #include <stdio.h>
-#include <algorithm>
 #include "stats.h"
 
 // Increment stats summary item
@@ -44,9 +43,6 @@ void StatsSummaryItem::Inc(StatsSummaryItem *item)
 	complexity_medium += item->complexity_medium;
 	complexity_high += item->complexity_high;
 	complexity_very_high += item->complexity_very_high;
-
-	if(!item->snippets.empty())
-		snippets.push_back(item->snippets.front());
 }
 
 // Update summary status for single occurrence from detail
@@ -140,9 +136,151 @@ int StatsSummaryItem::GetMostCritical()
 }
 
 // Constructor/destructor
-Stats::Stats() {}
+Stats::Stats() 
+{
+	_source_input = nullptr;
+	_source_size = 0;
+
+	_snippets_limit = STATS_SNIPPETS_LIMIT;
+	_snippets_random = 1;
+
+	_trace_file = nullptr;
+	_trace = nullptr;
+}
+
+Stats::~Stats() 
+{
+	CloseSnippetFiles();
+	CloseTrace();
+}
 
-Stats::~Stats() {}
+// Set the current source file
+void Stats::SetSourceFile(const char *f)
+{
+    if(f == nullptr)
+		return;
+
+	StatsSourceFile file;
+	file.name = f;
+
+	_source_files.push_back(file);
+}
+
+// Set the path to read the current source file again
+void Stats::SetSourcePath(const char *path)
+{
+    if(path == nullptr || _source_files.empty())
+		return;
+
+	_source_files.back().path = path;
+}
+
+// Get the snippet reference for the source code from start to end tokens
+StatsSnippetItem Stats::GetSnippetItem(Token *start, Token *end)
+{
+	StatsSnippetItem snippet;
+
+	snippet.file = (int)_source_files.size() - 1;
+	snippet.line = start->line;
+	snippet.length = start->len + start->remain_size - end->remain_size;
+
+	// Only the position is kept when the text can be read from the source file again
+	if(snippet.file != -1 && !_source_files[snippet.file].path.empty() && _source_input != nullptr && 
+		start->str >= _source_input && start->str + snippet.length <= _source_input + _source_size)
+		snippet.offset = start->str - _source_input;
+	else
+		snippet.text.assign(start->str, snippet.length);
+
+	return snippet;
+}
+
+// Add the snippet to the sample of the item snippets (reservoir sampling, each occurrence has the same chance)
+void Stats::AddSnippet(std::vector<StatsSnippetItem> &snippets, int *seen, StatsSnippetItem &snippet)
+{
+	(*seen)++;
+
+	if((int)snippets.size() < _snippets_limit)
+	{
+		snippets.push_back(snippet);
+		return;
+	}
+
+	// xorshift32
+	_snippets_random ^= _snippets_random << 13;
+	_snippets_random ^= _snippets_random >> 17;
+	_snippets_random ^= _snippets_random << 5;
+
+	int pos = (int)(_snippets_random % (unsigned int)(*seen));
+
+	if(pos < _snippets_limit)
+		snippets[pos] = snippet;
+}
+
+// Get the snippet text, it is read from the source file
+void Stats::GetSnippet(StatsSnippetItem &snippet, std::string &text)
+{
+	GetSnippet(snippet, text, _snippets_files);
+}
+
+// Get the snippet text using the specified set of open files, so sections can be read by different threads
+void Stats::GetSnippet(StatsSnippetItem &snippet, std::string &text, std::map<int, FILE*> &files)
+{
+	text.clear();
+
+	if(!snippet.text.empty() || snippet.file == -1 || snippet.length == 0)
+	{
+		text = snippet.text;
+		return;
+	}
+
+	FILE *file = nullptr;
+	std::map<int, FILE*>::iterator i = files.find(snippet.file);
+
+	if(i != files.end())
+		file = i->second;
+	else
+	{
+		if(files.size() >= STATS_SNIPPETS_OPEN_FILES)
+			CloseSnippetFiles(files);
+
+		file = fopen(_source_files[snippet.file].path.c_str(), "rb");
+
+		if(file == nullptr)
+			return;
+
+		files[snippet.file] = file;
+	}
+
+	text.resize(snippet.length);
+
+	if(fseek(file, (long)snippet.offset, SEEK_SET) != 0)
+		text.clear();
+	else
+		text.resize(fread(&text[0], 1, snippet.length, file));
+}
+
+// Get the source file name of the snippet
+const char* Stats::GetSnippetFileName(StatsSnippetItem &snippet)
+{
+	if(snippet.file == -1)
+		return "";
+
+	return _source_files[snippet.file].name.c_str();
+}
+
+// Close source files opened to extract snippets
+void Stats::CloseSnippetFiles()
+{
+	CloseSnippetFiles(_snippets_files);
+}
+
+void Stats::CloseSnippetFiles(std::map<int, FILE*> &files)
+{
+	for(std::map<int, FILE*>::iterator i = files.begin(); i != files.end(); i++)
+		fclose(i->second);
+
+	files.clear();
+}
 
 // Log function call with all nested expressions
 void Stats::LogFuncCall(Token *name, Token *end, std::string &cur_file)
@@ -150,101 +288,131 @@ void Stats::LogFuncCall(Token *name, Token *end, std::string &cur_file)
     if(name == nullptr || end == nullptr)
 		return;
 
-	static bool first_call = true;
+	// The file is truncated when opened for the first time, and then kept open
+	if(_trace == nullptr)
+	{
+		_trace_file = fopen(SQLEXEC_STAT_FILE, "w");
 
-	const char *openMode = first_call ? "w" : "a";
+		if(_trace_file == nullptr)
+			return;
 
-	FILE *file = fopen(SQLEXEC_STAT_FILE, openMode);
+		_trace = new ReportWriter(_trace_file);
+	}
 
-    if(file != nullptr)
-	{
-		// Line and source name
-		fprintf(file, "%s,%d,%.*s,", cur_file.c_str(), name->line, (int)name->len, name->str);
+	ReportWriter &out = *_trace;
 
-		std::string src, src_meta;
-		std::string tgt, tgt_meta;
+	// Line and source name
+	out += cur_file;
+	out += ',';
+	out.Int(name->line);
+	out += ',';
+	out.Write(name->str, name->len);
+	out += ',';
 
-		Token *cur = name;
+	_trace_src.clear();
+	_trace_tgt.clear();
+	_trace_src_meta.clear();
+	_trace_tgt_meta.clear();
 
-		// Build source and target strings
-		while(true)
-		{
-			const char *meta = GetMetaIdent(cur);
+	Token *cur = name;
+
+	// Build source and target strings in a single pass
+	while(true)
+	{
+		const char *meta = GetMetaIdent(cur);
+		size_t meta_len = (meta != nullptr) ? strlen(meta) : 0;
 
-			// Source expression
-			if(!(cur->flags & TOKEN_INSERTED))
+		// Source expression
+		if(!(cur->flags & TOKEN_INSERTED))
+		{
+            if(cur->str != nullptr)
 			{
-                if(cur->str != nullptr)
-				{
-					src.append(cur->str, cur->len);
-
-                    if(meta != nullptr)
-						src_meta.append(meta);
-					else
-						src_meta.append(cur->str, cur->len);
-				}
-				else
-				if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
-				{
-					src += ' ';
-					src_meta += ' ';
-				}
+				_trace_src.append(cur->str, cur->len);
+
+                if(meta != nullptr)
+					_trace_src_meta.append(meta, meta_len);
 				else
-				{
-					src += cur->chr;
-					src_meta += cur->chr;
-				}
+					_trace_src_meta.append(cur->str, cur->len);
 			}
-
-			// Target expression
-			if(!(cur->flags & TOKEN_REMOVED))
+			else
+			if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
 			{
-                if(cur->t_str != nullptr)
-				{
-					tgt.append(cur->t_str, cur->t_len);
-
-                    if(meta != nullptr)
-						tgt_meta.append(meta);
-					else
-						tgt_meta.append(cur->t_str, cur->t_len);
-				}
-				else
-                if(cur->str != nullptr)
-				{
-					tgt.append(cur->str, cur->len);
-
-                    if(meta != nullptr)
-						tgt_meta.append(meta);
-					else
-						tgt_meta.append(cur->str, cur->len);
-				}
-				else
-				if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
-				{
-					tgt += ' ';
-					tgt_meta += ' ';
-				}
-				else
-				{
-					tgt += cur->chr;
-					tgt_meta += cur->chr;
-				}
+				_trace_src += ' ';
+				_trace_src_meta += ' ';
 			}
+			else
+			{
+				_trace_src += cur->chr;
+				_trace_src_meta += cur->chr;
+			}
+		}
 
-			if(cur == end)
-				break;
+		// Target expression
+		if(!(cur->flags & TOKEN_REMOVED))
+		{
+			const char *str = (cur->t_str != nullptr) ? cur->t_str : cur->str;
+			size_t len = (cur->t_str != nullptr) ? cur->t_len : cur->len;
 
-			cur = cur->next;
+            if(str != nullptr)
+			{
+				_trace_tgt.append(str, len);
+
+                if(meta != nullptr)
+					_trace_tgt_meta.append(meta, meta_len);
+				else
+					_trace_tgt_meta.append(str, len);
+			}
+			else
+			if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
+			{
+				_trace_tgt += ' ';
+				_trace_tgt_meta += ' ';
+			}
+			else
+			{
+				_trace_tgt += cur->chr;
+				_trace_tgt_meta += cur->chr;
+			}
 		}
-		
-		fprintf(file, "<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>", src.c_str(), tgt.c_str(), 
-			src_meta.c_str(), tgt_meta.c_str());
 
-		fprintf(file, "\n");
-		fclose(file);
+		if(cur == end)
+			break;
+
+		cur = cur->next;
 	}
 
-	first_call = false;
+	out += "<sqlines>";
+	out += _trace_src;
+	out += "</sqlines>,<sqlines>";
+	out += _trace_tgt;
+	out += "</sqlines>,<sqlines>";
+	out += _trace_src_meta;
+	out += "</sqlines>,<sqlines>";
+	out += _trace_tgt_meta;
+	out += "</sqlines>\n";
+}
+
+// Write the buffered trace records to the file
+void Stats::FlushTrace()
+{
+	if(_trace == nullptr)
+		return;
+
+	_trace->Flush();
+	fflush(_trace_file);
+}
+
+void Stats::CloseTrace()
+{
+	if(_trace == nullptr)
+		return;
+
+	_trace->Flush();
+	delete _trace;
+	_trace = nullptr;
+
+	fclose(_trace_file);
+	_trace_file = nullptr;
 }
 
 // Get meta type for the specified identificator
@@ -273,32 +441,29 @@ const char* Stats::GetMetaIdent(Token *name)
 }
 
 // Collect statistics for the specified item
-void Stats::Add(std::map<std::string, StatsItem> &map, Token *token, StatsItem *si, bool case_insense)
+void Stats::Add(StatsMap<StatsItem> &map, Token *token, StatsItem *si, bool case_insense)
 {
     if(token == nullptr || token->str == nullptr || token->len == 0)
         return;
 
-    std::string source(token->str, token->len);
-    Add(map, source, token->t_str, si, case_insense);
+    Add(map, token->str, token->len, token->t_str, si, case_insense);
 }
 
-void Stats::Add(std::map<std::string, StatsItem> &map, Token* start, StatsItem *si, Token* end, bool case_insense)
+void Stats::Add(StatsMap<StatsItem> &map, Token* start, StatsItem *si, Token* end, bool case_insense)
 {
     if(start == nullptr || start->str == nullptr || start->len == 0 || end == nullptr)
         return;
 
-    std::string source(start->str, start->len + start->remain_size - end->remain_size);
-    Add(map, source, start->t_str, si, case_insense);
+    Add(map, start->str, start->len + start->remain_size - end->remain_size, start->t_str, si, case_insense);
 }
 
-void Stats::Add(std::map<std::string, StatsItem> &map, std::string value, const char* target, StatsItem *si,
+void Stats::Add(StatsMap<StatsItem> &map, const char *value, size_t len, const char* target, StatsItem *si,
                     bool case_insense)
 {
-    if(case_insense)
-        std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+    int key = _keys.Get(value, len, case_insense);
 
     // Check if this value already used
-	std::map<std::string, StatsItem>::iterator i = map.find(value);
+	StatsMap<StatsItem>::iterator i = map.find(key);
 
     // Increment the counter or insert new key-value pair
 	if(i != map.end())
@@ -310,34 +475,36 @@ void Stats::Add(std::map<std::string, StatsItem> &map, std::string value, const
         if(target != nullptr)
 			si->t_value.assign(target);
 
-	    map[value] = *si;
+	    map[key] = *si;
 	}
 }
 
 // Collect statistics for summary items
-void Stats::Add(std::map<std::string, StatsSummaryItem> &map, std::string value, int conv_status)
+void Stats::Add(StatsMap<StatsSummaryItem> &map, const char *value, size_t len, int conv_status)
 {
+	int key = _keys.Get(value, len, false);
+
 	// Check if this value already used
-	std::map<std::string, StatsSummaryItem>::iterator i = map.find(value);
+	StatsMap<StatsSummaryItem>::iterator i = map.find(key);
 
 	// Increment the counter or insert new key-value pair
 	if(i != map.end())
     	(*i).second.Inc(conv_status);
     else 
-	    map[value] = StatsSummaryItem(conv_status);  
+	    map[key] = StatsSummaryItem(conv_status);  
 }
 
 // Collect statistics for summary items
-void Stats::Add(std::map<std::string, StatsSummaryItem> &map, Token *token, int conv_status)
+void Stats::Add(StatsMap<StatsSummaryItem> &map, Token *token, int conv_status)
 {
     if(token == nullptr || token->str == nullptr || token->len == 0)
         return;
 
-    Add(map, std::string(token->str, token->len), conv_status);
+    Add(map, token->str, token->len, conv_status);
 }
 
 // Collect statistics for summary items
-void Stats::Add(std::map<std::string, StatsSummaryItem> &map, std::string value, StatsSummaryItem *item, 
+void Stats::Add(StatsMap<StatsSummaryItem> &map, const char *value, size_t len, StatsSummaryItem *item, 
 	            Token *start, Token *end)
 {
     if(item == nullptr)
@@ -349,35 +516,46 @@ void Stats::Add(std::map<std::string, StatsSummaryItem> &map, std::string value,
 		item->conv_undef++;
 	}
 
-	item->snippets.push_back(StatsSnippetItem(_source_current_file, start, end));
+	StatsSnippetItem snippet = GetSnippetItem(start, end);
+
+	AddSnippet(item->snippets, &item->snippets_seen, snippet);
+
+	int key = _keys.Get(value, len, false);
 
 	// Check if this value already used
-	std::map<std::string, StatsSummaryItem>::iterator i = map.find(value);
+	StatsMap<StatsSummaryItem>::iterator i = map.find(key);
 
 	// Increment the counter or insert new key-value pair
 	if(i != map.end())
+	{
     	(*i).second.Inc(item);
+		AddSnippet((*i).second.snippets, &(*i).second.snippets_seen, snippet);
+	}
     else 
-	    map[value] = *item;  
+	    map[key] = *item;  
 }
 
 // Collect statistics for summary items
-void Stats::Add(std::map<std::string, StatsSummaryItem> &map, Token *token, StatsSummaryItem *item, Token *end)
+void Stats::Add(StatsMap<StatsSummaryItem> &map, Token *token, StatsSummaryItem *item, Token *end)
 {
     if(token == nullptr || token->str == nullptr || token->len == 0)
         return;
 
-    Add(map, std::string(token->str, token->len), item, token, end);
+    Add(map, token->str, token->len, item, token, end);
 }
 
 // Collect statistics for detail items
-void Stats::Add(std::map<std::string, StatsDetailItem> &map, std::string value, StatsDetailItem *item, Token *start, Token *end)
+void Stats::Add(StatsMap<StatsDetailItem> &map, const char *value, size_t len, StatsDetailItem *item, Token *start, Token *end)
 {
     if(item == nullptr)
 		return;
 
+	int key = _keys.Get(value, len, false);
+
 	// Check if this value already used
-	std::map<std::string, StatsDetailItem>::iterator i = map.find(value);
+	StatsMap<StatsDetailItem>::iterator i = map.find(key);
+
+	StatsSnippetItem snippet = GetSnippetItem(start, end);
 
 	// Each detailed item has the same properties for all occurrences
 	if(i == map.end())
@@ -388,42 +566,42 @@ void Stats::Add(std::map<std::string, StatsDetailItem> &map, std::string value,
 		if(i.count == 0)
 			i.count = 1;
 
-		i.snippets.push_back(StatsSnippetItem(_source_current_file, start, end));
-		map[value] = i;  
+		AddSnippet(i.snippets, &i.snippets_seen, snippet);
+		map[key] = i;  
 	}
 	else
 	{
 		(*i).second.count++; 
-		(*i).second.snippets.push_back(StatsSnippetItem(_source_current_file, start, end));
+		AddSnippet((*i).second.snippets, &(*i).second.snippets_seen, snippet);
 	}
 }
 
 // Collect statistics for detailed items
-void Stats::Add(std::map<std::string, StatsDetailItem> &map, Token *token, StatsDetailItem *item, Token *end)
+void Stats::Add(StatsMap<StatsDetailItem> &map, Token *token, StatsDetailItem *item, Token *end)
 {
     if(token == nullptr || token->str == nullptr || token->len == 0)
         return;
 
-    Add(map, std::string(token->str, token->len), item, token, end);
+    Add(map, token->str, token->len, item, token, end);
 }
 
 // Collect statistics for detailed items
-void Stats::Add(std::map<std::string, StatsDetailItem> &map, Token *start_val, Token *end_val, StatsDetailItem *item, 
+void Stats::Add(StatsMap<StatsDetailItem> &map, Token *start_val, Token *end_val, StatsDetailItem *item, 
 	Token *start, Token *end)
 {
     if(start_val == nullptr || start_val->str == nullptr || end_val == nullptr || end_val->str == nullptr)
 		return;
 
-	std::string value(start_val->str, start_val->len + start_val->remain_size - end_val->remain_size);
-
-	Add(map, value, item, start, end);
+	Add(map, start_val->str, start_val->len + start_val->remain_size - end_val->remain_size, item, start, end);
 }	
 
 // Collect statistics for detailed items
-void Stats::Add(std::map<std::string, StatsDetailItem> &map, const char* value, const char* desc, const char* note, const char* link, int conv_status)
+void Stats::Add(StatsMap<StatsDetailItem> &map, const char* value, size_t len, const char* desc, const char* note, const char* link, int conv_status)
 {
+	int key = _keys.Get(value, len, false);
+
 	// Check if this value already used
-	std::map<std::string, StatsDetailItem>::iterator i = map.find(value);
+	StatsMap<StatsDetailItem>::iterator i = map.find(key);
 
 	// Each detailed item has the same properties for all occurrences
 	if(i == map.end())
@@ -441,54 +619,45 @@ void Stats::Add(std::map<std::string, StatsDetailItem> &map, const char* value,
         if(link != nullptr)
 			item.link = link;
 
-		map[value] = item;  
+		map[key] = item;  
 	}
 	else
 		(*i).second.count++;
 }
 
 // Collect statistics for detailed items
-void Stats::Add(std::map<std::string, StatsDetailItem> &map, Token *start, Token *end, const char* desc, const char* note, const char* link, int conv_status)
+void Stats::Add(StatsMap<StatsDetailItem> &map, Token *start, Token *end, const char* desc, const char* note, const char* link, int conv_status)
 {
-	Add(map, std::string(start->str, start->len + start->remain_size - end->remain_size).c_str(), desc, note, link, conv_status);
+	Add(map, start->str, start->len + start->remain_size - end->remain_size, desc, note, link, conv_status);
 }
 
 // Collect statistics for the specified item
-void Stats::Add(std::map<std::string, int> &map, Token *token, bool case_insense)
+void Stats::Add(StatsMap<int> &map, Token *token, bool case_insense)
 {
     if(token == nullptr || token->str == nullptr || token->len == 0)
         return;
 
-    Add(map, std::string(token->str, token->len), case_insense);
+    Add(map, token->str, token->len, case_insense);
 }
 
-void Stats::Add(std::map<std::string, int> &map, TokenStr *token, bool case_insense)
+void Stats::Add(StatsMap<int> &map, TokenStr *token, bool case_insense)
 {
     if(token == nullptr)
         return;
 
-    Add(map, token->str, case_insense);
+    Add(map, token->str.c_str(), token->str.length(), case_insense);
 }
 
-void Stats::Add(std::map<std::string, int> &map, Token *start, Token *end, bool case_insense )
+void Stats::Add(StatsMap<int> &map, Token *start, Token *end, bool case_insense )
 {
     if(start == nullptr || start->str == nullptr || start->len == 0)
         return;
 
-    Add(map, std::string(start->str, start->len + start->remain_size - end->remain_size), case_insense);
+    Add(map, start->str, start->len + start->remain_size - end->remain_size, case_insense);
 }
 
-void Stats::Add(std::map<std::string, int> &map, std::string value, bool case_insense)
+void Stats::Add(StatsMap<int> &map, const char *value, size_t len, bool case_insense)
 {
-    if(case_insense)
-        std::transform(value.begin(), value.end(), value.begin(), ::toupper);
-
-    // Check if this value already used
-	std::map<std::string, int>::iterator i = map.find(value);
-
-    // Increment the counter or insert new key-value pair
-	if(i != map.end())
-    	(*i).second++;
-    else 
-	    map[value] = 1;    
+    // New values are inserted with zero counter
+    map[_keys.Get(value, len, case_insense)]++;
 }
@@ -3,10 +3,14 @@
 #ifndef sqlexec_stats_h
 #define sqlexec_stats_h
 
+#include <stdio.h>
+#include <string.h>
 #include <string>
+#include <vector>
 #include <map>
-#include <list>
 #include "token.h"
+#include "statsmap.h"
+#include "reportwriter.h"
 
 // Conversion status
 #define STATS_CONV_UNDEFINED		1
@@ -85,6 +89,11 @@
 
 #define SQLEXEC_STAT_FILE                             "migration_tool_func_calls.txt"
 
+// Default maximum number of code snippets kept per item
+#define STATS_SNIPPETS_LIMIT                          100
+// Maximum number of source files kept open while snippets are extracted
+#define STATS_SNIPPETS_OPEN_FILES                     64
+
 struct StatsDetailItem;
 struct StatsSnippetItem;
 
@@ -114,15 +123,16 @@ struct StatsSummaryItem
 	int complexity_high;
 	int complexity_very_high;
 
-	// Code snippets
-	std::list<StatsSnippetItem> snippets;
+	// Code snippets (sample of at most the snippets limit), and the number of occurrences sampled
+	std::vector<StatsSnippetItem> snippets;
+	int snippets_seen;
 
 	StatsSummaryItem() { Init(); }
 	StatsSummaryItem(int conv_status) { Init(); Inc(conv_status); }
 
 	void Init() { occurrences = 0; conv_undef = 0; conv_no_need = 0; conv_ok = 0; conv_warn = 0; conv_error = 0; 
 	  complexity_very_low = 0; complexity_low = 0; complexity_medium = 0; complexity_high = 0;
-	  complexity_very_high = 0; }
+	  complexity_very_high = 0; snippets_seen = 0; }
 
 	// Increment stats summary item
 	void Inc(int conv_status);
@@ -153,25 +163,35 @@ struct StatsDetailItem
 	// Complexity level
 	int complexity;
 
-	// Code snippets
-	std::list<StatsSnippetItem> snippets;
+	// Code snippets (sample of at most the snippets limit), and the number of occurrences sampled
+	std::vector<StatsSnippetItem> snippets;
+	int snippets_seen;
 
-	StatsDetailItem() { count = 0; conv_status = 0; complexity = 0; }
+	StatsDetailItem() { count = 0; conv_status = 0; complexity = 0; snippets_seen = 0; }
 };
 
-// Code snippet
+// Code snippet, the text is extracted from the source file when the report is written
 struct StatsSnippetItem
 {
-	// Source file name
-	std::string filename;
+	// Source file id
+	int file;
 	// Line in source code
 	int line;
-	// Source code snippet
-	std::string snippet;
+	// Position of the snippet in the source file
+	size_t offset;
+	size_t length;
+	// Snippet text, set only when the source file cannot be read again
+	std::string text;
+
+	StatsSnippetItem() { file = -1; line = 0; offset = 0; length = 0; }
+};
 
-	StatsSnippetItem(std::string &f, Token *start, Token *end) { 
-		filename = f; line = start->line; snippet.assign(start->str, start->len + start->remain_size - end->remain_size);
-	}
+// Source file referenced by snippets
+struct StatsSourceFile
+{
+	// Relative name shown in the report, and the path to read the file
+	std::string name;
+	std::string path;
 };
 
 struct StatsItem
@@ -205,68 +225,92 @@ struct StatsItem
 class Stats
 {
 public:
-    std::map<std::string, int> _data_types;
-    std::map<std::string, int> _udt_data_types;
-    std::map<std::string, StatsItem> _data_types_dtl;
-    std::map<std::string, int> _udt_data_types_dtl;
-    std::map<std::string, StatsSummaryItem> _builtin_func;
-    std::map<std::string, int> _builtin_func_dtl;
-    std::map<std::string, int> _udf_func;
-
-	std::map<std::string, StatsSummaryItem> _sequences;
-	std::map<std::string, StatsDetailItem> _sequences_dtl;
-    std::map<std::string, StatsDetailItem> _sequences_opt_dtl;
-	std::map<std::string, StatsDetailItem> _sequences_ref;
-    std::map<std::string, StatsDetailItem> _sequences_ref_dtl;
-
-	std::map<std::string, int> _system_proc;
-    std::map<std::string, int> _system_proc_dtl;
-    std::map<std::string, StatsSummaryItem> _statements;
-    std::map<std::string, int> _crtab_statements;
-    std::map<std::string, int> _alttab_statements;
-	std::map<std::string, StatsDetailItem> _select_statements_dtl;
-	std::map<std::string, StatsDetailItem> _crproc_statements_dtl;
-
-    std::map<std::string, StatsSummaryItem> _pl_statements;
-	std::map<std::string, StatsDetailItem> _pl_statements_exceptions;
-
-	std::map<std::string, StatsSummaryItem> _packages;
-	std::map<std::string, StatsDetailItem> _pkg_statements_items;
+    StatsMap<int> _data_types;
+    StatsMap<int> _udt_data_types;
+    StatsMap<StatsItem> _data_types_dtl;
+    StatsMap<int> _udt_data_types_dtl;
+    StatsMap<StatsSummaryItem> _builtin_func;
+    StatsMap<int> _builtin_func_dtl;
+    StatsMap<int> _udf_func;
+
+	StatsMap<StatsSummaryItem> _sequences;
+	StatsMap<StatsDetailItem> _sequences_dtl;
+    StatsMap<StatsDetailItem> _sequences_opt_dtl;
+	StatsMap<StatsDetailItem> _sequences_ref;
+    StatsMap<StatsDetailItem> _sequences_ref_dtl;
+
+	StatsMap<int> _system_proc;
+    StatsMap<int> _system_proc_dtl;
+    StatsMap<StatsSummaryItem> _statements;
+    StatsMap<int> _crtab_statements;
+    StatsMap<int> _alttab_statements;
+	StatsMap<StatsDetailItem> _select_statements_dtl;
+	StatsMap<StatsDetailItem> _crproc_statements_dtl;
+
+    StatsMap<StatsSummaryItem> _pl_statements;
+	StatsMap<StatsDetailItem> _pl_statements_exceptions;
+
+	StatsMap<StatsSummaryItem> _packages;
+	StatsMap<StatsDetailItem> _pkg_statements_items;
     
-	std::map<std::string, int> _quoted_idents;
-	std::map<std::string, int> _non_7bit_ascii_idents;
-    std::map<std::string, int> _strings;
-    std::map<std::string, int> _numbers;
-    std::map<std::string, int> _words;
-    std::map<std::string, int> _delimiters;
+	StatsMap<int> _quoted_idents;
+	StatsMap<int> _non_7bit_ascii_idents;
+    StatsMap<int> _strings;
+    StatsMap<int> _numbers;
+    StatsMap<int> _words;
+    StatsMap<int> _delimiters;
+
+	// Interned keys of all collections
+	StatsKeys _keys;
+
+	// Source files, the last one is the current
+	std::vector<StatsSourceFile> _source_files;
+
+	// Content of the current source file
+	const char *_source_input;
+	size_t _source_size;
 
-	// Relative path to the current file
-	std::string _source_current_file;
+	// Maximum number of snippets kept per item, and the state of sampling random generator
+	int _snippets_limit;
+	unsigned int _snippets_random;
+
+	// Source files opened to extract snippets by file id
+	std::map<int, FILE*> _snippets_files;
+
+	// Function call trace file, kept open and written by blocks
+	FILE *_trace_file;
+	ReportWriter *_trace;
+
+	// Source and target expressions of the traced call, reused between calls
+	std::string _trace_src;
+	std::string _trace_tgt;
+	std::string _trace_src_meta;
+	std::string _trace_tgt_meta;
 
     // Constructor/destructor
     Stats();
     ~Stats();
 
     // Collect statistics 
-    void DataTypes(const char* value)  { Add(_data_types, value); }
+    void DataTypes(const char* value)  { Add(_data_types, value, strlen(value)); }
     void DataTypes(Token *token)       { Add(_data_types, token); }
     void DataTypesDetail(Token *start, StatsItem *si)  { Add(_data_types_dtl, start, si); }
     void DataTypesDetail(Token *start, StatsItem *si, Token *end)  { Add(_data_types_dtl, start, si, end); }
 
-    void UdtDataTypes(const char* value)  { Add(_udt_data_types, value); }
+    void UdtDataTypes(const char* value)  { Add(_udt_data_types, value, strlen(value)); }
     void UdtDataTypesDetail(Token *start, Token *end)  { Add(_udt_data_types_dtl, start, end); }
     
-    void Statements(const char* value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_statements, value, ssi, start, end); }
+    void Statements(const char* value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_statements, value, strlen(value), ssi, start, end); }
     void Statements(Token *token, StatsSummaryItem *ssi, Token *end) { Add(_statements, token, ssi, end); }
-    void CreateTabStatements(const char *value)  { Add(_crtab_statements, value, false); }
-    void AlterTabStatements(const char *value)   { Add(_alttab_statements, value, false); }
+    void CreateTabStatements(const char *value)  { Add(_crtab_statements, value, strlen(value), false); }
+    void AlterTabStatements(const char *value)   { Add(_alttab_statements, value, strlen(value), false); }
 
-	void SelectStatementsDetail(const char *value, StatsDetailItem *sdi, Token *start, Token *end) { Add(_select_statements_dtl, value, sdi, start, end); }
+	void SelectStatementsDetail(const char *value, StatsDetailItem *sdi, Token *start, Token *end) { Add(_select_statements_dtl, value, strlen(value), sdi, start, end); }
 
 	void CreateProcDetail(Token *token, StatsDetailItem *sdi, Token *end) { Add(_crproc_statements_dtl, token, sdi, end); }
-	void CreateProcDetail(const char *value, StatsDetailItem *sdi, Token *start, Token *end) { Add(_crproc_statements_dtl, value, sdi, start, end); }
+	void CreateProcDetail(const char *value, StatsDetailItem *sdi, Token *start, Token *end) { Add(_crproc_statements_dtl, value, strlen(value), sdi, start, end); }
     
-	void ProceduralStatements(const char *value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_pl_statements, value, ssi, start, end); }
+	void ProceduralStatements(const char *value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_pl_statements, value, strlen(value), ssi, start, end); }
     void ProceduralStatements(Token *token, StatsSummaryItem *ssi, Token *end) { Add(_pl_statements, token, ssi, end); }
 
 	void ExceptionsDetail(Token *token, StatsDetailItem *sdi, Token *end) { Add(_pl_statements_exceptions, token, sdi, end); }
@@ -275,20 +319,20 @@ public:
     void FunctionsDetail(TokenStr *token) { Add(_builtin_func_dtl, token); }
     void UdfFunctions(Token *token)       { Add(_udf_func, token); }
 
-	void Sequences(const char* value, StatsSummaryItem *ssi, Token *start, Token *end)  { Add(_sequences, value, ssi, start, end); }
+	void Sequences(const char* value, StatsSummaryItem *ssi, Token *start, Token *end)  { Add(_sequences, value, strlen(value), ssi, start, end); }
 	void SequencesDetail(const char* value, StatsDetailItem *sdi, Token *start, Token *end)  
-		{ Add(_sequences_dtl, value, sdi, start, end); }
+		{ Add(_sequences_dtl, value, strlen(value), sdi, start, end); }
 	void SequencesOptionsDetail(Token *start, Token *end, StatsDetailItem *sdi)  
 		{ Add(_sequences_opt_dtl, start, end, sdi, start, end); }
 	void SequencesReference(const char* value, const char* desc, const char* note, const char* link, int conv_status)  
-		{ Add(_sequences_ref, value, desc, note, link, conv_status); }
+		{ Add(_sequences_ref, value, strlen(value), desc, note, link, conv_status); }
 	void SequencesReferenceDetail(Token *start, Token *end, const char* desc, const char* note, const char* link, int conv_status)  
 		{ Add(_sequences_ref_dtl, start, end, desc, note, link, conv_status); }
 
     void Procedures(Token *token)           { Add(_system_proc, token); }
     void ProceduresDetail(TokenStr *token)  { Add(_system_proc_dtl, token); }
 
-	void Packages(const char *value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_packages, value, ssi, start, end); }
+	void Packages(const char *value, StatsSummaryItem *ssi, Token *start, Token *end) { Add(_packages, value, strlen(value), ssi, start, end); }
 	void PackagesDetail(Token *token, StatsDetailItem *sdi, Token *end) { Add(_pkg_statements_items, token, sdi, end); }
 
     void Quoted(Token *token)             { Add(_quoted_idents, token, false); }
@@ -300,35 +344,56 @@ public:
 
 	// Log function call with all nested expressions
 	void LogFuncCall(Token *name, Token *end, std::string &cur_file);
+	// Write the buffered trace records to the file
+	void FlushTrace();
+	void CloseTrace();
 	// Get meta type for the specified identificator
 	const char* GetMetaIdent(Token *name);
 
-    // Collect statistics for the specified item
+    // Collect statistics for the specified item, keys are interned so adding an existing item does not allocate
 
-    void Add(std::map<std::string, StatsItem> &map, Token *token, StatsItem *si, bool case_insense = true);
-    void Add(std::map<std::string, StatsItem> &map, Token *start, StatsItem *si, Token *end, bool case_insense = true);
-    void Add(std::map<std::string, StatsItem> &map, std::string value, const char* target, StatsItem *si, 
+    void Add(StatsMap<StatsItem> &map, Token *token, StatsItem *si, bool case_insense = true);
+    void Add(StatsMap<StatsItem> &map, Token *start, StatsItem *si, Token *end, bool case_insense = true);
+    void Add(StatsMap<StatsItem> &map, const char *value, size_t len, const char* target, StatsItem *si, 
 		bool case_insense = true);
     
-	void Add(std::map<std::string, StatsSummaryItem> &map, std::string value, int conv_status);
-	void Add(std::map<std::string, StatsSummaryItem> &map, std::string value, StatsSummaryItem *item, Token *start, Token *end);
-	void Add(std::map<std::string, StatsSummaryItem> &map, Token *token, int conv_status);
-	void Add(std::map<std::string, StatsSummaryItem> &map, Token *token, StatsSummaryItem *item, Token *end);
+	void Add(StatsMap<StatsSummaryItem> &map, const char *value, size_t len, int conv_status);
+	void Add(StatsMap<StatsSummaryItem> &map, const char *value, size_t len, StatsSummaryItem *item, Token *start, Token *end);
+	void Add(StatsMap<StatsSummaryItem> &map, Token *token, int conv_status);
+	void Add(StatsMap<StatsSummaryItem> &map, Token *token, StatsSummaryItem *item, Token *end);
 	
-	void Add(std::map<std::string, StatsDetailItem> &map, std::string value, StatsDetailItem *item, Token *start, Token *end);
-	void Add(std::map<std::string, StatsDetailItem> &map, Token *token, StatsDetailItem *item, Token *end);
-	void Add(std::map<std::string, StatsDetailItem> &map, Token *start_val, Token *end_val, StatsDetailItem *item, Token *start, Token *end);
-	void Add(std::map<std::string, StatsDetailItem> &map, const char* value, const char* desc, const char* note, const char* link, int conv_status);
-	void Add(std::map<std::string, StatsDetailItem> &map, Token *start, Token *end, const char* desc, const char* note, const char* link, int conv_status);
-
-    void Add(std::map<std::string, int> &map, std::string value, bool case_insense = true);
-    void Add(std::map<std::string, int> &map, Token *token, bool case_insense = true);
-    void Add(std::map<std::string, int> &map, TokenStr *token, bool case_insense = true);
-
-    void Add(std::map<std::string, int> &map, Token *start, Token *end, bool case_insense = true);
-
-	// Set the current source file
-	void SetSourceFile(const char *f) { _source_current_file = f; }
+	void Add(StatsMap<StatsDetailItem> &map, const char *value, size_t len, StatsDetailItem *item, Token *start, Token *end);
+	void Add(StatsMap<StatsDetailItem> &map, Token *token, StatsDetailItem *item, Token *end);
+	void Add(StatsMap<StatsDetailItem> &map, Token *start_val, Token *end_val, StatsDetailItem *item, Token *start, Token *end);
+	void Add(StatsMap<StatsDetailItem> &map, const char* value, size_t len, const char* desc, const char* note, const char* link, int conv_status);
+	void Add(StatsMap<StatsDetailItem> &map, Token *start, Token *end, const char* desc, const char* note, const char* link, int conv_status);
+
+    void Add(StatsMap<int> &map, const char *value, size_t len, bool case_insense = true);
+    void Add(StatsMap<int> &map, Token *token, bool case_insense = true);
+    void Add(StatsMap<int> &map, TokenStr *token, bool case_insense = true);
+
+    void Add(StatsMap<int> &map, Token *start, Token *end, bool case_insense = true);
+
+	// Set the current source file, and the path to read it again when snippets are extracted
+	void SetSourceFile(const char *f);
+	void SetSourcePath(const char *path);
+	// Set the content of the current source file
+	void SetSourceInput(const char *input, size_t size) { _source_input = input; _source_size = size; }
+	// Set the maximum number of snippets kept per item
+	void SetSnippetsLimit(int limit) { _snippets_limit = limit; }
+
+	// Get the snippet reference for the source code from start to end tokens
+	StatsSnippetItem GetSnippetItem(Token *start, Token *end);
+	// Add the snippet to the sample of the item snippets
+	void AddSnippet(std::vector<StatsSnippetItem> &snippets, int *seen, StatsSnippetItem &snippet);
+
+	// Get the snippet text and source file name
+	void GetSnippet(StatsSnippetItem &snippet, std::string &text);
+	void GetSnippet(StatsSnippetItem &snippet, std::string &text, std::map<int, FILE*> &files);
+	const char* GetSnippetFileName(StatsSnippetItem &snippet);
+	// Close source files opened to extract snippets
+	void CloseSnippetFiles();
+	void CloseSnippetFiles(std::map<int, FILE*> &files);
 };
 
 #endif // sqlexec_stats_h
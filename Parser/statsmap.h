@@ -0,0 +1,152 @@
+// StatsKeys and StatsMap<T> classes - Interned statistics keys and hash containers keyed by their ids
+
+#ifndef sqlines_statsmap_h
+#define sqlines_statsmap_h
+
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+// Initial number of hash slots (must be a power of 2)
+#define STATS_KEYS_SLOTS		1024
+
+// Each distinct key is stored once, lookups of existing keys do not allocate
+class StatsKeys
+{
+	// Keys by id, case-folded for case insensitive items
+	std::vector<std::string> keys;
+	// Hash values by id, used to rehash and to skip comparisons
+	std::vector<unsigned int> hashes;
+
+	// Open addressing hash table with key ids, -1 for empty slots
+	std::vector<int> slots;
+
+public:
+	// Get the key id, the key is added if not exists
+	int Get(const char *str, size_t len, bool case_insense)
+	{
+		if(str == NULL)
+			return -1;
+
+		if(slots.empty())
+			slots.assign(STATS_KEYS_SLOTS, -1);
+
+		unsigned int hash = Hash(str, len, case_insense);
+
+		size_t mask = slots.size() - 1;
+		size_t pos = hash & mask;
+
+		while(slots[pos] != -1)
+		{
+			int id = slots[pos];
+
+			if(hashes[id] == hash && Equals(keys[id], str, len, case_insense))
+				return id;
+
+			pos = (pos + 1) & mask;
+		}
+
+		int id = (int)keys.size();
+
+		keys.push_back(std::string(str, len));
+		hashes.push_back(hash);
+
+		if(case_insense)
+			std::transform(keys[id].begin(), keys[id].end(), keys[id].begin(), ::toupper);
+
+		slots[pos] = id;
+
+		// Keep the load factor under 0.5
+		if(keys.size() * 2 > slots.size())
+			Grow();
+
+		return id;
+	}
+
+	// Get the key by id
+	const std::string& GetKey(int id) { return keys[id]; }
+
+private:
+	// FNV-1a hash, case-folded bytes are used for case insensitive items
+	static unsigned int Hash(const char *str, size_t len, bool case_insense)
+	{
+		unsigned int hash = 2166136261u;
+
+		for(size_t i = 0; i < len; i++)
+		{
+			unsigned char c = (unsigned char)str[i];
+
+			if(case_insense)
+				c = (unsigned char)toupper(c);
+
+			hash = (hash ^ c) * 16777619u;
+		}
+
+		return hash;
+	}
+
+	// Compare the stored key with the input
+	static bool Equals(const std::string &key, const char *str, size_t len, bool case_insense)
+	{
+		if(key.length() != len)
+			return false;
+
+		for(size_t i = 0; i < len; i++)
+		{
+			char c = case_insense ? (char)toupper((unsigned char)str[i]) : str[i];
+
+			if(key[i] != c)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Double the number of slots and rehash
+	void Grow()
+	{
+		slots.assign(slots.size() * 2, -1);
+
+		size_t mask = slots.size() - 1;
+
+		for(size_t id = 0; id < keys.size(); id++)
+		{
+			size_t pos = hashes[id] & mask;
+
+			while(slots[pos] != -1)
+				pos = (pos + 1) & mask;
+
+			slots[pos] = (int)id;
+		}
+	}
+};
+
+// Statistics collection keyed by interned key ids, unordered until the report is rendered
+template <class T> class StatsMap : public std::unordered_map<int, T>
+{
+	// Compare items by key as std::map<std::string, T> ordered them
+	struct Less
+	{
+		bool operator()(const std::pair<const std::string*, T*> &a, const std::pair<const std::string*, T*> &b) const
+		{
+			return *a.first < *b.first;
+		}
+	};
+
+public:
+	// Get items ordered by key, sorting is done once when the report section is rendered
+	void GetSorted(StatsKeys &keys, std::vector<std::pair<const std::string*, T*> > &sorted)
+	{
+		sorted.clear();
+		sorted.reserve(this->size());
+
+		for(typename std::unordered_map<int, T>::iterator i = this->begin(); i != this->end(); i++)
+			sorted.push_back(std::pair<const std::string*, T*>(&keys.GetKey(i->first), &i->second));
+
+		std::sort(sorted.begin(), sorted.end(), Less());
+	}
+};
+
+#endif // sqlines_statsmap_h
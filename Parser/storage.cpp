@@ -5,7 +5,7 @@
 #include "sqlparser.h"
 
 // Temporary table options
-bool SqlParser::ParseTempTableOptions(Token *table_name, Token **start_out, Token **end_out, bool *no_data)
+bool SqlParser::ParseTempTableOptions(Token *table_name, Token **start_out, Token **end_out, bool *no_data, bool *delete_rows)
 {
 	bool exists = false;
 
@@ -41,6 +41,9 @@ bool SqlParser::ParseTempTableOptions(Token *table_name, Token **start_out, Toke
 
 			Token *rows = GetNextWordToken("ROWS", L"ROWS", 4);
 
+            if(commit != nullptr && delete_rows != nullptr)
+				*delete_rows = (delete_ != nullptr);
+
 			// Oracle does not support ON ROLLBACK, but DELETE ROWS in default on rollback
             if(rollback != nullptr)
 			{
@@ -75,10 +78,31 @@ bool SqlParser::ParseTempTableOptions(Token *table_name, Token **start_out, Toke
 bool SqlParser::ParseStorageClause(Token *table_name, Token **id_start, Token **comment,
 									Token *last_colname, Token *last_colend)
 {
-	if(ParseOracleStorageClause() == true)
-		return true;
-	
-	return false;
+	bool exists = false;
+
+	while(true)
+	{
+		// TABLESPACE of the table is kept
+		if(ParseOracleStorageClause(false) == true)
+			exists = true;
+
+		Token *next = GetNextToken();
+
+        if(next == nullptr)
+			break;
+
+		// Oracle partitioning clauses refer to the table columns
+		if(ParseOraclePartitions(next, table_name) == true)
+		{
+			exists = true;
+			continue;
+		}
+
+		PushBack(next);
+		break;
+	}
+
+	return exists;
 }
 
 // Parse MySQL CREATE TABLE storage clause
@@ -208,7 +232,7 @@ bool SqlParser::ParseMysqlStorageClause(Token *table_name, Token **id_start, Tok
 }
 
 // Parse Oracle CREATE TABLE, CREATE INDEX, PARTITION definition storage clause
-bool SqlParser::ParseOracleStorageClause()
+bool SqlParser::ParseOracleStorageClause(bool remove_tablespace)
 {
 	bool exists = false;
 
@@ -405,7 +429,9 @@ bool SqlParser::ParseOracleStorageClause()
 		if(next->Compare("TABLESPACE", L"TABLESPACE", 10) == true)
 		{
 			Token *name = GetNextIdentToken();
-			Token::Remove(next, name);
+
+			if(remove_tablespace == true)
+				Token::Remove(next, name);
 
 			exists = true;
 			continue;
@@ -450,13 +476,6 @@ bool SqlParser::ParseOracleStorageClause()
 		//	continue;
 		//}
 		else
-		// Oracle partitioning clauses
-		if(ParseOraclePartitions(next) == true)
-		{
-			exists = true;
-			continue;
-		}
-		else
 		// COMPUTE STATISTICS 
 		if(next->Compare("COMPUTE", L"COMPUTE", 7) == true)
 		{
@@ -507,8 +526,28 @@ bool SqlParser::ParseOracleStorageClause()
 // CREATE INDEX storage options
 bool SqlParser::ParseCreateIndexOptions()
 {
-	if(ParseOracleStorageClause() == true)
-		return true;
+	bool exists = false;
+
+	while(true)
+	{
+		if(ParseOracleStorageClause() == true)
+			exists = true;
+
+		Token *next = GetNextToken();
+
+        if(next == nullptr)
+			break;
+
+		// LOCAL and GLOBAL index partitioning
+		if(ParseOraclePartitions(next, nullptr) == true)
+		{
+			exists = true;
+			continue;
+		}
+
+		PushBack(next);
+		break;
+	}
 
-	return false;
+	return exists;
 }
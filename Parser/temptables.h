@@ -0,0 +1,95 @@
+// Oracle global temporary tables collected while parsed, and created in sessions by procedures at the end of file,
+// collections filled by BULK COLLECT are also held in session temporary tables
+
+#ifndef sqlines_temptables_h
+#define sqlines_temptables_h
+
+#include <string>
+#include <vector>
+#include "token.h"
+
+// CREATE GLOBAL TEMPORARY TABLE statement
+struct OracleTempTable
+{
+	Token *create;
+	Token *name;
+	// Closing ) of the column list
+	Token *close;
+	// Last token of the statement
+	Token *end;
+
+	// ON COMMIT DELETE ROWS is specified or used by default
+	bool delete_rows;
+
+	OracleTempTable()
+	{
+		create = NULL; name = NULL; close = NULL; end = NULL;
+		delete_rows = true;
+	}
+};
+
+// SELECT ... BULK COLLECT INTO c1 [, c2 ...] FROM ..., the temporary table is named after the first collection
+struct OracleBulkCollect
+{
+	// SELECT keyword, NULL for FETCH
+	Token *select;
+	// BULK keyword and the last collection of INTO
+	Token *bulk;
+	Token *into_last;
+	// ; of the statement
+	Token *end;
+
+	std::vector<Token*> collections;
+
+	// Last token of each select item, and whether it is an alias
+	std::vector<Token*> items;
+	std::vector<bool> aliases;
+
+	// Collection of records, otherwise each collection holds a single column
+	bool record;
+
+	// Columns of the temporary table
+	std::vector<std::string> columns;
+	bool columns_known;
+
+	bool convert;
+
+	OracleBulkCollect()
+	{
+		select = NULL; bulk = NULL; into_last = NULL; end = NULL;
+		record = false; columns_known = false; convert = false;
+	}
+};
+
+// FORALL i IN bounds INSERT, UPDATE or DELETE statement
+struct OracleForall
+{
+	Token *forall;
+	Token *index;
+	// DML statement and its ;
+	Token *stmt;
+	Token *end;
+
+	// VALUES and WHERE of the statement
+	Token *values;
+	Token *where_;
+
+	// Collections referenced as c(i) or c(i).field, and .field tokens (NULL for c(i))
+	std::vector<Token*> refs;
+	std::vector<Token*> fields;
+	// A collection is referenced in WHERE
+	bool refs_in_where;
+	// INSERT INTO table VALUES c(i)
+	bool whole_record;
+
+	// BULK COLLECT filling the collections, -1 if the statement cannot be converted
+	int bulk;
+
+	OracleForall()
+	{
+		forall = NULL; index = NULL; stmt = NULL; end = NULL; values = NULL; where_ = NULL;
+		refs_in_where = false; whole_record = false; bulk = -1;
+	}
+};
+
+#endif // sqlines_temptables_h
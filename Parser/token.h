@@ -17,6 +17,7 @@
 #define TOKEN_BOM		8		// UTF byte order mark
 #define TOKEN_FUNCTION	9		// Function
 #define TOKEN_STATEMENT	10		// Statement
+#define TOKEN_LITERALS	11		// Comma-separated literals copied as is (INSERT values i.e.)
 
 // Token subtype
 #define TOKEN_SUB_COLUMN_NAME         1    // Column name
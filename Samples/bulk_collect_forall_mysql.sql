@@ -0,0 +1,33 @@
+CREATE OR REPLACE PROCEDURE sync_emp AS
+  TYPE t_ids IS TABLE OF NUMBER;
+  TYPE t_names IS TABLE OF VARCHAR2(30);
+  v_ids t_ids;
+  v_names t_names;
+BEGIN
+  DROP TEMPORARY TABLE IF EXISTS v_ids;
+  CREATE TEMPORARY TABLE v_ids AS SELECT e.id AS v_ids, UPPER(e.name) v_names FROM emp e WHERE e.dept = 10;
+  UPDATE emp_hist h, v_ids SET name = v_ids.v_names WHERE h.id = v_ids.v_ids;
+  DELETE emp_log FROM emp_log, v_ids WHERE emp_id = v_ids.v_ids;
+END;
+/
+
+-- Collection passed to a procedure is kept
+CREATE OR REPLACE PROCEDURE print_emp AS
+  TYPE t_ids IS TABLE OF NUMBER;
+  v_ids t_ids;
+BEGIN
+  SELECT id BULK COLLECT INTO v_ids FROM emp;
+  print_ids(v_ids);
+END;
+/
+
+-- FORALL accumulating into the updated rows is kept, a department can match several elements
+CREATE OR REPLACE PROCEDURE count_depts AS
+  TYPE t_ids IS TABLE OF NUMBER;
+  v_d t_ids;
+BEGIN
+  SELECT dept BULK COLLECT INTO v_d FROM emp;
+  FORALL i IN 1.v_d.COUNT
+    UPDATE dept_stats SET cnt = cnt + 1 WHERE id = v_d(i);
+END;
+/
@@ -0,0 +1,25 @@
+CREATE OR REPLACE PROCEDURE archive_emp(p_dept IN NUMBER) AS
+  CURSOR c1 IS SELECT id, name FROM emp WHERE dept = p_dept;
+BEGIN
+  FOR r IN (SELECT id, name FROM emp) LOOP
+    INSERT INTO emp_log (id, name) VALUES (r.id, UPPER(r.name));
+  END LOOP;
+  FOR r IN c1 LOOP
+    UPDATE emp_hist h SET name = r.name WHERE h.id = r.id;
+  END LOOP;
+  FOR x IN (SELECT id FROM old_emp) LOOP
+    DELETE emp_log WHERE id = x.id;
+  END LOOP;
+  -- Loops accumulating into the updated rows, calling procedures or committing each row are kept
+  FOR r IN (SELECT dept, sal FROM emp) LOOP
+    UPDATE dept_stats SET cnt = cnt + 1, total = total + r.sal WHERE id = r.dept;
+  END LOOP;
+  FOR r IN (SELECT id FROM emp) LOOP
+    log_row(r.id);
+  END LOOP;
+  FOR r IN (SELECT id FROM emp) LOOP
+    INSERT INTO emp_log (id) VALUES (r.id);
+    COMMIT;
+  END LOOP;
+END;
+/
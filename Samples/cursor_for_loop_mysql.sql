@@ -0,0 +1,19 @@
+CREATE OR REPLACE PROCEDURE archive_emp(p_dept IN NUMBER) AS
+  CURSOR c1 IS SELECT id, name FROM emp WHERE dept = p_dept;
+BEGIN
+  INSERT INTO emp_log (id, name) SELECT r.id, UPPER(r.name) FROM (SELECT id, name FROM emp) r;
+  UPDATE emp_hist h, (SELECT id, name FROM emp WHERE dept = p_dept) r SET h.name = r.name WHERE h.id = r.id;
+  DELETE emp_log FROM emp_log, (SELECT id FROM old_emp) x WHERE emp_log.id = x.id;
+  -- Loops accumulating into the updated rows, calling procedures or committing each row are kept
+  FOR r IN (SELECT dept, sal FROM emp) LOOP
+    UPDATE dept_stats SET cnt = cnt + 1, total = total + r.sal WHERE id = r.dept;
+  END LOOP;
+  FOR r IN (SELECT id FROM emp) LOOP
+    log_row(r.id);
+  END LOOP;
+  FOR r IN (SELECT id FROM emp) LOOP
+    INSERT INTO emp_log (id) VALUES (r.id);
+    COMMIT;
+  END LOOP;
+END;
+/
@@ -0,0 +1,6 @@
+-- Options: -mysql_version=5.7
+CREATE TABLE emp (id NUMBER(10) PRIMARY KEY, name VARCHAR2(100), hire_date DATE, sal NUMBER(10,2), dept_id NUMBER(5));
+CREATE INDEX emp_name_idx ON emp (UPPER(name));
+CREATE INDEX emp_hire_idx ON emp (TRUNC(hire_date), dept_id DESC);
+CREATE INDEX emp_n2_idx ON emp (SUBSTR(name, 1, 10));
+CREATE INDEX emp_plain_idx ON emp (dept_id, id);
@@ -0,0 +1,9 @@
+-- Options: -mysql_version=5.7
+CREATE TABLE emp (id BIGINT PRIMARY KEY, name VARCHAR(100), hire_date DATETIME, sal DECIMAL(10,2), dept_id INT);
+ALTER TABLE emp ADD COLUMN emp_name_idx_expr VARCHAR(100) AS (UPPER(name)) STORED;
+CREATE INDEX emp_name_idx ON emp (emp_name_idx_expr);
+ALTER TABLE emp ADD COLUMN emp_hire_idx_expr DATE AS (DATE(hire_date)) STORED;
+CREATE INDEX emp_hire_idx ON emp (emp_hire_idx_expr, dept_id DESC);
+ALTER TABLE emp ADD COLUMN emp_n2_idx_expr VARCHAR(100) AS (SUBSTR(name, 1, 10)) STORED;
+CREATE INDEX emp_n2_idx ON emp (emp_n2_idx_expr);
+CREATE INDEX emp_plain_idx ON emp (dept_id, id);
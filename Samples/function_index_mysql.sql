@@ -0,0 +1,8 @@
+CREATE TABLE emp (id BIGINT PRIMARY KEY, name VARCHAR(100), hire_date DATETIME, sal DECIMAL(10,2), dept_id INT);
+CREATE INDEX emp_name_idx ON emp ((UPPER(name)));
+CREATE INDEX emp_hire_idx ON emp ((DATE(hire_date)), dept_id DESC);
+CREATE UNIQUE INDEX emp_x_idx ON hr.emp (dept_id, (LOWER(TRIM(name))));
+CREATE INDEX emp_sal_idx ON emp ((sal * 12));
+CREATE INDEX emp_n2_idx ON emp ((SUBSTR(name, 1, 10)));
+CREATE INDEX emp_plain_idx ON emp (dept_id, id);
+CREATE INDEX emp_u_idx ON emp2 ((UPPER(name2)));
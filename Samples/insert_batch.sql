@@ -0,0 +1,21 @@
+-- Options: -insert_batch=3
+CREATE TABLE orders (
+  id NUMBER(10) NOT NULL,
+  cust NUMBER(10),
+  note VARCHAR2(30),
+  created DATE
+);
+
+INSERT INTO orders (id, cust, note, created) VALUES (1, 332, 'first', NULL);
+INSERT INTO orders (id, cust, note, created) VALUES (2, 405, 'it''s second', NULL);
+INSERT INTO orders (id, cust, note, created) VALUES (3, 75, 'third', NULL);
+INSERT INTO orders (id, cust, note, created) VALUES (4, 97, 'fourth', NULL);
+INSERT INTO orders (id, cust, note, created) VALUES (5, 60, 'fifth', NULL);
+
+-- Different column list starts a new statement
+INSERT INTO orders (id, cust) VALUES (6, 220);
+INSERT INTO orders (id, cust) VALUES (7, 445);
+
+-- Converted expressions are kept in merged rows
+INSERT INTO orders (id, cust, note, created) VALUES (8, 247, 'eighth', SYSDATE);
+INSERT INTO orders (id, cust, note, created) VALUES (9, 435, 'ninth', NULL);
@@ -0,0 +1,21 @@
+-- Options: -insert_batch=3
+CREATE TABLE orders (
+  id BIGINT NOT NULL,
+  cust BIGINT,
+  note VARCHAR(30),
+  created DATETIME
+);
+
+INSERT INTO orders (id, cust, note, created) VALUES (1, 332, 'first', NULL),
+(2, 405, 'it''s second', NULL),
+(3, 75, 'third', NULL);
+INSERT INTO orders (id, cust, note, created) VALUES (4, 97, 'fourth', NULL),
+(5, 60, 'fifth', NULL);
+
+-- Different column list starts a new statement
+INSERT INTO orders (id, cust) VALUES (6, 220),
+(7, 445);
+
+-- Converted expressions are kept in merged rows
+INSERT INTO orders (id, cust, note, created) VALUES (8, 247, 'eighth', SYSDATE()),
+(9, 435, 'ninth', NULL);
@@ -0,0 +1,5 @@
+UPDATE /*+ INDEX(emp a_idx) */ emp SET x = 1 WHERE id = 1;
+UPDATE /*+ INDEX(emp a_idx) */ emp SET x = 1 WHERE id = 1;
+UPDATE /*+ INDEX(emp b_idx) */ emp SET x = 1 WHERE id = 1;
+SELECT NVL(name, 'n/a'), SYSDATE FROM emp WHERE id = 1;
+SELECT NVL(name, 'n/a'), SYSDATE FROM emp WHERE id = 2;
@@ -0,0 +1,5 @@
+UPDATE emp FORCE INDEX (a_idx) SET x = 1 WHERE id = 1;
+UPDATE emp FORCE INDEX (a_idx) SET x = 1 WHERE id = 1;
+UPDATE emp FORCE INDEX (b_idx) SET x = 1 WHERE id = 1;
+SELECT IFNULL(name, 'n/a'), SYSDATE() FROM emp WHERE id = 1;
+SELECT IFNULL(name, 'n/a'), SYSDATE() FROM emp WHERE id = 2;
@@ -0,0 +1,18 @@
+CREATE OR REPLACE PROCEDURE p(p_id NUMBER)
+IS
+  v VARCHAR2(30);
+BEGIN
+  SELECT /*+ INDEX(e pk_emp) */ name INTO v FROM emp e WHERE id = p_id;
+  SELECT /*+ INDEX(e) FULL(d) */ name INTO v FROM emp e, dept d WHERE e.dept_id = d.id AND e.id = p_id;
+  SELECT /*+ LEADING(d e) USE_NL(e) USE_HASH(d) PARALLEL(e 4) */ name INTO v FROM emp e JOIN dept d ON e.dept_id = d.id WHERE e.id = p_id;
+  UPDATE /*+ INDEX(emp emp_id_idx emp_id2_idx) NO_INDEX(emp x_idx) */ emp SET sal = sal * 2 WHERE id = p_id;
+  DELETE /*+ INDEX(e pk_emp) */ FROM emp e WHERE id = p_id;
+  SELECT /*+ ORDERED FIRST_ROWS(10) */ name INTO v FROM emp WHERE id = p_id;
+  SELECT /*+ PARALLEL(e, 8) */ name INTO v FROM hr.emp WHERE id = (SELECT /*+ INDEX(emp emp_idx) NO_MERGE */ MAX(id) FROM emp);
+  SELECT /*+ INDEX(@qb e pk) */ name INTO v FROM emp e WHERE id = 1;
+END;
+/
+
+UPDATE /*+ INDEX(emp a_idx) */ emp SET x = 1 WHERE id = 1;
+UPDATE /*+ INDEX(emp a_idx) */ emp SET x = 1 WHERE id = 1;
+UPDATE /*+ INDEX(emp b_idx) */ emp SET x = 1 WHERE id = 1;
@@ -0,0 +1,18 @@
+CREATE OR REPLACE PROCEDURE p(p_id NUMBER)
+IS
+  v VARCHAR2(30);
+BEGIN
+  SELECT name INTO v FROM emp e FORCE INDEX (pk_emp) WHERE id = p_id;
+  SELECT /*+ INDEX(e) NO_INDEX(d) */ name INTO v FROM emp e, dept d WHERE e.dept_id = d.id AND e.id = p_id;
+  SELECT /*+ JOIN_PREFIX(d, e) NO_BNL(e) BNL(d) */ /* PARALLEL(e 4) */ name INTO v FROM emp e JOIN dept d ON e.dept_id = d.id WHERE e.id = p_id;
+  UPDATE emp FORCE INDEX (emp_id_idx, emp_id2_idx) IGNORE INDEX (x_idx) SET sal = sal * 2 WHERE id = p_id;
+  DELETE /*+ INDEX(e pk_emp) */ FROM emp e WHERE id = p_id;
+  SELECT /*+ JOIN_FIXED_ORDER() */ /* FIRST_ROWS(10) */ name INTO v FROM emp WHERE id = p_id;
+  SELECT /* PARALLEL(e, 8) */ name INTO v FROM hr.emp WHERE id = (SELECT /* NO_MERGE */ MAX(id) FROM emp FORCE INDEX (emp_idx));
+  SELECT /* INDEX(@qb e pk) */ name INTO v FROM emp e WHERE id = 1;
+END;
+/
+
+UPDATE emp FORCE INDEX (a_idx) SET x = 1 WHERE id = 1;
+UPDATE emp FORCE INDEX (a_idx) SET x = 1 WHERE id = 1;
+UPDATE emp FORCE INDEX (b_idx) SET x = 1 WHERE id = 1;
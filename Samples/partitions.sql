@@ -0,0 +1,67 @@
+CREATE TABLE sales (
+  id NUMBER(10) NOT NULL,
+  sale_date DATE NOT NULL,
+  region VARCHAR2(10),
+  CONSTRAINT pk_sales PRIMARY KEY (id, sale_date)
+)
+TABLESPACE users
+PARTITION BY RANGE (sale_date)
+(
+  PARTITION p2019 VALUES LESS THAN (TO_DATE('2020-01-01', 'YYYY-MM-DD')) TABLESPACE users,
+  PARTITION p2020 VALUES LESS THAN (TO_DATE(' 2021-01-01 00:00:00', 'SYYYY-MM-DD HH24:MI:SS', 'NLS_CALENDAR=GREGORIAN')),
+  PARTITION p2021 VALUES LESS THAN (DATE '2022-01-01'),
+  PARTITION pmax VALUES LESS THAN (MAXVALUE)
+);
+
+-- Bounds with a time part
+CREATE TABLE events (
+  d DATE
+)
+PARTITION BY RANGE (d)
+(
+  PARTITION p1 VALUES LESS THAN (TO_DATE('01-JAN-2020 12:30', 'DD-MON-YYYY HH24:MI')),
+  PARTITION p2 VALUES LESS THAN (TIMESTAMP '2021-01-01 00:00:00')
+);
+
+CREATE TABLE regions (
+  id NUMBER(10),
+  region VARCHAR2(10)
+)
+PARTITION BY LIST (region)
+(
+  PARTITION p_east VALUES ('NY', 'NJ'),
+  PARTITION p_west VALUES ('CA')
+);
+
+CREATE TABLE codes (code NUMBER(5))
+PARTITION BY LIST (code) (PARTITION a VALUES (1, 2), PARTITION b VALUES (3));
+
+CREATE TABLE names (
+  name VARCHAR2(10) PRIMARY KEY
+)
+PARTITION BY HASH (name)
+PARTITIONS 4;
+
+CREATE TABLE orders (
+  id NUMBER(10),
+  d DATE
+)
+PARTITION BY RANGE (d)
+SUBPARTITION BY HASH (id) SUBPARTITIONS 4
+(
+  PARTITION p1 VALUES LESS THAN (TO_DATE('2020-01-01', 'YYYY-MM-DD')),
+  PARTITION p2 VALUES LESS THAN (MAXVALUE)
+);
+
+-- Primary key does not include the partitioning column
+CREATE TABLE items (
+  id NUMBER(10) PRIMARY KEY,
+  d DATE
+)
+PARTITION BY RANGE (d)
+(
+  PARTITION p1 VALUES LESS THAN (TO_DATE('2020-01-01', 'YYYY-MM-DD')),
+  PARTITION p2 VALUES LESS THAN (MAXVALUE)
+);
+
+CREATE INDEX idx_sales ON sales (region) LOCAL;
@@ -0,0 +1,63 @@
+CREATE TABLE sales (
+  id BIGINT NOT NULL,
+  sale_date DATETIME NOT NULL,
+  region VARCHAR(10),
+  CONSTRAINT pk_sales PRIMARY KEY (id, sale_date)
+)
+TABLESPACE users
+PARTITION BY RANGE (TO_DAYS(sale_date))
+(
+  PARTITION p2019 VALUES LESS THAN (TO_DAYS('2020-01-01')),
+  PARTITION p2020 VALUES LESS THAN (TO_DAYS('2021-01-01')),
+  PARTITION p2021 VALUES LESS THAN (TO_DAYS('2022-01-01')),
+  PARTITION pmax VALUES LESS THAN (MAXVALUE)
+);
+
+-- Bounds with a time part
+CREATE TABLE events (
+  d DATETIME
+)
+PARTITION BY RANGE COLUMNS (d)
+(
+  PARTITION p1 VALUES LESS THAN ('2020-01-01 12:30:00'),
+  PARTITION p2 VALUES LESS THAN ('2021-01-01')
+);
+
+CREATE TABLE regions (
+  id BIGINT,
+  region VARCHAR(10)
+)
+PARTITION BY LIST COLUMNS (region)
+(
+  PARTITION p_east VALUES IN ('NY', 'NJ'),
+  PARTITION p_west VALUES IN ('CA')
+);
+
+CREATE TABLE codes (code INT)
+PARTITION BY LIST (code) (PARTITION a VALUES IN (1, 2), PARTITION b VALUES IN (3));
+
+CREATE TABLE names (
+  name VARCHAR(10) PRIMARY KEY
+)
+PARTITION BY KEY (name)
+PARTITIONS 4;
+
+CREATE TABLE orders (
+  id BIGINT,
+  d DATETIME
+)
+PARTITION BY RANGE (TO_DAYS(d))
+SUBPARTITION BY HASH (id) SUBPARTITIONS 4
+(
+  PARTITION p1 VALUES LESS THAN (TO_DAYS('2020-01-01')),
+  PARTITION p2 VALUES LESS THAN (MAXVALUE)
+);
+
+-- Primary key does not include the partitioning column
+CREATE TABLE items (
+  id BIGINT PRIMARY KEY,
+  d DATETIME
+)
+;
+
+CREATE INDEX idx_sales ON sales (region);
@@ -0,0 +1,15 @@
+UPDATE orders o SET last_item = (SELECT i.id FROM items i WHERE i.order_id = o.id AND rownum = 1);
+UPDATE orders o SET top_item = (SELECT i.id FROM items i WHERE rownum <= 1 AND i.order_id = o.id);
+UPDATE orders o SET any_item = (SELECT i.id FROM items i WHERE rownum BETWEEN 1 AND 1);
+UPDATE orders o SET next_item = (SELECT i.id FROM items i WHERE i.order_id = o.id ORDER BY i.id OFFSET 1 ROWS FETCH NEXT 1 ROWS ONLY);
+UPDATE orders o SET first_item = (SELECT i.id FROM items i WHERE i.order_id = o.id ORDER BY i.id FETCH FIRST ROW ONLY);
+
+-- Conditions combined with OR are not converted
+UPDATE orders o SET flag = (SELECT 1 FROM items i WHERE rownum <= 5 OR i.order_id = o.id);
+UPDATE orders o SET flag = (SELECT 1 FROM items i WHERE (rownum <= 5 AND i.order_id = o.id) OR i.price > 100);
+UPDATE orders o SET flag = (SELECT 1 FROM items i WHERE i.order_id = o.id AND rownum <= 5 OR i.price > 100);
+
+-- MySQL does not allow LIMIT in IN subqueries, and rownum limits the rows before aggregation
+UPDATE emp e SET x = 1 WHERE e.id IN (SELECT id FROM t WHERE ROWNUM < 3);
+UPDATE emp e SET x = (SELECT MAX(v) FROM t WHERE t.id = e.id AND ROWNUM <= 2);
+UPDATE emp e SET x = (SELECT v FROM t WHERE t.id = e.id AND ROWNUM <= 2 GROUP BY v);
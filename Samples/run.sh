@@ -0,0 +1,53 @@
+#!/bin/sh
+# Convert each Oracle sample and compare the result with the expected MySQL output
+#
+#   Samples/run.sh [path to MigrationTool executable]
+#
+# name.sql is converted and compared with name_mysql.sql. Tool options for the sample
+# are taken from the "-- Options:" line at the start of name.sql.
+
+TOOL=${1:-./MigrationTool/MigrationTool}
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$TOOL" ]; then
+	echo "MigrationTool executable not found: $TOOL"
+	exit 2
+fi
+
+TOOL=$(cd "$(dirname "$TOOL")" && pwd)/$(basename "$TOOL")
+
+failed=0
+total=0
+
+for src in "$DIR"/*.sql; do
+	case "$src" in
+		*_mysql.sql) continue ;;
+	esac
+
+	name=$(basename "$src" .sql)
+	expected="$DIR/${name}_mysql.sql"
+
+	options=$(sed -n '1s/^-- Options: *//p' "$src")
+
+	cp "$src" "$WORK/$name.sql"
+	printf '{ "SourceDB": { "FilePath": "%s.sql" }, "DestinationDB": { "FilePath": "%s_out.sql" } }\n' "$name" "$name" > "$WORK/$name.json"
+
+	(cd "$WORK" && "$TOOL" -p="$name.json" -log="$name.log" $options > /dev/null 2>&1)
+
+	total=$((total + 1))
+
+	if diff -u "$expected" "$WORK/${name}_out.sql" > "$WORK/$name.diff"; then
+		echo "$name...Ok"
+	else
+		echo "$name...Failed"
+		cat "$WORK/$name.diff"
+		failed=$((failed + 1))
+	fi
+done
+
+echo "$total samples, $failed failed"
+
+[ $failed -eq 0 ]
@@ -0,0 +1,11 @@
+CREATE SEQUENCE order_seq START WITH 1000 INCREMENT BY 10 MAXVALUE 999999 CACHE 50 NOCYCLE;
+CREATE SEQUENCE ticket_seq NOCACHE;
+CREATE SEQUENCE round_seq START WITH 10 INCREMENT BY -1 MINVALUE 1 MAXVALUE 10 CYCLE CACHE 5;
+
+CREATE TABLE orders (
+  id NUMBER(10),
+  ticket NUMBER(10)
+);
+
+INSERT INTO orders (id, ticket) VALUES (order_seq.NEXTVAL, ticket_seq.NEXTVAL);
+UPDATE orders SET ticket = round_seq.NEXTVAL WHERE id = order_seq.CURRVAL;
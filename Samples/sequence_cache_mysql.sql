@@ -0,0 +1,119 @@
+-- Emulation of Oracle sequences, a session takes the next values from the block of CACHE values it reserved,
+-- and the row of the sequence is locked only when a new block is reserved
+CREATE TABLE IF NOT EXISTS sqlines_sequences
+(
+  name VARCHAR(128) NOT NULL PRIMARY KEY,
+  next_value DECIMAL(28) NOT NULL,
+  increment_by DECIMAL(28) NOT NULL,
+  min_value DECIMAL(28) NOT NULL,
+  max_value DECIMAL(28) NOT NULL,
+  cache_size INT NOT NULL,
+  cycle_option TINYINT NOT NULL
+) ENGINE = InnoDB;
+
+-- Blocks reserved by sessions, a row is changed by its session only
+CREATE TABLE IF NOT EXISTS sqlines_sequence_blocks
+(
+  name VARCHAR(128) NOT NULL,
+  session_id BIGINT UNSIGNED NOT NULL,
+  current_value DECIMAL(28) NOT NULL,
+  next_value DECIMAL(28) NOT NULL,
+  increment_by DECIMAL(28) NOT NULL,
+  remaining INT NOT NULL,
+  PRIMARY KEY (name, session_id)
+) ENGINE = InnoDB;
+
+-- Functions modify data, so log_bin_trust_function_creators = 1 is required when binary logging is enabled
+DROP FUNCTION IF EXISTS NextVal;
+DROP FUNCTION IF EXISTS LastVal;
+
+DELIMITER //
+
+CREATE FUNCTION NextVal(p_name VARCHAR(128)) RETURNS DECIMAL(28)
+  NOT DETERMINISTIC MODIFIES SQL DATA
+BEGIN
+  DECLARE v_value, v_inc, v_min, v_max DECIMAL(28);
+  DECLARE v_cache, v_remaining INT;
+  DECLARE v_cycle TINYINT;
+  DECLARE v_block INT DEFAULT NULL;
+  DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;
+
+  -- Non-locking read, other sessions do not change the block of this session
+  SELECT next_value, increment_by, remaining INTO v_value, v_inc, v_block
+  FROM sqlines_sequence_blocks WHERE name = p_name AND session_id = CONNECTION_ID();
+
+  IF v_block IS NOT NULL AND v_block > 0 THEN
+    UPDATE sqlines_sequence_blocks SET current_value = v_value, next_value = v_value + v_inc, remaining = v_block - 1
+    WHERE name = p_name AND session_id = CONNECTION_ID();
+
+    RETURN v_value;
+  END IF;
+
+  SET v_inc = NULL;
+
+  -- Reserve a new block, concurrent sessions get disjoint blocks
+  SELECT next_value, increment_by, min_value, max_value, cache_size, cycle_option
+  INTO v_value, v_inc, v_min, v_max, v_cache, v_cycle
+  FROM sqlines_sequences WHERE name = p_name FOR UPDATE;
+
+  IF v_inc IS NULL THEN
+    SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence does not exist';
+  END IF;
+
+  IF v_value > v_max OR v_value < v_min THEN
+    IF v_cycle = 0 THEN
+      SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence exceeds MAXVALUE or MINVALUE';
+    END IF;
+
+    SET v_value = IF(v_inc > 0, v_min, v_max);
+  END IF;
+
+  -- Block is limited by MAXVALUE or MINVALUE
+  SET v_remaining = LEAST(v_cache, FLOOR(IF(v_inc > 0, v_max - v_value, v_min - v_value) / v_inc) + 1);
+
+  UPDATE sqlines_sequences SET next_value = v_value + v_inc * v_remaining WHERE name = p_name;
+
+  IF v_block IS NULL THEN
+    INSERT INTO sqlines_sequence_blocks (name, session_id, current_value, next_value, increment_by, remaining)
+    VALUES (p_name, CONNECTION_ID(), v_value, v_value + v_inc, v_inc, v_remaining - 1);
+  ELSE
+    UPDATE sqlines_sequence_blocks SET current_value = v_value, next_value = v_value + v_inc, increment_by = v_inc,
+      remaining = v_remaining - 1
+    WHERE name = p_name AND session_id = CONNECTION_ID();
+  END IF;
+
+  RETURN v_value;
+END//
+
+CREATE FUNCTION LastVal(p_name VARCHAR(128)) RETURNS DECIMAL(28)
+  NOT DETERMINISTIC READS SQL DATA
+BEGIN
+  DECLARE v_value DECIMAL(28) DEFAULT NULL;
+  DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;
+
+  SELECT current_value INTO v_value
+  FROM sqlines_sequence_blocks WHERE name = p_name AND session_id = CONNECTION_ID();
+
+  IF v_value IS NULL THEN
+    SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Sequence CURRVAL is not yet defined in this session';
+  END IF;
+
+  RETURN v_value;
+END//
+
+DELIMITER ;
+
+INSERT INTO sqlines_sequences (name, next_value, increment_by, min_value, max_value, cache_size, cycle_option)
+  VALUES ('order_seq', 1000, 10, 1, 999999, 50, 0);
+INSERT INTO sqlines_sequences (name, next_value, increment_by, min_value, max_value, cache_size, cycle_option)
+  VALUES ('ticket_seq', 1, 1, 1, 9999999999999999999999999999, 1, 0);
+INSERT INTO sqlines_sequences (name, next_value, increment_by, min_value, max_value, cache_size, cycle_option)
+  VALUES ('round_seq', 10, -1, 1, 10, 5, 1);
+
+CREATE TABLE orders (
+  id BIGINT,
+  ticket BIGINT
+);
+
+INSERT INTO orders (id, ticket) VALUES (NextVal('order_seq'), NextVal('ticket_seq'));
+UPDATE orders SET ticket = NextVal('round_seq') WHERE id = LastVal('order_seq');
@@ -0,0 +1,44 @@
+CREATE TABLE customers (
+  id NUMBER(10) NOT NULL,
+  name VARCHAR2(30),
+  CONSTRAINT pk_customers PRIMARY KEY (id)
+);
+
+CREATE SEQUENCE customers_seq START WITH 100 INCREMENT BY 1;
+
+CREATE OR REPLACE TRIGGER customers_bi
+BEFORE INSERT ON customers
+FOR EACH ROW
+BEGIN
+  SELECT customers_seq.NEXTVAL INTO :NEW.id FROM dual;
+END;
+/
+
+-- Sequence shared by triggers of two tables stays a sequence
+CREATE TABLE invoices (
+  id NUMBER(10) PRIMARY KEY,
+  amount NUMBER(10,2)
+);
+
+CREATE TABLE payments (
+  id NUMBER(10) PRIMARY KEY,
+  amount NUMBER(10,2)
+);
+
+CREATE SEQUENCE doc_seq START WITH 1 INCREMENT BY 1 CACHE 20;
+
+CREATE OR REPLACE TRIGGER invoices_bi
+BEFORE INSERT ON invoices
+FOR EACH ROW
+BEGIN
+  :NEW.id := doc_seq.NEXTVAL;
+END;
+/
+
+CREATE OR REPLACE TRIGGER payments_bi
+BEFORE INSERT ON payments
+FOR EACH ROW
+BEGIN
+  :NEW.id := doc_seq.NEXTVAL;
+END;
+/
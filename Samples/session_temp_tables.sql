@@ -0,0 +1,34 @@
+-- Options: -session_temp_tables
+CREATE GLOBAL TEMPORARY TABLE tmp_orders
+(
+  id NUMBER(10) NOT NULL,
+  name VARCHAR2(100),
+  created DATE
+) ON COMMIT DELETE ROWS;
+
+CREATE GLOBAL TEMPORARY TABLE tmp_docs
+(
+  id NUMBER(10),
+  body CLOB
+) ON COMMIT PRESERVE ROWS;
+
+CREATE OR REPLACE PROCEDURE load_orders
+AS
+  v_cnt NUMBER;
+BEGIN
+  INSERT INTO tmp_orders (id, name, created) SELECT id, name, SYSDATE FROM orders;
+  SELECT COUNT(*) INTO v_cnt FROM tmp_orders;
+  INSERT INTO tmp_docs VALUES (1, 'x');
+  COMMIT;
+  UPDATE orders SET cnt = v_cnt;
+  ROLLBACK;
+END;
+/
+
+CREATE OR REPLACE PROCEDURE no_temp
+AS
+BEGIN
+  UPDATE orders SET cnt = 0;
+  COMMIT;
+END;
+/
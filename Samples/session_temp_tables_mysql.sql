@@ -0,0 +1,47 @@
+-- Options: -session_temp_tables
+/* CREATE GLOBAL TEMPORARY TABLE tmp_orders
+(
+  id BIGINT NOT NULL,
+  name VARCHAR(100),
+  created DATETIME
+) ON COMMIT DELETE ROWS; */
+
+/* CREATE GLOBAL TEMPORARY TABLE tmp_docs
+(
+  id BIGINT,
+  body LONGTEXT
+) ON COMMIT PRESERVE ROWS; */
+
+CREATE OR REPLACE PROCEDURE load_orders
+AS
+  v_cnt NUMBER;
+BEGIN
+  CREATE TEMPORARY TABLE IF NOT EXISTS tmp_orders
+  (
+    id BIGINT NOT NULL,
+    name VARCHAR(100),
+    created DATETIME
+  ) ENGINE = MEMORY;
+  CREATE TEMPORARY TABLE IF NOT EXISTS tmp_docs
+  (
+    id BIGINT,
+    body LONGTEXT
+  );
+  INSERT INTO tmp_orders (id, name, created) SELECT id, name, SYSDATE() FROM orders;
+  SELECT COUNT(*) INTO v_cnt FROM tmp_orders;
+  INSERT INTO tmp_docs VALUES (1, 'x');
+  COMMIT;
+  TRUNCATE TABLE tmp_orders;
+  UPDATE orders SET cnt = v_cnt;
+  ROLLBACK;
+  TRUNCATE TABLE tmp_orders;
+END;
+/
+
+CREATE OR REPLACE PROCEDURE no_temp
+AS
+BEGIN
+  UPDATE orders SET cnt = 0;
+  COMMIT;
+END;
+/